@@ -11,13 +11,36 @@
  * 3. Report both latency (ns/message) and throughput (messages/sec).
  */
 
+#include <algorithm>
 #include <benchmark/benchmark.h>
+#include <book/order_book.hpp>
+#include <book/order_table.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <span>
+#include <unordered_map>
 #include <vector>
 
 #include <itch/compat.hpp>
 #include <itch/messages.hpp>
+#include <itch/line_arbitrator.hpp>
+#include <itch/net_decoder.hpp>
+#include <itch/parallel_scan.hpp>
 #include <itch/parser.hpp>
+#include <itch/pcap_index.hpp>
+#include <itch/pcap_reader.hpp>
+#include <itch/pcap_stream_reader.hpp>
+#include <itch/pcap_writer.hpp>
+#include <itch/replay_clock.hpp>
+#include <itch/soa_decoder.hpp>
+#include <itch/stream_parser.hpp>
+#include <itch/udp_receiver.hpp>
 
 namespace {
 
@@ -39,7 +62,7 @@ std::vector<char> create_add_order_message() {
 
   // Stock locate = 1234 (big-endian) at offset 1
   buffer[1] = 0x04;
-  buffer[2] = 0xD2;
+  buffer[2] = static_cast<char>(0xD2);
 
   // Tracking number = 5678 (big-endian) at offset 3
   buffer[3] = 0x16;
@@ -281,6 +304,354 @@ BENCHMARK_REGISTER_F(ITCHParseFixture, NaiveParse)
     ->Unit(benchmark::kNanosecond)
     ->MinTime(1.0);
 
+// ============================================================================
+// Benchmark 2b: parse_buffer - Per-Message vs Batched Visitor
+// ============================================================================
+
+/**
+ * @brief Drain the whole buffer with parse_buffer, one callback per message.
+ */
+BENCHMARK_DEFINE_F(ITCHParseFixture, ParseBufferPerMessage)
+(benchmark::State &state) {
+  struct SharesVisitor : itch::DefaultVisitor {
+    uint64_t total_shares = 0;
+    void on_add_order(const itch::AddOrder &msg) {
+      total_shares += static_cast<uint32_t>(msg.shares);
+    }
+  };
+
+  itch::Parser parser;
+
+  for (auto _ : state) {
+    SharesVisitor visitor;
+    size_t consumed =
+        parser.parse_buffer(buffer_.data(), buffer_.size(), visitor);
+    benchmark::DoNotOptimize(consumed);
+    benchmark::DoNotOptimize(visitor.total_shares);
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_messages_);
+  state.SetBytesProcessed(state.iterations() * buffer_.size());
+}
+
+BENCHMARK_REGISTER_F(ITCHParseFixture, ParseBufferPerMessage)
+    ->Unit(benchmark::kNanosecond)
+    ->MinTime(1.0);
+
+/**
+ * @brief Same workload, but the visitor receives same-type runs as spans.
+ */
+BENCHMARK_DEFINE_F(ITCHParseFixture, ParseBufferBatched)
+(benchmark::State &state) {
+  struct SharesBatchVisitor : itch::DefaultVisitor {
+    uint64_t total_shares = 0;
+    void on_add_order_batch(itch::MessageSpan<itch::AddOrder> run) {
+      for (const itch::AddOrder *msg : run) {
+        total_shares += static_cast<uint32_t>(msg->shares);
+      }
+    }
+  };
+
+  itch::Parser parser;
+
+  for (auto _ : state) {
+    SharesBatchVisitor visitor;
+    size_t consumed =
+        parser.parse_buffer(buffer_.data(), buffer_.size(), visitor);
+    benchmark::DoNotOptimize(consumed);
+    benchmark::DoNotOptimize(visitor.total_shares);
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_messages_);
+  state.SetBytesProcessed(state.iterations() * buffer_.size());
+}
+
+BENCHMARK_REGISTER_F(ITCHParseFixture, ParseBufferBatched)
+    ->Unit(benchmark::kNanosecond)
+    ->MinTime(1.0);
+
+/**
+ * @brief Same buffer fed to StreamParser in fixed-size chunks (range(0)
+ *        bytes); chunk sizes are not multiples of 36, so most chunks end
+ *        mid-message and one message per boundary goes through the carry.
+ */
+BENCHMARK_DEFINE_F(ITCHParseFixture, StreamParseChunked)
+(benchmark::State &state) {
+  struct SharesVisitor : itch::DefaultVisitor {
+    uint64_t total_shares = 0;
+    void on_add_order(const itch::AddOrder &msg) {
+      total_shares += static_cast<uint32_t>(msg.shares);
+    }
+  };
+
+  const size_t chunk = static_cast<size_t>(state.range(0));
+
+  for (auto _ : state) {
+    itch::StreamParser<> stream;
+    SharesVisitor visitor;
+    for (size_t off = 0; off < buffer_.size(); off += chunk) {
+      const size_t n = std::min(chunk, buffer_.size() - off);
+      size_t accepted = stream.feed(buffer_.data() + off, n, visitor);
+      benchmark::DoNotOptimize(accepted);
+    }
+    benchmark::DoNotOptimize(visitor.total_shares);
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_messages_);
+  state.SetBytesProcessed(state.iterations() * buffer_.size());
+}
+
+BENCHMARK_REGISTER_F(ITCHParseFixture, StreamParseChunked)
+    ->Arg(1400)
+    ->Arg(4096)
+    ->Arg(65536)
+    ->Unit(benchmark::kNanosecond)
+    ->MinTime(1.0);
+
+// ============================================================================
+// Benchmark 2b: Bulk SoA Decode (every field, host order)
+// ============================================================================
+
+/**
+ * @brief Column buffers sized for the fixture's message count.
+ */
+struct AddOrderColumnStore {
+  explicit AddOrderColumnStore(size_t n)
+      : refs(n), timestamps(n), locates(n), shares(n), prices(n), sides(n) {}
+
+  [[nodiscard]] itch::AddOrderColumns columns() noexcept {
+    return {refs.data(),   timestamps.data(), locates.data(),
+            shares.data(), prices.data(),     sides.data()};
+  }
+
+  std::vector<uint64_t> refs;
+  std::vector<uint64_t> timestamps;
+  std::vector<uint16_t> locates;
+  std::vector<uint32_t> shares;
+  std::vector<uint32_t> prices;
+  std::vector<char> sides;
+};
+
+/**
+ * @brief Decode all six AddOrder fields with the scalar reference kernel.
+ */
+BENCHMARK_DEFINE_F(ITCHParseFixture, BulkDecodeScalar)
+(benchmark::State &state) {
+  std::span<const itch::AddOrder> msgs(
+      reinterpret_cast<const itch::AddOrder *>(buffer_.data()), num_messages_);
+  AddOrderColumnStore store(num_messages_);
+  const itch::AddOrderColumns cols = store.columns();
+
+  for (auto _ : state) {
+    itch::decode_add_orders_scalar(msgs, cols);
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_messages_);
+  state.SetBytesProcessed(state.iterations() * buffer_.size());
+}
+
+BENCHMARK_REGISTER_F(ITCHParseFixture, BulkDecodeScalar)
+    ->Unit(benchmark::kNanosecond)
+    ->MinTime(1.0);
+
+/**
+ * @brief Same decode through the dispatching (AVX2 when built) kernel.
+ */
+BENCHMARK_DEFINE_F(ITCHParseFixture, BulkDecodeSoa)(benchmark::State &state) {
+  std::span<const itch::AddOrder> msgs(
+      reinterpret_cast<const itch::AddOrder *>(buffer_.data()), num_messages_);
+  AddOrderColumnStore store(num_messages_);
+  const itch::AddOrderColumns cols = store.columns();
+
+  for (auto _ : state) {
+    itch::decode_add_orders(msgs, cols);
+    benchmark::ClobberMemory();
+  }
+
+  state.SetLabel(itch::kSoaDecoderHasAvx2 ? "avx2" : "scalar");
+  state.SetItemsProcessed(state.iterations() * num_messages_);
+  state.SetBytesProcessed(state.iterations() * buffer_.size());
+}
+
+BENCHMARK_REGISTER_F(ITCHParseFixture, BulkDecodeSoa)
+    ->Unit(benchmark::kNanosecond)
+    ->MinTime(1.0);
+
+// ============================================================================
+// Benchmark 2c: Feeds Dominated by Types the Visitor Ignores
+// ============================================================================
+
+/**
+ * @brief 10k messages: 90% OrderDelete, 5% OrderCancel, 5% AddOrder.
+ */
+std::vector<char> make_mostly_ignored_buffer() {
+  std::vector<char> buffer;
+  for (size_t i = 0; i < 10000; ++i) {
+    const size_t slot = i % 20;
+    const char type = slot == 0 ? 'A' : (slot == 1 ? 'X' : 'D');
+    if (type == 'A') {
+      buffer.insert(buffer.end(), g_add_order_msg.begin(),
+                    g_add_order_msg.end());
+      continue;
+    }
+    const size_t size = itch::message_size(type);
+    buffer.insert(buffer.end(), size, 0);
+    buffer[buffer.size() - size] = type;
+  }
+  return buffer;
+}
+
+struct AddOnlyVisitor : itch::DefaultVisitor {
+  uint64_t total_shares = 0;
+  void on_add_order(const itch::AddOrder &msg) {
+    total_shares += static_cast<uint32_t>(msg.shares);
+  }
+};
+
+/**
+ * @brief Same visitor, but also declares (empty) delete and cancel hooks,
+ *        so those messages still go through the dispatch table.
+ */
+struct AddPlusEmptyHooksVisitor : AddOnlyVisitor {
+  void on_order_delete(const itch::OrderDelete & /*msg*/) {}
+  void on_order_cancel(const itch::OrderCancel & /*msg*/) {}
+};
+
+template <typename Visitor>
+static void BM_ParseBufferMostlyIgnored(benchmark::State &state) {
+  const std::vector<char> buffer = make_mostly_ignored_buffer();
+  itch::Parser parser;
+
+  for (auto _ : state) {
+    Visitor visitor;
+    size_t consumed =
+        parser.parse_buffer(buffer.data(), buffer.size(), visitor);
+    benchmark::DoNotOptimize(consumed);
+    benchmark::DoNotOptimize(visitor.total_shares);
+  }
+
+  state.SetItemsProcessed(state.iterations() * 10000);
+  state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+BENCHMARK_TEMPLATE(BM_ParseBufferMostlyIgnored, AddOnlyVisitor)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_ParseBufferMostlyIgnored, AddPlusEmptyHooksVisitor)
+    ->Unit(benchmark::kMicrosecond);
+
+// ============================================================================
+// Benchmark 2d: Parse Loop Engines on a Mixed-Type Feed
+// ============================================================================
+
+/**
+ * @brief 10k messages in a pseudo-random order with a TotalView-like mix:
+ *        A 35%, D 30%, E 10%, X 8%, U 7%, F 3%, P 3%, C 2%, S/R/I 2%.
+ */
+std::vector<char> make_mixed_buffer() {
+  constexpr char kMix[] = {'A', 'A', 'A', 'A', 'A', 'A', 'A', 'D', 'D', 'D',
+                           'D', 'D', 'D', 'E', 'E', 'X', 'U', 'F', 'P', 'C'};
+  constexpr char kRare[] = {'S', 'R', 'I'};
+  std::vector<char> buffer;
+  uint32_t state = 12345;
+  for (size_t i = 0; i < 10000; ++i) {
+    state = state * 1664525u + 1013904223u;
+    char type = kMix[(state >> 16) % sizeof(kMix)];
+    if ((state >> 8) % 50 == 0) {
+      type = kRare[(state >> 24) % sizeof(kRare)];
+    }
+    const size_t size = itch::message_size(type);
+    buffer.insert(buffer.end(), size, 0);
+    buffer[buffer.size() - size] = type;
+  }
+  return buffer;
+}
+
+/**
+ * @brief Order-flow handler: every book-changing type, nothing else.
+ */
+struct OrderFlowVisitor : itch::DefaultVisitor {
+  uint64_t events = 0;
+  void on_add_order(const itch::AddOrder & /*msg*/) { ++events; }
+  void on_add_order_mpid(const itch::AddOrderMPID & /*msg*/) { ++events; }
+  void on_order_executed(const itch::OrderExecuted & /*msg*/) { ++events; }
+  void on_order_executed_with_price(
+      const itch::OrderExecutedWithPrice & /*msg*/) {
+    ++events;
+  }
+  void on_order_cancel(const itch::OrderCancel & /*msg*/) { ++events; }
+  void on_order_delete(const itch::OrderDelete & /*msg*/) { ++events; }
+  void on_order_replace(const itch::OrderReplace & /*msg*/) { ++events; }
+};
+
+template <itch::ParseLoop Loop>
+static void BM_ParseLoopMixed(benchmark::State &state) {
+  const std::vector<char> buffer = make_mixed_buffer();
+  itch::Parser parser;
+
+  for (auto _ : state) {
+    OrderFlowVisitor visitor;
+    size_t consumed =
+        parser.parse_buffer<Loop>(buffer.data(), buffer.size(), visitor);
+    benchmark::DoNotOptimize(consumed);
+    benchmark::DoNotOptimize(visitor.events);
+  }
+
+  state.SetItemsProcessed(state.iterations() * 10000);
+  state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+BENCHMARK_TEMPLATE(BM_ParseLoopMixed, itch::ParseLoop::Table)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_ParseLoopMixed, itch::ParseLoop::Threaded)
+    ->Unit(benchmark::kMicrosecond);
+
+template <itch::ParseLoop Loop>
+static void BM_ParseLoopAddOnly(benchmark::State &state) {
+  std::vector<char> buffer;
+  for (size_t i = 0; i < 10000; ++i) {
+    buffer.insert(buffer.end(), g_add_order_msg.begin(),
+                  g_add_order_msg.end());
+  }
+  itch::Parser parser;
+
+  for (auto _ : state) {
+    OrderFlowVisitor visitor;
+    size_t consumed =
+        parser.parse_buffer<Loop>(buffer.data(), buffer.size(), visitor);
+    benchmark::DoNotOptimize(consumed);
+    benchmark::DoNotOptimize(visitor.events);
+  }
+
+  state.SetItemsProcessed(state.iterations() * 10000);
+}
+BENCHMARK_TEMPLATE(BM_ParseLoopAddOnly, itch::ParseLoop::Table)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_ParseLoopAddOnly, itch::ParseLoop::Threaded)
+    ->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief The mixed feed with AddOnlyVisitor: the other 65% of messages are
+ *        left to DefaultVisitor and stepped over by size.
+ */
+template <itch::ParseLoop Loop>
+static void BM_ParseLoopSkipMixed(benchmark::State &state) {
+  const std::vector<char> buffer = make_mixed_buffer();
+  itch::Parser parser;
+
+  for (auto _ : state) {
+    AddOnlyVisitor visitor;
+    size_t consumed =
+        parser.parse_buffer<Loop>(buffer.data(), buffer.size(), visitor);
+    benchmark::DoNotOptimize(consumed);
+    benchmark::DoNotOptimize(visitor.total_shares);
+  }
+
+  state.SetItemsProcessed(state.iterations() * 10000);
+}
+BENCHMARK_TEMPLATE(BM_ParseLoopSkipMixed, itch::ParseLoop::Table)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_ParseLoopSkipMixed, itch::ParseLoop::Threaded)
+    ->Unit(benchmark::kMicrosecond);
+
 // ============================================================================
 // Benchmark 3: Single Message Parse (Latency Focus)
 // ============================================================================
@@ -351,4 +722,900 @@ static void BM_RawPointerAccess(benchmark::State &state) {
 }
 BENCHMARK(BM_RawPointerAccess)->Unit(benchmark::kNanosecond);
 
+// ============================================================================
+// Benchmark 5: Locating the UDP Payload
+// ============================================================================
+
+/**
+ * @brief Ethernet + 802.1Q + IPv4 + UDP frame carrying a MoldUDP64 packet
+ *        (headers copied from data/Multiple.Packets.pcap).
+ */
+std::vector<char> make_vlan_udp_frame() {
+  const unsigned char headers[] = {
+      0x01, 0x00, 0x5e, 0x36, 0x0c, 0x6f, 0xd4, 0xaf, 0xf7, 0xcb, 0x20, 0xd5,
+      0x81, 0x00, 0x00, 0x8d, 0x08, 0x00, 0x45, 0x00, 0x00, 0x56, 0xbb, 0xaa,
+      0x40, 0x00, 0x15, 0x11, 0x65, 0xf4, 0xce, 0xc8, 0x7f, 0x8a, 0xe9, 0x36,
+      0x0c, 0x6f, 0xc1, 0xf5, 0x67, 0x6d, 0x00, 0x42, 0xba, 0x78};
+  std::vector<char> frame(sizeof(headers) + 58, '0'); // 66-byte payload
+  std::memcpy(frame.data(), headers, sizeof(headers));
+  return frame;
+}
+
+/**
+ * @brief The per-packet offset guess the drivers used before UdpDecoder.
+ */
+size_t guess_itch_offset(const char *data, size_t len) {
+  constexpr size_t OFFSETS[] = {42, 46, 62, 64, 66, 68};
+  for (size_t offset : OFFSETS) {
+    if (offset < len && itch::is_valid_message_type(data[offset])) {
+      return offset;
+    }
+  }
+  const size_t search_end = len < 100 ? len : 100;
+  for (size_t offset = 0; offset < search_end; ++offset) {
+    if (itch::is_valid_message_type(data[offset]) && len >= offset + 3) {
+      const uint16_t locate = static_cast<uint16_t>(
+          (static_cast<uint8_t>(data[offset + 1]) << 8) |
+          static_cast<uint8_t>(data[offset + 2]));
+      if (locate > 0 && locate < 10000) {
+        return offset;
+      }
+    }
+  }
+  return 42;
+}
+
+static void BM_PayloadOffsetHeuristic(benchmark::State &state) {
+  const std::vector<char> frame = make_vlan_udp_frame();
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(frame.data());
+    size_t offset = guess_itch_offset(frame.data(), frame.size());
+    benchmark::DoNotOptimize(offset);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PayloadOffsetHeuristic)->Unit(benchmark::kNanosecond);
+
+static void BM_UdpDecode(benchmark::State &state) {
+  const std::vector<char> frame = make_vlan_udp_frame();
+  itch::UdpDecoder net;
+  itch::UdpDatagram udp;
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(frame.data());
+    bool ok = net.decode(frame.data(), frame.size(), udp);
+    benchmark::DoNotOptimize(ok);
+    benchmark::DoNotOptimize(udp);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_UdpDecode)->Unit(benchmark::kNanosecond);
+
+// ============================================================================
+// Benchmark 6: Capture File Iteration - Classic PCAP vs pcapng
+// ============================================================================
+
+template <typename T> void append_le(std::vector<char> &out, T value) {
+  const size_t at = out.size();
+  out.resize(at + sizeof(T));
+  std::memcpy(out.data() + at, &value, sizeof(T));
+}
+
+/**
+ * @brief Write 100k copies of the VLAN/UDP frame in the given format.
+ * @return Path of the temporary file (caller removes it).
+ */
+std::string write_capture(itch::CaptureFormat format) {
+  const std::vector<char> frame = make_vlan_udp_frame();
+  const auto frame_len = static_cast<uint32_t>(frame.size());
+  std::vector<char> out;
+
+  if (format == itch::CaptureFormat::Pcap) {
+    itch::PcapGlobalHeader header{0xa1b2c3d4, 2, 4, 0, 0, 65535, 1};
+    append_le(out, header);
+  } else {
+    append_le<uint32_t>(out, itch::kPcapNgSectionHeader);
+    append_le<uint32_t>(out, 28);
+    append_le<uint32_t>(out, itch::kPcapNgByteOrderMagic);
+    append_le<uint32_t>(out, 1); // Version 1.0
+    append_le<int64_t>(out, -1);
+    append_le<uint32_t>(out, 28);
+    append_le<uint32_t>(out, itch::kPcapNgInterfaceDescription);
+    append_le<uint32_t>(out, 20);
+    append_le<uint32_t>(out, 1); // Ethernet, reserved
+    append_le<uint32_t>(out, 65535);
+    append_le<uint32_t>(out, 20);
+  }
+
+  const uint32_t padded = (frame_len + 3) & ~3u;
+  for (uint32_t i = 0; i < 100000; ++i) {
+    if (format == itch::CaptureFormat::Pcap) {
+      append_le(out, itch::PcapPacketHeader{i, 0, frame_len, frame_len});
+      out.insert(out.end(), frame.begin(), frame.end());
+    } else {
+      const uint32_t total = 32 + padded;
+      append_le(out, itch::PcapNgBlockHeader{itch::kPcapNgEnhancedPacket,
+                                             total});
+      append_le(out, itch::PcapNgEnhancedPacketHeader{0, 0, i, frame_len,
+                                                      frame_len});
+      out.insert(out.end(), frame.begin(), frame.end());
+      out.insert(out.end(), padded - frame_len, 0);
+      append_le(out, total);
+    }
+  }
+
+  char path[] = "/tmp/chronos_bench_capture_XXXXXX";
+  const int fd = mkstemp(path);
+  if (fd >= 0) {
+    FILE *f = fdopen(fd, "wb");
+    std::fwrite(out.data(), 1, out.size(), f);
+    std::fclose(f);
+  }
+  return path;
+}
+
+template <itch::CaptureFormat Format>
+static void BM_CaptureIterate(benchmark::State &state) {
+  const std::string path = write_capture(Format);
+  itch::PcapReader reader(path.c_str());
+
+  for (auto _ : state) {
+    size_t bytes = 0;
+    size_t packets = reader.for_each_packet(
+        [&](const char *data, size_t len) {
+          benchmark::DoNotOptimize(data);
+          bytes += len;
+        });
+    benchmark::DoNotOptimize(packets);
+    benchmark::DoNotOptimize(bytes);
+  }
+
+  state.SetItemsProcessed(state.iterations() * 100000);
+  state.SetBytesProcessed(state.iterations() * reader.file_size());
+  std::remove(path.c_str());
+}
+BENCHMARK_TEMPLATE(BM_CaptureIterate, itch::CaptureFormat::Pcap)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_CaptureIterate, itch::CaptureFormat::PcapNg)
+    ->Unit(benchmark::kMicrosecond);
+
+// ============================================================================
+// Benchmark 7: Replay Clock Reads
+// ============================================================================
+
+static void BM_ClockSteadyNow(benchmark::State &state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::chrono::steady_clock::now());
+  }
+}
+BENCHMARK(BM_ClockSteadyNow)->Unit(benchmark::kNanosecond);
+
+static void BM_ClockTscTicks(benchmark::State &state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(itch::TscClock::ticks());
+  }
+}
+BENCHMARK(BM_ClockTscTicks)->Unit(benchmark::kNanosecond);
+
+// ============================================================================
+// Benchmark 8: Seek to a Late Packet - Header Walk vs Sidecar Index
+// ============================================================================
+
+/// Packet three quarters into the 100k-frame capture
+constexpr uint64_t kSeekTarget = 75000;
+
+static void BM_SeekHeaderWalk(benchmark::State &state) {
+  const std::string path = write_capture(itch::CaptureFormat::Pcap);
+  itch::PcapReader reader(path.c_str());
+
+  for (auto _ : state) {
+    itch::PacketCursor cursor = reader.first_packet();
+    itch::PacketRecord record;
+    while (cursor.packet < kSeekTarget && reader.next_packet(cursor, record)) {
+    }
+    benchmark::DoNotOptimize(cursor);
+  }
+  std::remove(path.c_str());
+}
+BENCHMARK(BM_SeekHeaderWalk)->Unit(benchmark::kMicrosecond);
+
+static void BM_SeekIndexed(benchmark::State &state) {
+  const std::string path = write_capture(itch::CaptureFormat::Pcap);
+  const std::string index_path = itch::PcapIndex::default_path(path.c_str());
+  itch::PcapReader reader(path.c_str());
+  itch::PcapIndex index;
+  if (!itch::PcapIndex::build(reader, index_path.c_str()) ||
+      !index.open(index_path.c_str(), reader)) {
+    state.SkipWithError("index build failed");
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(reader.seek_to_packet(index, kSeekTarget));
+  }
+  std::remove(index_path.c_str());
+  std::remove(path.c_str());
+}
+BENCHMARK(BM_SeekIndexed)->Unit(benchmark::kMicrosecond);
+
+// ============================================================================
+// Benchmark 9: Parallel Range Scan (UDP decode per packet)
+// ============================================================================
+
+static void BM_ParallelScan(benchmark::State &state) {
+  const std::string path = write_capture(itch::CaptureFormat::Pcap);
+  itch::PcapReader reader(path.c_str());
+  const auto threads = static_cast<size_t>(state.range(0));
+
+  struct UdpBytes {
+    itch::UdpDecoder net{itch::LinkType::Ethernet};
+    itch::UdpDatagram udp;
+    uint64_t bytes = 0;
+    void operator()(const char *data, size_t len) {
+      if (net.decode(data, len, udp)) {
+        bytes += udp.length;
+      }
+    }
+  };
+
+  for (auto _ : state) {
+    const uint64_t bytes = itch::parallel_for_each_packet(
+        reader, threads, uint64_t{0}, [](size_t) { return UdpBytes{}; },
+        [](uint64_t &total, const UdpBytes &range) { total += range.bytes; });
+    benchmark::DoNotOptimize(bytes);
+  }
+
+  state.SetItemsProcessed(state.iterations() * 100000);
+  std::remove(path.c_str());
+}
+BENCHMARK(BM_ParallelScan)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+// ============================================================================
+// Benchmark 10: Capture Scan - Mapped vs Streamed (io_uring, pread)
+// ============================================================================
+
+/// Streaming counterpart of BM_CaptureIterate; the capture is page-cache
+/// hot, so this measures framing and I/O overhead, not the disk
+template <itch::StreamBackend Backend>
+static void BM_StreamIterate(benchmark::State &state) {
+  const std::string path = write_capture(itch::CaptureFormat::Pcap);
+  itch::StreamOptions options;
+  options.backend = Backend;
+  options.buffer_bytes = size_t{1} << 20;
+  options.direct = false;
+  itch::PcapStreamReader reader(path.c_str(), options);
+  if (!reader.is_open()) {
+    state.SkipWithError("stream backend unavailable");
+  }
+
+  for (auto _ : state) {
+    size_t bytes = 0;
+    size_t packets = reader.for_each_packet(
+        [&](const char *data, size_t len) {
+          benchmark::DoNotOptimize(data);
+          bytes += len;
+        });
+    benchmark::DoNotOptimize(packets);
+    benchmark::DoNotOptimize(bytes);
+  }
+
+  state.SetItemsProcessed(state.iterations() * 100000);
+  state.SetBytesProcessed(state.iterations() * reader.file_size());
+  std::remove(path.c_str());
+}
+BENCHMARK_TEMPLATE(BM_StreamIterate, itch::StreamBackend::IoUring)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_StreamIterate, itch::StreamBackend::Pread)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+// ============================================================================
+// Benchmark 11: Loopback Receive - recvmmsg Batches vs recvfrom
+// ============================================================================
+
+/// Datagrams queued (untimed) before each timed drain
+constexpr int kRecvBurst = 64;
+
+/**
+ * @brief Queue a burst of MoldUDP64-sized datagrams on `port`.
+ */
+void send_burst(int fd, uint16_t port) {
+  sockaddr_in to{};
+  to.sin_family = AF_INET;
+  to.sin_port = htons(port);
+  to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  char datagram[256] = {};
+  for (int i = 0; i < kRecvBurst; ++i) {
+    (void)::sendto(fd, datagram, sizeof(datagram), 0,
+                   reinterpret_cast<const sockaddr *>(&to), sizeof(to));
+  }
+}
+
+static void BM_RecvFrom(benchmark::State &state) {
+  const int rx = ::socket(AF_INET, SOCK_DGRAM, 0);
+  const int tx = ::socket(AF_INET, SOCK_DGRAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t len = sizeof(addr);
+  if (::bind(rx, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) !=
+          0 ||
+      getsockname(rx, reinterpret_cast<sockaddr *>(&addr), &len) != 0) {
+    state.SkipWithError("loopback socket unavailable");
+  }
+
+  char buffer[2048];
+  uint64_t syscalls = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    send_burst(tx, ntohs(addr.sin_port));
+    state.ResumeTiming();
+    for (int i = 0; i < kRecvBurst; ++i) {
+      benchmark::DoNotOptimize(
+          ::recvfrom(rx, buffer, sizeof(buffer), 0, nullptr, nullptr));
+      ++syscalls;
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * kRecvBurst);
+  state.counters["syscalls_per_pkt"] = static_cast<double>(syscalls) /
+                                       (state.iterations() * kRecvBurst);
+  ::close(tx);
+  ::close(rx);
+}
+BENCHMARK(BM_RecvFrom)->Unit(benchmark::kMicrosecond);
+
+static void BM_RecvMmsg(benchmark::State &state) {
+  itch::ReceiverOptions options;
+  options.bind_address = "127.0.0.1";
+  options.batch = static_cast<size_t>(state.range(0));
+  options.timestamps = false;
+  itch::UdpReceiver rx;
+  const int tx = ::socket(AF_INET, SOCK_DGRAM, 0);
+  if (!rx.open(options)) {
+    state.SkipWithError("loopback socket unavailable");
+  }
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    send_burst(tx, rx.port());
+    state.ResumeTiming();
+    for (int got = 0; got < kRecvBurst;) {
+      got += static_cast<int>(rx.receive([](const char *data, size_t) {
+        benchmark::DoNotOptimize(data);
+      }));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * kRecvBurst);
+  state.counters["syscalls_per_pkt"] =
+      1.0 / rx.stats().packets_per_syscall();
+  ::close(tx);
+}
+BENCHMARK(BM_RecvMmsg)->Arg(8)->Arg(64)->Unit(benchmark::kMicrosecond);
+
+// ============================================================================
+// Benchmark 12: Capture Rewrite - writev Batches vs write() per Record
+// ============================================================================
+
+/// Baseline: what a filter does without batching - two write()s a packet
+static void BM_RewritePerPacket(benchmark::State &state) {
+  const std::string path = write_capture(itch::CaptureFormat::Pcap);
+  const std::string out_path = path + ".out";
+  itch::PcapReader reader(path.c_str());
+
+  for (auto _ : state) {
+    const int fd = ::open(out_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+                          0644);
+    (void)reader.for_each_packet(
+        [&](const char *data, size_t len, uint64_t ts_ns) {
+          const itch::PcapPacketHeader header{
+              static_cast<uint32_t>(ts_ns / 1'000'000'000),
+              static_cast<uint32_t>(ts_ns % 1'000'000'000),
+              static_cast<uint32_t>(len), static_cast<uint32_t>(len)};
+          benchmark::DoNotOptimize(::write(fd, &header, sizeof(header)));
+          benchmark::DoNotOptimize(::write(fd, data, len));
+        });
+    ::close(fd);
+  }
+
+  state.SetItemsProcessed(state.iterations() * 100000);
+  state.SetBytesProcessed(state.iterations() * reader.file_size());
+  std::remove(out_path.c_str());
+  std::remove(path.c_str());
+}
+BENCHMARK(BM_RewritePerPacket)->Unit(benchmark::kMillisecond);
+
+static void BM_RewriteGathered(benchmark::State &state) {
+  const std::string path = write_capture(itch::CaptureFormat::Pcap);
+  const std::string out_path = path + ".out";
+  itch::PcapReader reader(path.c_str());
+
+  uint64_t calls = 0;
+  for (auto _ : state) {
+    itch::PcapWriter out;
+    (void)out.open(out_path.c_str(), reader.link_type());
+    (void)reader.for_each_packet(
+        [&](const char *data, size_t len, uint64_t ts_ns) {
+          out.write_packet(ts_ns, data, len);
+        });
+    (void)out.close();
+    calls += out.writer().writev_calls();
+  }
+
+  state.SetItemsProcessed(state.iterations() * 100000);
+  state.SetBytesProcessed(state.iterations() * reader.file_size());
+  state.counters["syscalls_per_pkt"] =
+      static_cast<double>(calls) / (state.iterations() * 100000);
+  std::remove(out_path.c_str());
+  std::remove(path.c_str());
+}
+BENCHMARK(BM_RewriteGathered)->Unit(benchmark::kMillisecond);
+
+// ============================================================================
+// Benchmark 13: A/B Line Arbitration vs One Line
+// ============================================================================
+
+/// Packets per line; each carries three 19-byte message blocks
+constexpr uint64_t kLinePackets = 100000;
+
+/**
+ * @brief Write one line of a MoldUDP64 feed (raw IPv4), dropping every
+ *        `drop_every`th packet (0: none).
+ */
+std::string write_line(const char *suffix, uint64_t drop_every) {
+  std::string path = "/tmp/chronos_bench_line_";
+  path += suffix;
+  std::vector<char> frame(28 + 20 + 3 * 21, '\0');
+  const auto udp_len = static_cast<uint16_t>(frame.size() - 20);
+  frame[0] = 0x45;
+  frame[2] = static_cast<char>(frame.size() >> 8);
+  frame[3] = static_cast<char>(frame.size());
+  frame[9] = 17;
+  frame[24] = static_cast<char>(udp_len >> 8);
+  frame[25] = static_cast<char>(udp_len);
+  std::memcpy(frame.data() + 28, "SESSIONA  ", 10);
+  frame[28 + 19] = 3;
+  for (size_t b = 0; b < 3; ++b) {
+    char *block = frame.data() + 48 + b * 21;
+    block[1] = 19;
+    block[2] = 'D';
+  }
+
+  // Frames must outlive the writer's queue: keep them all
+  std::vector<std::vector<char>> frames;
+  frames.reserve(kLinePackets);
+  itch::PcapWriter out;
+  (void)out.open(path.c_str(), itch::LinkType::Raw);
+  for (uint64_t i = 0; i < kLinePackets; ++i) {
+    if (drop_every != 0 && i % drop_every == drop_every - 1) {
+      continue;
+    }
+    frames.push_back(frame);
+    const uint64_t sequence = 1 + i * 3;
+    for (int b = 0; b < 8; ++b) {
+      frames.back()[28 + 10 + b] = static_cast<char>(sequence >> (56 - b * 8));
+    }
+    out.write_packet(i * 1000, frames.back().data(), frames.back().size());
+  }
+  (void)out.close();
+  return path;
+}
+
+struct CountBlocks {
+  uint64_t blocks = 0;
+  void on_message(const char *, size_t) noexcept { ++blocks; }
+};
+
+static void BM_MoldOneLine(benchmark::State &state) {
+  const std::string path = write_line("a", 0);
+  itch::PcapReader reader(path.c_str());
+
+  for (auto _ : state) {
+    itch::MoldUdp64Decoder<> mold;
+    itch::UdpDecoder net(reader.link_type());
+    itch::UdpDatagram udp;
+    CountBlocks count;
+    (void)reader.for_each_packet([&](const char *data, size_t len) {
+      // As chronos_replay walks one line
+      if (net.decode(data, len, udp) &&
+          itch::is_moldudp64_packet(udp.payload, udp.length)) {
+        (void)mold.decode(udp.payload, udp.length, count);
+      }
+    });
+    benchmark::DoNotOptimize(count.blocks);
+  }
+
+  state.SetItemsProcessed(state.iterations() * kLinePackets * 3);
+  std::remove(path.c_str());
+}
+BENCHMARK(BM_MoldOneLine)->Unit(benchmark::kMillisecond);
+
+/// Two lines, each dropping 1 packet in 50, merged into one
+static void BM_ArbitrateLines(benchmark::State &state) {
+  const std::string path_a = write_line("a", 50);
+  const std::string path_b = write_line("b", 47);
+  itch::PcapReader a(path_a.c_str());
+  itch::PcapReader b(path_b.c_str());
+
+  uint64_t delivered = 0;
+  for (auto _ : state) {
+    itch::LineArbitrator<> arb(a, b);
+    CountBlocks count;
+    (void)arb.run(count);
+    delivered = count.blocks;
+  }
+
+  state.SetItemsProcessed(state.iterations() * kLinePackets * 3);
+  state.counters["delivered"] = static_cast<double>(delivered);
+  std::remove(path_a.c_str());
+  std::remove(path_b.c_str());
+}
+BENCHMARK(BM_ArbitrateLines)->Unit(benchmark::kMillisecond);
+
+// ============================================================================
+// Benchmark 14: OrderBook Add/Cancel Latency - Flat Index vs unordered_map
+// ============================================================================
+
+/**
+ * @brief The index OrderBook used to have: one heap node per order.
+ */
+class UnorderedOrderIndex {
+public:
+  [[nodiscard]] book::Order *find(uint64_t key) const noexcept {
+    const auto it = map_.find(key);
+    return it == map_.end() ? nullptr : it->second;
+  }
+  bool insert(uint64_t key, book::Order *value) noexcept {
+    return map_.emplace(key, value).second;
+  }
+  book::Order *erase(uint64_t key) noexcept {
+    const auto it = map_.find(key);
+    if (it == map_.end()) {
+      return nullptr;
+    }
+    book::Order *value = it->second;
+    map_.erase(it);
+    return value;
+  }
+  [[nodiscard]] size_t size() const noexcept { return map_.size(); }
+
+private:
+  std::unordered_map<uint64_t, book::Order *> map_;
+};
+
+/// Resting orders held through the run, and operations timed per pass
+constexpr size_t kBookResting = 100000;
+constexpr size_t kBookOps = 200000;
+constexpr size_t kBookCapacity = 1 << 18;
+
+/**
+ * @brief p-th percentile (0-1) of `samples`, sorting them in place.
+ */
+double percentile_ns(std::vector<uint64_t> &samples, double p,
+                     const itch::TscClock &clock) {
+  const auto rank =
+      static_cast<size_t>(p * static_cast<double>(samples.size()));
+  std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+  return static_cast<double>(clock.to_nanos(samples[rank]));
+}
+
+/**
+ * @brief A day-like churn: sequential order refs, a 100k-order resting
+ *        book over 20 levels a side, and each add followed by a cancel of
+ *        a random resting order. Each add and cancel is timed on its own.
+ */
+template <typename Index> void BM_BookChurn(benchmark::State &state) {
+  const itch::TscClock clock = itch::TscClock::calibrate();
+  std::vector<uint64_t> add_ticks;
+  std::vector<uint64_t> cancel_ticks;
+  add_ticks.reserve(kBookOps);
+  cancel_ticks.reserve(kBookOps);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    book::MemPool<book::Order, kBookCapacity> pool;
+    book::OrderBook<kBookCapacity, Index> ob(pool);
+    std::mt19937_64 rng(7);
+    std::vector<uint64_t> live;
+    live.reserve(kBookResting + 1);
+    uint64_t next_ref = 1;
+    auto add = [&] {
+      const bool buy = (rng() & 1) != 0;
+      const uint64_t price = buy ? 10000 - rng() % 20 : 10100 + rng() % 20;
+      const uint64_t ref = next_ref++;
+      live.push_back(ref);
+      return ob.add_order(ref, price, 100,
+                          buy ? book::Side::Buy : book::Side::Sell);
+    };
+    for (size_t i = 0; i < kBookResting; ++i) {
+      (void)add();
+    }
+    add_ticks.clear();
+    cancel_ticks.clear();
+    state.ResumeTiming();
+
+    for (size_t i = 0; i < kBookOps; ++i) {
+      uint64_t t0 = itch::TscClock::ticks();
+      benchmark::DoNotOptimize(add());
+      uint64_t t1 = itch::TscClock::ticks();
+      add_ticks.push_back(t1 - t0);
+
+      const size_t pick = rng() % live.size();
+      const uint64_t ref = live[pick];
+      live[pick] = live.back();
+      live.pop_back();
+      t0 = itch::TscClock::ticks();
+      benchmark::DoNotOptimize(ob.cancel_order(ref));
+      t1 = itch::TscClock::ticks();
+      cancel_ticks.push_back(t1 - t0);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * kBookOps * 2);
+  // Percentiles of the last pass
+  state.counters["add_p50_ns"] = percentile_ns(add_ticks, 0.50, clock);
+  state.counters["add_p99_ns"] = percentile_ns(add_ticks, 0.99, clock);
+  state.counters["add_p999_ns"] = percentile_ns(add_ticks, 0.999, clock);
+  state.counters["cancel_p50_ns"] = percentile_ns(cancel_ticks, 0.50, clock);
+  state.counters["cancel_p99_ns"] = percentile_ns(cancel_ticks, 0.99, clock);
+  state.counters["cancel_p999_ns"] =
+      percentile_ns(cancel_ticks, 0.999, clock);
+}
+BENCHMARK_TEMPLATE(BM_BookChurn, UnorderedOrderIndex)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_BookChurn,
+                   book::OrderMap<book::Order, kBookCapacity>)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_BookChurn,
+                   book::OrderTable<book::Order, kBookCapacity>)
+    ->Unit(benchmark::kMillisecond);
+
+/// Orders resting from the open, under refs that later wrap the index
+constexpr uint64_t kWrapResting = 20000;
+
+/**
+ * @brief Refs that wrap the index onto a dense block: orders 1-20000 rest
+ *        from the open while quotes much later in the day are added and
+ *        cancelled at once. A hash that keeps consecutive refs in
+ *        consecutive slots homes some of them inside the resting block.
+ */
+template <typename Index> void BM_IndexWrap(benchmark::State &state) {
+  std::vector<book::Order> orders(1024);
+  auto index = std::make_unique<Index>();
+  for (uint64_t ref = 1; ref <= kWrapResting; ++ref) {
+    (void)index->insert(ref, &orders[ref & 1023]);
+  }
+  uint64_t ref = 100'000'000;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(index->insert(ref, &orders[0]));
+    benchmark::DoNotOptimize(index->erase(ref));
+    ++ref;
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK_TEMPLATE(BM_IndexWrap, UnorderedOrderIndex);
+BENCHMARK_TEMPLATE(BM_IndexWrap, book::OrderMap<book::Order, kBookCapacity>);
+BENCHMARK_TEMPLATE(BM_IndexWrap,
+                   book::OrderTable<book::Order, kBookCapacity>);
+
+// ============================================================================
+// Benchmark 15: Order Index on a Full-Day Reference Stream
+// ============================================================================
+
+/**
+ * @brief One index operation of the day stream.
+ */
+struct IndexOp {
+  enum Kind : uint8_t { Add, Execute, Cancel };
+  uint64_t ref;
+  Kind kind;
+};
+
+/// Orders added over the synthetic day
+constexpr size_t kDayOrders = 4'000'000;
+
+/**
+ * @brief A day of order refs as an index sees it: sequential adds from a
+ *        late-morning ref, 90% of orders gone within ~50 events, 9% within
+ *        ~20k, and 1% resting until the close. Three in ten removals are
+ *        preceded by an execution (a lookup).
+ */
+const std::vector<IndexOp> &day_stream() {
+  static const std::vector<IndexOp> ops = [] {
+    std::vector<IndexOp> out;
+    out.reserve(kDayOrders * 3);
+    std::mt19937_64 rng(11);
+    std::exponential_distribution<double> quick(1.0 / 50);
+    std::exponential_distribution<double> slow(1.0 / 20000);
+    using Death = std::pair<uint64_t, uint64_t>; // (event, ref)
+    std::priority_queue<Death, std::vector<Death>, std::greater<>> deaths;
+    const uint64_t first_ref = 412'000'000;
+    for (uint64_t i = 0; i < kDayOrders; ++i) {
+      while (!deaths.empty() && deaths.top().first <= i) {
+        const uint64_t ref = deaths.top().second;
+        deaths.pop();
+        if (rng() % 10 < 3) {
+          out.push_back({ref, IndexOp::Execute});
+        }
+        out.push_back({ref, IndexOp::Cancel});
+      }
+      const uint64_t ref = first_ref + i;
+      out.push_back({ref, IndexOp::Add});
+      const uint64_t roll = rng() % 100;
+      if (roll < 90) {
+        deaths.emplace(i + 1 + static_cast<uint64_t>(quick(rng)), ref);
+      } else if (roll < 99) {
+        deaths.emplace(i + 1 + static_cast<uint64_t>(slow(rng)), ref);
+      }
+    }
+    return out;
+  }();
+  return ops;
+}
+
+template <typename Index> void BM_IndexDay(benchmark::State &state) {
+  const std::vector<IndexOp> &ops = day_stream();
+  std::vector<book::Order> orders(1024);
+  uint64_t found = 0;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto index = std::make_unique<Index>();
+    state.ResumeTiming();
+    for (const IndexOp &op : ops) {
+      book::Order *order = &orders[op.ref & 1023];
+      switch (op.kind) {
+      case IndexOp::Add:
+        (void)index->insert(op.ref, order);
+        break;
+      case IndexOp::Execute:
+        found += index->find(op.ref) != nullptr ? 1 : 0;
+        break;
+      case IndexOp::Cancel:
+        (void)index->erase(op.ref);
+        break;
+      }
+    }
+    benchmark::DoNotOptimize(found);
+    state.counters["resting_at_close"] = static_cast<double>(index->size());
+  }
+
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(ops.size()));
+}
+BENCHMARK_TEMPLATE(BM_IndexDay, UnorderedOrderIndex)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_IndexDay, book::OrderMap<book::Order, kBookCapacity>)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_IndexDay, book::OrderTable<book::Order, kBookCapacity>)
+    ->Unit(benchmark::kMillisecond);
+
+// ============================================================================
+// Benchmark 16: Cancel Deep in the Book
+// ============================================================================
+
+/// Orders resting per price level in the deep-book benchmark
+constexpr size_t kDeepPerLevel = 8;
+constexpr size_t kDeepCapacity = 1 << 16;
+
+/**
+ * @brief Cancel a random resting order of a book `state.range(0)` levels
+ *        deep on each side, then re-add it at the same price, so the shape
+ *        of the book holds steady. Cancel latency only.
+ */
+static void BM_CancelDeepBook(benchmark::State &state) {
+  const auto depth = static_cast<uint64_t>(state.range(0));
+  const itch::TscClock clock = itch::TscClock::calibrate();
+  book::MemPool<book::Order, kDeepCapacity> pool;
+  book::OrderBook<kDeepCapacity> ob(pool);
+
+  struct Resting {
+    uint64_t ref;
+    uint64_t price;
+    book::Side side;
+  };
+  std::vector<Resting> resting;
+  uint64_t next_ref = 1;
+  for (uint64_t level = 0; level < depth; ++level) {
+    for (size_t i = 0; i < kDeepPerLevel; ++i) {
+      resting.push_back({next_ref++, 10000 - level, book::Side::Buy});
+      resting.push_back({next_ref++, 10001 + level, book::Side::Sell});
+    }
+  }
+  for (const Resting &r : resting) {
+    (void)ob.add_order(r.ref, r.price, 100, r.side);
+  }
+
+  std::mt19937_64 rng(3);
+  std::vector<uint64_t> cancel_ticks;
+  cancel_ticks.reserve(1 << 20);
+  for (auto _ : state) {
+    Resting &r = resting[rng() % resting.size()];
+    const uint64_t t0 = itch::TscClock::ticks();
+    benchmark::DoNotOptimize(ob.cancel_order(r.ref));
+    const uint64_t t1 = itch::TscClock::ticks();
+    if (cancel_ticks.size() < cancel_ticks.capacity()) {
+      cancel_ticks.push_back(t1 - t0);
+    }
+    r.ref = next_ref++;
+    (void)ob.add_order(r.ref, r.price, 100, r.side);
+  }
+
+  state.counters["cancel_p50_ns"] = percentile_ns(cancel_ticks, 0.50, clock);
+  state.counters["cancel_p99_ns"] = percentile_ns(cancel_ticks, 0.99, clock);
+  state.counters["levels"] =
+      static_cast<double>(ob.bid_level_count() + ob.ask_level_count());
+}
+BENCHMARK(BM_CancelDeepBook)->Arg(10)->Arg(100)->Arg(1000)
+    ->Unit(benchmark::kNanosecond);
+
+// ============================================================================
+// Benchmark 17: Quote Flicker and Sweeps at the Touch
+// ============================================================================
+
+/**
+ * @brief Build a book `depth` levels a side (one order each, refs from 1).
+ */
+template <typename Book> void fill_levels(Book &ob, uint64_t depth) {
+  for (uint64_t level = 0; level < depth; ++level) {
+    (void)ob.add_order(2 * level + 1, 10000 - level, 100, book::Side::Buy);
+    (void)ob.add_order(2 * level + 2, 10002 + level, 100, book::Side::Sell);
+  }
+}
+
+/**
+ * @brief A quote improves the bid by one tick, opening a new best level,
+ *        and is cancelled again: one level insert and one level release at
+ *        the touch per iteration.
+ */
+static void BM_TouchFlicker(benchmark::State &state) {
+  const auto depth = static_cast<uint64_t>(state.range(0));
+  book::MemPool<book::Order, kDeepCapacity> pool;
+  book::OrderBook<kDeepCapacity> ob(pool);
+  fill_levels(ob, depth);
+
+  uint64_t ref = 1'000'000;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ob.add_order(ref, 10001, 100, book::Side::Buy));
+    benchmark::DoNotOptimize(ob.cancel_order(ref));
+    ++ref;
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_TouchFlicker)->Arg(10)->Arg(100)->Arg(1000)
+    ->Unit(benchmark::kNanosecond);
+
+/**
+ * @brief A marketable sell sweeps the top 4 bid levels; they are then
+ *        rebuilt, so each iteration releases and re-inserts 4 levels at the
+ *        touch.
+ */
+static void BM_TouchSweep(benchmark::State &state) {
+  const auto depth = static_cast<uint64_t>(state.range(0));
+  book::MemPool<book::Order, kDeepCapacity> pool;
+  book::OrderBook<kDeepCapacity> ob(pool);
+  fill_levels(ob, depth);
+
+  uint64_t ref = 1'000'000;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        ob.add_order(ref++, 10000 - 3, 400, book::Side::Sell));
+    for (uint64_t level = 4; level-- > 0;) {
+      (void)ob.add_order(ref++, 10000 - level, 100, book::Side::Buy);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * 5);
+}
+BENCHMARK(BM_TouchSweep)->Arg(10)->Arg(100)->Arg(1000)
+    ->Unit(benchmark::kNanosecond);
+
 } // anonymous namespace
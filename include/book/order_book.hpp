@@ -5,8 +5,12 @@
  * @brief High-performance limit order book with Price-Time Priority matching.
  *
  * DESIGN PRINCIPLES:
- * 1. Vector-based price levels for cache-friendly linear iteration.
- * 2. Hash map for O(1) order cancellation by ID.
+ * 1. Sorted vectors of pooled price levels, best price last: levels live
+ *    at stable addresses and each resting order points at its own, so a
+ *    cancel unlinks without searching, and opening or consuming the touch
+ *    is a push_back / pop_back. A level emptied below the touch stays in
+ *    place until its price trades again or the side is compacted.
+ * 2. Flat open-addressing index for O(1) order cancellation by ID.
  * 3. Price-Time Priority: best price first, FIFO within price level.
  * 4. Zero allocation during trading (uses external MemPool).
  *
@@ -18,12 +22,12 @@
  */
 
 #include "memory_pool.hpp"
+#include "order_map.hpp"
 #include "price_level.hpp"
 #include "types.hpp"
 #include <algorithm>
 #include <cstdint>
 #include <optional>
-#include <unordered_map>
 #include <vector>
 
 namespace book {
@@ -52,16 +56,21 @@ struct Execution {
 /**
  * @brief High-performance limit order book with matching engine.
  *
- * Maintains bid and ask sides as sorted vectors of price levels.
- * Provides O(1) order cancellation via hash map lookup.
+ * Maintains bid and ask sides as sorted vectors of pointers to pooled
+ * price levels, each with its best price at the back. Provides O(1) order
+ * cancellation via an order-ID index and each order's back-pointer to its
+ * level.
  *
  * @tparam Capacity Maximum number of orders the pool can hold
+ * @tparam Index Order-ID index (see OrderIndex); preallocated for Capacity
+ * @tparam LevelCapacity Price levels (both sides, emptied ones included)
+ *         the book can hold
  *
  * Key properties:
  * - Price-Time Priority matching (FIFO at each price level)
  * - Cache-friendly linear iteration through price levels
- * - O(1) cancel via order_map_ lookup
- * - Zero allocation during trading (pre-allocated pool)
+ * - O(1) cancel: index lookup, unlink from the order's level
+ * - Zero allocation during trading (pre-allocated pools)
  *
  * @example
  *   MemPool<Order, 1000000> pool;
@@ -72,13 +81,19 @@ struct Execution {
  *
  *   auto spread = book.spread();  // 100 ticks = 0.0100
  */
-template <std::size_t Capacity> class OrderBook {
+template <std::size_t Capacity, typename Index = OrderMap<Order, Capacity>,
+          std::size_t LevelCapacity = std::min<std::size_t>(Capacity,
+                                                            1 << 20)>
+  requires OrderIndex<Index, Order>
+class OrderBook {
 public:
   // ========================================================================
   // Types
   // ========================================================================
 
   using PoolType = MemPool<Order, Capacity>;
+  using IndexType = Index;
+  using LevelPoolType = MemPool<PriceLevel, LevelCapacity>;
   using ExecutionCallback = void (*)(const Execution &);
 
   // ========================================================================
@@ -89,8 +104,14 @@ public:
    * @brief Construct order book with reference to memory pool.
    *
    * @param pool Reference to pre-allocated memory pool for orders
+   *
+   * @note The order index, the level pool and both sides are preallocated
+   *       here and may throw std::bad_alloc; nothing allocates after this.
    */
-  explicit OrderBook(PoolType &pool) noexcept : pool_(pool) {}
+  explicit OrderBook(PoolType &pool) : pool_(pool) {
+    bids_.levels.reserve(LevelCapacity);
+    asks_.levels.reserve(LevelCapacity);
+  }
 
   // Non-copyable
   OrderBook(const OrderBook &) = delete;
@@ -117,29 +138,31 @@ public:
    * @param qty Quantity (shares)
    * @param side Order side (Buy or Sell)
    * @param on_execution Optional callback for trade notifications
-   * @return true if order was added/matched, false if pool is full
+   * @return true if order was added/matched, false if the order or level
+   *         pool is full (or the ID is resting already)
    *
    * Complexity: O(k) where k is number of price levels crossed
    */
   bool add_order(uint64_t id, uint64_t price, uint32_t qty, Side side,
                  ExecutionCallback on_execution = nullptr) noexcept {
-    // Check for duplicate order ID
-    if (order_map_.find(id) != order_map_.end()) {
-      return false;
-    }
-
     uint32_t remaining_qty = qty;
 
-    // Try to match against opposite side
-    if (side == Side::Buy) {
-      remaining_qty = match_buy(id, price, qty, on_execution);
-    } else {
-      remaining_qty = match_sell(id, price, qty, on_execution);
-    }
+    // Try to match against opposite side. Only a crossing order needs the
+    // duplicate check up front; a resting one gets it from insert() below
+    if (crosses(price, side)) {
+      if (order_map_.find(id) != nullptr) {
+        return false;
+      }
+      if (side == Side::Buy) {
+        remaining_qty = match_buy(id, price, qty, on_execution);
+      } else {
+        remaining_qty = match_sell(id, price, qty, on_execution);
+      }
 
-    // If fully filled, no need to add to book
-    if (remaining_qty == 0) {
-      return true;
+      // If fully filled, no need to add to book
+      if (remaining_qty == 0) {
+        return true;
+      }
     }
 
     // Allocate order from pool
@@ -148,6 +171,12 @@ public:
       return false; // Pool exhausted
     }
 
+    // Register in order map for O(1) cancel (one probe: rejects duplicates)
+    if (!order_map_.insert(id, order)) {
+      pool_.deallocate(order);
+      return false;
+    }
+
     // Initialize order
     order->id = id;
     order->price = price;
@@ -155,15 +184,14 @@ public:
     order->side = static_cast<char>(side);
 
     // Add to book
-    if (side == Side::Buy) {
-      add_to_bids(order);
-    } else {
-      add_to_asks(order);
+    const bool rested =
+        side == Side::Buy ? add_to_bids(order) : add_to_asks(order);
+    if (!rested) [[unlikely]] {
+      (void)order_map_.erase(id); // Level pool exhausted
+      pool_.deallocate(order);
+      return false;
     }
 
-    // Register in order map for O(1) cancel
-    order_map_[id] = order;
-
     return true;
   }
 
@@ -177,24 +205,20 @@ public:
    * @param id Order ID to cancel
    * @return true if order was found and cancelled, false otherwise
    *
-   * Complexity: O(1) for lookup + O(1) for removal from list
-   *             Price level cleanup is O(n) in worst case
+   * Complexity: O(1) for lookup + O(1) for removal from the order's level.
+   *             An emptied best level is released at once (with any empty
+   *             levels behind it); one deeper in the book is left for
+   *             reuse, and the side is compacted, in O(levels), once empty
+   *             levels outnumber live ones.
    */
   bool cancel_order(uint64_t id) noexcept {
-    auto it = order_map_.find(id);
-    if (it == order_map_.end()) {
+    Order *order = order_map_.erase(id);
+    if (order == nullptr) {
       return false;
     }
 
-    Order *order = it->second;
-    order_map_.erase(it);
-
-    // Remove from price level
-    if (order->is_buy()) {
-      remove_from_bids(order);
-    } else {
-      remove_from_asks(order);
-    }
+    // Unlink from its level; no search
+    remove_from_level(order);
 
     // Return to pool
     pool_.deallocate(order);
@@ -212,10 +236,10 @@ public:
    * @return Best bid price, or nullopt if no bids
    */
   [[nodiscard]] std::optional<uint64_t> best_bid() const noexcept {
-    if (bids_.empty() || bids_.front().empty()) {
+    if (bids_.levels.empty()) {
       return std::nullopt;
     }
-    return bids_.front().price;
+    return bids_.levels.back()->price;
   }
 
   /**
@@ -224,10 +248,10 @@ public:
    * @return Best ask price, or nullopt if no asks
    */
   [[nodiscard]] std::optional<uint64_t> best_ask() const noexcept {
-    if (asks_.empty() || asks_.front().empty()) {
+    if (asks_.levels.empty()) {
       return std::nullopt;
     }
-    return asks_.front().price;
+    return asks_.levels.back()->price;
   }
 
   /**
@@ -248,27 +272,27 @@ public:
    * @brief Get total volume at best bid.
    */
   [[nodiscard]] uint64_t best_bid_volume() const noexcept {
-    if (bids_.empty()) {
+    if (bids_.levels.empty()) {
       return 0;
     }
-    return bids_.front().total_volume;
+    return bids_.levels.back()->total_volume;
   }
 
   /**
    * @brief Get total volume at best ask.
    */
   [[nodiscard]] uint64_t best_ask_volume() const noexcept {
-    if (asks_.empty()) {
+    if (asks_.levels.empty()) {
       return 0;
     }
-    return asks_.front().total_volume;
+    return asks_.levels.back()->total_volume;
   }
 
   /**
    * @brief Check if order book is empty (no resting orders).
    */
   [[nodiscard]] bool empty() const noexcept {
-    return bids_.empty() && asks_.empty();
+    return bids_.levels.empty() && asks_.levels.empty();
   }
 
   /**
@@ -279,29 +303,31 @@ public:
   }
 
   /**
-   * @brief Get number of bid price levels.
+   * @brief Get number of bid price levels with resting orders.
    */
   [[nodiscard]] std::size_t bid_level_count() const noexcept {
-    return bids_.size();
+    return bids_.levels.size() - bids_.empty_levels;
   }
 
   /**
-   * @brief Get number of ask price levels.
+   * @brief Get number of ask price levels with resting orders.
    */
   [[nodiscard]] std::size_t ask_level_count() const noexcept {
-    return asks_.size();
+    return asks_.levels.size() - asks_.empty_levels;
   }
 
   // ========================================================================
   // Direct access for testing
   // ========================================================================
 
-  [[nodiscard]] const std::vector<PriceLevel> &bids() const noexcept {
-    return bids_;
+  /// Bid levels, best last; emptied levels below the best may remain
+  [[nodiscard]] const std::vector<PriceLevel *> &bids() const noexcept {
+    return bids_.levels;
   }
 
-  [[nodiscard]] const std::vector<PriceLevel> &asks() const noexcept {
-    return asks_;
+  /// Ask levels, best last; emptied levels below the best may remain
+  [[nodiscard]] const std::vector<PriceLevel *> &asks() const noexcept {
+    return asks_.levels;
   }
 
 private:
@@ -309,15 +335,41 @@ private:
   // Data Members
   // ========================================================================
 
-  std::vector<PriceLevel> bids_; ///< Sorted descending (best bid first)
-  std::vector<PriceLevel> asks_; ///< Sorted ascending (best ask first)
-  std::unordered_map<uint64_t, Order *> order_map_; ///< ID -> Order*
+  /**
+   * @brief One side of the book: its levels sorted best last, so the
+   *        touch is the end of the vector.
+   *
+   * The back level always has resting orders; levels below it may be
+   * empty (counted in `empty_levels`) until reused or compacted away.
+   */
+  struct BookSide {
+    std::vector<PriceLevel *> levels;
+    std::size_t empty_levels = 0;
+  };
+
+  /// Empty levels tolerated on a side before it is compacted
+  static constexpr std::size_t kCompactSlack = 64;
+
+  BookSide bids_;             ///< Sorted ascending (best bid last)
+  BookSide asks_;             ///< Sorted descending (best ask last)
+  Index order_map_;           ///< ID -> Order*
+  LevelPoolType level_pool_;  ///< Stable storage for price levels
   PoolType &pool_; ///< Reference to memory pool
 
   // ========================================================================
   // Matching Logic
   // ========================================================================
 
+  /**
+   * @brief Check whether an order at `price` would trade on arrival.
+   */
+  [[nodiscard]] bool crosses(uint64_t price, Side side) const noexcept {
+    if (side == Side::Buy) {
+      return !asks_.levels.empty() && price >= asks_.levels.back()->price;
+    }
+    return !bids_.levels.empty() && price <= bids_.levels.back()->price;
+  }
+
   /**
    * @brief Match a buy order against resting asks.
    *
@@ -328,8 +380,8 @@ private:
     uint32_t remaining = qty;
 
     // Iterate through ask levels (lowest price first)
-    while (remaining > 0 && !asks_.empty()) {
-      PriceLevel &level = asks_.front();
+    while (remaining > 0 && !asks_.levels.empty()) {
+      PriceLevel &level = *asks_.levels.back();
 
       // Check if we can match (buy price >= ask price)
       if (price < level.price) {
@@ -342,7 +394,7 @@ private:
 
       // Remove empty level
       if (level.empty()) {
-        asks_.erase(asks_.begin());
+        release_best(asks_);
       }
     }
 
@@ -359,8 +411,8 @@ private:
     uint32_t remaining = qty;
 
     // Iterate through bid levels (highest price first)
-    while (remaining > 0 && !bids_.empty()) {
-      PriceLevel &level = bids_.front();
+    while (remaining > 0 && !bids_.levels.empty()) {
+      PriceLevel &level = *bids_.levels.back();
 
       // Check if we can match (sell price <= bid price)
       if (price > level.price) {
@@ -373,13 +425,12 @@ private:
 
       // Remove empty level
       if (level.empty()) {
-        bids_.erase(bids_.begin());
+        release_best(bids_);
       }
     }
 
     return remaining;
   }
-
   /**
    * @brief Match against orders at a single price level.
    *
@@ -421,7 +472,7 @@ private:
       if (maker.is_filled()) {
         Order *filled_order = &maker;
         level.orders.pop_front();
-        order_map_.erase(filled_order->id);
+        (void)order_map_.erase(filled_order->id);
         pool_.deallocate(filled_order);
       }
     }
@@ -434,76 +485,141 @@ private:
   // ========================================================================
 
   /**
-   * @brief Add order to bid side (sorted descending).
+   * @brief Add order to bid side (sorted ascending, best last).
+   *
+   * @return false if a new level was needed and the level pool is full
    */
-  void add_to_bids(Order *order) noexcept {
-    // Find insertion point (descending order)
-    auto it = std::lower_bound(bids_.begin(), bids_.end(), order->price,
-                               [](const PriceLevel &level, uint64_t price) {
-                                 return level.price > price; // Descending
-                               });
-
-    // Check if level exists at this price
-    if (it != bids_.end() && it->price == order->price) {
-      it->add_order(order);
-    } else {
-      // Insert new level
-      PriceLevel new_level(order->price);
-      new_level.add_order(order);
-      bids_.insert(it, std::move(new_level));
+  bool add_to_bids(Order *order) noexcept {
+    reclaim_if_full();
+    std::vector<PriceLevel *> &levels = bids_.levels;
+    // At or above the touch: no search (a new best is a push_back)
+    auto it = levels.end();
+    if (!levels.empty() && levels.back()->price >= order->price) {
+      if (levels.back()->price == order->price) {
+        --it;
+      } else {
+        // Find insertion point (ascending order)
+        it = std::lower_bound(levels.begin(), levels.end(), order->price,
+                              [](const PriceLevel *level, uint64_t price) {
+                                return level->price < price; // Ascending
+                              });
+      }
     }
+    return add_at(bids_, it, order);
   }
 
   /**
-   * @brief Add order to ask side (sorted ascending).
+   * @brief Add order to ask side (sorted descending, best last).
+   *
+   * @return false if a new level was needed and the level pool is full
    */
-  void add_to_asks(Order *order) noexcept {
-    // Find insertion point (ascending order)
-    auto it = std::lower_bound(asks_.begin(), asks_.end(), order->price,
-                               [](const PriceLevel &level, uint64_t price) {
-                                 return level.price < price; // Ascending
-                               });
+  bool add_to_asks(Order *order) noexcept {
+    reclaim_if_full();
+    std::vector<PriceLevel *> &levels = asks_.levels;
+    // At or below the touch: no search (a new best is a push_back)
+    auto it = levels.end();
+    if (!levels.empty() && levels.back()->price <= order->price) {
+      if (levels.back()->price == order->price) {
+        --it;
+      } else {
+        // Find insertion point (descending order)
+        it = std::lower_bound(levels.begin(), levels.end(), order->price,
+                              [](const PriceLevel *level, uint64_t price) {
+                                return level->price > price; // Descending
+                              });
+      }
+    }
+    return add_at(asks_, it, order);
+  }
 
-    // Check if level exists at this price
-    if (it != asks_.end() && it->price == order->price) {
-      it->add_order(order);
+  /**
+   * @brief Add order to the level at `it` if it has the order's price
+   *        (reusing it if emptied), else to a new level inserted there.
+   */
+  bool add_at(BookSide &side, std::vector<PriceLevel *>::iterator it,
+              Order *order) noexcept {
+    PriceLevel *level = nullptr;
+    if (it != side.levels.end() && (*it)->price == order->price) {
+      level = *it;
+      if (level->empty()) {
+        --side.empty_levels; // Emptied earlier, live again
+      }
     } else {
-      // Insert new level
-      PriceLevel new_level(order->price);
-      new_level.add_order(order);
-      asks_.insert(it, std::move(new_level));
+      level = level_pool_.allocate();
+      if (level == nullptr) [[unlikely]] {
+        return false;
+      }
+      level->price = order->price;
+      level->total_volume = 0;
+      side.levels.insert(it, level); // Capacity reserved up front
     }
+    level->add_order(order);
+    order->level = level;
+    return true;
   }
 
   /**
-   * @brief Remove order from bid side.
+   * @brief Unlink an order from its level, releasing the level if that
+   *        emptied the best price.
    */
-  void remove_from_bids(Order *order) noexcept {
-    // Find price level
-    for (auto it = bids_.begin(); it != bids_.end(); ++it) {
-      if (it->price == order->price) {
-        it->remove_order(order);
-        if (it->empty()) {
-          bids_.erase(it);
-        }
-        return;
-      }
+  void remove_from_level(Order *order) noexcept {
+    PriceLevel *level = order->level;
+    level->remove_order(order);
+    if (!level->empty()) {
+      return;
+    }
+    BookSide &side = order->is_buy() ? bids_ : asks_;
+    if (level == side.levels.back()) {
+      release_best(side);
+      return;
+    }
+    // Deeper in the book: leave it in place for the next order at its price
+    ++side.empty_levels;
+    if (side.empty_levels > kCompactSlack &&
+        2 * side.empty_levels > side.levels.size()) {
+      compact(side);
     }
   }
 
   /**
-   * @brief Remove order from ask side.
+   * @brief Pop the emptied best level and any empty levels below it, so
+   *        the new back has resting orders.
    */
-  void remove_from_asks(Order *order) noexcept {
-    // Find price level
-    for (auto it = asks_.begin(); it != asks_.end(); ++it) {
-      if (it->price == order->price) {
-        it->remove_order(order);
-        if (it->empty()) {
-          asks_.erase(it);
-        }
-        return;
-      }
+  void release_best(BookSide &side) noexcept {
+    level_pool_.deallocate(side.levels.back());
+    side.levels.pop_back();
+    while (!side.levels.empty() && side.levels.back()->empty()) {
+      level_pool_.deallocate(side.levels.back());
+      side.levels.pop_back();
+      --side.empty_levels;
+    }
+  }
+
+  /**
+   * @brief Release every empty level of a side (O(levels)).
+   */
+  void compact(BookSide &side) noexcept {
+    auto keep = std::remove_if(side.levels.begin(), side.levels.end(),
+                               [this](PriceLevel *level) {
+                                 if (!level->empty()) {
+                                   return false;
+                                 }
+                                 level_pool_.deallocate(level);
+                                 return true;
+                               });
+    side.levels.erase(keep, side.levels.end());
+    side.empty_levels = 0;
+  }
+
+  /**
+   * @brief Before a possible level allocation: if the pool is out of
+   *        levels, release the emptied ones first.
+   */
+  void reclaim_if_full() noexcept {
+    if (level_pool_.full() && bids_.empty_levels + asks_.empty_levels > 0)
+        [[unlikely]] {
+      compact(bids_);
+      compact(asks_);
     }
   }
 };
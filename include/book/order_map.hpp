@@ -0,0 +1,259 @@
+#pragma once
+
+/**
+ * @file order_map.hpp
+ * @brief Preallocated open-addressing index from order ID to resting order.
+ *
+ * DESIGN PRINCIPLES:
+ * 1. Zero allocation during trading: every slot is allocated at
+ *    construction, sized from the pool capacity, and never rehashed.
+ * 2. Robin Hood linear probing over a flat, cache-line-aligned
+ *    power-of-two array: a lookup is one mask and, almost always, one
+ *    cache line, and entries stay sorted by home slot within a run, so
+ *    misses stop early.
+ * 3. Tombstone-free: erase() shifts the rest of the probe run back (up to
+ *    the first entry at home), so long days of adds and cancels never
+ *    degrade the probe lengths.
+ * 4. A hash for sequential keys: ITCH order refs count up through the day.
+ *    Each run of four consecutive refs fills one cache line, so a burst of
+ *    adds stays on few lines. The lines themselves are scattered by
+ *    Fibonacci hashing: placed as they are, refs still resting from early
+ *    in the day form a dense block that later refs wrap onto, and every
+ *    insert homed inside the block shifts the rest of it.
+ *
+ * USAGE:
+ *   OrderMap<Order, 1'000'000> index;   // 2M slots, allocated once
+ *   index.insert(order->id, order);     // false on a duplicate ID
+ *   Order* o = index.find(id);          // nullptr if absent
+ *   index.erase(id);                    // Returns the removed order
+ */
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace book {
+
+// ============================================================================
+// Index Concept
+// ============================================================================
+
+/**
+ * @brief What OrderBook needs from its order-ID index.
+ *
+ * find() returns nullptr for an absent key, insert() refuses a present
+ * one, and erase() returns what it removed (nullptr if absent).
+ */
+template <typename I, typename T>
+concept OrderIndex =
+    std::default_initializable<I> &&
+    requires(I index, const I &cindex, uint64_t key, T *value) {
+      { cindex.find(key) } -> std::same_as<T *>;
+      { index.insert(key, value) } -> std::same_as<bool>;
+      { index.erase(key) } -> std::same_as<T *>;
+      { cindex.size() } -> std::convertible_to<std::size_t>;
+    };
+
+// ============================================================================
+// OrderMap - Flat Hash Index
+// ============================================================================
+
+/**
+ * @brief Fixed-capacity map from 64-bit ID to T*, for at most Capacity
+ *        entries.
+ *
+ * A slot is empty when its value is nullptr, so every key (0 included) is
+ * usable and null values cannot be stored.
+ *
+ * @tparam T Mapped object type (stored by pointer)
+ * @tparam Capacity Maximum number of entries (the pool's capacity)
+ */
+template <typename T, std::size_t Capacity> class OrderMap {
+public:
+  /// log2 of the consecutive keys homed on one cache line (4 slots of 16B)
+  static constexpr int kRunBits = 2;
+
+  /// Slots in the table: load factor stays at or below 2/3, and there are
+  /// at least two cache lines
+  static constexpr std::size_t kSlots =
+      std::max(std::bit_ceil(Capacity + Capacity / 2 + 1),
+               std::size_t{2} << kRunBits);
+
+  /**
+   * @brief Allocate and clear every slot.
+   *
+   * @note This may throw std::bad_alloc if allocation fails.
+   */
+  OrderMap() : lines_(kSlots >> kRunBits) {}
+
+  // Non-copyable, like the pool it indexes
+  OrderMap(const OrderMap &) = delete;
+  OrderMap &operator=(const OrderMap &) = delete;
+
+  // ========================================================================
+  // Capacity
+  // ========================================================================
+
+  [[nodiscard]] std::size_t size() const noexcept { return size_; }
+  [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+  [[nodiscard]] static constexpr std::size_t capacity() noexcept {
+    return Capacity;
+  }
+
+  // ========================================================================
+  // Lookup
+  // ========================================================================
+
+  /**
+   * @brief Find the object stored under `key`.
+   *
+   * @return The object, or nullptr if absent.
+   */
+  [[nodiscard]] T *find(uint64_t key) const noexcept {
+    std::size_t i = home(key);
+    for (std::size_t dist = 0;; ++dist, i = (i + 1) & kMask) {
+      const Slot &slot = slot_at(i);
+      if (slot.value == nullptr || distance(slot.key, i) < dist) {
+        return nullptr; // Key would have displaced this entry
+      }
+      if (slot.key == key) {
+        return slot.value;
+      }
+    }
+  }
+
+  // ========================================================================
+  // Modifiers
+  // ========================================================================
+
+  /**
+   * @brief Store `value` under `key`.
+   *
+   * @return false if `key` is present already (or the map is full).
+   */
+  bool insert(uint64_t key, T *value) noexcept {
+    if (size_ == Capacity) [[unlikely]] {
+      return false;
+    }
+    Slot carry{key, value};
+    std::size_t i = home(key);
+    for (std::size_t dist = 0;; ++dist, i = (i + 1) & kMask) {
+      Slot &slot = slot_at(i);
+      if (slot.value == nullptr) {
+        slot = carry;
+        ++size_;
+        return true;
+      }
+      // Only reachable before the first swap: find() stops where we swap
+      if (slot.key == key) {
+        return false;
+      }
+      const std::size_t slot_dist = distance(slot.key, i);
+      if (slot_dist < dist) {
+        std::swap(slot, carry); // Robin Hood: the richer entry moves on
+        dist = slot_dist;
+      }
+    }
+  }
+
+  /**
+   * @brief Remove `key`, shifting the rest of its probe run back one slot.
+   *
+   * @return The removed object, or nullptr if absent.
+   */
+  T *erase(uint64_t key) noexcept {
+    std::size_t hole = home(key);
+    for (std::size_t dist = 0;; ++dist, hole = (hole + 1) & kMask) {
+      const Slot &slot = slot_at(hole);
+      if (slot.value == nullptr || distance(slot.key, hole) < dist) {
+        return nullptr;
+      }
+      if (slot.key == key) {
+        break;
+      }
+    }
+    T *removed = slot_at(hole).value;
+
+    // Entries after the hole move back until one is empty or already home;
+    // with sequential refs nearly all sit at home, so this rarely iterates
+    for (std::size_t i = (hole + 1) & kMask;
+         slot_at(i).value != nullptr && distance(slot_at(i).key, i) != 0;
+         i = (i + 1) & kMask) {
+      slot_at(hole) = slot_at(i);
+      hole = i;
+    }
+    slot_at(hole).value = nullptr;
+    --size_;
+    return removed;
+  }
+
+  /**
+   * @brief Remove every entry (touches every slot).
+   */
+  void clear() noexcept {
+    for (Line &line : lines_) {
+      for (Slot &slot : line.slots) {
+        slot.value = nullptr;
+      }
+    }
+    size_ = 0;
+  }
+
+  // ========================================================================
+  // Hashing
+  // ========================================================================
+
+  /**
+   * @brief Home slot of `key`: the low kRunBits pick the slot within a
+   *        cache line, and the top bits of (key >> kRunBits) * 2^64/phi
+   *        pick the line.
+   */
+  [[nodiscard]] static constexpr std::size_t home(uint64_t key) noexcept {
+    const uint64_t line = ((key >> kRunBits) * kGolden) >> kLineShift;
+    return static_cast<std::size_t>((line << kRunBits) | (key & kRunMask));
+  }
+
+private:
+  static constexpr std::size_t kMask = kSlots - 1;
+  static constexpr uint64_t kRunMask = (uint64_t{1} << kRunBits) - 1;
+  static constexpr int kLineShift =
+      64 - std::countr_zero(kSlots) + kRunBits;
+  static constexpr uint64_t kGolden = 0x9E3779B97F4A7C15ULL;
+
+  struct Slot {
+    uint64_t key = 0;
+    T *value = nullptr; ///< nullptr: slot is empty
+  };
+
+  /// The slots homed on one run of keys, on a cache line of their own
+  struct alignas(64) Line {
+    std::array<Slot, std::size_t{1} << kRunBits> slots;
+  };
+
+  /// Slot `i` of the table, counting across lines
+  [[nodiscard]] Slot &slot_at(std::size_t i) noexcept {
+    return lines_[i >> kRunBits].slots[i & kRunMask];
+  }
+  [[nodiscard]] const Slot &slot_at(std::size_t i) const noexcept {
+    return lines_[i >> kRunBits].slots[i & kRunMask];
+  }
+
+  /**
+   * @brief Probe distance of `key` stored in slot `i`.
+   */
+  [[nodiscard]] static constexpr std::size_t distance(uint64_t key,
+                                                      std::size_t i) noexcept {
+    return (i - home(key)) & kMask;
+  }
+
+  std::vector<Line> lines_;
+  std::size_t size_ = 0;
+};
+
+} // namespace book
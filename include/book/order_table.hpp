@@ -0,0 +1,253 @@
+#pragma once
+
+/**
+ * @file order_table.hpp
+ * @brief Direct-mapped order index over a sliding window of order refs.
+ *
+ * DESIGN PRINCIPLES:
+ * 1. Index by arithmetic, not hashing: ITCH order refs are assigned densely
+ *    and increase through the day, so a ref inside the window lives at slot
+ *    `ref & mask` of a flat array. A lookup is a subtract, a compare and a
+ *    load; there are no probes and no keys to compare.
+ * 2. Page-segmented sliding window: the window is a ring of fixed-size
+ *    pages, each with a live-order count. When new refs run past the end,
+ *    the window slides forward a page at a time and the oldest pages are
+ *    recycled for the newest refs. Dead pages (count zero) recycle for free.
+ * 3. Small overflow hash for outliers: the few orders still resting when
+ *    their page is recycled move to an OrderMap, as do refs far outside
+ *    the window. Lookups reach it only on a window miss.
+ * 4. Zero allocation during trading: the window and the overflow table are
+ *    allocated once at construction.
+ *
+ * USAGE:
+ *   OrderTable<Order, 1'000'000> index;  // Window of 2M refs, 16 MB
+ *   index.insert(order->id, order);      // false on a duplicate ID
+ *   Order* o = index.find(id);           // nullptr if absent
+ *   OrderBook<1'000'000, OrderTable<Order, 1'000'000>> book(pool);
+ */
+
+#include "order_map.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace book {
+
+// ============================================================================
+// OrderTable - Direct-Mapped Sliding Window
+// ============================================================================
+
+/**
+ * @brief Fixed-capacity map from order ref to T*, for at most Capacity
+ *        entries, tuned for refs that increase through the day.
+ *
+ * Refs below the window, or far beyond its end, are stored in the overflow
+ * table, as are survivors of recycled pages. insert() fails when the table
+ * holds Capacity entries or an entry needs the overflow table and it is
+ * full.
+ *
+ * @tparam T Mapped object type (stored by pointer)
+ * @tparam Capacity Maximum number of entries (the pool's capacity)
+ * @tparam PageBits log2 of the refs per page (the recycling unit)
+ * @tparam OverflowCapacity Outliers and survivors of recycled pages held
+ *         at once; size it for the orders that rest for most of the day
+ */
+template <typename T, std::size_t Capacity, unsigned PageBits = 12,
+          std::size_t OverflowCapacity = Capacity / 4 + 64>
+class OrderTable {
+public:
+  /// Refs per page
+  static constexpr std::size_t kPageRefs = std::size_t{1} << PageBits;
+
+  /// Pages in the window: the window spans about twice Capacity refs
+  static constexpr std::size_t kWindowPages =
+      std::max<std::size_t>(2, std::bit_ceil(2 * Capacity) >> PageBits);
+
+  /// Refs covered by the window
+  static constexpr std::size_t kWindowRefs = kWindowPages * kPageRefs;
+
+  /// Entries the overflow table can hold
+  static constexpr std::size_t kOverflowCapacity = OverflowCapacity;
+
+  /**
+   * @brief Allocate and clear the window and the overflow table.
+   *
+   * @note This may throw std::bad_alloc if allocation fails.
+   */
+  OrderTable() : slots_(kWindowRefs), page_live_(kWindowPages) {}
+
+  // Non-copyable, like the pool it indexes
+  OrderTable(const OrderTable &) = delete;
+  OrderTable &operator=(const OrderTable &) = delete;
+
+  // ========================================================================
+  // Capacity
+  // ========================================================================
+
+  [[nodiscard]] std::size_t size() const noexcept { return size_; }
+  [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+  [[nodiscard]] static constexpr std::size_t capacity() noexcept {
+    return Capacity;
+  }
+
+  /// Entries held in the overflow table
+  [[nodiscard]] std::size_t overflow_size() const noexcept {
+    return overflow_.size();
+  }
+
+  /// First ref of the window
+  [[nodiscard]] uint64_t window_base() const noexcept { return base_; }
+
+  /// Pages recycled by window slides so far (live or not)
+  [[nodiscard]] uint64_t pages_recycled() const noexcept {
+    return pages_recycled_;
+  }
+
+  // ========================================================================
+  // Lookup
+  // ========================================================================
+
+  /**
+   * @brief Find the object stored under `key`.
+   *
+   * @return The object, or nullptr if absent.
+   */
+  [[nodiscard]] T *find(uint64_t key) const noexcept {
+    if (key - base_ < kWindowRefs) [[likely]] {
+      T *value = slots_[key & kWindowMask];
+      if (value != nullptr || key > overflow_high_ || overflow_.empty())
+          [[likely]] {
+        return value;
+      }
+    }
+    return overflow_.find(key);
+  }
+
+  // ========================================================================
+  // Modifiers
+  // ========================================================================
+
+  /**
+   * @brief Store `value` under `key`, sliding the window forward if `key`
+   *        is just past its end.
+   *
+   * @return false if `key` is present already, or there is no room.
+   */
+  bool insert(uint64_t key, T *value) noexcept {
+    if (size_ == Capacity) [[unlikely]] {
+      return false;
+    }
+    if (window_live_ == 0 && key - base_ >= kWindowRefs) {
+      base_ = key & ~kPageMask; // Empty window: anchor it at this ref
+    }
+    uint64_t offset = key - base_;
+    if (offset >= kWindowRefs && offset < 2 * kWindowRefs) {
+      slide(key);
+      offset = key - base_;
+    }
+    if (offset >= kWindowRefs) [[unlikely]] {
+      return insert_overflow(key, value);
+    }
+
+    // Survivors sit below the window, so a new ref only needs the overflow
+    // duplicate check if an outlier at or above it was ever stored there
+    T *&slot = slots_[key & kWindowMask];
+    if (slot != nullptr || (key <= overflow_high_ && !overflow_.empty() &&
+                            overflow_.find(key) != nullptr)) {
+      return false;
+    }
+    slot = value;
+    ++page_live_[page_of(key)];
+    ++window_live_;
+    ++size_;
+    return true;
+  }
+
+  /**
+   * @brief Remove `key`.
+   *
+   * @return The removed object, or nullptr if absent.
+   */
+  T *erase(uint64_t key) noexcept {
+    if (key - base_ < kWindowRefs) [[likely]] {
+      T *&slot = slots_[key & kWindowMask];
+      if (slot != nullptr) [[likely]] {
+        T *removed = slot;
+        slot = nullptr;
+        --page_live_[page_of(key)];
+        --window_live_;
+        --size_;
+        return removed;
+      }
+    }
+    if (key > overflow_high_ || overflow_.empty()) {
+      return nullptr;
+    }
+    T *removed = overflow_.erase(key);
+    size_ -= removed != nullptr ? 1 : 0;
+    return removed;
+  }
+
+private:
+  static constexpr uint64_t kWindowMask = kWindowRefs - 1;
+  static constexpr uint64_t kPageMask = kPageRefs - 1;
+
+  /**
+   * @brief Ring index of the page holding `key`.
+   */
+  [[nodiscard]] static constexpr std::size_t page_of(uint64_t key) noexcept {
+    return static_cast<std::size_t>(key & kWindowMask) >> PageBits;
+  }
+
+  bool insert_overflow(uint64_t key, T *value) noexcept {
+    if (!overflow_.insert(key, value)) {
+      return false; // Duplicate, or overflow table full
+    }
+    overflow_high_ = std::max(overflow_high_, key);
+    ++size_;
+    return true;
+  }
+
+  /**
+   * @brief Move the window forward until it covers `key`, recycling the
+   *        pages that fall off its start. Stops early, leaving `key`
+   *        outside, if a page's survivors do not fit the overflow table.
+   */
+  void slide(uint64_t key) noexcept {
+    const uint64_t new_base = (key & ~kPageMask) - kWindowRefs + kPageRefs;
+    for (; base_ < new_base; base_ += kPageRefs) {
+      const std::size_t page = page_of(base_);
+      const uint32_t live = page_live_[page];
+      if (live != 0) {
+        if (overflow_.size() + live > kOverflowCapacity) [[unlikely]] {
+          return;
+        }
+        T **slots = &slots_[page * kPageRefs];
+        for (std::size_t i = 0; i < kPageRefs; ++i) {
+          if (slots[i] != nullptr) {
+            (void)overflow_.insert(base_ + i, slots[i]);
+            overflow_high_ = std::max(overflow_high_, base_ + i);
+            slots[i] = nullptr;
+          }
+        }
+        page_live_[page] = 0;
+        window_live_ -= live;
+      }
+      ++pages_recycled_;
+    }
+  }
+
+  std::vector<T *> slots_;            ///< Window, indexed by ref & mask
+  std::vector<uint32_t> page_live_;   ///< Live entries per window page
+  OrderMap<T, kOverflowCapacity> overflow_;
+  uint64_t base_ = 0;                 ///< First ref of the window
+  uint64_t overflow_high_ = 0;        ///< Highest ref ever overflowed
+  std::size_t window_live_ = 0;       ///< Entries held in the window
+  std::size_t size_ = 0;
+  uint64_t pages_recycled_ = 0;
+};
+
+} // namespace book
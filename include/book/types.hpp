@@ -16,6 +16,8 @@
 
 namespace book {
 
+struct PriceLevel;
+
 // ============================================================================
 // Side Enum
 // ============================================================================
@@ -42,8 +44,9 @@ enum class Side : char { Buy = 'B', Sell = 'S' };
  *   price:          8 bytes
  *   qty:            4 bytes
  *   side:           1 byte
+ *   level:          8 bytes
  *   -----------------------
- *   Total:         37 bytes (vs 40+ with padding)
+ *   Total:         45 bytes (vs 48 with padding)
  *
  * @note Using #pragma pack(1) may cause unaligned access on some architectures.
  *       On x86-64 this is generally fine, but may have performance implications
@@ -55,6 +58,7 @@ struct Order : IntrusiveNode {
   uint64_t price; ///< Price in ticks (fixed-point, e.g., price * 10000)
   uint32_t qty;   ///< Remaining quantity (shares)
   char side;      ///< 'B' = Buy, 'S' = Sell
+  PriceLevel *level = nullptr; ///< Level it rests on (set by OrderBook)
 
   // ========================================================================
   // Constructors
@@ -140,8 +144,8 @@ static_assert(IntrusiveListElement<Order>,
               "Order must satisfy IntrusiveListElement concept");
 
 // Verify packed size (pointers are 8 bytes on 64-bit)
-// IntrusiveNode: 16 bytes, Order fields: 21 bytes, Total: 37 bytes
-static_assert(sizeof(Order) == 37, "Order should be 37 bytes when packed");
+// IntrusiveNode: 16 bytes, Order fields: 29 bytes, Total: 45 bytes
+static_assert(sizeof(Order) == 45, "Order should be 45 bytes when packed");
 
 // Note: offsetof cannot be used on Order because it inherits from
 // IntrusiveNode, making it a non-standard-layout type. The layout is verified
@@ -0,0 +1,276 @@
+#pragma once
+
+/**
+ * @file binary_reader.hpp
+ * @brief Zero-copy reader for raw NASDAQ "binary ITCH" files using mmap.
+ *
+ * DESIGN PRINCIPLES:
+ * 1. Same model as PcapReader: map the whole file (any MapStrategy), hand
+ *    out pointers.
+ * 2. No framing guesswork - every record carries its own length.
+ * 3. Chunks always end on a record boundary, so each one can be handed to a
+ *    different consumer (thread, progress report) without re-syncing.
+ *
+ * Binary ITCH File Format (e.g. 01302019.NASDAQ_ITCH50):
+ *   For each message:
+ *     Message Length (2 bytes, big-endian)
+ *     Message Data (Message Length bytes, starts with the type byte)
+ *
+ * USAGE:
+ *   BinaryItchReader reader("01302019.NASDAQ_ITCH50");
+ *   reader.for_each_message([&](const char* msg, size_t len) {
+ *       parser.parse(msg, len, handler);
+ *   });
+ */
+
+#include "mapped_file.hpp"
+#include "messages.hpp"
+#include "registry.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace itch {
+
+/// Size of the big-endian length prefix in front of every record
+inline constexpr size_t kBinaryItchLengthPrefix = 2;
+
+// ============================================================================
+// Record Walking (any buffer)
+// ============================================================================
+
+/**
+ * @brief Walk length-prefixed records in a buffer.
+ *
+ * @param data Start of a record boundary.
+ * @param length Bytes available.
+ * @param callback void(const char* msg, size_t len) per complete record.
+ * @return Bytes consumed (stops before a truncated trailing record).
+ */
+template <typename Callback>
+size_t for_each_length_prefixed(const char *data, size_t length,
+                                Callback &&callback) {
+  size_t offset = 0;
+  while (length - offset >= kBinaryItchLengthPrefix) {
+    const uint16_t msg_len = *reinterpret_cast<const be_u16 *>(data + offset);
+    const size_t record = kBinaryItchLengthPrefix + msg_len;
+    if (record > length - offset) {
+      break; // Truncated record
+    }
+    callback(data + offset + kBinaryItchLengthPrefix, size_t{msg_len});
+    offset += record;
+  }
+  return offset;
+}
+
+// ============================================================================
+// Binary ITCH Reader Class
+// ============================================================================
+
+/**
+ * @brief Memory-mapped reader for length-prefixed ITCH day files.
+ *
+ * @example
+ *   BinaryItchReader reader("01302019.NASDAQ_ITCH50");
+ *   if (!reader.is_open()) { error... }
+ *
+ *   // Record-aligned 64 MB chunks, e.g. for progress reporting
+ *   reader.for_each_chunk(64 << 20, [&](const char* chunk, size_t len) {
+ *       for_each_length_prefixed(chunk, len, on_message);
+ *   });
+ */
+class BinaryItchReader {
+public:
+  BinaryItchReader() = default;
+
+  explicit BinaryItchReader(const char *filename,
+                            const MapOptions &options = {}) {
+    open(filename, options);
+  }
+
+  ~BinaryItchReader() { close(); }
+
+  // Non-copyable (owns mmap'd memory)
+  BinaryItchReader(const BinaryItchReader &) = delete;
+  BinaryItchReader &operator=(const BinaryItchReader &) = delete;
+
+  // Movable
+  BinaryItchReader(BinaryItchReader &&other) noexcept
+      : file_(std::move(other.file_)), data_(other.data_),
+        size_(other.size_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+  }
+
+  BinaryItchReader &operator=(BinaryItchReader &&other) noexcept {
+    if (this != &other) {
+      close();
+      file_ = std::move(other.file_);
+      data_ = other.data_;
+      size_ = other.size_;
+      other.data_ = nullptr;
+      other.size_ = 0;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Open and mmap a binary ITCH file.
+   *
+   * The first record is validated (known type byte whose registry size
+   * matches the length prefix), so PCAP or other files are rejected -
+   * through a lazy mapping, before any populate or copy.
+   *
+   * @param filename Path to the file.
+   * @param options Page-fault strategy (see MapStrategy).
+   * @return true if successful.
+   */
+  bool open(const char *filename, const MapOptions &options = {}) {
+    close();
+
+    if (!file_.open(filename)) {
+      return false;
+    }
+    if (!looks_like_binary_itch(file_.data(), file_.size())) {
+      close();
+      return false;
+    }
+    if (options.strategy != MapStrategy::Lazy &&
+        !file_.open(filename, options)) {
+      close();
+      return false;
+    }
+
+    data_ = file_.data();
+    size_ = file_.size();
+    return true;
+  }
+
+  /**
+   * @brief Close the file and unmap memory.
+   */
+  void close() {
+    file_.close();
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  [[nodiscard]] bool is_open() const noexcept { return data_ != nullptr; }
+
+  [[nodiscard]] size_t file_size() const noexcept { return size_; }
+
+  /**
+   * @brief Iterate over every message (length prefix stripped).
+   *
+   * @tparam Callback void(const char* msg, size_t len)
+   * @return Number of messages delivered.
+   */
+  template <typename Callback>
+  size_t for_each_message(Callback &&callback) const {
+    if (!is_open()) {
+      return 0;
+    }
+
+    size_t count = 0;
+    (void)for_each_length_prefixed(
+        data_, size_, [&](const char *msg, size_t len) {
+          callback(msg, len);
+          ++count;
+          file_.consumed(static_cast<size_t>(msg + len - data_));
+        });
+    return count;
+  }
+
+  /**
+   * @brief Iterate over record-aligned chunks of about `chunk_bytes`.
+   *
+   * Each chunk still contains length prefixes; walk it with
+   * for_each_length_prefixed(). A chunk is never split mid-record and is
+   * only larger than `chunk_bytes` when one record alone exceeds it.
+   *
+   * @tparam Callback void(const char*, size_t) or bool(...) - returning
+   *                  false stops the iteration.
+   * @return Number of chunks delivered.
+   */
+  template <typename Callback>
+  size_t for_each_chunk(size_t chunk_bytes, Callback &&callback) const {
+    if (!is_open()) {
+      return 0;
+    }
+
+    size_t offset = 0;
+    size_t chunks = 0;
+
+    while (offset < size_) {
+      const size_t end = chunk_end(offset, chunk_bytes);
+      if (end == offset) {
+        break; // Only a truncated record left
+      }
+
+      ++chunks;
+      if constexpr (std::is_same_v<std::invoke_result_t<Callback &,
+                                                        const char *, size_t>,
+                                   bool>) {
+        if (!callback(data_ + offset, end - offset)) {
+          break;
+        }
+      } else {
+        callback(data_ + offset, end - offset);
+      }
+      offset = end;
+      file_.consumed(offset);
+    }
+
+    return chunks;
+  }
+
+  /**
+   * @brief Underlying mapping (strategy, read-ahead progress).
+   */
+  [[nodiscard]] const MappedFile &mapping() const noexcept { return file_; }
+
+  /**
+   * @brief Get raw mmap'd data pointer.
+   */
+  [[nodiscard]] const char *data() const noexcept { return data_; }
+
+private:
+  /**
+   * @brief First record: known type byte whose wire size matches its prefix.
+   */
+  [[nodiscard]] static bool looks_like_binary_itch(const char *data,
+                                                   size_t size) noexcept {
+    if (size < kBinaryItchLengthPrefix + 1) {
+      return false;
+    }
+    const uint16_t msg_len = *reinterpret_cast<const be_u16 *>(data);
+    return msg_len != 0 && message_size(data[2]) == msg_len;
+  }
+
+  /**
+   * @brief End of the last whole record starting before offset + target.
+   */
+  [[nodiscard]] size_t chunk_end(size_t offset,
+                                 size_t target) const noexcept {
+    size_t end = offset;
+    while (size_ - end >= kBinaryItchLengthPrefix) {
+      const uint16_t msg_len = *reinterpret_cast<const be_u16 *>(data_ + end);
+      const size_t record = kBinaryItchLengthPrefix + msg_len;
+      if (record > size_ - end) {
+        break; // Truncated record
+      }
+      if (end > offset && end - offset + record > target) {
+        break;
+      }
+      end += record;
+    }
+    return end;
+  }
+
+  MappedFile file_;
+  const char *data_ = nullptr; // file_.data(), cached for the hot loops
+  size_t size_ = 0;
+};
+
+} // namespace itch
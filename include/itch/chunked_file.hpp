@@ -0,0 +1,615 @@
+#pragma once
+
+/**
+ * @file chunked_file.hpp
+ * @brief Sequential file streaming through a fixed ring of aligned buffers.
+ *
+ * DESIGN PRINCIPLES:
+ * 1. Bounded memory: buffer_count x buffer_bytes, allocated and faulted
+ *    in once at open(), whatever the file size. No mapping of the file,
+ *    so a 200 GB capture cannot push the book's working set out of RAM.
+ * 2. I/O overlapped with parsing: while one buffer is being parsed, reads
+ *    for the next buffer_count - 1 are already in flight.
+ * 3. No liburing dependency: io_uring is driven through its raw syscalls,
+ *    with a pread thread as the fallback when the kernel (or a seccomp
+ *    filter) refuses it.
+ *
+ * Backends:
+ *   IoUring - reads queued on an io_uring, reaped in file order
+ *   Pread   - an I/O thread fills buffers with pread() ahead of the consumer
+ *
+ * With `direct` set the file is opened O_DIRECT (bypassing the page cache)
+ * where the filesystem allows it; otherwise consumed ranges are dropped
+ * from the page cache with POSIX_FADV_DONTNEED.
+ *
+ * USAGE:
+ *   ChunkedFile file;
+ *   file.open("day.pcap", {StreamBackend::Auto, 4 << 20, 4});
+ *   file.start();
+ *   const char* chunk; size_t len;
+ *   while (file.next(chunk, len)) { ... }   // chunk valid until next()
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace itch {
+
+// ============================================================================
+// Options
+// ============================================================================
+
+/**
+ * @brief I/O mechanism behind a ChunkedFile.
+ */
+enum class StreamBackend : uint8_t {
+  Auto,    ///< IoUring if the kernel allows it, else Pread
+  IoUring, ///< io_uring reads (fails to open if unavailable)
+  Pread    ///< Background pread() thread
+};
+
+/**
+ * @brief Streaming options for ChunkedFile (and the readers built on it).
+ */
+struct StreamOptions {
+  StreamBackend backend = StreamBackend::Auto;
+  size_t buffer_bytes = size_t{4} << 20; ///< Per buffer; rounded to 4 KiB
+  size_t buffer_count = 4;               ///< Ring depth (at least 2)
+  bool direct = true;                    ///< Try O_DIRECT
+};
+
+/**
+ * @brief Command-line name of a backend.
+ */
+[[nodiscard]] constexpr const char *
+stream_backend_name(StreamBackend backend) noexcept {
+  switch (backend) {
+  case StreamBackend::Auto:
+    return "auto";
+  case StreamBackend::IoUring:
+    return "uring";
+  case StreamBackend::Pread:
+    return "pread";
+  }
+  return "?";
+}
+
+/**
+ * @brief Parse a name produced by stream_backend_name().
+ */
+[[nodiscard]] inline bool parse_stream_backend(const char *name,
+                                               StreamBackend &out) noexcept {
+  for (StreamBackend backend :
+       {StreamBackend::Auto, StreamBackend::IoUring, StreamBackend::Pread}) {
+    if (std::strcmp(name, stream_backend_name(backend)) == 0) {
+      out = backend;
+      return true;
+    }
+  }
+  return false;
+}
+
+namespace detail {
+
+// ============================================================================
+// Raw io_uring
+// ============================================================================
+
+/**
+ * @brief Minimal io_uring: queue reads, reap completions.
+ *
+ * Single-threaded use only. The ring memory is shared with the kernel, so
+ * head/tail indices go through acquire/release atomics.
+ */
+class IoUring {
+public:
+  IoUring() = default;
+  ~IoUring() { close(); }
+
+  IoUring(const IoUring &) = delete;
+  IoUring &operator=(const IoUring &) = delete;
+
+  /**
+   * @brief Create a ring with room for `entries` submissions.
+   * @return false if io_uring is unavailable or refused.
+   */
+  bool init(unsigned entries) noexcept {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    const long fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) {
+      return false;
+    }
+    ring_fd_ = static_cast<int>(fd);
+
+    sq_len_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_len_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    single_mmap_ = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap_) {
+      sq_len_ = cq_len_ = sq_len_ > cq_len_ ? sq_len_ : cq_len_;
+    }
+    sqes_len_ = params.sq_entries * sizeof(io_uring_sqe);
+
+    sq_ring_ = map_ring(sq_len_, IORING_OFF_SQ_RING);
+    cq_ring_ = single_mmap_ ? sq_ring_ : map_ring(cq_len_, IORING_OFF_CQ_RING);
+    void *sqes = map_ring(sqes_len_, IORING_OFF_SQES);
+    if (sq_ring_ == nullptr || cq_ring_ == nullptr || sqes == nullptr) {
+      if (sqes != nullptr) {
+        munmap(sqes, sqes_len_);
+      }
+      close();
+      return false;
+    }
+    sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+    char *sq = static_cast<char *>(sq_ring_);
+    sq_head_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    sq_entries_ = params.sq_entries;
+
+    char *cq = static_cast<char *>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    return true;
+  }
+
+  void close() noexcept {
+    if (sqes_ != nullptr) {
+      munmap(sqes_, sqes_len_);
+      sqes_ = nullptr;
+    }
+    if (cq_ring_ != nullptr && !single_mmap_) {
+      munmap(cq_ring_, cq_len_);
+    }
+    if (sq_ring_ != nullptr) {
+      munmap(sq_ring_, sq_len_);
+    }
+    sq_ring_ = cq_ring_ = nullptr;
+    if (ring_fd_ >= 0) {
+      ::close(ring_fd_);
+      ring_fd_ = -1;
+    }
+  }
+
+  /**
+   * @brief Queue and submit a read of `len` bytes at `offset`.
+   */
+  bool read(int fd, void *buf, unsigned len, uint64_t offset,
+            uint64_t user_data) noexcept {
+    const unsigned tail = *sq_tail_; // Only this thread writes the tail
+    const unsigned head =
+        std::atomic_ref<unsigned>(*sq_head_).load(std::memory_order_acquire);
+    if (tail - head >= sq_entries_) {
+      return false;
+    }
+    const unsigned index = tail & sq_mask_;
+    io_uring_sqe &sqe = sqes_[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_READ;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<uint64_t>(buf);
+    sqe.len = len;
+    sqe.off = offset;
+    sqe.user_data = user_data;
+    sq_array_[index] = index;
+    std::atomic_ref<unsigned>(*sq_tail_).store(tail + 1,
+                                               std::memory_order_release);
+    return enter(1, 0, 0) == 1;
+  }
+
+  /**
+   * @brief Block until a completion is available and pop it.
+   * @param result Bytes read, or -errno.
+   */
+  bool wait(uint64_t &user_data, int &result) noexcept {
+    for (;;) {
+      const unsigned head = *cq_head_; // Only this thread writes the head
+      const unsigned tail =
+          std::atomic_ref<unsigned>(*cq_tail_).load(std::memory_order_acquire);
+      if (head != tail) {
+        const io_uring_cqe &cqe = cqes_[head & cq_mask_];
+        user_data = cqe.user_data;
+        result = cqe.res;
+        std::atomic_ref<unsigned>(*cq_head_).store(head + 1,
+                                                   std::memory_order_release);
+        return true;
+      }
+      if (enter(0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+        return false;
+      }
+    }
+  }
+
+private:
+  void *map_ring(size_t len, off_t offset) const noexcept {
+    void *p = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, ring_fd_, offset);
+    return p == MAP_FAILED ? nullptr : p;
+  }
+
+  long enter(unsigned to_submit, unsigned min_complete,
+             unsigned flags) const noexcept {
+    return syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete,
+                   flags, nullptr, 0);
+  }
+
+  int ring_fd_ = -1;
+  bool single_mmap_ = false;
+  void *sq_ring_ = nullptr;
+  void *cq_ring_ = nullptr;
+  size_t sq_len_ = 0;
+  size_t cq_len_ = 0;
+  size_t sqes_len_ = 0;
+  io_uring_sqe *sqes_ = nullptr;
+  unsigned *sq_head_ = nullptr;
+  unsigned *sq_tail_ = nullptr;
+  unsigned *sq_array_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned sq_entries_ = 0;
+  unsigned *cq_head_ = nullptr;
+  unsigned *cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  io_uring_cqe *cqes_ = nullptr;
+};
+
+} // namespace detail
+
+// ============================================================================
+// Chunked File Class
+// ============================================================================
+
+/**
+ * @brief Streams a file front to back through a ring of buffers.
+ *
+ * Chunk k holds bytes [k * buffer_bytes(), (k + 1) * buffer_bytes()) and
+ * stays valid until the following next(); only the last chunk is short.
+ * Not movable: the pread thread refers to the object.
+ */
+class ChunkedFile {
+public:
+  /// Alignment of buffers, lengths and offsets (O_DIRECT requirement)
+  static constexpr size_t kAlignment = 4096;
+
+  ChunkedFile() = default;
+  ~ChunkedFile() { close(); }
+
+  ChunkedFile(const ChunkedFile &) = delete;
+  ChunkedFile &operator=(const ChunkedFile &) = delete;
+
+  /**
+   * @brief Open `filename` and allocate the buffer ring.
+   * @return false if the file is missing or empty, the buffers cannot be
+   *         allocated, or StreamBackend::IoUring was demanded and refused.
+   */
+  bool open(const char *filename, const StreamOptions &options = {}) {
+    close();
+
+    direct_ = false;
+    int fd = -1;
+    if (options.direct) {
+      fd = ::open(filename, O_RDONLY | O_DIRECT);
+      direct_ = fd >= 0; // tmpfs and friends refuse O_DIRECT
+    }
+    if (fd < 0) {
+      fd = ::open(filename, O_RDONLY);
+    }
+    if (fd < 0) {
+      return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size <= 0) {
+      ::close(fd);
+      return false;
+    }
+    fd_ = fd;
+    size_ = static_cast<uint64_t>(st.st_size);
+
+    buffer_bytes_ = options.buffer_bytes < kAlignment ? kAlignment
+                                                      : options.buffer_bytes;
+    buffer_bytes_ = (buffer_bytes_ + kAlignment - 1) & ~(kAlignment - 1);
+    buffer_count_ = options.buffer_count < 2 ? 2 : options.buffer_count;
+    chunk_count_ = (size_ + buffer_bytes_ - 1) / buffer_bytes_;
+
+    // Faulted in now, so the ring never page-faults while streaming
+    void *ring = mmap(nullptr, buffer_bytes_ * buffer_count_,
+                      PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (ring == MAP_FAILED) {
+      close();
+      return false;
+    }
+    ring_ = static_cast<char *>(ring);
+    lengths_.assign(buffer_count_, 0);
+    ready_.assign(buffer_count_, 0);
+
+    backend_ = StreamBackend::Pread;
+    if (options.backend != StreamBackend::Pread) {
+      if (uring_.init(static_cast<unsigned>(buffer_count_))) {
+        backend_ = StreamBackend::IoUring;
+      } else if (options.backend == StreamBackend::IoUring) {
+        close();
+        return false;
+      }
+    }
+    if (!direct_) {
+      posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Stop any I/O in flight, free the ring and close the file.
+   */
+  void close() noexcept {
+    stop();
+    uring_.close();
+    if (ring_ != nullptr) {
+      munmap(ring_, buffer_bytes_ * buffer_count_);
+      ring_ = nullptr;
+    }
+    if (fd_ >= 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+    size_ = 0;
+    chunk_count_ = 0;
+  }
+
+  /**
+   * @brief (Re)start streaming from the beginning of the file.
+   */
+  bool start() {
+    if (!is_open()) {
+      return false;
+    }
+    stop();
+    failed_ = false;
+    current_ = kNone;
+    submitted_ = 0;
+
+    if (backend_ == StreamBackend::IoUring) {
+      std::fill(ready_.begin(), ready_.end(), 0);
+      while (submitted_ < chunk_count_ && submitted_ < buffer_count_) {
+        if (!submit(submitted_)) {
+          return false;
+        }
+      }
+    } else {
+      filled_.store(0, std::memory_order_relaxed);
+      released_.store(0, std::memory_order_relaxed);
+      stop_.store(false, std::memory_order_relaxed);
+      io_thread_ = std::thread(&ChunkedFile::run_pread, this);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Hand back the previous chunk and return the next one.
+   * @return false at end of file or on an I/O error (see failed()).
+   */
+  bool next(const char *&data, size_t &length) {
+    uint64_t chunk = 0;
+    if (current_ != kNone) {
+      release(current_);
+      chunk = current_ + 1;
+    }
+    current_ = chunk;
+    if (failed_ || chunk >= chunk_count_) {
+      return false;
+    }
+
+    const size_t slot = chunk % buffer_count_;
+    if (backend_ == StreamBackend::IoUring) {
+      while (ready_[slot] == 0) {
+        if (!reap()) {
+          failed_ = true;
+          return false;
+        }
+      }
+      ready_[slot] = 0;
+    } else {
+      uint64_t filled = filled_.load(std::memory_order_acquire);
+      while (filled <= chunk) {
+        filled_.wait(filled, std::memory_order_acquire);
+        filled = filled_.load(std::memory_order_acquire);
+      }
+    }
+
+    const int64_t got = lengths_[slot];
+    if (got < 0 || static_cast<uint64_t>(got) != expected(chunk)) {
+      failed_ = true;
+      return false;
+    }
+    data = ring_ + slot * buffer_bytes_;
+    length = static_cast<size_t>(got);
+    return true;
+  }
+
+  [[nodiscard]] bool is_open() const noexcept { return fd_ >= 0; }
+  [[nodiscard]] uint64_t size() const noexcept { return size_; }
+  [[nodiscard]] StreamBackend backend() const noexcept { return backend_; }
+  [[nodiscard]] bool direct() const noexcept { return direct_; }
+  [[nodiscard]] size_t buffer_bytes() const noexcept { return buffer_bytes_; }
+  [[nodiscard]] size_t buffer_count() const noexcept { return buffer_count_; }
+
+  /**
+   * @brief True once a read failed or came back short.
+   */
+  [[nodiscard]] bool failed() const noexcept { return failed_; }
+
+  /**
+   * @brief Buffer memory held for the life of the object.
+   */
+  [[nodiscard]] size_t memory_bytes() const noexcept {
+    return buffer_bytes_ * buffer_count_;
+  }
+
+private:
+  static constexpr uint64_t kNone = ~uint64_t{0};
+
+  [[nodiscard]] uint64_t expected(uint64_t chunk) const noexcept {
+    const uint64_t offset = chunk * buffer_bytes_;
+    return size_ - offset < buffer_bytes_ ? size_ - offset : buffer_bytes_;
+  }
+
+  bool submit(uint64_t chunk) noexcept {
+    const size_t slot = chunk % buffer_count_;
+    // Always a whole buffer: O_DIRECT needs aligned lengths, and the
+    // kernel stops at end of file
+    if (!uring_.read(fd_, ring_ + slot * buffer_bytes_,
+                     static_cast<unsigned>(buffer_bytes_),
+                     chunk * buffer_bytes_, chunk)) {
+      failed_ = true;
+      return false;
+    }
+    ++submitted_;
+    ++in_flight_;
+    return true;
+  }
+
+  /**
+   * @brief Pop one completion and finish its chunk (short reads are
+   *        completed synchronously).
+   */
+  bool reap() noexcept {
+    uint64_t chunk = 0;
+    int result = 0;
+    if (!uring_.wait(chunk, result)) {
+      return false;
+    }
+    --in_flight_;
+    const size_t slot = chunk % buffer_count_;
+    int64_t got = result;
+    if (got >= 0 && static_cast<uint64_t>(got) < expected(chunk)) {
+      got = read_at(slot, chunk, static_cast<size_t>(got));
+    }
+    lengths_[slot] = got;
+    ready_[slot] = 1;
+    return true;
+  }
+
+  /**
+   * @brief pread() the rest of `chunk` into its slot from byte `done`.
+   * @return Bytes in the slot, or -1 on error.
+   */
+  int64_t read_at(size_t slot, uint64_t chunk, size_t done) noexcept {
+    char *buf = ring_ + slot * buffer_bytes_;
+    const uint64_t want = expected(chunk);
+    while (done < want) {
+      const ssize_t n =
+          pread(fd_, buf + done, buffer_bytes_ - done,
+                static_cast<off_t>(chunk * buffer_bytes_ + done));
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n <= 0) {
+        return -1;
+      }
+      done += static_cast<size_t>(n);
+    }
+    return static_cast<int64_t>(done);
+  }
+
+  /**
+   * @brief Recycle the slot of a consumed chunk for a later one.
+   */
+  void release(uint64_t chunk) noexcept {
+    if (!direct_) {
+      // Keep the page cache from filling with bytes already parsed
+      posix_fadvise(fd_, static_cast<off_t>(chunk * buffer_bytes_),
+                    static_cast<off_t>(buffer_bytes_), POSIX_FADV_DONTNEED);
+    }
+    if (backend_ == StreamBackend::IoUring) {
+      if (!failed_ && submitted_ < chunk_count_) {
+        (void)submit(submitted_);
+      }
+    } else {
+      released_.store(chunk + 1, std::memory_order_release);
+      released_.notify_one();
+    }
+  }
+
+  /**
+   * @brief Pread backend: fill slots in order, staying within the ring.
+   */
+  void run_pread() noexcept {
+    for (uint64_t chunk = 0; chunk < chunk_count_; ++chunk) {
+      uint64_t released = released_.load(std::memory_order_acquire);
+      while (chunk - released >= buffer_count_) {
+        if (stop_.load(std::memory_order_relaxed)) {
+          return;
+        }
+        released_.wait(released, std::memory_order_acquire);
+        released = released_.load(std::memory_order_acquire);
+      }
+      if (stop_.load(std::memory_order_relaxed)) {
+        return;
+      }
+      const size_t slot = chunk % buffer_count_;
+      lengths_[slot] = read_at(slot, chunk, 0);
+      filled_.store(chunk + 1, std::memory_order_release);
+      filled_.notify_one();
+    }
+  }
+
+  /**
+   * @brief Wait out any reads still in flight.
+   */
+  void stop() noexcept {
+    if (io_thread_.joinable()) {
+      stop_.store(true, std::memory_order_relaxed);
+      released_.fetch_add(buffer_count_, std::memory_order_release);
+      released_.notify_one();
+      io_thread_.join();
+    }
+    uint64_t chunk = 0;
+    int result = 0;
+    while (in_flight_ > 0 && uring_.wait(chunk, result)) {
+      --in_flight_;
+    }
+    in_flight_ = 0;
+  }
+
+  int fd_ = -1;
+  uint64_t size_ = 0;
+  bool direct_ = false;
+  bool failed_ = false;
+  StreamBackend backend_ = StreamBackend::Pread;
+
+  char *ring_ = nullptr;
+  size_t buffer_bytes_ = 0;
+  size_t buffer_count_ = 0;
+  uint64_t chunk_count_ = 0;
+  std::vector<int64_t> lengths_; ///< Bytes read into each slot, -1 = error
+  uint64_t current_ = kNone;     ///< Chunk held by the consumer
+
+  // IoUring backend
+  detail::IoUring uring_;
+  std::vector<uint8_t> ready_; ///< Slot's read has completed
+  uint64_t submitted_ = 0;     ///< Chunks queued so far
+  size_t in_flight_ = 0;
+
+  // Pread backend
+  std::thread io_thread_;
+  std::atomic<uint64_t> filled_{0};   ///< Chunks read by the I/O thread
+  std::atomic<uint64_t> released_{0}; ///< Chunks handed back
+  std::atomic<bool> stop_{false};
+};
+
+} // namespace itch
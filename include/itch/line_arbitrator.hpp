@@ -0,0 +1,214 @@
+#pragma once
+
+/**
+ * @file line_arbitrator.hpp
+ * @brief A/B feed line arbitration across two redundant captures.
+ *
+ * DESIGN PRINCIPLES:
+ * 1. Sequence-driven merge: the two captures are walked in step, always
+ *    taking the packet with the lower MoldUDP64 sequence number next, so a
+ *    message one line dropped is filled from the other before either line
+ *    moves past it. Capture clocks only break ties, which makes the merge
+ *    immune to skew between the two capture hosts.
+ * 2. Exactly once: a single MoldUdp64Decoder sees the merged packet stream
+ *    and drops whatever the other line already delivered, including the
+ *    overlapping prefix of packets the two lines framed differently.
+ * 3. Zero-copy: packets are pulled from both mappings with next_packet()
+ *    and message blocks go to the Parser in place.
+ * 4. Per-line accounting: each line also tracks its own next sequence
+ *    (from packet headers only), so its drops are counted even when the
+ *    other line covered them.
+ *
+ * USAGE:
+ *   PcapReader a("feed_a.pcap");
+ *   PcapReader b("feed_b.pcap");
+ *   LineArbitrator<> arb(a, b);
+ *   arb.run_itch(visitor);                 // Each message once
+ *   arb.line_stats(1).missed_messages;     // Drops on line B
+ *   arb.merged().stats().missed_messages;  // Lost on both lines
+ */
+
+#include "moldudp64.hpp"
+#include "net_decoder.hpp"
+#include "pcap_reader.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace itch {
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+/**
+ * @brief Counters for one input line of a LineArbitrator.
+ */
+struct LineStats {
+  uint64_t packets = 0;         ///< MoldUDP64 packets read from the line
+  uint64_t skipped = 0;         ///< Packets that were not MoldUDP64 over UDP
+  uint64_t wins = 0;            ///< Messages this line delivered first
+  uint64_t gaps = 0;            ///< Sequence gaps on this line alone
+  uint64_t missed_messages = 0; ///< Messages this line dropped
+};
+
+// ============================================================================
+// Line Arbitrator Class
+// ============================================================================
+
+/**
+ * @brief Merge two captures of the same MoldUDP64 feed into one stream.
+ *
+ * Each capture must be in sequence order on its own (as captured). Packets
+ * of different sessions are merged by capture time. Per-line gap counts
+ * follow one session at a time, as in a day's feed.
+ *
+ * @tparam MaxSessions Session table capacity of the merged decoder.
+ */
+template <std::size_t MaxSessions = 4> class LineArbitrator {
+public:
+  /// Number of input lines
+  static constexpr size_t kLines = 2;
+
+  /**
+   * @brief Arbitrate line A (`a`) and line B (`b`); both must outlive this.
+   */
+  LineArbitrator(const PcapReader &a, const PcapReader &b) noexcept
+      : lines_{Line{&a, UdpDecoder(a.link_type()), a.first_packet()},
+               Line{&b, UdpDecoder(b.link_type()), b.first_packet()}} {}
+
+  /**
+   * @brief Merge both lines to the end, passing each new message block to
+   *        `handler.on_message(data, len)` (and MoldUDP64 hooks, as in
+   *        MoldUdp64Decoder::decode()). Gaps reported are messages lost
+   *        on both lines.
+   * @return Packets passed to the merged decoder.
+   */
+  template <typename Handler> size_t run(Handler &handler) noexcept {
+    return merge([&](const UdpDatagram &udp) {
+      (void)merged_.decode(udp.payload, udp.length, handler);
+    });
+  }
+
+  /**
+   * @brief As run(), parsing each block as an ITCH message for `visitor`.
+   */
+  template <typename Visitor> size_t run_itch(Visitor &visitor) noexcept {
+    return merge([&](const UdpDatagram &udp) {
+      (void)merged_.decode_itch(udp.payload, udp.length, visitor);
+    });
+  }
+
+  /**
+   * @brief Counters for line 0 (A) or 1 (B).
+   */
+  [[nodiscard]] const LineStats &line_stats(size_t line) const noexcept {
+    return lines_[line].stats;
+  }
+
+  /// Decoder of the merged stream: its gaps are losses on both lines
+  [[nodiscard]] const MoldUdp64Decoder<MaxSessions> &merged() const noexcept {
+    return merged_;
+  }
+
+private:
+  struct Line {
+    const PcapReader *reader;
+    UdpDecoder net;
+    PacketCursor cursor{};
+    PacketRecord record{};
+    UdpDatagram udp{};
+    bool live = false; ///< `udp` holds the line's next MoldUDP64 packet
+    MoldSessionId session{};
+    uint64_t next_sequence = 0; ///< 0: no packet of `session` seen yet
+    LineStats stats{};
+  };
+
+  /**
+   * @brief Pull the line's next MoldUDP64 packet (or mark it finished).
+   */
+  static void advance(Line &line) noexcept {
+    while (line.reader->next_packet(line.cursor, line.record)) {
+      if (line.net.decode(line.record.data, line.record.length, line.udp) &&
+          is_moldudp64_packet(line.udp.payload, line.udp.length)) {
+        line.live = true;
+        return;
+      }
+      ++line.stats.skipped;
+    }
+    line.live = false;
+  }
+
+  [[nodiscard]] static const MoldUdp64Header &
+  header(const Line &line) noexcept {
+    return *reinterpret_cast<const MoldUdp64Header *>(line.udp.payload);
+  }
+
+  /**
+   * @brief Per-line gap check. The blocks were validated by advance(), so
+   *        the header's count can be trusted without walking them again.
+   */
+  static void track(Line &line) noexcept {
+    const MoldUdp64Header &h = header(line);
+    const uint64_t sequence = h.sequence_number;
+    const uint16_t count = h.message_count;
+    ++line.stats.packets;
+    if (!(h.session == line.session) || line.next_sequence == 0) {
+      line.session = h.session; // New session: no gap across it
+      line.next_sequence = sequence;
+    }
+    if (sequence > line.next_sequence) {
+      ++line.stats.gaps;
+      line.stats.missed_messages += sequence - line.next_sequence;
+    }
+    const uint64_t end =
+        count == kMoldHeartbeat || count == kMoldEndOfSession
+            ? sequence
+            : sequence + count;
+    if (end > line.next_sequence) {
+      line.next_sequence = end;
+    }
+  }
+
+  /**
+   * @brief Index of the line whose head packet goes next (both live).
+   */
+  [[nodiscard]] size_t pick() const noexcept {
+    const MoldUdp64Header &a = header(lines_[0]);
+    const MoldUdp64Header &b = header(lines_[1]);
+    if (a.session == b.session) {
+      const uint64_t seq_a = a.sequence_number;
+      const uint64_t seq_b = b.sequence_number;
+      if (seq_a != seq_b) {
+        return seq_a < seq_b ? 0 : 1;
+      }
+    }
+    // Same packet on both lines (or unrelated sessions): first captured
+    return lines_[1].record.ts_ns < lines_[0].record.ts_ns ? 1 : 0;
+  }
+
+  template <typename Deliver> size_t merge(Deliver &&deliver) noexcept {
+    size_t packets = 0;
+    advance(lines_[0]);
+    advance(lines_[1]);
+    while (lines_[0].live || lines_[1].live) {
+      const size_t next = !lines_[1].live   ? 0
+                          : !lines_[0].live ? 1
+                                            : pick();
+      Line &line = lines_[next];
+      track(line);
+
+      const uint64_t before = merged_.stats().messages;
+      deliver(line.udp);
+      line.stats.wins += merged_.stats().messages - before;
+      ++packets;
+      advance(line);
+    }
+    return packets;
+  }
+
+  std::array<Line, kLines> lines_;
+  MoldUdp64Decoder<MaxSessions> merged_{};
+};
+
+} // namespace itch
@@ -0,0 +1,382 @@
+#pragma once
+
+/**
+ * @file mapped_file.hpp
+ * @brief Read-only file mapping with selectable page-fault strategies.
+ *
+ * DESIGN PRINCIPLES:
+ * 1. Take the page faults before (or beside) the hot loop, never inside it:
+ *    a major fault on a cold page cache costs tens of microseconds and
+ *    lands in whatever latency the replay loop is measuring.
+ * 2. One owner for the fd/mapping so PcapReader and BinaryItchReader share
+ *    the same strategies.
+ * 3. Fault counts come from the kernel (getrusage), not estimates.
+ *
+ * Strategies:
+ *   Lazy      - mmap + MADV_SEQUENTIAL; pages fault in on first touch
+ *   Populate  - MAP_POPULATE: open() reads and maps the whole file
+ *   ReadAhead - a background thread madvise(WILLNEED)s and touches pages,
+ *               staying read_ahead_bytes ahead of the consumer
+ *   HugeCopy  - open() copies the file into anonymous hugepage memory
+ *               (MAP_HUGETLB, else transparent hugepages)
+ *
+ * USAGE:
+ *   PcapReader reader("day.pcap", {MapStrategy::ReadAhead, 256 << 20});
+ *   const FaultCounts before = thread_faults();
+ *   reader.for_each_packet(...);
+ *   const FaultCounts faults = thread_faults() - before;
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace itch {
+
+// ============================================================================
+// Options and Fault Accounting
+// ============================================================================
+
+/**
+ * @brief How the file's pages get into the address space.
+ */
+enum class MapStrategy : uint8_t {
+  Lazy,      ///< Demand paging (kernel read-ahead only)
+  Populate,  ///< MAP_POPULATE: fault everything in during open()
+  ReadAhead, ///< Background thread prefaults ahead of the consumer
+  HugeCopy   ///< Copy into anonymous hugepage memory during open()
+};
+
+/**
+ * @brief Mapping options for MappedFile (and the readers built on it).
+ */
+struct MapOptions {
+  MapStrategy strategy = MapStrategy::Lazy;
+  size_t read_ahead_bytes = size_t{64} << 20; ///< ReadAhead window
+};
+
+/**
+ * @brief Page faults taken by a thread.
+ */
+struct FaultCounts {
+  uint64_t minor = 0; ///< Served without I/O (page already in memory)
+  uint64_t major = 0; ///< Required I/O
+
+  [[nodiscard]] FaultCounts operator-(const FaultCounts &rhs) const noexcept {
+    return {minor - rhs.minor, major - rhs.major};
+  }
+};
+
+/**
+ * @brief Faults taken so far by the calling thread.
+ */
+[[nodiscard]] inline FaultCounts thread_faults() noexcept {
+  struct rusage usage {};
+  if (getrusage(RUSAGE_THREAD, &usage) != 0) {
+    return {};
+  }
+  return {static_cast<uint64_t>(usage.ru_minflt),
+          static_cast<uint64_t>(usage.ru_majflt)};
+}
+
+/**
+ * @brief Command-line name of a strategy.
+ */
+[[nodiscard]] constexpr const char *
+map_strategy_name(MapStrategy strategy) noexcept {
+  switch (strategy) {
+  case MapStrategy::Lazy:
+    return "lazy";
+  case MapStrategy::Populate:
+    return "populate";
+  case MapStrategy::ReadAhead:
+    return "readahead";
+  case MapStrategy::HugeCopy:
+    return "hugecopy";
+  }
+  return "?";
+}
+
+/**
+ * @brief Parse a name produced by map_strategy_name().
+ */
+[[nodiscard]] inline bool parse_map_strategy(const char *name,
+                                             MapStrategy &out) noexcept {
+  for (MapStrategy strategy : {MapStrategy::Lazy, MapStrategy::Populate,
+                               MapStrategy::ReadAhead, MapStrategy::HugeCopy}) {
+    if (std::strcmp(name, map_strategy_name(strategy)) == 0) {
+      out = strategy;
+      return true;
+    }
+  }
+  return false;
+}
+
+// ============================================================================
+// Mapped File Class
+// ============================================================================
+
+/**
+ * @brief Owns a read-only view of a whole file.
+ *
+ * Consumers that walk the file front to back report their position with
+ * consumed(); only the ReadAhead strategy uses it.
+ */
+class MappedFile {
+public:
+  /// Granularity of the read-ahead thread's madvise/touch steps
+  static constexpr size_t kReadAheadStep = size_t{2} << 20;
+
+  /// Explicit hugepage size used to round HugeCopy allocations
+  static constexpr size_t kHugePageSize = size_t{2} << 20;
+
+  MappedFile() = default;
+
+  ~MappedFile() { close(); }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  // Movable: the read-ahead thread only refers to heap state
+  MappedFile(MappedFile &&other) noexcept { take(other); }
+
+  MappedFile &operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+      close();
+      take(other);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Map `filename` with the given strategy.
+   * @return false if the file is missing, empty, or cannot be mapped.
+   */
+  bool open(const char *filename, const MapOptions &options = {}) {
+    close();
+
+    const int fd = ::open(filename, O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size <= 0) {
+      ::close(fd);
+      return false;
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    strategy_ = options.strategy;
+
+    const bool ok = strategy_ == MapStrategy::HugeCopy
+                        ? copy_to_hugepages(fd)
+                        : map_file(fd, options);
+    ::close(fd); // A mapping stays valid after its fd is closed
+    if (!ok) {
+      data_ = nullptr;
+      size_ = 0;
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Stop the read-ahead thread and unmap.
+   */
+  void close() noexcept {
+    if (read_ahead_) {
+      read_ahead_->stop.store(true, std::memory_order_relaxed);
+      read_ahead_->thread.join();
+      read_ahead_.reset();
+    }
+    if (data_ != nullptr) {
+      munmap(const_cast<char *>(data_), map_len_);
+      data_ = nullptr;
+    }
+    size_ = 0;
+    map_len_ = 0;
+    huge_pages_ = false;
+  }
+
+  [[nodiscard]] bool is_open() const noexcept { return data_ != nullptr; }
+  [[nodiscard]] const char *data() const noexcept { return data_; }
+  [[nodiscard]] size_t size() const noexcept { return size_; }
+  [[nodiscard]] MapStrategy strategy() const noexcept { return strategy_; }
+
+  /**
+   * @brief True if HugeCopy obtained explicit (MAP_HUGETLB) hugepages
+   *        rather than falling back to transparent hugepages.
+   */
+  [[nodiscard]] bool huge_pages() const noexcept { return huge_pages_; }
+
+  /**
+   * @brief Report that bytes before `offset` have been consumed.
+   */
+  void consumed(size_t offset) const noexcept {
+    if (read_ahead_) {
+      read_ahead_->consumer.store(offset, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Bytes the read-ahead thread has faulted in (size() once done;
+   *        always size() for the other strategies).
+   */
+  [[nodiscard]] size_t prefetched() const noexcept {
+    if (read_ahead_) {
+      return read_ahead_->prefetched.load(std::memory_order_acquire);
+    }
+    return size_;
+  }
+
+  /**
+   * @brief madvise(WILLNEED) calls the read-ahead thread saw fail (0 for
+   *        the other strategies). The thread still touches those pages.
+   */
+  [[nodiscard]] size_t read_ahead_errors() const noexcept {
+    if (read_ahead_) {
+      return read_ahead_->advise_errors.load(std::memory_order_relaxed);
+    }
+    return 0;
+  }
+
+private:
+  struct ReadAheadState {
+    std::atomic<size_t> consumer{0};
+    std::atomic<size_t> prefetched{0};
+    std::atomic<size_t> advise_errors{0}; ///< Failed madvise(WILLNEED)s
+    std::atomic<bool> stop{false};
+    std::thread thread;
+  };
+
+  bool map_file(int fd, const MapOptions &options) {
+    const int flags = MAP_PRIVATE | (strategy_ == MapStrategy::Populate
+                                         ? MAP_POPULATE
+                                         : 0);
+    void *addr = mmap(nullptr, size_, PROT_READ, flags, fd, 0);
+    if (addr == MAP_FAILED) {
+      return false;
+    }
+    data_ = static_cast<const char *>(addr);
+    map_len_ = size_;
+
+    // Replay scans front to back: ask for aggressive kernel read-ahead
+    madvise(addr, size_, MADV_SEQUENTIAL);
+
+    if (strategy_ == MapStrategy::ReadAhead) {
+      const size_t window = options.read_ahead_bytes > kReadAheadStep
+                                ? options.read_ahead_bytes
+                                : kReadAheadStep;
+      read_ahead_ = std::make_unique<ReadAheadState>();
+      read_ahead_->thread = std::thread(run_read_ahead, read_ahead_.get(),
+                                        data_, size_, window);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Anonymous (huge)page buffer filled with read(): every page is
+   *        faulted here, none later.
+   */
+  bool copy_to_hugepages(int fd) {
+    map_len_ = (size_ + kHugePageSize - 1) & ~(kHugePageSize - 1);
+    constexpr int kAnon = MAP_PRIVATE | MAP_ANONYMOUS;
+    void *addr = mmap(nullptr, map_len_, PROT_READ | PROT_WRITE,
+                      kAnon | MAP_HUGETLB, -1, 0);
+    huge_pages_ = addr != MAP_FAILED;
+    if (!huge_pages_) {
+      // No reserved hugepages: transparent hugepages if the kernel allows
+      addr = mmap(nullptr, map_len_, PROT_READ | PROT_WRITE, kAnon, -1, 0);
+      if (addr == MAP_FAILED) {
+        return false;
+      }
+      madvise(addr, map_len_, MADV_HUGEPAGE);
+    }
+    data_ = static_cast<const char *>(addr);
+
+    char *dst = static_cast<char *>(addr);
+    size_t done = 0;
+    while (done < size_) {
+      const ssize_t n = pread(fd, dst + done, size_ - done,
+                              static_cast<off_t>(done));
+      if (n <= 0) {
+        munmap(addr, map_len_);
+        map_len_ = 0;
+        huge_pages_ = false;
+        return false;
+      }
+      done += static_cast<size_t>(n);
+    }
+    mprotect(addr, map_len_, PROT_READ);
+    return true;
+  }
+
+  /**
+   * @brief Keep [consumer, consumer + window) resident and mapped.
+   *
+   * Touching one byte per page installs the page-table entries in this
+   * thread, so the consumer neither waits for I/O nor takes minor faults.
+   */
+  static void run_read_ahead(ReadAheadState *state, const char *data,
+                             size_t size, size_t window) noexcept {
+    const auto page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t ahead = 0;
+
+    while (ahead < size && !state->stop.load(std::memory_order_relaxed)) {
+      const size_t consumer =
+          state->consumer.load(std::memory_order_relaxed);
+      // consumer is any byte offset: round up so every step (and so
+      // `ahead`) stays page-aligned, as madvise() requires of its address
+      const size_t end = (consumer + window + page - 1) & ~(page - 1);
+      const size_t target = end < size ? end : size;
+      if (ahead >= target) {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+        continue;
+      }
+
+      const size_t step =
+          target - ahead < kReadAheadStep ? target - ahead : kReadAheadStep;
+      if (madvise(const_cast<char *>(data + ahead), step, MADV_WILLNEED) !=
+          0) {
+        state->advise_errors.fetch_add(1, std::memory_order_relaxed);
+      }
+      uint8_t sink = 0;
+      for (size_t off = ahead; off < ahead + step; off += page) {
+        sink ^= static_cast<uint8_t>(
+            *static_cast<const volatile char *>(data + off));
+      }
+      (void)sink;
+      ahead += step;
+      state->prefetched.store(ahead, std::memory_order_release);
+    }
+  }
+
+  void take(MappedFile &other) noexcept {
+    data_ = other.data_;
+    size_ = other.size_;
+    map_len_ = other.map_len_;
+    strategy_ = other.strategy_;
+    huge_pages_ = other.huge_pages_;
+    read_ahead_ = std::move(other.read_ahead_);
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.map_len_ = 0;
+  }
+
+  const char *data_ = nullptr;
+  size_t size_ = 0;
+  size_t map_len_ = 0; ///< Mapped length (HugeCopy rounds up)
+  MapStrategy strategy_ = MapStrategy::Lazy;
+  bool huge_pages_ = false;
+  std::unique_ptr<ReadAheadState> read_ahead_;
+};
+
+} // namespace itch
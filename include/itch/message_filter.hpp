@@ -0,0 +1,90 @@
+#pragma once
+
+/**
+ * @file message_filter.hpp
+ * @brief Select ITCH messages by stock locate, message type and time.
+ *
+ * DESIGN PRINCIPLES:
+ * 1. Header-only test: every criterion reads the common 11-byte message
+ *    header, so no message is parsed to decide.
+ * 2. Branch-light sets: locates and types are flat bitsets, one load each.
+ * 3. Criteria combine with AND; a criterion never configured passes all.
+ *
+ * USAGE:
+ *   MessageFilter filter;
+ *   filter.add_locate(13);                       // One security
+ *   filter.add_type('A');                        // Adds only
+ *   filter.set_window(34'200 * kNanosPerSecond,  // 09:30 -
+ *                     36'000 * kNanosPerSecond); // 10:00
+ *   if (filter.matches(msg, len)) { ... }
+ */
+
+#include "messages.hpp"
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace itch {
+
+/// Nanoseconds per second, for ITCH time-of-day arithmetic
+inline constexpr uint64_t kNanosPerSecond = 1'000'000'000;
+
+/**
+ * @brief Locate / type / time-of-day predicate over raw ITCH messages.
+ */
+class MessageFilter {
+public:
+  void add_locate(uint16_t locate) noexcept {
+    locates_.set(locate);
+    by_locate_ = true;
+  }
+
+  void add_type(char type) noexcept {
+    types_.set(static_cast<unsigned char>(type));
+    by_type_ = true;
+  }
+
+  /**
+   * @brief Keep messages stamped in [from_ns, to_ns), ns since midnight.
+   */
+  void set_window(uint64_t from_ns, uint64_t to_ns) noexcept {
+    from_ns_ = from_ns;
+    to_ns_ = to_ns;
+  }
+
+  /// True if no criterion is set (every message matches)
+  [[nodiscard]] bool accepts_all() const noexcept {
+    return !by_locate_ && !by_type_ && from_ns_ == 0 &&
+           to_ns_ == std::numeric_limits<uint64_t>::max();
+  }
+
+  /**
+   * @brief Test one message (type byte first, no length prefix).
+   * @return false for messages shorter than the common header.
+   */
+  [[nodiscard]] bool matches(const char *msg, size_t len) const noexcept {
+    if (len < sizeof(MessageHeader)) {
+      return false;
+    }
+    const auto *header = reinterpret_cast<const MessageHeader *>(msg);
+    if (by_type_ && !types_.test(static_cast<unsigned char>(msg[0]))) {
+      return false;
+    }
+    if (by_locate_ && !locates_.test(header->stock_locate)) {
+      return false;
+    }
+    const uint64_t ts = header->timestamp.nanoseconds();
+    return ts >= from_ns_ && ts < to_ns_;
+  }
+
+private:
+  std::bitset<65536> locates_;
+  std::bitset<256> types_;
+  bool by_locate_ = false;
+  bool by_type_ = false;
+  uint64_t from_ns_ = 0;
+  uint64_t to_ns_ = std::numeric_limits<uint64_t>::max();
+};
+
+} // namespace itch
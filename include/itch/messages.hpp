@@ -9,6 +9,8 @@
  * 2. BigEndian<T> wrapper provides transparent byte-swap on access.
  * 3. No memcpy, no allocations - direct reinterpret_cast from buffer.
  * 4. Fields are swapped lazily on operator T(), not all at once.
+ * 5. Each message struct carries its wire type byte as kMsgType, which
+ *    registry.hpp uses to build size/validity/dispatch tables.
  *
  * USAGE:
  *   const auto* msg = reinterpret_cast<const AddOrder*>(buffer);
@@ -41,7 +43,7 @@ namespace itch {
  *   BigEndian<uint32_t> price;  // Stored as big-endian
  *   uint32_t host_price = price;  // Swapped to host order on access
  */
-template <typename T> class BigEndian {
+template <typename T> class __attribute__((packed)) BigEndian {
   static_assert(std::is_integral_v<T>, "BigEndian<T> requires integral type");
   static_assert(std::is_unsigned_v<T>, "BigEndian<T> requires unsigned type");
 
@@ -189,6 +191,10 @@ inline constexpr char Trade = 'P';
 inline constexpr char CrossTrade = 'Q';
 inline constexpr char BrokenTrade = 'B';
 inline constexpr char NOII = 'I';
+inline constexpr char RetailPriceImprovement = 'N';
+inline constexpr char LULDAuctionCollar = 'J';
+inline constexpr char OperationalHalt = 'h';
+inline constexpr char DirectListingCapitalRaise = 'O';
 } // namespace msg_type
 
 // ============================================================================
@@ -217,6 +223,363 @@ static_assert(offsetof(MessageHeader, stock_locate) == 1);
 static_assert(offsetof(MessageHeader, tracking_number) == 3);
 static_assert(offsetof(MessageHeader, timestamp) == 5);
 
+// ============================================================================
+// System Event Message (Type 'S')
+// ============================================================================
+
+/**
+ * @brief System Event message signalling a market or data feed handler event.
+ *
+ * Total size: 12 bytes
+ *
+ * Layout:
+ *   Offset  0: Message Type (1 byte) = 'S'
+ *   Offset  1: Stock Locate (2 bytes) - always 0
+ *   Offset  3: Tracking Number (2 bytes)
+ *   Offset  5: Timestamp (6 bytes)
+ *   Offset 11: Event Code (1 byte) 'O','S','Q','M','E','C'
+ */
+struct __attribute__((packed)) SystemEvent {
+  static constexpr char kMsgType = itch::msg_type::SystemEvent;
+
+  char msg_type;          // Offset 0: 'S'
+  be_u16 stock_locate;    // Offset 1
+  be_u16 tracking_number; // Offset 3
+  Timestamp48 timestamp;  // Offset 5
+
+  char event_code; // Offset 11: 'O' = Start of Messages, 'C' = End, etc.
+
+  [[nodiscard]] const MessageHeader &header() const noexcept {
+    return *reinterpret_cast<const MessageHeader *>(this);
+  }
+};
+
+static_assert(sizeof(SystemEvent) == 12, "SystemEvent must be 12 bytes");
+static_assert(offsetof(SystemEvent, event_code) == 11);
+
+// ============================================================================
+// Stock Directory Message (Type 'R')
+// ============================================================================
+
+/**
+ * @brief Stock Directory message, one per security at start of day.
+ *
+ * Total size: 39 bytes
+ *
+ * Layout:
+ *   Offset  0: Header (11 bytes)
+ *   Offset 11: Stock (8 bytes)
+ *   Offset 19: Market Category (1 byte)
+ *   Offset 20: Financial Status Indicator (1 byte)
+ *   Offset 21: Round Lot Size (4 bytes)
+ *   Offset 25: Round Lots Only (1 byte)
+ *   Offset 26: Issue Classification (1 byte)
+ *   Offset 27: Issue Sub-Type (2 bytes, ASCII)
+ *   Offset 29: Authenticity (1 byte)
+ *   Offset 30: Short Sale Threshold Indicator (1 byte)
+ *   Offset 31: IPO Flag (1 byte)
+ *   Offset 32: LULD Reference Price Tier (1 byte)
+ *   Offset 33: ETP Flag (1 byte)
+ *   Offset 34: ETP Leverage Factor (4 bytes)
+ *   Offset 38: Inverse Indicator (1 byte)
+ */
+struct __attribute__((packed)) StockDirectory {
+  static constexpr char kMsgType = itch::msg_type::StockDirectory;
+
+  char msg_type;          // Offset 0: 'R'
+  be_u16 stock_locate;    // Offset 1
+  be_u16 tracking_number; // Offset 3
+  Timestamp48 timestamp;  // Offset 5
+
+  StockSymbol stock;                   // Offset 11
+  char market_category;                // Offset 19
+  char financial_status_indicator;     // Offset 20
+  be_u32 round_lot_size;               // Offset 21
+  char round_lots_only;                // Offset 25
+  char issue_classification;           // Offset 26
+  char issue_sub_type[2];              // Offset 27
+  char authenticity;                   // Offset 29: 'P' = Live, 'T' = Test
+  char short_sale_threshold_indicator; // Offset 30
+  char ipo_flag;                       // Offset 31
+  char luld_reference_price_tier;      // Offset 32
+  char etp_flag;                       // Offset 33
+  be_u32 etp_leverage_factor;          // Offset 34
+  char inverse_indicator;              // Offset 38
+};
+
+static_assert(sizeof(StockDirectory) == 39, "StockDirectory must be 39 bytes");
+static_assert(offsetof(StockDirectory, stock) == 11);
+static_assert(offsetof(StockDirectory, round_lot_size) == 21);
+static_assert(offsetof(StockDirectory, etp_leverage_factor) == 34);
+static_assert(offsetof(StockDirectory, inverse_indicator) == 38);
+
+// ============================================================================
+// Stock Trading Action Message (Type 'H')
+// ============================================================================
+
+/**
+ * @brief Trading state change (halt, pause, quotation, trading) for a stock.
+ *
+ * Total size: 25 bytes
+ *
+ * Layout:
+ *   Offset  0: Header (11 bytes)
+ *   Offset 11: Stock (8 bytes)
+ *   Offset 19: Trading State (1 byte) 'H','P','Q','T'
+ *   Offset 20: Reserved (1 byte)
+ *   Offset 21: Reason (4 bytes, ASCII)
+ */
+struct __attribute__((packed)) StockTradingAction {
+  static constexpr char kMsgType = itch::msg_type::StockTradingAction;
+
+  char msg_type;          // Offset 0: 'H'
+  be_u16 stock_locate;    // Offset 1
+  be_u16 tracking_number; // Offset 3
+  Timestamp48 timestamp;  // Offset 5
+
+  StockSymbol stock;  // Offset 11
+  char trading_state; // Offset 19
+  char reserved;      // Offset 20
+  char reason[4];     // Offset 21
+};
+
+static_assert(sizeof(StockTradingAction) == 25,
+              "StockTradingAction must be 25 bytes");
+static_assert(offsetof(StockTradingAction, trading_state) == 19);
+static_assert(offsetof(StockTradingAction, reason) == 21);
+
+// ============================================================================
+// Reg SHO Short Sale Price Test Restricted Indicator (Type 'Y')
+// ============================================================================
+
+/**
+ * @brief Reg SHO short sale restriction status for a stock.
+ *
+ * Total size: 20 bytes
+ *
+ * Layout:
+ *   Offset  0: Header (11 bytes)
+ *   Offset 11: Stock (8 bytes)
+ *   Offset 19: Reg SHO Action (1 byte) '0','1','2'
+ */
+struct __attribute__((packed)) RegSHORestriction {
+  static constexpr char kMsgType = itch::msg_type::RegSHORestriction;
+
+  char msg_type;          // Offset 0: 'Y'
+  be_u16 stock_locate;    // Offset 1
+  be_u16 tracking_number; // Offset 3
+  Timestamp48 timestamp;  // Offset 5
+
+  StockSymbol stock;   // Offset 11
+  char reg_sho_action; // Offset 19
+};
+
+static_assert(sizeof(RegSHORestriction) == 20,
+              "RegSHORestriction must be 20 bytes");
+static_assert(offsetof(RegSHORestriction, reg_sho_action) == 19);
+
+// ============================================================================
+// Market Participant Position Message (Type 'L')
+// ============================================================================
+
+/**
+ * @brief Market maker registration status for a stock.
+ *
+ * Total size: 26 bytes
+ *
+ * Layout:
+ *   Offset  0: Header (11 bytes)
+ *   Offset 11: MPID (4 bytes, ASCII)
+ *   Offset 15: Stock (8 bytes)
+ *   Offset 23: Primary Market Maker (1 byte) 'Y' or 'N'
+ *   Offset 24: Market Maker Mode (1 byte)
+ *   Offset 25: Market Participant State (1 byte)
+ */
+struct __attribute__((packed)) MarketParticipantPosition {
+  static constexpr char kMsgType = itch::msg_type::MarketParticipantPosition;
+
+  char msg_type;          // Offset 0: 'L'
+  be_u16 stock_locate;    // Offset 1
+  be_u16 tracking_number; // Offset 3
+  Timestamp48 timestamp;  // Offset 5
+
+  char mpid[4];                  // Offset 11
+  StockSymbol stock;             // Offset 15
+  char primary_market_maker;     // Offset 23
+  char market_maker_mode;        // Offset 24
+  char market_participant_state; // Offset 25
+};
+
+static_assert(sizeof(MarketParticipantPosition) == 26,
+              "MarketParticipantPosition must be 26 bytes");
+static_assert(offsetof(MarketParticipantPosition, stock) == 15);
+static_assert(offsetof(MarketParticipantPosition, market_participant_state) ==
+              25);
+
+// ============================================================================
+// MWCB Decline Level Message (Type 'V')
+// ============================================================================
+
+/**
+ * @brief Market-wide circuit breaker decline levels for the day.
+ *
+ * Total size: 35 bytes
+ *
+ * Layout:
+ *   Offset  0: Header (11 bytes)
+ *   Offset 11: Level 1 (8 bytes) - price * 1e8 (8 decimal places)
+ *   Offset 19: Level 2 (8 bytes)
+ *   Offset 27: Level 3 (8 bytes)
+ */
+struct __attribute__((packed)) MWCBDeclineLevel {
+  static constexpr char kMsgType = itch::msg_type::MWCBDeclineLevel;
+
+  char msg_type;          // Offset 0: 'V'
+  be_u16 stock_locate;    // Offset 1
+  be_u16 tracking_number; // Offset 3
+  Timestamp48 timestamp;  // Offset 5
+
+  be_u64 level1; // Offset 11
+  be_u64 level2; // Offset 19
+  be_u64 level3; // Offset 27
+};
+
+static_assert(sizeof(MWCBDeclineLevel) == 35,
+              "MWCBDeclineLevel must be 35 bytes");
+static_assert(offsetof(MWCBDeclineLevel, level1) == 11);
+static_assert(offsetof(MWCBDeclineLevel, level3) == 27);
+
+// ============================================================================
+// MWCB Status Message (Type 'W')
+// ============================================================================
+
+/**
+ * @brief Market-wide circuit breaker breach notification.
+ *
+ * Total size: 12 bytes
+ *
+ * Layout:
+ *   Offset  0: Header (11 bytes)
+ *   Offset 11: Breached Level (1 byte) '1','2','3'
+ */
+struct __attribute__((packed)) MWCBStatus {
+  static constexpr char kMsgType = itch::msg_type::MWCBStatus;
+
+  char msg_type;          // Offset 0: 'W'
+  be_u16 stock_locate;    // Offset 1
+  be_u16 tracking_number; // Offset 3
+  Timestamp48 timestamp;  // Offset 5
+
+  char breached_level; // Offset 11
+};
+
+static_assert(sizeof(MWCBStatus) == 12, "MWCBStatus must be 12 bytes");
+static_assert(offsetof(MWCBStatus, breached_level) == 11);
+
+// ============================================================================
+// IPO Quoting Period Update Message (Type 'K')
+// ============================================================================
+
+/**
+ * @brief Anticipated IPO quotation release time for a security.
+ *
+ * Total size: 28 bytes
+ *
+ * Layout:
+ *   Offset  0: Header (11 bytes)
+ *   Offset 11: Stock (8 bytes)
+ *   Offset 19: IPO Quotation Release Time (4 bytes) - seconds since midnight
+ *   Offset 23: IPO Quotation Release Qualifier (1 byte) 'A' or 'C'
+ *   Offset 24: IPO Price (4 bytes) - price * 10000
+ */
+struct __attribute__((packed)) IPOQuotingPeriod {
+  static constexpr char kMsgType = itch::msg_type::IPOQuotingPeriod;
+
+  char msg_type;          // Offset 0: 'K'
+  be_u16 stock_locate;    // Offset 1
+  be_u16 tracking_number; // Offset 3
+  Timestamp48 timestamp;  // Offset 5
+
+  StockSymbol stock;                    // Offset 11
+  be_u32 ipo_quotation_release_time;    // Offset 19
+  char ipo_quotation_release_qualifier; // Offset 23
+  be_u32 ipo_price;                     // Offset 24
+};
+
+static_assert(sizeof(IPOQuotingPeriod) == 28,
+              "IPOQuotingPeriod must be 28 bytes");
+static_assert(offsetof(IPOQuotingPeriod, ipo_quotation_release_qualifier) ==
+              23);
+static_assert(offsetof(IPOQuotingPeriod, ipo_price) == 24);
+
+// ============================================================================
+// LULD Auction Collar Message (Type 'J')
+// ============================================================================
+
+/**
+ * @brief Limit Up-Limit Down auction collar thresholds for a paused stock.
+ *
+ * Total size: 35 bytes
+ *
+ * Layout:
+ *   Offset  0: Header (11 bytes)
+ *   Offset 11: Stock (8 bytes)
+ *   Offset 19: Auction Collar Reference Price (4 bytes)
+ *   Offset 23: Upper Auction Collar Price (4 bytes)
+ *   Offset 27: Lower Auction Collar Price (4 bytes)
+ *   Offset 31: Auction Collar Extension (4 bytes)
+ */
+struct __attribute__((packed)) LULDAuctionCollar {
+  static constexpr char kMsgType = itch::msg_type::LULDAuctionCollar;
+
+  char msg_type;          // Offset 0: 'J'
+  be_u16 stock_locate;    // Offset 1
+  be_u16 tracking_number; // Offset 3
+  Timestamp48 timestamp;  // Offset 5
+
+  StockSymbol stock;                     // Offset 11
+  be_u32 auction_collar_reference_price; // Offset 19
+  be_u32 upper_auction_collar_price;     // Offset 23
+  be_u32 lower_auction_collar_price;     // Offset 27
+  be_u32 auction_collar_extension;       // Offset 31
+};
+
+static_assert(sizeof(LULDAuctionCollar) == 35,
+              "LULDAuctionCollar must be 35 bytes");
+static_assert(offsetof(LULDAuctionCollar, auction_collar_extension) == 31);
+
+// ============================================================================
+// Operational Halt Message (Type 'h')
+// ============================================================================
+
+/**
+ * @brief Operational halt or resumption on a specific market center.
+ *
+ * Total size: 21 bytes
+ *
+ * Layout:
+ *   Offset  0: Header (11 bytes)
+ *   Offset 11: Stock (8 bytes)
+ *   Offset 19: Market Code (1 byte) 'Q','B','X'
+ *   Offset 20: Operational Halt Action (1 byte) 'H' or 'T'
+ */
+struct __attribute__((packed)) OperationalHalt {
+  static constexpr char kMsgType = itch::msg_type::OperationalHalt;
+
+  char msg_type;          // Offset 0: 'h'
+  be_u16 stock_locate;    // Offset 1
+  be_u16 tracking_number; // Offset 3
+  Timestamp48 timestamp;  // Offset 5
+
+  StockSymbol stock;            // Offset 11
+  char market_code;             // Offset 19
+  char operational_halt_action; // Offset 20
+};
+
+static_assert(sizeof(OperationalHalt) == 21,
+              "OperationalHalt must be 21 bytes");
+static_assert(offsetof(OperationalHalt, operational_halt_action) == 20);
+
 // ============================================================================
 // Add Order Message (Type 'A') - No MPID Attribution
 // ============================================================================
@@ -238,6 +601,8 @@ static_assert(offsetof(MessageHeader, timestamp) == 5);
  *   Offset 32: Price (4 bytes) - price * 10000 (4 decimal places)
  */
 struct __attribute__((packed)) AddOrder {
+  static constexpr char kMsgType = itch::msg_type::AddOrder;
+
   // Header fields (11 bytes)
   char msg_type;          // Offset 0: 'A'
   be_u16 stock_locate;    // Offset 1
@@ -293,6 +658,8 @@ static_assert(offsetof(AddOrder, price) == 32);
  *   Offset 23: Match Number (8 bytes)
  */
 struct __attribute__((packed)) OrderExecuted {
+  static constexpr char kMsgType = itch::msg_type::OrderExecuted;
+
   // Header fields (11 bytes)
   char msg_type;          // Offset 0: 'E'
   be_u16 stock_locate;    // Offset 1
@@ -321,6 +688,412 @@ static_assert(offsetof(OrderExecuted, order_ref) == 11);
 static_assert(offsetof(OrderExecuted, executed_shares) == 19);
 static_assert(offsetof(OrderExecuted, match_number) == 23);
 
+// ============================================================================
+// Add Order with MPID Attribution Message (Type 'F')
+// ============================================================================
+
+/**
+ * @brief Add Order message carrying the market participant identifier.
+ *
+ * Total size: 40 bytes
+ *
+ * Layout: identical to AddOrder, followed by
+ *   Offset 36: Attribution (4 bytes, ASCII MPID)
+ */
+struct __attribute__((packed)) AddOrderMPID {
+  static constexpr char kMsgType = itch::msg_type::AddOrderMPID;
+
+  char msg_type;          // Offset 0: 'F'
+  be_u16 stock_locate;    // Offset 1
+  be_u16 tracking_number; // Offset 3
+  Timestamp48 timestamp;  // Offset 5
+
+  be_u64 order_ref;    // Offset 11
+  char side;           // Offset 19: 'B' = Buy, 'S' = Sell
+  be_u32 shares;       // Offset 20
+  StockSymbol stock;   // Offset 24
+  be_u32 price;        // Offset 32: Price * 10000
+  char attribution[4]; // Offset 36: MPID
+
+  [[nodiscard]] constexpr bool is_buy() const noexcept { return side == 'B'; }
+  [[nodiscard]] constexpr bool is_sell() const noexcept { return side == 'S'; }
+
+  [[nodiscard]] double price_double() const noexcept {
+    return static_cast<double>(static_cast<uint32_t>(price)) / 10000.0;
+  }
+
+  /**
+   * @brief View the common prefix as a plain AddOrder.
+   */
+  [[nodiscard]] const AddOrder &add_order() const noexcept {
+    return *reinterpret_cast<const AddOrder *>(this);
+  }
+};
+
+static_assert(sizeof(AddOrderMPID) == 40, "AddOrderMPID must be 40 bytes");
+static_assert(offsetof(AddOrderMPID, price) == 32);
+static_assert(offsetof(AddOrderMPID, attribution) == 36);
+
+// ============================================================================
+// Order Executed With Price Message (Type 'C')
+// ============================================================================
+
+/**
+ * @brief Execution at a price different from the order's display price.
+ *
+ * Total size: 36 bytes
+ *
+ * Layout:
+ *   Offset  0: Header (11 bytes)
+ *   Offset 11: Order Reference Number (8 bytes)
+ *   Offset 19: Executed Shares (4 bytes)
+ *   Offset 23: Match Number (8 bytes)
+ *   Offset 31: Printable (1 byte) 'Y' or 'N'
+ *   Offset 32: Execution Price (4 bytes) - price * 10000
+ */
+struct __attribute__((packed)) OrderExecutedWithPrice {
+  static constexpr char kMsgType = itch::msg_type::OrderExecutedWithPrice;
+
+  char msg_type;          // Offset 0: 'C'
+  be_u16 stock_locate;    // Offset 1
+  be_u16 tracking_number; // Offset 3
+  Timestamp48 timestamp;  // Offset 5
+
+  be_u64 order_ref;       // Offset 11
+  be_u32 executed_shares; // Offset 19
+  be_u64 match_number;    // Offset 23
+  char printable;         // Offset 31
+  be_u32 execution_price; // Offset 32
+
+  [[nodiscard]] constexpr bool is_printable() const noexcept {
+    return printable == 'Y';
+  }
+};
+
+static_assert(sizeof(OrderExecutedWithPrice) == 36,
+              "OrderExecutedWithPrice must be 36 bytes");
+static_assert(offsetof(OrderExecutedWithPrice, printable) == 31);
+static_assert(offsetof(OrderExecutedWithPrice, execution_price) == 32);
+
+// ============================================================================
+// Order Cancel Message (Type 'X')
+// ============================================================================
+
+/**
+ * @brief Partial cancellation of a resting order.
+ *
+ * Total size: 23 bytes
+ *
+ * Layout:
+ *   Offset  0: Header (11 bytes)
+ *   Offset 11: Order Reference Number (8 bytes)
+ *   Offset 19: Cancelled Shares (4 bytes)
+ */
+struct __attribute__((packed)) OrderCancel {
+  static constexpr char kMsgType = itch::msg_type::OrderCancel;
+
+  char msg_type;          // Offset 0: 'X'
+  be_u16 stock_locate;    // Offset 1
+  be_u16 tracking_number; // Offset 3
+  Timestamp48 timestamp;  // Offset 5
+
+  be_u64 order_ref;        // Offset 11
+  be_u32 cancelled_shares; // Offset 19
+};
+
+static_assert(sizeof(OrderCancel) == 23, "OrderCancel must be 23 bytes");
+static_assert(offsetof(OrderCancel, cancelled_shares) == 19);
+
+// ============================================================================
+// Order Delete Message (Type 'D')
+// ============================================================================
+
+/**
+ * @brief Full removal of a resting order from the book.
+ *
+ * Total size: 19 bytes
+ *
+ * Layout:
+ *   Offset  0: Header (11 bytes)
+ *   Offset 11: Order Reference Number (8 bytes)
+ */
+struct __attribute__((packed)) OrderDelete {
+  static constexpr char kMsgType = itch::msg_type::OrderDelete;
+
+  char msg_type;          // Offset 0: 'D'
+  be_u16 stock_locate;    // Offset 1
+  be_u16 tracking_number; // Offset 3
+  Timestamp48 timestamp;  // Offset 5
+
+  be_u64 order_ref; // Offset 11
+};
+
+static_assert(sizeof(OrderDelete) == 19, "OrderDelete must be 19 bytes");
+static_assert(offsetof(OrderDelete, order_ref) == 11);
+
+// ============================================================================
+// Order Replace Message (Type 'U')
+// ============================================================================
+
+/**
+ * @brief Cancel-replace: the original order is removed and a new one added.
+ *
+ * Total size: 35 bytes
+ *
+ * Layout:
+ *   Offset  0: Header (11 bytes)
+ *   Offset 11: Original Order Reference Number (8 bytes)
+ *   Offset 19: New Order Reference Number (8 bytes)
+ *   Offset 27: Shares (4 bytes)
+ *   Offset 31: Price (4 bytes) - price * 10000
+ */
+struct __attribute__((packed)) OrderReplace {
+  static constexpr char kMsgType = itch::msg_type::OrderReplace;
+
+  char msg_type;          // Offset 0: 'U'
+  be_u16 stock_locate;    // Offset 1
+  be_u16 tracking_number; // Offset 3
+  Timestamp48 timestamp;  // Offset 5
+
+  be_u64 original_order_ref; // Offset 11
+  be_u64 new_order_ref;      // Offset 19
+  be_u32 shares;             // Offset 27
+  be_u32 price;              // Offset 31
+
+  [[nodiscard]] double price_double() const noexcept {
+    return static_cast<double>(static_cast<uint32_t>(price)) / 10000.0;
+  }
+};
+
+static_assert(sizeof(OrderReplace) == 35, "OrderReplace must be 35 bytes");
+static_assert(offsetof(OrderReplace, new_order_ref) == 19);
+static_assert(offsetof(OrderReplace, shares) == 27);
+static_assert(offsetof(OrderReplace, price) == 31);
+
+// ============================================================================
+// Trade Message - Non-Cross (Type 'P')
+// ============================================================================
+
+/**
+ * @brief Execution against a non-displayed order.
+ *
+ * Total size: 44 bytes
+ *
+ * Layout:
+ *   Offset  0: Header (11 bytes)
+ *   Offset 11: Order Reference Number (8 bytes)
+ *   Offset 19: Buy/Sell Indicator (1 byte)
+ *   Offset 20: Shares (4 bytes)
+ *   Offset 24: Stock (8 bytes)
+ *   Offset 32: Price (4 bytes) - price * 10000
+ *   Offset 36: Match Number (8 bytes)
+ */
+struct __attribute__((packed)) Trade {
+  static constexpr char kMsgType = itch::msg_type::Trade;
+
+  char msg_type;          // Offset 0: 'P'
+  be_u16 stock_locate;    // Offset 1
+  be_u16 tracking_number; // Offset 3
+  Timestamp48 timestamp;  // Offset 5
+
+  be_u64 order_ref;    // Offset 11
+  char side;           // Offset 19
+  be_u32 shares;       // Offset 20
+  StockSymbol stock;   // Offset 24
+  be_u32 price;        // Offset 32
+  be_u64 match_number; // Offset 36
+
+  [[nodiscard]] double price_double() const noexcept {
+    return static_cast<double>(static_cast<uint32_t>(price)) / 10000.0;
+  }
+};
+
+static_assert(sizeof(Trade) == 44, "Trade must be 44 bytes");
+static_assert(offsetof(Trade, side) == 19);
+static_assert(offsetof(Trade, price) == 32);
+static_assert(offsetof(Trade, match_number) == 36);
+
+// ============================================================================
+// Cross Trade Message (Type 'Q')
+// ============================================================================
+
+/**
+ * @brief Bulk print of an opening, closing, IPO or halt cross.
+ *
+ * Total size: 40 bytes
+ *
+ * Layout:
+ *   Offset  0: Header (11 bytes)
+ *   Offset 11: Shares (8 bytes)
+ *   Offset 19: Stock (8 bytes)
+ *   Offset 27: Cross Price (4 bytes) - price * 10000
+ *   Offset 31: Match Number (8 bytes)
+ *   Offset 39: Cross Type (1 byte) 'O','C','H','I'
+ */
+struct __attribute__((packed)) CrossTrade {
+  static constexpr char kMsgType = itch::msg_type::CrossTrade;
+
+  char msg_type;          // Offset 0: 'Q'
+  be_u16 stock_locate;    // Offset 1
+  be_u16 tracking_number; // Offset 3
+  Timestamp48 timestamp;  // Offset 5
+
+  be_u64 shares;       // Offset 11
+  StockSymbol stock;   // Offset 19
+  be_u32 cross_price;  // Offset 27
+  be_u64 match_number; // Offset 31
+  char cross_type;     // Offset 39
+};
+
+static_assert(sizeof(CrossTrade) == 40, "CrossTrade must be 40 bytes");
+static_assert(offsetof(CrossTrade, cross_price) == 27);
+static_assert(offsetof(CrossTrade, cross_type) == 39);
+
+// ============================================================================
+// Broken Trade Message (Type 'B')
+// ============================================================================
+
+/**
+ * @brief Notification that a previously reported execution was broken.
+ *
+ * Total size: 19 bytes
+ *
+ * Layout:
+ *   Offset  0: Header (11 bytes)
+ *   Offset 11: Match Number (8 bytes)
+ */
+struct __attribute__((packed)) BrokenTrade {
+  static constexpr char kMsgType = itch::msg_type::BrokenTrade;
+
+  char msg_type;          // Offset 0: 'B'
+  be_u16 stock_locate;    // Offset 1
+  be_u16 tracking_number; // Offset 3
+  Timestamp48 timestamp;  // Offset 5
+
+  be_u64 match_number; // Offset 11
+};
+
+static_assert(sizeof(BrokenTrade) == 19, "BrokenTrade must be 19 bytes");
+
+// ============================================================================
+// Net Order Imbalance Indicator Message (Type 'I')
+// ============================================================================
+
+/**
+ * @brief Cross imbalance information disseminated ahead of auctions.
+ *
+ * Total size: 50 bytes
+ *
+ * Layout:
+ *   Offset  0: Header (11 bytes)
+ *   Offset 11: Paired Shares (8 bytes)
+ *   Offset 19: Imbalance Shares (8 bytes)
+ *   Offset 27: Imbalance Direction (1 byte) 'B','S','N','O','P'
+ *   Offset 28: Stock (8 bytes)
+ *   Offset 36: Far Price (4 bytes)
+ *   Offset 40: Near Price (4 bytes)
+ *   Offset 44: Current Reference Price (4 bytes)
+ *   Offset 48: Cross Type (1 byte)
+ *   Offset 49: Price Variation Indicator (1 byte)
+ */
+struct __attribute__((packed)) NOII {
+  static constexpr char kMsgType = itch::msg_type::NOII;
+
+  char msg_type;          // Offset 0: 'I'
+  be_u16 stock_locate;    // Offset 1
+  be_u16 tracking_number; // Offset 3
+  Timestamp48 timestamp;  // Offset 5
+
+  be_u64 paired_shares;           // Offset 11
+  be_u64 imbalance_shares;        // Offset 19
+  char imbalance_direction;       // Offset 27
+  StockSymbol stock;              // Offset 28
+  be_u32 far_price;               // Offset 36
+  be_u32 near_price;              // Offset 40
+  be_u32 current_reference_price; // Offset 44
+  char cross_type;                // Offset 48
+  char price_variation_indicator; // Offset 49
+};
+
+static_assert(sizeof(NOII) == 50, "NOII must be 50 bytes");
+static_assert(offsetof(NOII, stock) == 28);
+static_assert(offsetof(NOII, current_reference_price) == 44);
+static_assert(offsetof(NOII, price_variation_indicator) == 49);
+
+// ============================================================================
+// Retail Price Improvement Indicator Message (Type 'N')
+// ============================================================================
+
+/**
+ * @brief Presence of retail price improving interest on a stock.
+ *
+ * Total size: 20 bytes
+ *
+ * Layout:
+ *   Offset  0: Header (11 bytes)
+ *   Offset 11: Stock (8 bytes)
+ *   Offset 19: Interest Flag (1 byte) 'B','S','A','N'
+ */
+struct __attribute__((packed)) RetailPriceImprovement {
+  static constexpr char kMsgType = itch::msg_type::RetailPriceImprovement;
+
+  char msg_type;          // Offset 0: 'N'
+  be_u16 stock_locate;    // Offset 1
+  be_u16 tracking_number; // Offset 3
+  Timestamp48 timestamp;  // Offset 5
+
+  StockSymbol stock;  // Offset 11
+  char interest_flag; // Offset 19
+};
+
+static_assert(sizeof(RetailPriceImprovement) == 20,
+              "RetailPriceImprovement must be 20 bytes");
+static_assert(offsetof(RetailPriceImprovement, interest_flag) == 19);
+
+// ============================================================================
+// Direct Listing with Capital Raise Price Discovery Message (Type 'O')
+// ============================================================================
+
+/**
+ * @brief Price discovery bounds for a direct listing with capital raise.
+ *
+ * Total size: 48 bytes
+ *
+ * Layout:
+ *   Offset  0: Header (11 bytes)
+ *   Offset 11: Stock (8 bytes)
+ *   Offset 19: Open Eligibility Status (1 byte) 'N' or 'Y'
+ *   Offset 20: Minimum Allowable Price (4 bytes)
+ *   Offset 24: Maximum Allowable Price (4 bytes)
+ *   Offset 28: Near Execution Price (4 bytes)
+ *   Offset 32: Near Execution Time (8 bytes) - nanoseconds since midnight
+ *   Offset 40: Lower Price Range Collar (4 bytes)
+ *   Offset 44: Upper Price Range Collar (4 bytes)
+ */
+struct __attribute__((packed)) DirectListingCapitalRaise {
+  static constexpr char kMsgType = itch::msg_type::DirectListingCapitalRaise;
+
+  char msg_type;          // Offset 0: 'O'
+  be_u16 stock_locate;    // Offset 1
+  be_u16 tracking_number; // Offset 3
+  Timestamp48 timestamp;  // Offset 5
+
+  StockSymbol stock;               // Offset 11
+  char open_eligibility_status;    // Offset 19
+  be_u32 minimum_allowable_price;  // Offset 20
+  be_u32 maximum_allowable_price;  // Offset 24
+  be_u32 near_execution_price;     // Offset 28
+  be_u64 near_execution_time;      // Offset 32
+  be_u32 lower_price_range_collar; // Offset 40
+  be_u32 upper_price_range_collar; // Offset 44
+};
+
+static_assert(sizeof(DirectListingCapitalRaise) == 48,
+              "DirectListingCapitalRaise must be 48 bytes");
+static_assert(offsetof(DirectListingCapitalRaise, near_execution_time) == 32);
+static_assert(offsetof(DirectListingCapitalRaise, upper_price_range_collar) ==
+              44);
+
 // ============================================================================
 // Zero-Copy Message Parsing
 // ============================================================================
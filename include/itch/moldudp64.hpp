@@ -0,0 +1,522 @@
+#pragma once
+
+/**
+ * @file moldudp64.hpp
+ * @brief MoldUDP64 session-layer decoder with per-session sequence tracking.
+ *
+ * DESIGN PRINCIPLES:
+ * 1. Walk message blocks by their 2-byte length prefix - never guess.
+ * 2. Track the next expected sequence number per session; report gaps and
+ *    duplicates through counters and optional handler hooks.
+ * 3. Zero allocation: sessions live in a fixed-size inline table.
+ * 4. Zero-copy: message blocks are passed as pointers into the packet.
+ *
+ * MoldUDP64 Downstream Packet:
+ *   Header: 20 bytes
+ *     Offset 0:  Session (10 bytes, ASCII)
+ *     Offset 10: Sequence Number (8 bytes) - sequence of first message
+ *     Offset 18: Message Count (2 bytes) - 0 = heartbeat, 0xFFFF = end
+ *   For each message:
+ *     Message Length (2 bytes, big-endian)
+ *     Message Data (Message Length bytes)
+ *
+ * USAGE:
+ *   itch::MoldUdp64Decoder<> mold;
+ *   mold.decode_itch(udp_payload, udp_len, visitor);  // ITCH messages
+ *   if (mold.stats().gaps > 0) { ... request retransmission ... }
+ */
+
+#include "messages.hpp"
+#include "parser.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace itch {
+
+// ============================================================================
+// Wire Format
+// ============================================================================
+
+/**
+ * @brief 10-byte MoldUDP64 session identifier (ASCII, space-padded).
+ */
+struct __attribute__((packed)) MoldSessionId {
+  char data[10];
+
+  [[nodiscard]] bool operator==(const MoldSessionId &other) const noexcept {
+    return std::memcmp(data, other.data, sizeof(data)) == 0;
+  }
+};
+
+static_assert(sizeof(MoldSessionId) == 10, "MoldSessionId must be 10 bytes");
+
+/**
+ * @brief MoldUDP64 downstream packet header (20 bytes).
+ */
+struct __attribute__((packed)) MoldUdp64Header {
+  MoldSessionId session;  // Offset 0
+  be_u64 sequence_number; // Offset 10
+  be_u16 message_count;   // Offset 18
+};
+
+static_assert(sizeof(MoldUdp64Header) == 20,
+              "MoldUdp64Header must be exactly 20 bytes");
+static_assert(offsetof(MoldUdp64Header, sequence_number) == 10);
+static_assert(offsetof(MoldUdp64Header, message_count) == 18);
+
+/// message_count value of a heartbeat packet
+inline constexpr uint16_t kMoldHeartbeat = 0;
+
+/// message_count value of an end-of-session packet
+inline constexpr uint16_t kMoldEndOfSession = 0xFFFF;
+
+/**
+ * @brief Check whether a UDP payload is a well-formed MoldUDP64 packet.
+ *
+ * Session bytes must be printable ASCII and the message blocks must tile
+ * the payload exactly. Used to locate the session layer inside captures.
+ * Zero-length blocks are allowed, as in MoldUdp64Decoder::decode(): they
+ * still take a sequence number, and decode_itch() skips them.
+ */
+[[nodiscard]] inline bool is_moldudp64_packet(const char *payload,
+                                              size_t length) noexcept {
+  if (length < sizeof(MoldUdp64Header)) {
+    return false;
+  }
+
+  const auto *header = reinterpret_cast<const MoldUdp64Header *>(payload);
+  for (char c : header->session.data) {
+    if (c < 0x20 || c > 0x7E) {
+      return false;
+    }
+  }
+
+  const uint16_t count = header->message_count;
+  if (count == kMoldHeartbeat || count == kMoldEndOfSession) {
+    return length == sizeof(MoldUdp64Header);
+  }
+
+  size_t offset = sizeof(MoldUdp64Header);
+  for (uint16_t i = 0; i < count; ++i) {
+    if (length - offset < sizeof(be_u16)) {
+      return false;
+    }
+    const uint16_t block_len =
+        *reinterpret_cast<const be_u16 *>(payload + offset);
+    offset += sizeof(be_u16);
+    if (block_len > length - offset) {
+      return false;
+    }
+    offset += block_len;
+  }
+  return offset == length;
+}
+
+/**
+ * @brief Visit the message blocks of one MoldUDP64 packet, in order.
+ *
+ * No sequence tracking: every block is passed as (message, length), with
+ * its 2-byte length prefix at message - 2. Heartbeats and end-of-session
+ * packets have no blocks.
+ * @return false if the header or a block runs past the payload (blocks
+ *         before the damage have been visited).
+ */
+template <typename Callback>
+bool for_each_mold_message(const char *payload, size_t length,
+                           Callback &&callback) {
+  if (length < sizeof(MoldUdp64Header)) {
+    return false;
+  }
+  const uint16_t count =
+      reinterpret_cast<const MoldUdp64Header *>(payload)->message_count;
+  if (count == kMoldEndOfSession) {
+    return true;
+  }
+
+  size_t offset = sizeof(MoldUdp64Header);
+  for (uint16_t i = 0; i < count; ++i) {
+    if (length - offset < sizeof(be_u16)) {
+      return false;
+    }
+    const uint16_t block_len =
+        *reinterpret_cast<const be_u16 *>(payload + offset);
+    offset += sizeof(be_u16);
+    if (block_len > length - offset) {
+      return false;
+    }
+    callback(payload + offset, size_t{block_len});
+    offset += block_len;
+  }
+  return true;
+}
+
+// ============================================================================
+// Decode Result & Statistics
+// ============================================================================
+
+/**
+ * @brief Outcome of decoding one MoldUDP64 packet.
+ */
+enum class MoldResult : uint8_t {
+  Ok,              ///< New messages delivered (possibly after a gap)
+  Heartbeat,       ///< No messages; sequence checked for gaps
+  EndOfSession,    ///< Session closed by the publisher
+  Duplicate,       ///< Every message already seen; nothing delivered
+  Truncated,       ///< Header or a message block ran past the payload
+  SessionTableFull ///< Messages delivered, but the session is untracked
+};
+
+/**
+ * @brief Running counters kept by MoldUdp64Decoder.
+ */
+struct MoldUdp64Stats {
+  uint64_t packets = 0;            ///< Packets passed to decode()
+  uint64_t messages = 0;           ///< Message blocks delivered
+  uint64_t heartbeats = 0;         ///< Packets with message_count 0
+  uint64_t end_of_session = 0;     ///< Packets with message_count 0xFFFF
+  uint64_t gaps = 0;               ///< Sequence jumps detected
+  uint64_t missed_messages = 0;    ///< Messages lost across all gaps
+  uint64_t duplicate_packets = 0;  ///< Packets carrying only seen messages
+  uint64_t duplicate_messages = 0; ///< Message blocks dropped as duplicates
+  uint64_t truncated = 0;          ///< Malformed / short packets
+  uint64_t untracked_packets = 0;  ///< Packets from sessions beyond capacity
+};
+
+/**
+ * @brief Optional hooks for session events (all no-ops).
+ *
+ * A handler passed to decode() must provide
+ *   void on_message(const char* data, size_t len);
+ * and may provide any of the hooks below; missing hooks cost nothing.
+ */
+struct DefaultMoldHandler {
+  void on_gap(const MoldSessionId & /*session*/, uint64_t /*expected*/,
+              uint64_t /*received*/) {}
+  void on_duplicate(const MoldSessionId & /*session*/, uint64_t /*sequence*/,
+                    uint64_t /*count*/) {}
+  void on_end_of_session(const MoldSessionId & /*session*/) {}
+};
+
+// ============================================================================
+// Decoder
+// ============================================================================
+
+/**
+ * @brief Stateful MoldUDP64 decoder for one feed (any number of packets).
+ *
+ * Sequence numbers are tracked per session. The first packet of a session
+ * establishes its start; later packets are classified as in-order, gap
+ * (messages delivered, gap reported), duplicate (dropped) or overlapping
+ * (already-seen prefix dropped, rest delivered).
+ *
+ * @tparam MaxSessions Inline session table capacity.
+ */
+template <std::size_t MaxSessions = 4> class MoldUdp64Decoder {
+public:
+  /**
+   * @brief Per-session tracking state.
+   */
+  struct Session {
+    MoldSessionId id;
+    uint64_t next_sequence; ///< Sequence number expected next
+    bool ended;             ///< End-of-session packet seen
+  };
+
+  /**
+   * @brief Decode one downstream packet.
+   *
+   * @param payload UDP payload (starts with the MoldUDP64 header).
+   * @param length Payload length in bytes.
+   * @param handler Receives on_message() per new block, plus optional hooks.
+   */
+  template <typename Handler>
+  MoldResult decode(const char *payload, size_t length,
+                    Handler &handler) noexcept {
+    ++stats_.packets;
+
+    if (length < sizeof(MoldUdp64Header)) [[unlikely]] {
+      ++stats_.truncated;
+      return MoldResult::Truncated;
+    }
+
+    const auto *header = reinterpret_cast<const MoldUdp64Header *>(payload);
+    const uint64_t sequence = header->sequence_number;
+    const uint16_t count = header->message_count;
+    Session *session = find_or_add(header->session, sequence);
+
+    if (count == kMoldHeartbeat || count == kMoldEndOfSession) {
+      // Control packets carry the next sequence the publisher will send
+      if (session != nullptr) {
+        check_gap(*session, sequence, handler);
+        if (sequence > session->next_sequence) {
+          session->next_sequence = sequence;
+        }
+      }
+      if (count == kMoldHeartbeat) {
+        ++stats_.heartbeats;
+        return MoldResult::Heartbeat;
+      }
+      ++stats_.end_of_session;
+      if (session != nullptr) {
+        session->ended = true;
+      }
+      if constexpr (requires { handler.on_end_of_session(header->session); }) {
+        handler.on_end_of_session(header->session);
+      }
+      return MoldResult::EndOfSession;
+    }
+
+    // Number of leading blocks this decoder has already delivered
+    uint64_t skip = 0;
+    if (session != nullptr) {
+      if (sequence < session->next_sequence) {
+        skip = session->next_sequence - sequence;
+        if (skip >= count) {
+          ++stats_.duplicate_packets;
+          stats_.duplicate_messages += count;
+          if constexpr (requires {
+                          handler.on_duplicate(header->session, sequence,
+                                               uint64_t{count});
+                        }) {
+            handler.on_duplicate(header->session, sequence, uint64_t{count});
+          }
+          return MoldResult::Duplicate;
+        }
+        stats_.duplicate_messages += skip;
+      } else {
+        check_gap(*session, sequence, handler);
+      }
+    } else {
+      ++stats_.untracked_packets;
+    }
+
+    // Walk message blocks by length prefix
+    size_t offset = sizeof(MoldUdp64Header);
+    uint16_t index = 0;
+    for (; index < count; ++index) {
+      if (length - offset < sizeof(be_u16)) [[unlikely]] {
+        break;
+      }
+      const uint16_t block_len =
+          *reinterpret_cast<const be_u16 *>(payload + offset);
+      offset += sizeof(be_u16);
+      if (block_len > length - offset) [[unlikely]] {
+        break;
+      }
+      if (index >= skip) {
+        handler.on_message(payload + offset, block_len);
+        ++stats_.messages;
+      }
+      offset += block_len;
+    }
+
+    // Only blocks actually present advance the session
+    if (session != nullptr && sequence + index > session->next_sequence) {
+      session->next_sequence = sequence + index;
+    }
+
+    if (index < count) [[unlikely]] {
+      ++stats_.truncated;
+      return MoldResult::Truncated;
+    }
+    return session != nullptr ? MoldResult::Ok : MoldResult::SessionTableFull;
+  }
+
+  /**
+   * @brief Decode one packet and parse each block as an ITCH message.
+   *
+   * The visitor receives the usual on_xxx hooks; if it also declares
+   * on_gap / on_duplicate / on_end_of_session they are called too.
+   * Blocks follow Parser::parse_buffer(): types the visitor leaves to
+   * DefaultVisitor are skipped by their type byte, and consecutive blocks
+   * of a batched type reach its on_xxx_batch hook as one MessageSpan (runs
+   * end with the packet).
+   */
+  template <typename Visitor>
+  MoldResult decode_itch(const char *payload, size_t length,
+                         Visitor &visitor) noexcept {
+    ItchSink<Visitor> sink{visitor};
+    const MoldResult result = decode(payload, length, sink);
+    sink.flush();
+    return result;
+  }
+
+  /**
+   * @brief Look up a session's tracking state (nullptr if never seen).
+   */
+  [[nodiscard]] const Session *
+  session(const MoldSessionId &id) const noexcept {
+    for (std::size_t i = 0; i < session_count_; ++i) {
+      if (sessions_[i].id == id) {
+        return &sessions_[i];
+      }
+    }
+    return nullptr;
+  }
+
+  [[nodiscard]] const MoldUdp64Stats &stats() const noexcept { return stats_; }
+
+  [[nodiscard]] std::size_t session_count() const noexcept {
+    return session_count_;
+  }
+
+  /**
+   * @brief Forget all sessions and counters.
+   */
+  void reset() noexcept {
+    session_count_ = 0;
+    last_ = 0;
+    stats_ = MoldUdp64Stats{};
+  }
+
+private:
+  /**
+   * @brief Adapter from message blocks to Parser + visitor.
+   *
+   * Blocks are not contiguous (each has its own length prefix), so a batch
+   * is collected as block pointers and handed over at the next block of
+   * another type, every kMaxBatch blocks, or by flush().
+   */
+  template <typename Visitor> struct ItchSink {
+    using Fn = void (*)(ItchSink &, const char *, size_t) noexcept;
+    using FlushFn = void (*)(ItchSink &) noexcept;
+
+    /// Largest span handed to a batch hook, as in parse_buffer()
+    static constexpr size_t kMaxBatch = BatchDispatchTable<Visitor>::kMaxBatch;
+
+    explicit ItchSink(Visitor &v) noexcept : visitor(v) {}
+
+    Visitor &visitor;
+    Parser parser{};
+    const char *run[kMaxBatch]; ///< Blocks of the pending batch
+    size_t run_count = 0;
+    FlushFn run_flush = nullptr; ///< Hands `run` over as its message type
+
+    void on_message(const char *data, size_t len) noexcept {
+      if (len == 0) [[unlikely]] {
+        return; // parse() would report BufferTooSmall
+      }
+      const auto type = static_cast<uint8_t>(data[0]);
+      // Registered types the visitor leaves to DefaultVisitor
+      if constexpr (!HandledTypes<Visitor>::all) {
+        if (HandledTypes<Visitor>::skip_sizes[type] != 0) {
+          return;
+        }
+      }
+      if constexpr (has_batch_hooks_v<Visitor>) {
+        table[type](*this, data, len);
+      } else {
+        (void)parser.parse(data, len, visitor);
+      }
+    }
+
+    /**
+     * @brief Deliver the pending batch, if any.
+     */
+    void flush() noexcept {
+      if (run_count > 0) {
+        run_flush(*this);
+        run_count = 0;
+      }
+    }
+
+    template <typename Msg>
+    static void handle(ItchSink &sink, const char *data,
+                       size_t len) noexcept {
+      if constexpr (BatchVisitor<Visitor, Msg>) {
+        if (len < sizeof(Msg)) [[unlikely]] {
+          return; // parse() would report BufferTooSmall
+        }
+        if (sink.run_flush != &deliver<Msg> || sink.run_count == kMaxBatch) {
+          sink.flush();
+          sink.run_flush = &deliver<Msg>;
+        }
+        sink.run[sink.run_count++] = data;
+      } else {
+        sink.flush();
+        (void)sink.parser.parse(data, len, sink.visitor);
+      }
+    }
+
+    static void unknown(ItchSink &sink, const char *data,
+                        size_t len) noexcept {
+      sink.flush();
+      (void)sink.parser.parse(data, len, sink.visitor); // on_unknown
+    }
+
+    template <typename Msg> static void deliver(ItchSink &sink) noexcept {
+      const Msg *msgs[kMaxBatch];
+      for (size_t i = 0; i < sink.run_count; ++i) {
+        msgs[i] = reinterpret_cast<const Msg *>(sink.run[i]);
+      }
+      visit_batch(sink.visitor, MessageSpan<Msg>(msgs, sink.run_count));
+    }
+
+    static constexpr std::array<Fn, 256> table =
+        MessageRegistry::make_dispatch_table<Fn, ItchSink>(&unknown);
+
+    void on_gap(const MoldSessionId &s, uint64_t expected, uint64_t received) {
+      if constexpr (requires { visitor.on_gap(s, expected, received); }) {
+        visitor.on_gap(s, expected, received);
+      }
+    }
+    void on_duplicate(const MoldSessionId &s, uint64_t sequence,
+                      uint64_t count) {
+      if constexpr (requires { visitor.on_duplicate(s, sequence, count); }) {
+        visitor.on_duplicate(s, sequence, count);
+      }
+    }
+    void on_end_of_session(const MoldSessionId &s) {
+      if constexpr (requires { visitor.on_end_of_session(s); }) {
+        visitor.on_end_of_session(s);
+      }
+    }
+  };
+
+  /**
+   * @brief Find a session (last-used first), or start tracking it.
+   *
+   * @return nullptr when the table is full.
+   */
+  Session *find_or_add(const MoldSessionId &id, uint64_t sequence) noexcept {
+    if (last_ < session_count_ && sessions_[last_].id == id) [[likely]] {
+      return &sessions_[last_];
+    }
+    for (std::size_t i = 0; i < session_count_; ++i) {
+      if (sessions_[i].id == id) {
+        last_ = i;
+        return &sessions_[i];
+      }
+    }
+    if (session_count_ == MaxSessions) {
+      return nullptr;
+    }
+    last_ = session_count_++;
+    sessions_[last_] = Session{id, sequence, false};
+    return &sessions_[last_];
+  }
+
+  template <typename Handler>
+  void check_gap(const Session &session, uint64_t sequence,
+                 Handler &handler) noexcept {
+    if (sequence > session.next_sequence) [[unlikely]] {
+      ++stats_.gaps;
+      stats_.missed_messages += sequence - session.next_sequence;
+      if constexpr (requires {
+                      handler.on_gap(session.id, session.next_sequence,
+                                     sequence);
+                    }) {
+        handler.on_gap(session.id, session.next_sequence, sequence);
+      }
+    }
+  }
+
+  std::array<Session, MaxSessions> sessions_{};
+  std::size_t session_count_ = 0;
+  std::size_t last_ = 0;
+  MoldUdp64Stats stats_{};
+};
+
+} // namespace itch
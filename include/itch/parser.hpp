@@ -6,7 +6,7 @@
  *
  * DESIGN PRINCIPLES:
  * 1. No virtual functions - templates enable full inlining.
- * 2. Switch-case dispatch compiles to efficient jump table.
+ * 2. Dispatch goes through a jump table generated from registry.hpp.
  * 3. Visitor pattern allows caller to handle only messages they care about.
  * 4. All parsing is zero-copy via reinterpret_cast.
  *
@@ -17,12 +17,26 @@
  *       void on_unknown(char msg_type, const char* data, size_t len) { ... }
  *   };
  *
+ *   // Optional: receive runs of same-type messages in one call
+ *   struct ColumnHandler : DefaultVisitor {
+ *       void on_add_order_batch(MessageSpan<AddOrder> run) { ... }
+ *   };
+ *
+ *   // Optional: receive only pre-decoded fields (see projection.hpp)
+ *   struct VolumeHandler : DefaultVisitor {
+ *       using Fields = Projection<field::StockLocate | field::Shares>;
+ *       void on_order_executed(const Fields& f) { ... }
+ *   };
+ *
  *   Parser<MyHandler> parser(handler);
  *   parser.parse(buffer, length);
  */
 
 #include "messages.hpp"
+#include "registry.hpp"
+#include <array>
 #include <cstddef>
+#include <type_traits>
 
 namespace itch {
 
@@ -40,6 +54,20 @@ enum class ParseResult : uint8_t {
   InvalidLength   ///< Message length doesn't match expected size
 };
 
+/**
+ * @brief Engine used by Parser::parse_buffer() to walk a message stream.
+ */
+enum class ParseLoop : uint8_t {
+  Table,   ///< Size-table lookup, then jump-table call per message
+  Threaded ///< Computed-goto threaded code: one indirect jump per message
+};
+
+#if defined(__GNUC__) || defined(__clang__)
+inline constexpr bool kHasThreadedDispatch = true;
+#else
+inline constexpr bool kHasThreadedDispatch = false; // Falls back to Table
+#endif
+
 // ============================================================================
 // Default Visitor (No-op handlers)
 // ============================================================================
@@ -52,16 +80,246 @@ enum class ParseResult : uint8_t {
  */
 struct DefaultVisitor {
   // System messages
-  void on_system_event(const MessageHeader & /*msg*/) {}
+  void on_system_event(const SystemEvent & /*msg*/) {}
+  void on_stock_directory(const StockDirectory & /*msg*/) {}
+  void on_stock_trading_action(const StockTradingAction & /*msg*/) {}
+  void on_reg_sho_restriction(const RegSHORestriction & /*msg*/) {}
+  void on_market_participant_position(const MarketParticipantPosition &
+                                      /*msg*/) {}
+  void on_mwcb_decline_level(const MWCBDeclineLevel & /*msg*/) {}
+  void on_mwcb_status(const MWCBStatus & /*msg*/) {}
+  void on_ipo_quoting_period(const IPOQuotingPeriod & /*msg*/) {}
+  void on_luld_auction_collar(const LULDAuctionCollar & /*msg*/) {}
+  void on_operational_halt(const OperationalHalt & /*msg*/) {}
 
   // Order messages
   void on_add_order(const AddOrder & /*msg*/) {}
+  void on_add_order_mpid(const AddOrderMPID & /*msg*/) {}
   void on_order_executed(const OrderExecuted & /*msg*/) {}
+  void on_order_executed_with_price(const OrderExecutedWithPrice & /*msg*/) {}
+  void on_order_cancel(const OrderCancel & /*msg*/) {}
+  void on_order_delete(const OrderDelete & /*msg*/) {}
+  void on_order_replace(const OrderReplace & /*msg*/) {}
+
+  // Trade messages
+  void on_trade(const Trade & /*msg*/) {}
+  void on_cross_trade(const CrossTrade & /*msg*/) {}
+  void on_broken_trade(const BrokenTrade & /*msg*/) {}
+
+  // Auction / imbalance messages
+  void on_noii(const NOII & /*msg*/) {}
+  void on_retail_price_improvement(const RetailPriceImprovement & /*msg*/) {}
+  void on_direct_listing_capital_raise(const DirectListingCapitalRaise &
+                                       /*msg*/) {}
 
   // Called for unhandled message types
   void on_unknown(char /*msg_type*/, const char * /*data*/, size_t /*len*/) {}
 };
 
+// ============================================================================
+// Hook Detection
+// ============================================================================
+
+namespace detail {
+
+/// Member pointer type of DefaultVisitor's no-op hook for Msg
+template <typename P, typename Msg>
+concept NoOpHook = std::is_same_v<P, void (DefaultVisitor::*)(const Msg &)>;
+
+/**
+ * @brief Whether V replaces DefaultVisitor's no-op hook for a message type.
+ *
+ * The tag pointer only selects the overload. A hook V does not redeclare
+ * resolves to `void (DefaultVisitor::*)(const Msg&)`; anything else (own
+ * declaration, Projection parameter, overload set, or a visitor that does
+ * not derive from DefaultVisitor) counts as handled.
+ */
+template <typename V>
+constexpr bool overrides_hook(const SystemEvent *) noexcept {
+  return !requires { { &V::on_system_event } -> NoOpHook<SystemEvent>; };
+}
+template <typename V>
+constexpr bool overrides_hook(const StockDirectory *) noexcept {
+  return !requires { { &V::on_stock_directory } -> NoOpHook<StockDirectory>; };
+}
+template <typename V>
+constexpr bool overrides_hook(const StockTradingAction *) noexcept {
+  return !requires {
+    { &V::on_stock_trading_action } -> NoOpHook<StockTradingAction>;
+  };
+}
+template <typename V>
+constexpr bool overrides_hook(const RegSHORestriction *) noexcept {
+  return !requires {
+    { &V::on_reg_sho_restriction } -> NoOpHook<RegSHORestriction>;
+  };
+}
+template <typename V>
+constexpr bool overrides_hook(const MarketParticipantPosition *) noexcept {
+  return !requires {
+    {
+      &V::on_market_participant_position
+    } -> NoOpHook<MarketParticipantPosition>;
+  };
+}
+template <typename V>
+constexpr bool overrides_hook(const MWCBDeclineLevel *) noexcept {
+  return !requires {
+    { &V::on_mwcb_decline_level } -> NoOpHook<MWCBDeclineLevel>;
+  };
+}
+template <typename V>
+constexpr bool overrides_hook(const MWCBStatus *) noexcept {
+  return !requires { { &V::on_mwcb_status } -> NoOpHook<MWCBStatus>; };
+}
+template <typename V>
+constexpr bool overrides_hook(const IPOQuotingPeriod *) noexcept {
+  return !requires {
+    { &V::on_ipo_quoting_period } -> NoOpHook<IPOQuotingPeriod>;
+  };
+}
+template <typename V>
+constexpr bool overrides_hook(const LULDAuctionCollar *) noexcept {
+  return !requires {
+    { &V::on_luld_auction_collar } -> NoOpHook<LULDAuctionCollar>;
+  };
+}
+template <typename V>
+constexpr bool overrides_hook(const OperationalHalt *) noexcept {
+  return !requires {
+    { &V::on_operational_halt } -> NoOpHook<OperationalHalt>;
+  };
+}
+template <typename V> constexpr bool overrides_hook(const AddOrder *) noexcept {
+  return !requires { { &V::on_add_order } -> NoOpHook<AddOrder>; };
+}
+template <typename V>
+constexpr bool overrides_hook(const AddOrderMPID *) noexcept {
+  return !requires { { &V::on_add_order_mpid } -> NoOpHook<AddOrderMPID>; };
+}
+template <typename V>
+constexpr bool overrides_hook(const OrderExecuted *) noexcept {
+  return !requires { { &V::on_order_executed } -> NoOpHook<OrderExecuted>; };
+}
+template <typename V>
+constexpr bool overrides_hook(const OrderExecutedWithPrice *) noexcept {
+  return !requires {
+    { &V::on_order_executed_with_price } -> NoOpHook<OrderExecutedWithPrice>;
+  };
+}
+template <typename V>
+constexpr bool overrides_hook(const OrderCancel *) noexcept {
+  return !requires { { &V::on_order_cancel } -> NoOpHook<OrderCancel>; };
+}
+template <typename V>
+constexpr bool overrides_hook(const OrderDelete *) noexcept {
+  return !requires { { &V::on_order_delete } -> NoOpHook<OrderDelete>; };
+}
+template <typename V>
+constexpr bool overrides_hook(const OrderReplace *) noexcept {
+  return !requires { { &V::on_order_replace } -> NoOpHook<OrderReplace>; };
+}
+template <typename V> constexpr bool overrides_hook(const Trade *) noexcept {
+  return !requires { { &V::on_trade } -> NoOpHook<Trade>; };
+}
+template <typename V>
+constexpr bool overrides_hook(const CrossTrade *) noexcept {
+  return !requires { { &V::on_cross_trade } -> NoOpHook<CrossTrade>; };
+}
+template <typename V>
+constexpr bool overrides_hook(const BrokenTrade *) noexcept {
+  return !requires { { &V::on_broken_trade } -> NoOpHook<BrokenTrade>; };
+}
+template <typename V> constexpr bool overrides_hook(const NOII *) noexcept {
+  return !requires { { &V::on_noii } -> NoOpHook<NOII>; };
+}
+template <typename V>
+constexpr bool overrides_hook(const RetailPriceImprovement *) noexcept {
+  return !requires {
+    { &V::on_retail_price_improvement } -> NoOpHook<RetailPriceImprovement>;
+  };
+}
+template <typename V>
+constexpr bool overrides_hook(const DirectListingCapitalRaise *) noexcept {
+  return !requires {
+    {
+      &V::on_direct_listing_capital_raise
+    } -> NoOpHook<DirectListingCapitalRaise>;
+  };
+}
+
+} // namespace detail
+
+/**
+ * @brief Visitor V does real work for Msg (per-message or batch hook).
+ */
+template <typename V, typename Msg>
+concept HandlesMessage =
+    BatchVisitor<V, Msg> ||
+    detail::overrides_hook<V>(static_cast<const Msg *>(nullptr));
+
+/**
+ * @brief Per-visitor set of handled type bytes, built at compile time.
+ *
+ * parse_buffer() steps over every other registered type using only the
+ * size table: no decode, no table dispatch, no visitor call.
+ */
+template <typename Visitor> struct HandledTypes {
+  template <typename Msg>
+  static constexpr bool contains = HandlesMessage<Visitor, Msg>;
+
+  static constexpr std::array<uint64_t, 4> bits =
+      MessageRegistry::make_type_set<HandledTypes>();
+
+  /// True when every registered type reaches the visitor (no skipping)
+  static constexpr bool all = bits == MessageRegistry::valid;
+
+  [[nodiscard]] static constexpr bool test(char msg_type) noexcept {
+    const auto c = static_cast<uint8_t>(msg_type);
+    return (bits[c >> 6] >> (c & 63)) & 1u;
+  }
+
+  /// Wire size of registered-but-unhandled types, 0 for everything else
+  static constexpr std::array<uint8_t, 256> skip_sizes = [] {
+    std::array<uint8_t, 256> table = MessageRegistry::sizes;
+    for (std::size_t c = 0; c < table.size(); ++c) {
+      if (test(static_cast<char>(c))) {
+        table[c] = 0;
+      }
+    }
+    return table;
+  }();
+
+  /**
+   * @brief Advance past a run of unhandled messages.
+   *
+   * Stops at a handled, unknown or incomplete message. The size is only
+   * reloaded when the type byte changes: inside a same-type run the next
+   * offset is a register add the CPU can run ahead on, instead of waiting
+   * for the type-byte and table loads on every message.
+   */
+  [[nodiscard]] static size_t skip_run(const char *buffer, size_t offset,
+                                       size_t length) noexcept {
+    int type = -1; // Matches no byte, so the first pass always loads
+    size_t size = 0;
+    while (offset < length) {
+      const int next = static_cast<uint8_t>(buffer[offset]);
+      if (next != type) {
+        type = next;
+        size = skip_sizes[next];
+        if (size == 0) {
+          break;
+        }
+      }
+      if (size > length - offset) {
+        break;
+      }
+      offset += size;
+    }
+    return offset;
+  }
+};
+
 // ============================================================================
 // Message Size Lookup
 // ============================================================================
@@ -72,24 +330,224 @@ struct DefaultVisitor {
  * Returns 0 for unknown types.
  */
 [[nodiscard]] constexpr size_t get_message_size(char msg_type) noexcept {
-  switch (msg_type) {
-  // Order messages
-  case msg_type::AddOrder:
-    return sizeof(AddOrder);
-  case msg_type::OrderExecuted:
-    return sizeof(OrderExecuted);
+  return message_size(msg_type);
+}
+
+// ============================================================================
+// Dispatch Table
+// ============================================================================
+
+/**
+ * @brief Per-visitor jump table generated from the message registry.
+ *
+ * Slot N handles type byte N: bounds check, overlay, call the visitor hook.
+ * Unregistered slots forward to on_unknown.
+ */
+template <typename Visitor> struct DispatchTable {
+  using Fn = ParseResult (*)(const char *, size_t, Visitor &) noexcept;
+
+  template <typename Msg>
+  static ParseResult handle(const char *buffer, size_t length,
+                            Visitor &visitor) noexcept {
+    if (length < sizeof(Msg)) [[unlikely]] {
+      return ParseResult::BufferTooSmall;
+    }
+    visit(visitor, *reinterpret_cast<const Msg *>(buffer));
+    return ParseResult::Ok;
+  }
 
-  // System messages (just header for now)
-  case msg_type::SystemEvent:
-    return sizeof(MessageHeader);
+  static ParseResult unknown(const char *buffer, size_t length,
+                             Visitor &visitor) noexcept {
+    visitor.on_unknown(buffer[0], buffer, length);
+    return ParseResult::UnknownType;
+  }
+
+  static constexpr std::array<Fn, 256> table =
+      MessageRegistry::make_dispatch_table<Fn, DispatchTable>(&unknown);
+};
+
+// ============================================================================
+// Batch Dispatch Table
+// ============================================================================
+
+/**
+ * @brief Per-visitor jump table used when the visitor opts into batching.
+ *
+ * For a type the visitor batches, the slot consumes the whole run of
+ * consecutive messages of that type (pointers collected on the stack, handed
+ * over kMaxBatch at a time). Other types are delivered one by one as usual.
+ *
+ * Every slot assumes the first message is complete and returns the number of
+ * bytes it consumed.
+ */
+template <typename Visitor> struct BatchDispatchTable {
+  using Fn = size_t (*)(const char *, size_t, Visitor &) noexcept;
+
+  /// Largest span handed to a batch hook (bounds the on-stack pointer array)
+  static constexpr size_t kMaxBatch = 64;
+
+  template <typename Msg>
+  static size_t handle(const char *buffer, size_t length,
+                       Visitor &visitor) noexcept {
+    if constexpr (BatchVisitor<Visitor, Msg>) {
+      const Msg *run[kMaxBatch];
+      size_t count = 0;
+      size_t offset = 0;
+
+      do {
+        run[count++] = reinterpret_cast<const Msg *>(buffer + offset);
+        offset += sizeof(Msg);
+        if (count == kMaxBatch) [[unlikely]] {
+          visit_batch(visitor, MessageSpan<Msg>(run, count));
+          count = 0;
+        }
+      } while (offset + sizeof(Msg) <= length &&
+               buffer[offset] == Msg::kMsgType);
+
+      if (count > 0) {
+        visit_batch(visitor, MessageSpan<Msg>(run, count));
+      }
+      return offset;
+    } else {
+      visit(visitor, *reinterpret_cast<const Msg *>(buffer));
+      return sizeof(Msg);
+    }
+  }
+
+  static size_t unknown(const char * /*buffer*/, size_t /*length*/,
+                        Visitor & /*visitor*/) noexcept {
+    return 0; // Unreachable: parse_buffer filters unknown types first
+  }
+
+  static constexpr std::array<Fn, 256> table =
+      MessageRegistry::make_dispatch_table<Fn, BatchDispatchTable>(&unknown);
+};
 
-    // TODO: Add more message types as implemented
+// ============================================================================
+// Threaded Parse Loop
+// ============================================================================
 
-  default:
-    return 0; // Unknown type
+// Per-type handler labels, in Itch50Messages order (checked below). Computed
+// goto needs real labels, so this is the one place the list is spelled out.
+#define ITCH_THREADED_MESSAGES(X)                                              \
+  X(SystemEvent)                                                               \
+  X(StockDirectory)                                                            \
+  X(StockTradingAction)                                                        \
+  X(RegSHORestriction)                                                         \
+  X(MarketParticipantPosition)                                                 \
+  X(MWCBDeclineLevel)                                                          \
+  X(MWCBStatus)                                                                \
+  X(IPOQuotingPeriod)                                                          \
+  X(LULDAuctionCollar)                                                         \
+  X(OperationalHalt)                                                           \
+  X(AddOrder)                                                                  \
+  X(AddOrderMPID)                                                              \
+  X(OrderExecuted)                                                             \
+  X(OrderExecutedWithPrice)                                                    \
+  X(OrderCancel)                                                               \
+  X(OrderDelete)                                                               \
+  X(OrderReplace)                                                              \
+  X(Trade)                                                                     \
+  X(CrossTrade)                                                                \
+  X(BrokenTrade)                                                               \
+  X(NOII)                                                                      \
+  X(RetailPriceImprovement)                                                    \
+  X(DirectListingCapitalRaise)
+
+namespace detail {
+
+#define ITCH_THREADED_TYPE_BYTE(Msg) Msg::kMsgType,
+inline constexpr char kThreadedOrder[] = {
+    ITCH_THREADED_MESSAGES(ITCH_THREADED_TYPE_BYTE)};
+#undef ITCH_THREADED_TYPE_BYTE
+
+[[nodiscard]] constexpr bool threaded_order_matches_registry() noexcept {
+  if (sizeof(kThreadedOrder) != MessageRegistry::types.size()) {
+    return false;
   }
+  for (size_t i = 0; i < sizeof(kThreadedOrder); ++i) {
+    if (kThreadedOrder[i] != MessageRegistry::types[i]) {
+      return false;
+    }
+  }
+  return true;
 }
 
+static_assert(threaded_order_matches_registry(),
+              "ITCH_THREADED_MESSAGES must list Itch50Messages in order");
+
+/**
+ * @brief Threaded-code parse loop (GCC/Clang computed goto).
+ *
+ * Every handler ends by jumping straight to the next message's handler:
+ * one indirect jump per message, no call/return and no separate size
+ * lookup. Each handler's jump is a distinct branch site, so the predictor
+ * learns type-to-type transitions (e.g. AddOrder is usually followed by
+ * AddOrder) instead of sharing one indirect call for every message.
+ *
+ * Handlers of types the visitor leaves to DefaultVisitor do no dispatch:
+ * they step over their message and any unhandled run after it by size
+ * alone (HandledTypes::skip_run), as the Table loop does.
+ *
+ * Stopping conditions match Parser::parse_buffer().
+ */
+template <typename Visitor> struct ThreadedLoop {
+  using Skip = HandledTypes<Visitor>;
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic" // &&label and goto *
+  [[nodiscard]] static size_t run(const char *buffer, size_t length,
+                                  Visitor &visitor) noexcept {
+#define ITCH_THREADED_LABEL(Msg) &&handle_##Msg,
+    static const void *const labels[] = {
+        &&unknown, ITCH_THREADED_MESSAGES(ITCH_THREADED_LABEL)};
+#undef ITCH_THREADED_LABEL
+
+    const char *p = buffer;
+    const char *const end = buffer + length;
+
+#define ITCH_THREADED_NEXT()                                                   \
+  do {                                                                         \
+    if (p >= end) {                                                            \
+      goto done;                                                               \
+    }                                                                          \
+    goto *labels[MessageRegistry::positions[static_cast<uint8_t>(*p)]];        \
+  } while (0)
+
+#define ITCH_THREADED_HANDLER(Msg)                                             \
+  handle_##Msg:                                                                \
+  if (static_cast<size_t>(end - p) < sizeof(Msg)) {                            \
+    goto done; /* Incomplete message */                                        \
+  }                                                                            \
+  if constexpr (HandledTypes<Visitor>::template contains<Msg>) {               \
+    visit(visitor, *reinterpret_cast<const Msg *>(p));                         \
+    p += sizeof(Msg);                                                          \
+  } else {                                                                     \
+    /* Left to DefaultVisitor: step over it and any unhandled run after it */  \
+    p += Skip::skip_run(p, sizeof(Msg), static_cast<size_t>(end - p));         \
+  }                                                                            \
+  ITCH_THREADED_NEXT();
+
+    ITCH_THREADED_NEXT();
+    ITCH_THREADED_MESSAGES(ITCH_THREADED_HANDLER)
+
+  unknown:
+    visitor.on_unknown(*p, p, static_cast<size_t>(end - p));
+  done:
+    return static_cast<size_t>(p - buffer);
+
+#undef ITCH_THREADED_HANDLER
+#undef ITCH_THREADED_NEXT
+  }
+#pragma GCC diagnostic pop
+#endif
+};
+
+} // namespace detail
+
+#undef ITCH_THREADED_MESSAGES
+
 // ============================================================================
 // Parser Class
 // ============================================================================
@@ -138,46 +596,10 @@ public:
       return ParseResult::BufferTooSmall;
     }
 
-    // Read message type (first byte)
-    const char msg_type = buffer[0];
-
-    // Dispatch based on message type
-    // Using switch-case compiles to efficient jump table
-    // Branch hints: AddOrder is most common (~70% of messages), SystemEvent is
-    // rare
-    switch (msg_type) {
-    [[likely]] case msg_type::AddOrder: {
-      if (length < sizeof(AddOrder)) [[unlikely]] {
-        return ParseResult::BufferTooSmall;
-      }
-      const auto *msg = reinterpret_cast<const AddOrder *>(buffer);
-      visitor.on_add_order(*msg);
-      return ParseResult::Ok;
-    }
-
-    case msg_type::OrderExecuted: {
-      if (length < sizeof(OrderExecuted)) [[unlikely]] {
-        return ParseResult::BufferTooSmall;
-      }
-      const auto *msg = reinterpret_cast<const OrderExecuted *>(buffer);
-      visitor.on_order_executed(*msg);
-      return ParseResult::Ok;
-    }
-
-    [[unlikely]] case msg_type::SystemEvent: {
-      if (length < sizeof(MessageHeader)) [[unlikely]] {
-        return ParseResult::BufferTooSmall;
-      }
-      const auto *msg = reinterpret_cast<const MessageHeader *>(buffer);
-      visitor.on_system_event(*msg);
-      return ParseResult::Ok;
-    }
-
-    default:
-      // Unknown message type - still dispatch to on_unknown
-      visitor.on_unknown(msg_type, buffer, length);
-      return ParseResult::UnknownType;
-    }
+    // Dispatch through the registry-generated jump table: one indexed load
+    // and one indirect call regardless of how many types are registered.
+    return DispatchTable<Visitor>::table[static_cast<uint8_t>(buffer[0])](
+        buffer, length, visitor);
   }
 
   /**
@@ -188,18 +610,41 @@ public:
    * - An error occurs
    * - Unknown message type encountered (can't determine size)
    *
+   * Registered types whose hook the visitor inherits unchanged from
+   * DefaultVisitor are stepped over by size alone (see HandledTypes), by
+   * either engine.
+   *
+   * @tparam Loop Parse engine. ParseLoop::Threaded dispatches each message
+   *              with a single computed goto (GCC/Clang; elsewhere it
+   *              falls back to Table). Visitors with batch hooks always
+   *              take the batched loop.
    * @tparam Visitor Handler type with on_xxx methods.
    * @param buffer Raw message buffer.
    * @param length Total buffer length.
    * @param visitor Handler to receive parsed messages.
    * @return Number of bytes successfully consumed.
    */
-  template <typename Visitor>
+  template <ParseLoop Loop = ParseLoop::Table, typename Visitor>
   [[nodiscard]] size_t parse_buffer(const char *buffer, size_t length,
                                     Visitor &visitor) const noexcept {
+    if constexpr (has_batch_hooks_v<Visitor>) {
+      return parse_buffer_batched(buffer, length, visitor);
+    } else if constexpr (Loop == ParseLoop::Threaded &&
+                         kHasThreadedDispatch) {
+      return detail::ThreadedLoop<Visitor>::run(buffer, length, visitor);
+    }
+
     size_t consumed = 0;
 
     while (consumed < length) {
+      // Types the visitor leaves to DefaultVisitor: step over by size only
+      if constexpr (!HandledTypes<Visitor>::all) {
+        consumed = HandledTypes<Visitor>::skip_run(buffer, consumed, length);
+        if (consumed >= length) {
+          break;
+        }
+      }
+
       const char *current = buffer + consumed;
       const size_t remaining = length - consumed;
 
@@ -234,6 +679,52 @@ public:
 
     return consumed;
   }
+
+  /**
+   * @brief Parse multiple messages, grouping same-type runs into batches.
+   *
+   * Consecutive messages of a type for which the visitor declares
+   * on_xxx_batch(MessageSpan<Msg>) are delivered as one span of pointers
+   * into the buffer (zero-copy). All other types go to the per-message
+   * hooks. Stopping conditions match parse_buffer().
+   *
+   * parse_buffer() selects this path automatically for batching visitors.
+   *
+   * @return Number of bytes successfully consumed.
+   */
+  template <typename Visitor>
+  [[nodiscard]] size_t parse_buffer_batched(const char *buffer, size_t length,
+                                            Visitor &visitor) const noexcept {
+    size_t consumed = 0;
+
+    while (consumed < length) {
+      if constexpr (!HandledTypes<Visitor>::all) {
+        consumed = HandledTypes<Visitor>::skip_run(buffer, consumed, length);
+        if (consumed >= length) {
+          break;
+        }
+      }
+
+      const char *current = buffer + consumed;
+      const size_t remaining = length - consumed;
+
+      const char msg_type = current[0];
+      const size_t msg_size = get_message_size(msg_type);
+
+      if (msg_size == 0) [[unlikely]] {
+        visitor.on_unknown(msg_type, current, remaining);
+        break;
+      }
+      if (remaining < msg_size) {
+        break;
+      }
+
+      consumed += BatchDispatchTable<Visitor>::table[static_cast<uint8_t>(
+          msg_type)](current, remaining, visitor);
+    }
+
+    return consumed;
+  }
 };
 
 // ============================================================================
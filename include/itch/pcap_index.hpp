@@ -0,0 +1,296 @@
+#pragma once
+
+/**
+ * @file pcap_index.hpp
+ * @brief Sidecar packet index: seek a capture by packet number or time.
+ *
+ * DESIGN PRINCIPLES:
+ * 1. Build once, map thereafter: one pass over the record headers writes
+ *    the index; every later run maps it and seeks without walking the
+ *    capture from its first record.
+ * 2. Sparse: one entry (byte offset + timestamp) per `stride` packets, so
+ *    a 10 GB day indexes into well under a megabyte, and a seek costs a
+ *    binary search plus at most `stride` record-header hops.
+ * 3. A stale index is refused, never trusted: the header records the
+ *    capture's size and a hash of its first bytes.
+ *
+ * Index File Format (host byte order; the index is a local cache):
+ *   Header: 48 bytes (magic, version, stride, capture size, fingerprint,
+ *           packet count, entry count)
+ *   Entries: entry_count x 16 bytes (record offset, capture time in ns);
+ *            entry i describes packet i * stride.
+ *
+ * pcapng captures are indexed over their first section only, and
+ * build() refuses files with more than one (see
+ * PcapReader::single_section).
+ *
+ * USAGE:
+ *   PcapReader reader("day.pcap");
+ *   PcapIndex index;
+ *   const std::string path = PcapIndex::default_path("day.pcap");
+ *   if (!index.open(path.c_str(), reader)) {
+ *       PcapIndex::build(reader, path.c_str());
+ *       index.open(path.c_str(), reader);
+ *   }
+ *   reader.for_each_packet_in(reader.seek_to_time(index, t0),
+ *                             reader.seek_to_time(index, t1), handler);
+ */
+
+#include "mapped_file.hpp"
+#include "pcap_reader.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace itch {
+
+// ============================================================================
+// Index File Structures
+// ============================================================================
+
+/**
+ * @brief Index file header (48 bytes).
+ */
+struct __attribute__((packed)) PcapIndexHeader {
+  char magic[8];         // "CHRIDX\0\0"
+  uint32_t version;      // kPcapIndexVersion
+  uint32_t stride;       // Packets per entry
+  uint64_t capture_size; // Bytes in the indexed capture
+  uint64_t fingerprint;  // FNV-1a of the capture's leading bytes
+  uint64_t packet_count; // Packets in the capture
+  uint64_t entry_count;  // Entries following the header
+};
+
+static_assert(sizeof(PcapIndexHeader) == 48,
+              "PcapIndexHeader must be 48 bytes");
+
+/**
+ * @brief Index entry (16 bytes): where packet i * stride starts.
+ */
+struct __attribute__((packed)) PcapIndexEntry {
+  uint64_t offset; // Record (PCAP) or block (pcapng) offset
+  uint64_t ts_ns;  // Capture time of that packet
+};
+
+static_assert(sizeof(PcapIndexEntry) == 16,
+              "PcapIndexEntry must be 16 bytes");
+
+inline constexpr char kPcapIndexMagic[8] = {'C', 'H', 'R', 'I',
+                                            'D', 'X', '\0', '\0'};
+inline constexpr uint32_t kPcapIndexVersion = 1;
+
+/// Leading capture bytes hashed into the fingerprint
+inline constexpr size_t kPcapIndexFingerprintBytes = size_t{64} << 10;
+
+/**
+ * @brief FNV-1a over the first kPcapIndexFingerprintBytes of a capture.
+ */
+[[nodiscard]] inline uint64_t capture_fingerprint(const char *data,
+                                                  size_t size) noexcept {
+  const size_t n =
+      size < kPcapIndexFingerprintBytes ? size : kPcapIndexFingerprintBytes;
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (size_t i = 0; i < n; ++i) {
+    hash ^= static_cast<uint8_t>(data[i]);
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+// ============================================================================
+// Packet Index Class
+// ============================================================================
+
+/**
+ * @brief Read-only view of a mapped sidecar index.
+ */
+class PcapIndex {
+public:
+  /// Default packets per entry: 64 KiB of index per ~4M packets
+  static constexpr uint32_t kDefaultStride = 1024;
+
+  PcapIndex() = default;
+
+  /**
+   * @brief Conventional sidecar path: the capture path plus ".idx".
+   */
+  [[nodiscard]] static std::string default_path(const char *capture) {
+    return std::string(capture) + ".idx";
+  }
+
+  /**
+   * @brief Walk `reader`'s capture once and write its index to `path`.
+   * @return false if the reader is closed, `stride` is 0, the capture is a
+   *         multi-section pcapng file, or the file cannot be written.
+   */
+  static bool build(const PcapReader &reader, const char *path,
+                    uint32_t stride = kDefaultStride) {
+    // Cursors stop at a second section: its records would be out of
+    // reach of every seek
+    if (stride == 0 || !reader.single_section()) {
+      return false;
+    }
+
+    std::vector<PcapIndexEntry> entries;
+    PacketCursor cursor = reader.first_packet();
+    PacketRecord record;
+    while (reader.next_packet(cursor, record)) {
+      if ((cursor.packet - 1) % stride == 0) {
+        entries.push_back({record.offset, record.ts_ns});
+      }
+    }
+
+    PcapIndexHeader header{};
+    std::memcpy(header.magic, kPcapIndexMagic, sizeof(header.magic));
+    header.version = kPcapIndexVersion;
+    header.stride = stride;
+    header.capture_size = reader.file_size();
+    header.fingerprint = capture_fingerprint(reader.data(), reader.file_size());
+    header.packet_count = cursor.packet;
+    header.entry_count = entries.size();
+
+    FILE *f = std::fopen(path, "wb");
+    if (f == nullptr) {
+      return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1;
+    if (ok && !entries.empty()) {
+      ok = std::fwrite(entries.data(), sizeof(PcapIndexEntry), entries.size(),
+                       f) == entries.size();
+    }
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok) {
+      std::remove(path);
+    }
+    return ok;
+  }
+
+  /**
+   * @brief Map the index at `path` and check that it describes `reader`'s
+   *        capture.
+   * @return false if the index is missing, malformed or stale.
+   */
+  bool open(const char *path, const PcapReader &reader) {
+    close();
+    if (!reader.is_open() || !file_.open(path)) {
+      return false;
+    }
+    if (file_.size() < sizeof(PcapIndexHeader)) {
+      close();
+      return false;
+    }
+
+    std::memcpy(&header_, file_.data(), sizeof(header_));
+    const bool valid =
+        std::memcmp(header_.magic, kPcapIndexMagic, sizeof(header_.magic)) ==
+            0 &&
+        header_.version == kPcapIndexVersion && header_.stride != 0 &&
+        header_.entry_count ==
+            (header_.packet_count + header_.stride - 1) / header_.stride &&
+        file_.size() == sizeof(PcapIndexHeader) +
+                            header_.entry_count * sizeof(PcapIndexEntry) &&
+        header_.capture_size == reader.file_size() &&
+        header_.fingerprint ==
+            capture_fingerprint(reader.data(), reader.file_size());
+    if (!valid) {
+      close();
+      return false;
+    }
+    entries_ = reinterpret_cast<const PcapIndexEntry *>(
+        file_.data() + sizeof(PcapIndexHeader));
+    return true;
+  }
+
+  void close() noexcept {
+    file_.close();
+    header_ = PcapIndexHeader{};
+    entries_ = nullptr;
+  }
+
+  [[nodiscard]] bool is_open() const noexcept { return file_.is_open(); }
+  [[nodiscard]] uint32_t stride() const noexcept { return header_.stride; }
+  [[nodiscard]] uint64_t packet_count() const noexcept {
+    return header_.packet_count;
+  }
+  [[nodiscard]] size_t entry_count() const noexcept {
+    return static_cast<size_t>(header_.entry_count);
+  }
+
+  /**
+   * @brief Entry `i` (< entry_count()): packet i * stride().
+   */
+  [[nodiscard]] const PcapIndexEntry &entry(size_t i) const noexcept {
+    return entries_[i];
+  }
+
+  /**
+   * @brief Cursor past the last packet.
+   */
+  [[nodiscard]] PacketCursor end() const noexcept {
+    return {static_cast<size_t>(header_.capture_size), header_.packet_count};
+  }
+
+private:
+  MappedFile file_;
+  PcapIndexHeader header_{};
+  const PcapIndexEntry *entries_ = nullptr;
+};
+
+// ============================================================================
+// PcapReader Seeking
+// ============================================================================
+
+inline PacketCursor PcapReader::seek_to_packet(const PcapIndex &index,
+                                               uint64_t packet) const noexcept {
+  if (!is_open() || packet >= index.packet_count()) {
+    return index.end();
+  }
+  const uint64_t slot = packet / index.stride();
+  PacketCursor cursor{static_cast<size_t>(index.entry(slot).offset),
+                      slot * index.stride()};
+  PacketRecord record;
+  while (cursor.packet < packet) {
+    if (!read_packet<false>(cursor.offset, record)) {
+      return index.end();
+    }
+    ++cursor.packet;
+  }
+  return cursor;
+}
+
+inline PacketCursor PcapReader::seek_to_time(const PcapIndex &index,
+                                             uint64_t ts_ns) const noexcept {
+  if (!is_open() || index.entry_count() == 0) {
+    return index.end();
+  }
+
+  // Last entry strictly before ts_ns (entry 0 if none): packets stamped
+  // ts_ns may start anywhere after it, even ahead of later equal entries
+  size_t lo = 0;
+  size_t hi = index.entry_count();
+  while (hi - lo > 1) {
+    const size_t mid = lo + (hi - lo) / 2;
+    if (index.entry(mid).ts_ns < ts_ns) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+
+  size_t offset = static_cast<size_t>(index.entry(lo).offset);
+  uint64_t packet = lo * index.stride();
+  PacketRecord record;
+  record.ts_ns = index.entry(lo).ts_ns; // Simple Packet Blocks inherit it
+  while (read_packet<true>(offset, record)) {
+    if (record.ts_ns >= ts_ns) {
+      return {record.offset, packet};
+    }
+    ++packet;
+  }
+  return index.end();
+}
+
+} // namespace itch
@@ -2,11 +2,12 @@
 
 /**
  * @file pcap_reader.hpp
- * @brief Zero-copy PCAP file reader using mmap.
+ * @brief Zero-copy PCAP / pcapng file reader using mmap.
  *
  * DESIGN PRINCIPLES:
  * 1. No libpcap dependency - manual header parsing.
- * 2. mmap entire file for zero-copy access.
+ * 2. mmap entire file for zero-copy access; how its pages fault in is
+ *    selectable (MapOptions, see mapped_file.hpp).
  * 3. Direct pointer passing to parser (no memcpy).
  *
  * PCAP File Format:
@@ -14,15 +15,28 @@
  *   For each packet:
  *     Packet Header: 16 bytes (ts_sec, ts_usec, incl_len, orig_len)
  *     Packet Data: incl_len bytes
+ *
+ * pcapng File Format:
+ *   Sequence of blocks: type (4), total length (4), body, total length (4)
+ *   Section Header Block:        byte order of the section
+ *   Interface Description Block: link type, snaplen, if_tsresol option
+ *   Enhanced / Simple Packet:    packet data, padded to 4 bytes
+ *   Any other block is skipped by its total length.
+ *
+ * Packets are handed over without their interface, so a pcapng capture
+ * must use one link type throughout: open() refuses one whose interfaces
+ * disagree before the first packet, and iteration ends at a later
+ * Interface Description Block with another link type.
  */
 
+#include "mapped_file.hpp"
+#include "net_decoder.hpp"
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
-#include <fcntl.h>
-#include <sys/mman.h>
-#include <sys/stat.h>
-#include <unistd.h>
+#include <type_traits>
+#include <utility>
 
 namespace itch {
 
@@ -59,15 +73,179 @@ struct __attribute__((packed)) PcapPacketHeader {
 static_assert(sizeof(PcapPacketHeader) == 16,
               "PcapPacketHeader must be 16 bytes");
 
+// ============================================================================
+// pcapng Block Structures
+// ============================================================================
+
+/// Section Header Block type (a palindrome: same in either byte order)
+inline constexpr uint32_t kPcapNgSectionHeader = 0x0A0D0D0A;
+inline constexpr uint32_t kPcapNgInterfaceDescription = 0x00000001;
+inline constexpr uint32_t kPcapNgSimplePacket = 0x00000003;
+inline constexpr uint32_t kPcapNgEnhancedPacket = 0x00000006;
+
+/// Section Header byte-order magic, as written by the capturing host
+inline constexpr uint32_t kPcapNgByteOrderMagic = 0x1A2B3C4D;
+
+/// if_tsresol option code in an Interface Description Block
+inline constexpr uint16_t kPcapNgOptionTsResol = 9;
+
+/// Interfaces tracked per section; packets on later ones still iterate
+inline constexpr size_t kMaxPcapInterfaces = 16;
+
+/**
+ * @brief pcapng block framing (8 bytes, followed by body and a trailing
+ *        copy of total_length).
+ */
+struct __attribute__((packed)) PcapNgBlockHeader {
+  uint32_t block_type;
+  uint32_t total_length; // Whole block, header and trailer included
+};
+
+static_assert(sizeof(PcapNgBlockHeader) == 8,
+              "PcapNgBlockHeader must be 8 bytes");
+
+/**
+ * @brief Enhanced Packet Block body prefix (20 bytes).
+ */
+struct __attribute__((packed)) PcapNgEnhancedPacketHeader {
+  uint32_t interface_id;
+  uint32_t ts_high; // Timestamp in if_tsresol units, upper 32 bits
+  uint32_t ts_low;
+  uint32_t cap_len; // Bytes of packet data present
+  uint32_t orig_len;
+};
+
+static_assert(sizeof(PcapNgEnhancedPacketHeader) == 20,
+              "PcapNgEnhancedPacketHeader must be 20 bytes");
+
+/// Smallest legal block: header plus trailing length
+inline constexpr size_t kPcapNgMinBlock = sizeof(PcapNgBlockHeader) + 4;
+
+/**
+ * @brief Container the file was recognised as.
+ */
+enum class CaptureFormat : uint8_t {
+  Pcap,  ///< Classic libpcap (microsecond or nanosecond magic)
+  PcapNg ///< pcapng block format
+};
+
+/**
+ * @brief Capture interface: link type and timestamp resolution.
+ *
+ * Classic PCAP files have exactly one, described by the global header.
+ */
+struct PcapInterface {
+  LinkType link_type = LinkType::Ethernet;
+  uint32_t snaplen = 0;
+  uint8_t tsresol = 6; ///< if_tsresol: MSB clear = 10^-n s, set = 2^-n s
+
+  /**
+   * @brief Convert a timestamp in this interface's units to nanoseconds.
+   */
+  [[nodiscard]] uint64_t to_nanos(uint64_t ticks) const noexcept {
+    const uint8_t exp = tsresol & 0x7F;
+    if ((tsresol & 0x80) != 0) {
+      if (exp >= 64) {
+        return 0;
+      }
+      __extension__ typedef unsigned __int128 u128;
+      return static_cast<uint64_t>((static_cast<u128>(ticks) * 1000000000u) >>
+                                   exp);
+    }
+    if (exp >= 29) {
+      return 0; // Finer than 10^-28 s: any 64-bit count is under 1 ns
+    }
+    const int digits = exp <= 9 ? 9 - exp : exp - 9;
+    uint64_t scale = 1;
+    for (int i = 0; i < digits; ++i) {
+      scale *= 10;
+    }
+    return exp <= 9 ? ticks * scale : ticks / scale;
+  }
+};
+
+namespace detail {
+
+/// Unaligned capture field reads, byte-swapped for opposite-endian files
+[[nodiscard]] inline uint32_t pcap_load32(const void *p, bool swap) noexcept {
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return swap ? __builtin_bswap32(v) : v;
+}
+
+[[nodiscard]] inline uint16_t pcap_load16(const void *p, bool swap) noexcept {
+  uint16_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return swap ? __builtin_bswap16(v) : v;
+}
+
+} // namespace detail
+
+/**
+ * @brief Decode an Interface Description Block body.
+ */
+[[nodiscard]] inline PcapInterface
+decode_pcapng_interface(const char *body, size_t len, bool swap) noexcept {
+  PcapInterface iface;
+  if (len < 8) {
+    return iface;
+  }
+  iface.link_type = static_cast<LinkType>(detail::pcap_load16(body, swap));
+  iface.snaplen = detail::pcap_load32(body + 4, swap);
+
+  // Options: code (2), length (2), value padded to 4; code 0 ends
+  size_t off = 8;
+  while (off + 4 <= len) {
+    const uint16_t code = detail::pcap_load16(body + off, swap);
+    const uint16_t opt_len = detail::pcap_load16(body + off + 2, swap);
+    if (code == 0 || off + 4 + opt_len > len) {
+      break;
+    }
+    if (code == kPcapNgOptionTsResol && opt_len >= 1) {
+      iface.tsresol = static_cast<uint8_t>(body[off + 4]);
+    }
+    off += 4 + ((opt_len + 3u) & ~size_t{3});
+  }
+  return iface;
+}
+
+// ============================================================================
+// Packet Cursors
+// ============================================================================
+
+/**
+ * @brief Position of a packet record within a capture.
+ *
+ * Obtained from PcapReader::first_packet(), next_packet() or the seek
+ * functions; only meaningful for the capture it came from.
+ */
+struct PacketCursor {
+  size_t offset = 0;   ///< Record (PCAP) or block (pcapng) to read next
+  uint64_t packet = 0; ///< Zero-based number of that packet
+};
+
+/**
+ * @brief One packet returned by PcapReader::next_packet().
+ */
+struct PacketRecord {
+  const char *data = nullptr; ///< Payload (zero-copy, into the mapping)
+  size_t length = 0;          ///< Captured bytes
+  uint64_t ts_ns = 0;         ///< Capture time, ns since the epoch
+  size_t offset = 0;          ///< Where the record starts in the file
+};
+
+class PcapIndex;
+
 // ============================================================================
 // PCAP Reader Class
 // ============================================================================
 
 /**
- * @brief Memory-mapped PCAP file reader.
+ * @brief Memory-mapped PCAP / pcapng file reader.
  *
- * Opens a PCAP file, mmaps it into memory, and provides iteration
- * over packet payloads with zero-copy semantics.
+ * Opens a capture file, mmaps it into memory, and provides iteration
+ * over packet payloads with zero-copy semantics. The container format is
+ * detected from the leading magic.
  *
  * @example
  *   PcapReader reader("data.pcap");
@@ -76,12 +254,19 @@ static_assert(sizeof(PcapPacketHeader) == 16,
  *   reader.for_each_packet([&](const char* data, size_t len) {
  *       parser.parse(data, len, handler);
  *   });
+ *
+ *   // Capture timestamps (ns since the epoch) on request
+ *   reader.for_each_packet([&](const char* data, size_t len, uint64_t ts) {
+ *       pacer.wait(ts);
+ *   });
  */
 class PcapReader {
 public:
   PcapReader() = default;
 
-  explicit PcapReader(const char *filename) { open(filename); }
+  explicit PcapReader(const char *filename, const MapOptions &options = {}) {
+    open(filename, options);
+  }
 
   ~PcapReader() { close(); }
 
@@ -91,83 +276,66 @@ public:
 
   // Movable
   PcapReader(PcapReader &&other) noexcept
-      : data_(other.data_), size_(other.size_), fd_(other.fd_),
-        needs_swap_(other.needs_swap_) {
+      : file_(std::move(other.file_)), data_(other.data_), size_(other.size_),
+        needs_swap_(other.needs_swap_), link_type_(other.link_type_),
+        format_(other.format_), interfaces_(other.interfaces_),
+        interface_count_(other.interface_count_),
+        first_offset_(other.first_offset_) {
     other.data_ = nullptr;
     other.size_ = 0;
-    other.fd_ = -1;
   }
 
   PcapReader &operator=(PcapReader &&other) noexcept {
     if (this != &other) {
       close();
+      file_ = std::move(other.file_);
       data_ = other.data_;
       size_ = other.size_;
-      fd_ = other.fd_;
       needs_swap_ = other.needs_swap_;
+      link_type_ = other.link_type_;
+      format_ = other.format_;
+      interfaces_ = other.interfaces_;
+      interface_count_ = other.interface_count_;
+      first_offset_ = other.first_offset_;
       other.data_ = nullptr;
       other.size_ = 0;
-      other.fd_ = -1;
     }
     return *this;
   }
 
   /**
-   * @brief Open and mmap a PCAP file.
-   * @param filename Path to PCAP file.
-   * @return true if successful.
+   * @brief Open and mmap a PCAP or pcapng file.
+   *
+   * The headers are validated through a lazy mapping first, so a file that
+   * is not a capture costs a page or two, not a full populate or copy.
+   *
+   * @param filename Path to capture file.
+   * @param options Page-fault strategy (see MapStrategy).
+   * @return true if successful; false for a pcapng capture whose
+   *         interfaces have different link types.
    */
-  bool open(const char *filename) {
+  bool open(const char *filename, const MapOptions &options = {}) {
     close();
 
-    // Open file
-    fd_ = ::open(filename, O_RDONLY);
-    if (fd_ < 0) {
-      return false;
-    }
-
-    // Get file size
-    struct stat st;
-    if (fstat(fd_, &st) < 0) {
-      ::close(fd_);
-      fd_ = -1;
-      return false;
-    }
-    size_ = static_cast<size_t>(st.st_size);
-
-    // Memory map the file
-    data_ = static_cast<const char *>(
-        mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0));
-    if (data_ == MAP_FAILED) {
-      ::close(fd_);
-      fd_ = -1;
-      data_ = nullptr;
-      size_ = 0;
+    if (!file_.open(filename)) {
       return false;
     }
+    data_ = file_.data();
+    size_ = file_.size();
 
-    // Verify and parse global header
-    if (size_ < sizeof(PcapGlobalHeader)) {
+    if (!read_header()) {
       close();
       return false;
     }
 
-    const auto *global_header =
-        reinterpret_cast<const PcapGlobalHeader *>(data_);
-
-    // Check magic number
-    // Standard PCAP (microsecond): 0xa1b2c3d4 (native) or 0xd4c3b2a1 (swapped)
-    // Nanosecond PCAP:             0xa1b23c4d (native) or 0x4d3cb2a1 (swapped)
-    const uint32_t magic = global_header->magic_number;
-    if (magic == 0xa1b2c3d4 || magic == 0xa1b23c4d) {
-      needs_swap_ = false; // Native byte order
-    } else if (magic == 0xd4c3b2a1 || magic == 0x4d3cb2a1) {
-      needs_swap_ = true; // Need to swap bytes
-    } else {
-      close(); // Invalid PCAP file
-      return false;
+    if (options.strategy != MapStrategy::Lazy) {
+      if (!file_.open(filename, options)) {
+        close();
+        return false;
+      }
+      data_ = file_.data();
+      size_ = file_.size();
     }
-
     return true;
   }
 
@@ -175,15 +343,10 @@ public:
    * @brief Close the file and unmap memory.
    */
   void close() {
-    if (data_ != nullptr) {
-      munmap(const_cast<char *>(data_), size_);
-      data_ = nullptr;
-    }
-    if (fd_ >= 0) {
-      ::close(fd_);
-      fd_ = -1;
-    }
+    file_.close();
+    data_ = nullptr;
     size_ = 0;
+    interface_count_ = 0;
   }
 
   /**
@@ -196,10 +359,43 @@ public:
    */
   [[nodiscard]] size_t file_size() const noexcept { return size_; }
 
+  /**
+   * @brief Data link type of the packets (PcapGlobalHeader::network, or
+   *        that of every pcapng interface).
+   */
+  [[nodiscard]] LinkType link_type() const noexcept { return link_type_; }
+
+  /**
+   * @brief Container format detected by open().
+   */
+  [[nodiscard]] CaptureFormat format() const noexcept { return format_; }
+
+  /**
+   * @brief Interfaces described before the first packet (always 1 for
+   *        classic PCAP).
+   */
+  [[nodiscard]] size_t interface_count() const noexcept {
+    return interface_count_;
+  }
+
+  /**
+   * @brief Interface `index` (< interface_count()).
+   */
+  [[nodiscard]] const PcapInterface &interface(size_t index) const noexcept {
+    return interfaces_[index];
+  }
+
   /**
    * @brief Iterate over all packet payloads.
    *
+   * The timestamp is only decoded when the callback asks for it, so the
+   * two-argument form costs nothing extra.
+   *
    * @tparam Callback Function with signature void(const char* data, size_t len)
+   *                  or void(const char* data, size_t len, uint64_t ts_ns),
+   *                  ts_ns being the capture time in nanoseconds since the
+   *                  epoch (a pcapng Simple Packet Block has none and
+   *                  repeats the previous packet's).
    * @param callback Called for each packet's payload.
    * @return Number of packets processed.
    */
@@ -208,18 +404,20 @@ public:
     if (!is_open()) {
       return 0;
     }
+    if (format_ == CaptureFormat::PcapNg) {
+      return for_each_pcapng_packet(callback);
+    }
 
     size_t offset = sizeof(PcapGlobalHeader);
     size_t packet_count = 0;
+    // ts_usec holds nanoseconds in files with the nanosecond magic
+    const uint64_t frac_to_ns = interfaces_[0].tsresol == 9 ? 1 : 1000;
 
     while (offset + sizeof(PcapPacketHeader) <= size_) {
       const auto *pkt_header =
           reinterpret_cast<const PcapPacketHeader *>(data_ + offset);
 
-      uint32_t incl_len = pkt_header->incl_len;
-      if (needs_swap_) {
-        incl_len = __builtin_bswap32(incl_len);
-      }
+      const uint32_t incl_len = load32(&pkt_header->incl_len);
 
       offset += sizeof(PcapPacketHeader);
 
@@ -230,25 +428,587 @@ public:
 
       // Pass payload directly to callback (zero-copy!)
       const char *payload = data_ + offset;
-      callback(payload, incl_len);
+      if constexpr (kWantsTimestamp<Callback>) {
+        const uint64_t ts_ns =
+            load32(&pkt_header->ts_sec) * uint64_t{1'000'000'000} +
+            load32(&pkt_header->ts_usec) * frac_to_ns;
+        callback(payload, incl_len, ts_ns);
+      } else {
+        callback(payload, incl_len);
+      }
 
       offset += incl_len;
       ++packet_count;
+      file_.consumed(offset); // Paces the ReadAhead thread, if any
+    }
+
+    return packet_count;
+  }
+
+  /**
+   * @brief Cursor at the first packet record.
+   */
+  [[nodiscard]] PacketCursor first_packet() const noexcept {
+    return {first_offset_, 0};
+  }
+
+  /**
+   * @brief Cursor past the last packet (its packet number is unknown
+   *        without an index, and ranges compare offsets only).
+   */
+  [[nodiscard]] PacketCursor end_of_capture() const noexcept {
+    return {size_, 0};
+  }
+
+  /**
+   * @brief False for a pcapng file with more than one section, whose later
+   *        sections the cursor API cannot reach, or with a later interface
+   *        of another link type, where iteration ends. Walks the block
+   *        headers.
+   */
+  [[nodiscard]] bool single_section() const noexcept {
+    if (format_ != CaptureFormat::PcapNg) {
+      return is_open();
+    }
+    bool swap = needs_swap_;
+    size_t offset = first_offset_;
+    Block block;
+    while (read_block(offset, swap, block)) {
+      if (block.type == kPcapNgSectionHeader ||
+          !same_link_type(block, swap)) {
+        return false;
+      }
+      offset += block.total;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Offset of the first packet record at or after `offset`, found
+   *        without walking from the file header.
+   *
+   * A candidate must look like a record - PCAP: incl_len <= orig_len, both
+   * within the snaplen (at most kMaxPlausibleFrame), a sub-second fraction
+   * and a ts_sec within kMaxCaptureSpanSec of the first packet's; pcapng:
+   * a packet block whose trailing length copy matches - and the next
+   * kResyncChain - 1 records must chain from it (or the file must end).
+   * Single-section captures only (see single_section()).
+   *
+   * @return file_size() if no record starts at or after `offset`.
+   */
+  [[nodiscard]] size_t resync(size_t offset) const noexcept {
+    if (offset <= first_offset_) {
+      return first_offset_;
+    }
+    if (format_ == CaptureFormat::PcapNg) {
+      // Every block length is a multiple of 4, so blocks are aligned
+      for (offset = (offset + 3) & ~size_t{3};
+           offset + kPcapNgMinBlock <= size_; offset += 4) {
+        if (records_chain(offset, 0)) {
+          return offset;
+        }
+      }
+      return size_;
+    }
+
+    if (first_offset_ + sizeof(PcapPacketHeader) > size_) {
+      return size_;
+    }
+    const uint32_t first_sec = load32(data_ + first_offset_);
+    for (; offset + sizeof(PcapPacketHeader) <= size_; ++offset) {
+      if (records_chain(offset, first_sec)) {
+        return offset;
+      }
+    }
+    return size_;
+  }
+
+  /**
+   * @brief Read the packet at `cursor` and advance the cursor past it.
+   *
+   * Pull-style counterpart of for_each_packet(). For pcapng files only the
+   * first section is walked, with the interfaces described before its
+   * first packet; a new Section Header ends the walk.
+   *
+   * @param record Receives the packet; a Simple Packet Block keeps the
+   *               timestamp already in `record`.
+   * @return false at the end of the capture.
+   */
+  bool next_packet(PacketCursor &cursor, PacketRecord &record) const noexcept {
+    if (!is_open() || !read_packet<true>(cursor.offset, record)) {
+      return false;
+    }
+    ++cursor.packet;
+    return true;
+  }
+
+  /**
+   * @brief Iterate over the packets in [from, to).
+   *
+   * Same callbacks as for_each_packet(). `to` bounds by file offset, so
+   * end_of_capture() (or an index's end()) runs to the end of the file.
+   *
+   * @return Number of packets processed.
+   */
+  template <typename Callback>
+  size_t for_each_packet_in(PacketCursor from, PacketCursor to,
+                            Callback &&callback) const {
+    if (!is_open()) {
+      return 0;
+    }
+    size_t offset = from.offset;
+    size_t packet_count = 0;
+    PacketRecord record;
+
+    while (read_packet<kWantsTimestamp<Callback>>(offset, record) &&
+           record.offset < to.offset) {
+      if constexpr (kWantsTimestamp<Callback>) {
+        callback(record.data, record.length, record.ts_ns);
+      } else {
+        callback(record.data, record.length);
+      }
+      ++packet_count;
+      file_.consumed(offset);
     }
 
     return packet_count;
   }
 
+  /**
+   * @brief Cursor at packet number `packet`, found from `index` in at most
+   *        index.stride() record hops (defined in pcap_index.hpp).
+   *
+   * @return index.end() if the capture has fewer packets.
+   */
+  [[nodiscard]] PacketCursor seek_to_packet(const PcapIndex &index,
+                                            uint64_t packet) const noexcept;
+
+  /**
+   * @brief Cursor at the first packet captured at or after `ts_ns`
+   *        (defined in pcap_index.hpp).
+   *
+   * Binary search over the index, then a scan of at most one stride when
+   * capture timestamps are non-decreasing. With out-of-order timestamps
+   * the result is the first qualifying packet after the indexed one
+   * preceding `ts_ns`.
+   *
+   * @return index.end() if no packet is that late.
+   */
+  [[nodiscard]] PacketCursor seek_to_time(const PcapIndex &index,
+                                          uint64_t ts_ns) const noexcept;
+
+  /**
+   * @brief Underlying mapping (strategy, read-ahead progress).
+   */
+  [[nodiscard]] const MappedFile &mapping() const noexcept { return file_; }
+
   /**
    * @brief Get raw mmap'd data pointer.
    */
   [[nodiscard]] const char *data() const noexcept { return data_; }
 
 private:
-  const char *data_ = nullptr;
+  /// Largest frame a plausible record may hold (libpcap's MAXIMUM_SNAPLEN)
+  static constexpr uint32_t kMaxPlausibleFrame = 262144;
+
+  /// Records that must chain from a resync() candidate
+  static constexpr int kResyncChain = 8;
+
+  /// Furthest a plausible timestamp may lie from the first packet's
+  static constexpr uint32_t kMaxCaptureSpanSec = 7 * 86400;
+
+  template <typename Callback>
+  static constexpr bool kWantsTimestamp =
+      std::is_invocable_v<Callback &, const char *, size_t, uint64_t>;
+
+  /**
+   * @brief One validated pcapng block.
+   */
+  struct Block {
+    uint32_t type;
+    const char *body;
+    size_t body_len;
+    size_t total; // Bytes to the next block
+  };
+
+  [[nodiscard]] static uint32_t load32(const void *p, bool swap) noexcept {
+    return detail::pcap_load32(p, swap);
+  }
+
+  [[nodiscard]] uint32_t load32(const void *p) const noexcept {
+    return load32(p, needs_swap_);
+  }
+
+  /**
+   * @brief Decode the block at `offset`.
+   *
+   * A Section Header Block switches `swap` to the new section's byte
+   * order before its length is read.
+   *
+   * @return false at end of file, on a truncated block, or on a length
+   *         that cannot be trusted to find the next block.
+   */
+  bool read_block(size_t offset, bool &swap, Block &out) const noexcept {
+    if (offset + kPcapNgMinBlock > size_) {
+      return false;
+    }
+    const char *block = data_ + offset;
+    out.type = load32(block, swap);
+    if (out.type == kPcapNgSectionHeader) {
+      const uint32_t bom = load32(block + sizeof(PcapNgBlockHeader), false);
+      if (bom == kPcapNgByteOrderMagic) {
+        swap = false;
+      } else if (bom == __builtin_bswap32(kPcapNgByteOrderMagic)) {
+        swap = true;
+      } else {
+        return false;
+      }
+    }
+    const size_t total = load32(block + 4, swap);
+    if (total < kPcapNgMinBlock || total % 4 != 0 || total > size_ - offset) {
+      return false;
+    }
+    out.body = block + sizeof(PcapNgBlockHeader);
+    out.body_len = total - kPcapNgMinBlock;
+    out.total = total;
+    return true;
+  }
+
+  /**
+   * @brief False for an Interface Description Block whose link type
+   *        differs from link_type().
+   */
+  [[nodiscard]] bool same_link_type(const Block &block,
+                                    bool swap) const noexcept {
+    return block.type != kPcapNgInterfaceDescription ||
+           decode_pcapng_interface(block.body, block.body_len, swap)
+                   .link_type == link_type_;
+  }
+
+  /**
+   * @brief Detect the format and decode the file header(s).
+   */
+  bool read_header() noexcept {
+    uint32_t leading = 0;
+    if (size_ >= sizeof(leading)) {
+      std::memcpy(&leading, data_, sizeof(leading));
+    }
+    if (leading == kPcapNgSectionHeader) {
+      return open_pcapng();
+    }
+
+    // Verify and parse global header
+    if (size_ < sizeof(PcapGlobalHeader)) {
+      return false;
+    }
+
+    const auto *global_header =
+        reinterpret_cast<const PcapGlobalHeader *>(data_);
+
+    // Check magic number
+    // Standard PCAP (microsecond): 0xa1b2c3d4 (native) or 0xd4c3b2a1 (swapped)
+    // Nanosecond PCAP:             0xa1b23c4d (native) or 0x4d3cb2a1 (swapped)
+    const uint32_t magic = global_header->magic_number;
+    if (magic == 0xa1b2c3d4 || magic == 0xa1b23c4d) {
+      needs_swap_ = false; // Native byte order
+    } else if (magic == 0xd4c3b2a1 || magic == 0x4d3cb2a1) {
+      needs_swap_ = true; // Need to swap bytes
+    } else {
+      return false; // Invalid PCAP file
+    }
+
+    format_ = CaptureFormat::Pcap;
+    PcapInterface &iface = interfaces_[0];
+    iface.link_type = static_cast<LinkType>(load32(&global_header->network));
+    iface.snaplen = load32(&global_header->snaplen);
+    iface.tsresol = (magic == 0xa1b23c4d || magic == 0x4d3cb2a1) ? 9 : 6;
+    interface_count_ = 1;
+    link_type_ = iface.link_type;
+    first_offset_ = sizeof(PcapGlobalHeader);
+
+    return true;
+  }
+
+  /**
+   * @brief Validate the first Section Header and collect the interfaces
+   *        described before the first packet (which must share a link
+   *        type).
+   */
+  bool open_pcapng() noexcept {
+    bool swap = false;
+    Block block;
+    if (!read_block(0, swap, block) || block.body_len < 16) {
+      return false;
+    }
+    format_ = CaptureFormat::PcapNg;
+    needs_swap_ = swap;
+    interface_count_ = 0;
+
+    size_t offset = block.total;
+    first_offset_ = offset;
+    while (read_block(offset, swap, block) &&
+           block.type != kPcapNgSectionHeader &&
+           block.type != kPcapNgEnhancedPacket &&
+           block.type != kPcapNgSimplePacket) {
+      if (block.type == kPcapNgInterfaceDescription &&
+          interface_count_ < kMaxPcapInterfaces) {
+        interfaces_[interface_count_++] =
+            decode_pcapng_interface(block.body, block.body_len, swap);
+      }
+      offset += block.total;
+    }
+    link_type_ = interface_count_ > 0 ? interfaces_[0].link_type
+                                      : LinkType::Ethernet;
+    for (size_t i = 1; i < interface_count_; ++i) {
+      if (interfaces_[i].link_type != link_type_) {
+        return false; // Packets carry no link type to decode them by
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Length of the plausible record at `offset`, or 0 if the bytes
+   *        there cannot be one.
+   *
+   * @param packet_only pcapng: accept packet blocks only (any block but a
+   *                    Section Header otherwise).
+   */
+  [[nodiscard]] size_t plausible_record(size_t offset, uint32_t first_sec,
+                                        bool packet_only) const noexcept {
+    if (format_ == CaptureFormat::PcapNg) {
+      const char *block = data_ + offset;
+      const uint32_t type = load32(block);
+      const size_t total = load32(block + 4);
+      if (type == kPcapNgSectionHeader || total < kPcapNgMinBlock ||
+          total % 4 != 0 || total > size_ - offset ||
+          load32(block + total - 4) != total) {
+        return 0;
+      }
+      const size_t body_len = total - kPcapNgMinBlock;
+      if (type == kPcapNgEnhancedPacket) {
+        const bool ok = body_len >= sizeof(PcapNgEnhancedPacketHeader) &&
+                        load32(block + 8) < kMaxPcapInterfaces &&
+                        load32(block + 20) <= body_len - 20;
+        return ok ? total : 0;
+      }
+      if (type == kPcapNgSimplePacket) {
+        return body_len >= 4 ? total : 0;
+      }
+      return packet_only ? 0 : total;
+    }
+
+    const auto *pkt_header =
+        reinterpret_cast<const PcapPacketHeader *>(data_ + offset);
+    const uint32_t incl_len = load32(&pkt_header->incl_len);
+    const uint32_t orig_len = load32(&pkt_header->orig_len);
+    const uint32_t ts_sec = load32(&pkt_header->ts_sec);
+    const uint32_t snaplen = interfaces_[0].snaplen;
+    const uint32_t limit = snaplen != 0 && snaplen < kMaxPlausibleFrame
+                               ? snaplen
+                               : kMaxPlausibleFrame;
+    const uint32_t span =
+        ts_sec > first_sec ? ts_sec - first_sec : first_sec - ts_sec;
+    const bool ok = incl_len <= orig_len && incl_len <= limit &&
+                    orig_len <= kMaxPlausibleFrame &&
+                    load32(&pkt_header->ts_usec) < 1'000'000'000 &&
+                    span <= kMaxCaptureSpanSec &&
+                    incl_len <= size_ - offset - sizeof(PcapPacketHeader);
+    return ok ? sizeof(PcapPacketHeader) + incl_len : 0;
+  }
+
+  /**
+   * @brief True if kResyncChain plausible records chain from `offset`
+   *        (fewer if the file ends exactly after the last).
+   */
+  [[nodiscard]] bool records_chain(size_t offset,
+                                   uint32_t first_sec) const noexcept {
+    const size_t min_record = format_ == CaptureFormat::PcapNg
+                                  ? kPcapNgMinBlock
+                                  : sizeof(PcapPacketHeader);
+    for (int i = 0; i < kResyncChain; ++i) {
+      if (offset == size_) {
+        return true;
+      }
+      if (offset + min_record > size_) {
+        return false;
+      }
+      const size_t len = plausible_record(offset, first_sec, i == 0);
+      if (len == 0) {
+        return false;
+      }
+      offset += len;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Decode the packet record at or after `offset` and move `offset`
+   *        past it.
+   *
+   * Classic records are read in place; pcapng blocks that carry no packet
+   * are skipped. Used by the cursor API, which is limited to the first
+   * pcapng section (interface numbering restarts with each section) and
+   * stops at an interface of another link type.
+   */
+  template <bool WantTs>
+  bool read_packet(size_t &offset, PacketRecord &out) const noexcept {
+    if (format_ == CaptureFormat::Pcap) {
+      if (offset + sizeof(PcapPacketHeader) > size_) {
+        return false;
+      }
+      const auto *pkt_header =
+          reinterpret_cast<const PcapPacketHeader *>(data_ + offset);
+      const uint32_t incl_len = load32(&pkt_header->incl_len);
+      if (offset + sizeof(PcapPacketHeader) + incl_len > size_) {
+        return false; // Truncated packet
+      }
+      out.data = data_ + offset + sizeof(PcapPacketHeader);
+      out.length = incl_len;
+      out.offset = offset;
+      if constexpr (WantTs) {
+        const uint64_t frac_to_ns = interfaces_[0].tsresol == 9 ? 1 : 1000;
+        out.ts_ns = load32(&pkt_header->ts_sec) * uint64_t{1'000'000'000} +
+                    load32(&pkt_header->ts_usec) * frac_to_ns;
+      }
+      offset += sizeof(PcapPacketHeader) + incl_len;
+      return true;
+    }
+
+    bool swap = needs_swap_;
+    Block block;
+    while (read_block(offset, swap, block) &&
+           block.type != kPcapNgSectionHeader && same_link_type(block, swap)) {
+      const size_t start = offset;
+      offset += block.total;
+
+      if (block.type == kPcapNgEnhancedPacket) {
+        if (block.body_len < sizeof(PcapNgEnhancedPacketHeader)) {
+          continue;
+        }
+        const size_t cap_len = load32(block.body + 12, swap);
+        if (cap_len > block.body_len - sizeof(PcapNgEnhancedPacketHeader)) {
+          continue;
+        }
+        out.data = block.body + sizeof(PcapNgEnhancedPacketHeader);
+        out.length = cap_len;
+        out.offset = start;
+        if constexpr (WantTs) {
+          const uint32_t id = load32(block.body, swap);
+          const uint64_t ticks =
+              (uint64_t{load32(block.body + 4, swap)} << 32) |
+              load32(block.body + 8, swap);
+          out.ts_ns = id < interface_count_
+                          ? interfaces_[id].to_nanos(ticks)
+                          : PcapInterface{}.to_nanos(ticks);
+        }
+        return true;
+      }
+      if (block.type == kPcapNgSimplePacket && block.body_len >= 4) {
+        size_t cap_len = load32(block.body, swap);
+        if (interface_count_ > 0 && interfaces_[0].snaplen != 0 &&
+            interfaces_[0].snaplen < cap_len) {
+          cap_len = interfaces_[0].snaplen;
+        }
+        if (cap_len > block.body_len - 4) {
+          cap_len = block.body_len - 4;
+        }
+        out.data = block.body + 4;
+        out.length = cap_len;
+        out.offset = start;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Block walk behind for_each_packet() for pcapng files.
+   *
+   * Interfaces are re-collected as the walk goes, since every new section
+   * restarts interface numbering. One of another link type ends the walk.
+   */
+  template <typename Callback>
+  size_t for_each_pcapng_packet(Callback &callback) const {
+    std::array<PcapInterface, kMaxPcapInterfaces> interfaces;
+    size_t interface_count = 0;
+    bool swap = needs_swap_;
+    size_t offset = 0;
+    size_t packet_count = 0;
+    [[maybe_unused]] uint64_t ts_ns = 0; // Timestamp callbacks only
+    Block block;
+
+    while (read_block(offset, swap, block)) {
+      offset += block.total;
+      file_.consumed(offset);
+
+      if (block.type == kPcapNgEnhancedPacket) {
+        if (block.body_len < sizeof(PcapNgEnhancedPacketHeader)) {
+          continue;
+        }
+        const size_t cap_len = load32(block.body + 12, swap);
+        if (cap_len > block.body_len - sizeof(PcapNgEnhancedPacketHeader)) {
+          continue; // Corrupt record; the block length still holds
+        }
+        const char *payload = block.body + sizeof(PcapNgEnhancedPacketHeader);
+        if constexpr (kWantsTimestamp<Callback>) {
+          const uint32_t id = load32(block.body, swap);
+          const uint64_t ticks =
+              (uint64_t{load32(block.body + 4, swap)} << 32) |
+              load32(block.body + 8, swap);
+          ts_ns = id < interface_count ? interfaces[id].to_nanos(ticks)
+                                       : PcapInterface{}.to_nanos(ticks);
+          callback(payload, cap_len, ts_ns);
+        } else {
+          callback(payload, cap_len);
+        }
+        ++packet_count;
+      } else if (block.type == kPcapNgSimplePacket) {
+        if (block.body_len < 4) {
+          continue;
+        }
+        // Captured length is implied: original length cut to snaplen
+        // (and to the block, which also holds the padding)
+        size_t cap_len = load32(block.body, swap);
+        if (interface_count > 0 && interfaces[0].snaplen != 0 &&
+            interfaces[0].snaplen < cap_len) {
+          cap_len = interfaces[0].snaplen;
+        }
+        if (cap_len > block.body_len - 4) {
+          cap_len = block.body_len - 4;
+        }
+        if constexpr (kWantsTimestamp<Callback>) {
+          callback(block.body + 4, cap_len, ts_ns);
+        } else {
+          callback(block.body + 4, cap_len);
+        }
+        ++packet_count;
+      } else if (block.type == kPcapNgInterfaceDescription) {
+        const PcapInterface iface =
+            decode_pcapng_interface(block.body, block.body_len, swap);
+        if (iface.link_type != link_type_) {
+          break;
+        }
+        if (interface_count < kMaxPcapInterfaces) {
+          interfaces[interface_count++] = iface;
+        }
+      } else if (block.type == kPcapNgSectionHeader) {
+        interface_count = 0;
+      }
+    }
+
+    return packet_count;
+  }
+
+  MappedFile file_;
+  const char *data_ = nullptr; // file_.data(), cached for the hot loops
   size_t size_ = 0;
-  int fd_ = -1;
   bool needs_swap_ = false;
+  LinkType link_type_ = LinkType::Ethernet;
+  CaptureFormat format_ = CaptureFormat::Pcap;
+  std::array<PcapInterface, kMaxPcapInterfaces> interfaces_{};
+  size_t interface_count_ = 0;
+  size_t first_offset_ = 0; ///< First record after the file header(s)
 };
 
 } // namespace itch
@@ -0,0 +1,476 @@
+#pragma once
+
+/**
+ * @file pcap_stream_reader.hpp
+ * @brief Bounded-memory PCAP / pcapng reader over a ChunkedFile.
+ *
+ * DESIGN PRINCIPLES:
+ * 1. Same packet callbacks as PcapReader, so a consumer switches between
+ *    the mapped and the streaming reader without changes.
+ * 2. Packets are passed in place from the I/O buffers; only a record that
+ *    straddles two buffers is copied, into a fixed carry buffer.
+ * 3. Memory is fixed at open(): the buffer ring plus the carry buffer.
+ *
+ * Records larger than kCarryCapacity that straddle a buffer boundary
+ * cannot be reassembled: they are skipped and counted in oversize().
+ *
+ * USAGE:
+ *   PcapStreamReader reader("week.pcap", {StreamBackend::Auto, 8 << 20});
+ *   reader.for_each_packet([&](const char* data, size_t len) {
+ *       parser.parse(data, len, handler);
+ *   });
+ */
+
+#include "chunked_file.hpp"
+#include "pcap_reader.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
+
+namespace itch {
+
+/**
+ * @brief Streaming counterpart of PcapReader.
+ *
+ * for_each_packet() may be called repeatedly; each call streams the file
+ * again from the start. Not copyable or movable (owns a ChunkedFile).
+ */
+class PcapStreamReader {
+public:
+  /// Largest record reassembled across a buffer boundary
+  static constexpr size_t kCarryCapacity = size_t{512} << 10;
+
+  /// Bytes read synchronously by open() to decode the file header(s)
+  static constexpr size_t kProbeBytes = size_t{64} << 10;
+
+  PcapStreamReader() = default;
+
+  explicit PcapStreamReader(const char *filename,
+                            const StreamOptions &options = {}) {
+    open(filename, options);
+  }
+
+  PcapStreamReader(const PcapStreamReader &) = delete;
+  PcapStreamReader &operator=(const PcapStreamReader &) = delete;
+
+  /**
+   * @brief Decode the capture header and allocate the buffer ring.
+   * @return false if the file is missing or not a PCAP / pcapng capture,
+   *         or its pcapng interfaces have different link types (as in
+   *         PcapReader::open()).
+   */
+  bool open(const char *filename, const StreamOptions &options = {}) {
+    close();
+    if (!probe(filename)) {
+      return false;
+    }
+    if (!file_.open(filename, options)) {
+      close();
+      return false;
+    }
+    carry_.resize(kCarryCapacity);
+    return true;
+  }
+
+  void close() noexcept {
+    file_.close();
+    open_ = false;
+    interface_count_ = 0;
+  }
+
+  [[nodiscard]] bool is_open() const noexcept { return open_; }
+  [[nodiscard]] size_t file_size() const noexcept {
+    return static_cast<size_t>(file_.size());
+  }
+  [[nodiscard]] LinkType link_type() const noexcept { return link_type_; }
+  [[nodiscard]] CaptureFormat format() const noexcept { return format_; }
+
+  /**
+   * @brief Underlying buffer ring (backend, O_DIRECT, memory use).
+   */
+  [[nodiscard]] const ChunkedFile &stream() const noexcept { return file_; }
+
+  /**
+   * @brief Fixed memory held while open: buffer ring plus carry buffer.
+   */
+  [[nodiscard]] size_t memory_bytes() const noexcept {
+    return file_.memory_bytes() + kCarryCapacity;
+  }
+
+  /**
+   * @brief True if the last pass stopped on an I/O error, on a record
+   *        that could not be framed, or on a pcapng interface whose link
+   *        type differs from link_type().
+   */
+  [[nodiscard]] bool failed() const noexcept { return failed_; }
+
+  /**
+   * @brief Records skipped in the last pass for exceeding kCarryCapacity.
+   */
+  [[nodiscard]] uint64_t oversize() const noexcept { return oversize_; }
+
+  /**
+   * @brief Iterate over all packet payloads, as PcapReader::for_each_packet.
+   *
+   * @return Number of packets processed.
+   */
+  template <typename Callback> size_t for_each_packet(Callback &&callback) {
+    if (!is_open() || !file_.start()) {
+      return 0;
+    }
+    Pass pass;
+    pass.swap = needs_swap_;
+    if (format_ == CaptureFormat::Pcap) {
+      pass.skip = sizeof(PcapGlobalHeader);
+      pass.interfaces[0] = interfaces_[0];
+      pass.interface_count = 1;
+    }
+    failed_ = false;
+    oversize_ = 0;
+    carry_len_ = 0;
+
+    const char *chunk = nullptr;
+    size_t length = 0;
+    while (!failed_ && file_.next(chunk, length)) {
+      size_t pos = consume_carry(chunk, length, pass, callback);
+
+      while (!failed_ && pos < length) {
+        const size_t avail = length - pos;
+        if (avail < header_bytes()) {
+          break;
+        }
+        const size_t total = record_length(chunk + pos, pass.swap);
+        if (total == 0) {
+          failed_ = true;
+          break;
+        }
+        if (total > avail) {
+          break;
+        }
+        handle_record(chunk + pos, total, pass, callback);
+        pos += total;
+      }
+
+      // Keep the partial record for the next chunk
+      if (!failed_ && pos < length) {
+        carry(chunk + pos, length - pos, pass);
+      }
+    }
+    if (file_.failed()) {
+      failed_ = true;
+    }
+    return pass.packets;
+  }
+
+private:
+  template <typename Callback>
+  static constexpr bool kWantsTimestamp =
+      std::is_invocable_v<Callback &, const char *, size_t, uint64_t>;
+
+  /**
+   * @brief Framing state of one pass over the file.
+   */
+  struct Pass {
+    bool swap = false;
+    size_t skip = 0;  ///< Bytes still to discard (header, oversize record)
+    size_t packets = 0;
+    uint64_t ts_ns = 0; ///< Last timestamp (Simple Packet Blocks reuse it)
+    std::array<PcapInterface, kMaxPcapInterfaces> interfaces{};
+    size_t interface_count = 0;
+  };
+
+  [[nodiscard]] size_t header_bytes() const noexcept {
+    // pcapng: type, length and (for a Section Header) the byte-order magic
+    return format_ == CaptureFormat::Pcap ? sizeof(PcapPacketHeader)
+                                          : kPcapNgMinBlock;
+  }
+
+  /**
+   * @brief Total length of the record starting at `p` (header_bytes()
+   *        available), or 0 if it cannot be framed.
+   */
+  [[nodiscard]] size_t record_length(const char *p,
+                                     bool swap) const noexcept {
+    if (format_ == CaptureFormat::Pcap) {
+      return sizeof(PcapPacketHeader) + detail::pcap_load32(p + 8, swap);
+    }
+    if (detail::pcap_load32(p, swap) == kPcapNgSectionHeader) {
+      const uint32_t bom = detail::pcap_load32(p + 8, false);
+      if (bom == kPcapNgByteOrderMagic) {
+        swap = false;
+      } else if (bom == __builtin_bswap32(kPcapNgByteOrderMagic)) {
+        swap = true;
+      } else {
+        return 0;
+      }
+    }
+    const size_t total = detail::pcap_load32(p + 4, swap);
+    return total < kPcapNgMinBlock || total % 4 != 0 ? 0 : total;
+  }
+
+  /**
+   * @brief Stash the unfinished record at the end of a chunk.
+   */
+  void carry(const char *p, size_t len, Pass &pass) noexcept {
+    if (len >= header_bytes()) {
+      const size_t total = record_length(p, pass.swap);
+      if (total == 0) {
+        failed_ = true;
+        return;
+      }
+      if (total > kCarryCapacity) {
+        ++oversize_;
+        pass.skip = total - len;
+        return;
+      }
+    }
+    std::memcpy(carry_.data(), p, len);
+    carry_len_ = len;
+  }
+
+  /**
+   * @brief Finish the carried record (or a skip) from the start of a new
+   *        chunk.
+   * @return Bytes of the chunk used.
+   */
+  template <typename Callback>
+  size_t consume_carry(const char *chunk, size_t length, Pass &pass,
+                       Callback &callback) noexcept {
+    size_t pos = 0;
+    if (pass.skip > 0) {
+      pos = pass.skip < length ? pass.skip : length;
+      pass.skip -= pos;
+      return pos;
+    }
+    if (carry_len_ == 0) {
+      return 0;
+    }
+
+    if (carry_len_ < header_bytes()) {
+      const size_t need = header_bytes() - carry_len_;
+      const size_t n = need < length ? need : length;
+      std::memcpy(carry_.data() + carry_len_, chunk, n);
+      carry_len_ += n;
+      pos = n;
+      if (carry_len_ < header_bytes()) {
+        return pos;
+      }
+      const size_t total = record_length(carry_.data(), pass.swap);
+      if (total == 0) {
+        failed_ = true;
+        return pos;
+      }
+      if (total > kCarryCapacity) {
+        ++oversize_;
+        pass.skip = total - carry_len_;
+        carry_len_ = 0;
+        const size_t s = pass.skip < length - pos ? pass.skip : length - pos;
+        pass.skip -= s;
+        return pos + s;
+      }
+    }
+
+    const size_t total = record_length(carry_.data(), pass.swap);
+    const size_t need = total - carry_len_;
+    const size_t n = need < length - pos ? need : length - pos;
+    std::memcpy(carry_.data() + carry_len_, chunk + pos, n);
+    carry_len_ += n;
+    pos += n;
+    if (carry_len_ == total) {
+      carry_len_ = 0;
+      handle_record(carry_.data(), total, pass, callback);
+    }
+    return pos;
+  }
+
+  /**
+   * @brief Dispatch one complete record (packet, or pcapng metadata).
+   */
+  template <typename Callback>
+  void handle_record(const char *p, size_t total, Pass &pass,
+                     Callback &callback) noexcept {
+    if (format_ == CaptureFormat::Pcap) {
+      if constexpr (kWantsTimestamp<Callback>) {
+        const uint64_t frac_to_ns = pass.interfaces[0].tsresol == 9 ? 1 : 1000;
+        pass.ts_ns = detail::pcap_load32(p, pass.swap) *
+                         uint64_t{1'000'000'000} +
+                     detail::pcap_load32(p + 4, pass.swap) * frac_to_ns;
+        callback(p + sizeof(PcapPacketHeader),
+                 total - sizeof(PcapPacketHeader), pass.ts_ns);
+      } else {
+        callback(p + sizeof(PcapPacketHeader),
+                 total - sizeof(PcapPacketHeader));
+      }
+      ++pass.packets;
+      return;
+    }
+
+    const uint32_t type = detail::pcap_load32(p, pass.swap);
+    const char *body = p + sizeof(PcapNgBlockHeader);
+    const size_t body_len = total - kPcapNgMinBlock;
+
+    if (type == kPcapNgEnhancedPacket) {
+      if (body_len < sizeof(PcapNgEnhancedPacketHeader)) {
+        return;
+      }
+      const size_t cap_len = detail::pcap_load32(body + 12, pass.swap);
+      if (cap_len > body_len - sizeof(PcapNgEnhancedPacketHeader)) {
+        return; // Corrupt record; the block length still holds
+      }
+      const char *payload = body + sizeof(PcapNgEnhancedPacketHeader);
+      if constexpr (kWantsTimestamp<Callback>) {
+        const uint32_t id = detail::pcap_load32(body, pass.swap);
+        const uint64_t ticks =
+            (uint64_t{detail::pcap_load32(body + 4, pass.swap)} << 32) |
+            detail::pcap_load32(body + 8, pass.swap);
+        pass.ts_ns = id < pass.interface_count
+                         ? pass.interfaces[id].to_nanos(ticks)
+                         : PcapInterface{}.to_nanos(ticks);
+        callback(payload, cap_len, pass.ts_ns);
+      } else {
+        callback(payload, cap_len);
+      }
+      ++pass.packets;
+    } else if (type == kPcapNgSimplePacket) {
+      if (body_len < 4) {
+        return;
+      }
+      size_t cap_len = detail::pcap_load32(body, pass.swap);
+      if (pass.interface_count > 0 && pass.interfaces[0].snaplen != 0 &&
+          pass.interfaces[0].snaplen < cap_len) {
+        cap_len = pass.interfaces[0].snaplen;
+      }
+      if (cap_len > body_len - 4) {
+        cap_len = body_len - 4;
+      }
+      if constexpr (kWantsTimestamp<Callback>) {
+        callback(body + 4, cap_len, pass.ts_ns);
+      } else {
+        callback(body + 4, cap_len);
+      }
+      ++pass.packets;
+    } else if (type == kPcapNgInterfaceDescription) {
+      const PcapInterface iface =
+          decode_pcapng_interface(body, body_len, pass.swap);
+      if (iface.link_type != link_type_) {
+        failed_ = true; // Packets carry no link type to decode them by
+        return;
+      }
+      if (pass.interface_count < kMaxPcapInterfaces) {
+        pass.interfaces[pass.interface_count++] = iface;
+      }
+    } else if (type == kPcapNgSectionHeader) {
+      pass.swap = detail::pcap_load32(body, false) != kPcapNgByteOrderMagic;
+      pass.interface_count = 0;
+    }
+  }
+
+  /**
+   * @brief Read the start of the file and decode its header(s): the link
+   *        type must be known before the first pass.
+   */
+  bool probe(const char *filename) {
+    const int fd = ::open(filename, O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+    std::vector<char> head(kProbeBytes);
+    const ssize_t got = pread(fd, head.data(), head.size(), 0);
+    ::close(fd);
+    if (got < 0) {
+      return false;
+    }
+    const auto len = static_cast<size_t>(got);
+
+    if (len >= 4 && detail::pcap_load32(head.data(), false) ==
+                        kPcapNgSectionHeader) {
+      return probe_pcapng(head.data(), len);
+    }
+    if (len < sizeof(PcapGlobalHeader)) {
+      return false;
+    }
+    const uint32_t magic = detail::pcap_load32(head.data(), false);
+    if (magic == 0xa1b2c3d4 || magic == 0xa1b23c4d) {
+      needs_swap_ = false;
+    } else if (magic == 0xd4c3b2a1 || magic == 0x4d3cb2a1) {
+      needs_swap_ = true;
+    } else {
+      return false;
+    }
+    format_ = CaptureFormat::Pcap;
+    PcapInterface &iface = interfaces_[0];
+    iface.link_type = static_cast<LinkType>(
+        detail::pcap_load32(head.data() + 20, needs_swap_));
+    iface.snaplen = detail::pcap_load32(head.data() + 16, needs_swap_);
+    iface.tsresol = (magic == 0xa1b23c4d || magic == 0x4d3cb2a1) ? 9 : 6;
+    interface_count_ = 1;
+    link_type_ = iface.link_type;
+    open_ = true;
+    return true;
+  }
+
+  /**
+   * @brief Interfaces described before the first packet, as in
+   *        PcapReader (those beyond the probe are picked up while
+   *        streaming).
+   */
+  bool probe_pcapng(const char *head, size_t len) noexcept {
+    if (len < kPcapNgMinBlock + 16) {
+      return false;
+    }
+    format_ = CaptureFormat::PcapNg; // record_length() frames by format
+    bool swap = false;
+    size_t total = record_length(head, swap);
+    if (total == 0) {
+      return false;
+    }
+    needs_swap_ = detail::pcap_load32(head + 8, false) != kPcapNgByteOrderMagic;
+    interface_count_ = 0;
+
+    size_t offset = total;
+    while (offset + kPcapNgMinBlock <= len) {
+      total = record_length(head + offset, needs_swap_);
+      const uint32_t type = detail::pcap_load32(head + offset, needs_swap_);
+      if (total == 0 || offset + total > len ||
+          type == kPcapNgSectionHeader || type == kPcapNgEnhancedPacket ||
+          type == kPcapNgSimplePacket) {
+        break;
+      }
+      if (type == kPcapNgInterfaceDescription &&
+          interface_count_ < kMaxPcapInterfaces) {
+        interfaces_[interface_count_++] = decode_pcapng_interface(
+            head + offset + sizeof(PcapNgBlockHeader), total - kPcapNgMinBlock,
+            needs_swap_);
+      }
+      offset += total;
+    }
+    link_type_ = interface_count_ > 0 ? interfaces_[0].link_type
+                                      : LinkType::Ethernet;
+    for (size_t i = 1; i < interface_count_; ++i) {
+      if (interfaces_[i].link_type != link_type_) {
+        return false;
+      }
+    }
+    open_ = true;
+    return true;
+  }
+
+  ChunkedFile file_;
+  bool open_ = false;
+  bool needs_swap_ = false;
+  bool failed_ = false;
+  uint64_t oversize_ = 0;
+  LinkType link_type_ = LinkType::Ethernet;
+  CaptureFormat format_ = CaptureFormat::Pcap;
+  std::array<PcapInterface, kMaxPcapInterfaces> interfaces_{};
+  size_t interface_count_ = 0;
+  std::vector<char> carry_; ///< kCarryCapacity bytes once open
+  size_t carry_len_ = 0;
+};
+
+} // namespace itch
@@ -0,0 +1,276 @@
+#pragma once
+
+/**
+ * @file pcap_writer.hpp
+ * @brief writev()-batched file writer and nanosecond PCAP writer.
+ *
+ * DESIGN PRINCIPLES:
+ * 1. Zero-copy: payloads are queued by reference (straight from a mapped
+ *    capture) and must stay valid until the next flush(). Only the small
+ *    per-record headers are copied, into a fixed staging arena.
+ * 2. Large batches: up to kMaxIovecs ranges leave in one writev() call, and
+ *    ranges that touch in memory are merged into one iovec first.
+ * 3. No per-packet allocation: the iovec table and the arena are sized once
+ *    at construction.
+ * 4. Errors are sticky and reported through failed(), never thrown.
+ *
+ * Output is always classic PCAP with the nanosecond magic (0xa1b23c4d), so
+ * capture timestamps survive a filter pass unrounded. PcapReader reads it.
+ *
+ * USAGE:
+ *   PcapWriter out;
+ *   out.open("AAPL.pcap", reader.link_type());
+ *   reader.for_each_packet([&](const char* data, size_t len, uint64_t ts) {
+ *       if (wanted(data, len)) {
+ *           out.write_packet(ts, data, len);
+ *       }
+ *   });
+ *   out.close();  // Flushes; false if any write failed
+ */
+
+#include "net_decoder.hpp"
+#include "pcap_reader.hpp"
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <vector>
+
+namespace itch {
+
+// ============================================================================
+// Gather Writer
+// ============================================================================
+
+/**
+ * @brief Append-only file writer that gathers ranges into writev() calls.
+ *
+ * Not copyable: queued iovecs may point into the arena.
+ */
+class GatherWriter {
+public:
+  /// Ranges per writev() (Linux IOV_MAX)
+  static constexpr size_t kMaxIovecs = 1024;
+
+  /// Staging bytes for append_copy() between flushes
+  static constexpr size_t kArenaBytes = 64 * 1024;
+
+  GatherWriter() : iovecs_(kMaxIovecs), arena_(kArenaBytes) {}
+  ~GatherWriter() { (void)close(); }
+
+  GatherWriter(const GatherWriter &) = delete;
+  GatherWriter &operator=(const GatherWriter &) = delete;
+
+  /**
+   * @brief Create (or truncate) `path` for writing.
+   * @return false if the file cannot be opened.
+   */
+  bool open(const char *path) {
+    (void)close();
+    fd_ = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    bytes_written_ = 0;
+    writev_calls_ = 0;
+    failed_ = fd_ < 0;
+    return fd_ >= 0;
+  }
+
+  /**
+   * @brief Flush and close the file.
+   * @return false if any write since open() failed.
+   */
+  bool close() {
+    if (fd_ < 0) {
+      return !failed_;
+    }
+    (void)flush();
+    ::close(fd_);
+    fd_ = -1;
+    return !failed_;
+  }
+
+  [[nodiscard]] bool is_open() const noexcept { return fd_ >= 0; }
+  [[nodiscard]] bool failed() const noexcept { return failed_; }
+
+  /// Bytes the kernel has accepted (queued ranges excluded)
+  [[nodiscard]] uint64_t bytes_written() const noexcept {
+    return bytes_written_;
+  }
+  [[nodiscard]] uint64_t writev_calls() const noexcept {
+    return writev_calls_;
+  }
+  [[nodiscard]] size_t pending() const noexcept { return count_; }
+
+  /**
+   * @brief Queue `len` bytes by reference; valid until the next flush().
+   */
+  void append(const char *data, size_t len) {
+    if (len == 0 || fd_ < 0) {
+      return;
+    }
+    if (count_ > 0) {
+      iovec &last = iovecs_[count_ - 1];
+      if (static_cast<const char *>(last.iov_base) + last.iov_len == data) {
+        last.iov_len += len; // Touches the previous range
+        return;
+      }
+    }
+    if (count_ == kMaxIovecs) {
+      (void)flush();
+    }
+    iovecs_[count_] = {const_cast<char *>(data), len};
+    ++count_;
+  }
+
+  /**
+   * @brief Queue a copy of `len` bytes (for headers built on the stack).
+   */
+  void append_copy(const void *data, size_t len) {
+    // Flush first, so the append below cannot flush (and recycle the
+    // arena) while the copy is still queued
+    if (len > kArenaBytes - used_ || count_ == kMaxIovecs) {
+      (void)flush();
+      if (len > kArenaBytes) {
+        write_all(static_cast<const char *>(data), len);
+        return;
+      }
+    }
+    char *slot = arena_.data() + used_;
+    std::memcpy(slot, data, len);
+    used_ += len;
+    append(slot, len);
+  }
+
+  /**
+   * @brief Write every queued range; the arena is reusable afterwards.
+   * @return false if the file is closed or a write failed.
+   */
+  bool flush() {
+    iovec *iov = iovecs_.data();
+    size_t left = count_;
+    while (left > 0 && !failed_) {
+      ++writev_calls_;
+      const ssize_t n = ::writev(fd_, iov, static_cast<int>(left));
+      if (n < 0) {
+        failed_ = errno != EINTR;
+        continue;
+      }
+      bytes_written_ += static_cast<uint64_t>(n);
+      // Partial write: skip what went out and retry the remainder
+      auto done = static_cast<size_t>(n);
+      while (left > 0 && done >= iov->iov_len) {
+        done -= iov->iov_len;
+        ++iov;
+        --left;
+      }
+      if (left > 0) {
+        iov->iov_base = static_cast<char *>(iov->iov_base) + done;
+        iov->iov_len -= done;
+      }
+    }
+    count_ = 0;
+    used_ = 0;
+    return fd_ >= 0 && !failed_;
+  }
+
+private:
+  /**
+   * @brief Unbatched write of a range too large to stage.
+   */
+  void write_all(const char *data, size_t len) {
+    while (len > 0 && !failed_) {
+      ++writev_calls_;
+      const ssize_t n = ::write(fd_, data, len);
+      if (n < 0) {
+        failed_ = errno != EINTR;
+        continue;
+      }
+      bytes_written_ += static_cast<uint64_t>(n);
+      data += n;
+      len -= static_cast<size_t>(n);
+    }
+  }
+
+  int fd_ = -1;
+  bool failed_ = false;
+  uint64_t bytes_written_ = 0;
+  uint64_t writev_calls_ = 0;
+  std::vector<iovec> iovecs_;
+  size_t count_ = 0;
+  std::vector<char> arena_;
+  size_t used_ = 0;
+};
+
+// ============================================================================
+// PCAP Writer
+// ============================================================================
+
+/// Classic PCAP magic for nanosecond timestamps, in host byte order
+inline constexpr uint32_t kPcapNanosecondMagic = 0xa1b23c4d;
+
+/**
+ * @brief Nanosecond-resolution PCAP writer over a GatherWriter.
+ */
+class PcapWriter {
+public:
+  /**
+   * @brief Create `path` and write the global header.
+   * @return false if the file cannot be created.
+   */
+  bool open(const char *path, LinkType link_type,
+            uint32_t snaplen = 65535) {
+    packets_ = 0;
+    if (!out_.open(path)) {
+      return false;
+    }
+    const PcapGlobalHeader header{kPcapNanosecondMagic,
+                                  2,
+                                  4,
+                                  0,
+                                  0,
+                                  snaplen,
+                                  static_cast<uint32_t>(link_type)};
+    out_.append_copy(&header, sizeof(header));
+    return true;
+  }
+
+  /**
+   * @brief Queue one packet; `data` must stay valid until the next flush.
+   * @param ts_ns Capture time, nanoseconds since the epoch.
+   * @param orig_len Length on the wire, if the capture truncated it.
+   */
+  void write_packet(uint64_t ts_ns, const char *data, size_t len,
+                    size_t orig_len = 0) {
+    const PcapPacketHeader header{
+        static_cast<uint32_t>(ts_ns / 1'000'000'000),
+        static_cast<uint32_t>(ts_ns % 1'000'000'000),
+        static_cast<uint32_t>(len),
+        static_cast<uint32_t>(orig_len > len ? orig_len : len)};
+    out_.append_copy(&header, sizeof(header));
+    out_.append(data, len);
+    ++packets_;
+  }
+
+  bool flush() { return out_.flush(); }
+
+  /**
+   * @brief Flush and close.
+   * @return false if any write failed.
+   */
+  bool close() { return out_.close(); }
+
+  [[nodiscard]] bool is_open() const noexcept { return out_.is_open(); }
+  [[nodiscard]] bool failed() const noexcept { return out_.failed(); }
+  [[nodiscard]] uint64_t packets() const noexcept { return packets_; }
+
+  /// The underlying writer, for byte and syscall counters
+  [[nodiscard]] const GatherWriter &writer() const noexcept { return out_; }
+
+private:
+  GatherWriter out_;
+  uint64_t packets_ = 0;
+};
+
+} // namespace itch
@@ -0,0 +1,251 @@
+#pragma once
+
+/**
+ * @file projection.hpp
+ * @brief Compile-time field projection for visitor hooks.
+ *
+ * DESIGN PRINCIPLES:
+ * 1. A visitor names the fields it needs in a FieldMask; Projection<Mask>
+ *    holds exactly those fields, already in host byte order.
+ * 2. Only masked fields are loaded and swapped - no bswap or 48-bit
+ *    timestamp assembly for fields nobody reads.
+ * 3. Unrequested fields do not exist as members, so reading one is a
+ *    compile error rather than a silent zero.
+ * 4. No parser changes: a hook that takes Projection<Mask> is selected by
+ *    normal overload resolution and the wire struct converts implicitly.
+ *    DefaultVisitor and hooks taking wire structs keep working as before.
+ * 5. Common fields share one name across messages (e.g. `shares` is
+ *    executed_shares on 'E' and cancelled_shares on 'X'), so one Projection
+ *    type can serve several hooks.
+ *
+ * USAGE:
+ *   struct Volume : itch::DefaultVisitor {
+ *       static constexpr itch::FieldMask kFields =
+ *           itch::field::StockLocate | itch::field::Shares;
+ *       using Fields = itch::Projection<kFields>;
+ *
+ *       void on_order_executed(const Fields& f) {
+ *           volume[f.stock_locate] += f.shares;
+ *       }
+ *   };
+ */
+
+#include "messages.hpp"
+#include <cstdint>
+
+namespace itch {
+
+// ============================================================================
+// Field Mask
+// ============================================================================
+
+using FieldMask = uint32_t;
+
+namespace field {
+inline constexpr FieldMask StockLocate = 1u << 0;    ///< uint16_t
+inline constexpr FieldMask TrackingNumber = 1u << 1; ///< uint16_t
+inline constexpr FieldMask Timestamp = 1u << 2;      ///< uint64_t ns
+inline constexpr FieldMask OrderRef = 1u << 3;       ///< order_ref / original
+inline constexpr FieldMask NewOrderRef = 1u << 4;    ///< OrderReplace only
+inline constexpr FieldMask Side = 1u << 5;           ///< 'B' / 'S'
+inline constexpr FieldMask Shares = 1u << 6;         ///< uint64_t quantity
+inline constexpr FieldMask Price = 1u << 7;          ///< uint32_t * 10000
+inline constexpr FieldMask MatchNumber = 1u << 8;    ///< uint64_t
+inline constexpr FieldMask Stock = 1u << 9;          ///< 8-byte symbol
+} // namespace field
+
+namespace detail {
+
+// ============================================================================
+// Per-Message Field Mapping
+// ============================================================================
+
+/// Share quantity, whatever the message calls it
+template <typename Msg> constexpr bool kHasShares = requires(const Msg &m) {
+  m.shares;
+} || requires(const Msg &m) { m.executed_shares; } || requires(const Msg &m) {
+  m.cancelled_shares;
+};
+
+/// Price, whatever the message calls it
+template <typename Msg> constexpr bool kHasPrice = requires(const Msg &m) {
+  m.price;
+} || requires(const Msg &m) { m.execution_price; } || requires(const Msg &m) {
+  m.cross_price;
+};
+
+template <typename Msg> constexpr bool kHasOrderRef = requires(const Msg &m) {
+  m.order_ref;
+} || requires(const Msg &m) { m.original_order_ref; };
+
+/**
+ * @brief Fields that Projection can extract from Msg.
+ *
+ * The 11-byte header fields are present on every message.
+ */
+template <typename Msg>
+inline constexpr FieldMask available_fields_v =
+    field::StockLocate | field::TrackingNumber | field::Timestamp |
+    (kHasOrderRef<Msg> ? field::OrderRef : 0) |
+    (requires(const Msg &m) { m.new_order_ref; } ? field::NewOrderRef : 0) |
+    (requires(const Msg &m) { m.side; } ? field::Side : 0) |
+    (kHasShares<Msg> ? field::Shares : 0) |
+    (kHasPrice<Msg> ? field::Price : 0) |
+    (requires(const Msg &m) { m.match_number; } ? field::MatchNumber : 0) |
+    (requires(const Msg &m) { m.stock; } ? field::Stock : 0);
+
+template <typename Msg> uint64_t order_ref_of(const Msg &m) noexcept {
+  if constexpr (requires { m.order_ref; }) {
+    return m.order_ref;
+  } else {
+    return m.original_order_ref;
+  }
+}
+
+template <typename Msg> uint64_t shares_of(const Msg &m) noexcept {
+  if constexpr (requires { m.shares; }) {
+    return m.shares;
+  } else if constexpr (requires { m.executed_shares; }) {
+    return m.executed_shares;
+  } else {
+    return m.cancelled_shares;
+  }
+}
+
+template <typename Msg> uint32_t price_of(const Msg &m) noexcept {
+  if constexpr (requires { m.price; }) {
+    return m.price;
+  } else if constexpr (requires { m.execution_price; }) {
+    return m.execution_price;
+  } else {
+    return m.cross_price;
+  }
+}
+
+// ============================================================================
+// Conditional Members (empty when the field is not requested)
+// ============================================================================
+
+template <bool> struct LocateSlot {};
+template <> struct LocateSlot<true> {
+  uint16_t stock_locate;
+};
+template <bool> struct TrackingSlot {};
+template <> struct TrackingSlot<true> {
+  uint16_t tracking_number;
+};
+template <bool> struct TimestampSlot {};
+template <> struct TimestampSlot<true> {
+  uint64_t timestamp; ///< Nanoseconds since midnight
+};
+template <bool> struct OrderRefSlot {};
+template <> struct OrderRefSlot<true> {
+  uint64_t order_ref;
+};
+template <bool> struct NewOrderRefSlot {};
+template <> struct NewOrderRefSlot<true> {
+  uint64_t new_order_ref;
+};
+template <bool> struct SideSlot {};
+template <> struct SideSlot<true> {
+  char side;
+};
+template <bool> struct SharesSlot {};
+template <> struct SharesSlot<true> {
+  uint64_t shares;
+};
+template <bool> struct PriceSlot {};
+template <> struct PriceSlot<true> {
+  uint32_t price; ///< Price * 10000
+};
+template <bool> struct MatchNumberSlot {};
+template <> struct MatchNumberSlot<true> {
+  uint64_t match_number;
+};
+template <bool> struct StockSlot {};
+template <> struct StockSlot<true> {
+  StockSymbol stock;
+};
+
+} // namespace detail
+
+// ============================================================================
+// Projection
+// ============================================================================
+
+/**
+ * @brief Host-order struct holding only the fields named in Mask.
+ *
+ * Constructible from any wire message that provides every masked field;
+ * asking for a field the message lacks (e.g. Side from an OrderDelete) makes
+ * the hook unusable for that message, which fails at compile time.
+ *
+ * @tparam Mask Bitwise OR of itch::field constants.
+ */
+template <FieldMask Mask>
+struct Projection : detail::LocateSlot<(Mask & field::StockLocate) != 0>,
+                    detail::TrackingSlot<(Mask & field::TrackingNumber) != 0>,
+                    detail::TimestampSlot<(Mask & field::Timestamp) != 0>,
+                    detail::OrderRefSlot<(Mask & field::OrderRef) != 0>,
+                    detail::NewOrderRefSlot<(Mask & field::NewOrderRef) != 0>,
+                    detail::SideSlot<(Mask & field::Side) != 0>,
+                    detail::SharesSlot<(Mask & field::Shares) != 0>,
+                    detail::PriceSlot<(Mask & field::Price) != 0>,
+                    detail::MatchNumberSlot<(Mask & field::MatchNumber) != 0>,
+                    detail::StockSlot<(Mask & field::Stock) != 0> {
+  static constexpr FieldMask kMask = Mask;
+
+  Projection() = default;
+
+  /**
+   * @brief Decode the masked fields of a wire message.
+   *
+   * Intentionally implicit: this conversion is how the parser's existing
+   * visit() calls reach a hook declared with a Projection parameter.
+   */
+  template <typename Msg>
+    requires((Mask & ~detail::available_fields_v<Msg>) == 0)
+  Projection(const Msg &msg) noexcept {
+    if constexpr ((Mask & field::StockLocate) != 0) {
+      this->stock_locate = msg.stock_locate;
+    }
+    if constexpr ((Mask & field::TrackingNumber) != 0) {
+      this->tracking_number = msg.tracking_number;
+    }
+    if constexpr ((Mask & field::Timestamp) != 0) {
+      this->timestamp = msg.timestamp.nanoseconds();
+    }
+    if constexpr ((Mask & field::OrderRef) != 0) {
+      this->order_ref = detail::order_ref_of(msg);
+    }
+    if constexpr ((Mask & field::NewOrderRef) != 0) {
+      this->new_order_ref = msg.new_order_ref;
+    }
+    if constexpr ((Mask & field::Side) != 0) {
+      this->side = msg.side;
+    }
+    if constexpr ((Mask & field::Shares) != 0) {
+      this->shares = detail::shares_of(msg);
+    }
+    if constexpr ((Mask & field::Price) != 0) {
+      this->price = detail::price_of(msg);
+    }
+    if constexpr ((Mask & field::MatchNumber) != 0) {
+      this->match_number = msg.match_number;
+    }
+    if constexpr ((Mask & field::Stock) != 0) {
+      this->stock = msg.stock;
+    }
+  }
+};
+
+/**
+ * @brief Explicitly project a message (outside of visitor dispatch).
+ */
+template <FieldMask Mask, typename Msg>
+  requires((Mask & ~detail::available_fields_v<Msg>) == 0)
+[[nodiscard]] Projection<Mask> project(const Msg &msg) noexcept {
+  return Projection<Mask>(msg);
+}
+
+} // namespace itch
@@ -0,0 +1,474 @@
+#pragma once
+
+/**
+ * @file registry.hpp
+ * @brief Compile-time ITCH 5.0 message registry.
+ *
+ * DESIGN PRINCIPLES:
+ * 1. One type list (Itch50Messages) is the single source of truth for which
+ *    message types exist - sizes, validity and dispatch are derived from it.
+ * 2. All tables are constexpr: built by the compiler, stored in .rodata.
+ * 3. Lookups are one indexed load keyed by the type byte - adding a message
+ *    type adds a table entry, not a branch.
+ * 4. Visitor hook binding is an overload set; a registered type without a
+ *    hook is a compile error, so the tables cannot drift from the parser.
+ * 5. Batch hooks (on_xxx_batch) are opt-in and detected with concepts.
+ *
+ * USAGE:
+ *   if (itch::is_valid_message_type(buf[0])) {
+ *       size_t len = itch::message_size(buf[0]);
+ *   }
+ */
+
+#include "messages.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace itch {
+
+// ============================================================================
+// Message Type List
+// ============================================================================
+
+/**
+ * @brief Compile-time list of wire message structs.
+ *
+ * Every element must expose `static constexpr char kMsgType`.
+ */
+template <typename... Msgs> struct MessageList {
+  static constexpr std::size_t size = sizeof...(Msgs);
+};
+
+/**
+ * @brief Every message type defined by TotalView-ITCH 5.0.
+ *
+ * To add a message: define its packed struct (with kMsgType) in
+ * messages.hpp, append it here and add a visit() overload below.
+ */
+using Itch50Messages =
+    MessageList<SystemEvent, StockDirectory, StockTradingAction,
+                RegSHORestriction, MarketParticipantPosition, MWCBDeclineLevel,
+                MWCBStatus, IPOQuotingPeriod, LULDAuctionCollar,
+                OperationalHalt, AddOrder, AddOrderMPID, OrderExecuted,
+                OrderExecutedWithPrice, OrderCancel, OrderDelete, OrderReplace,
+                Trade, CrossTrade, BrokenTrade, NOII, RetailPriceImprovement,
+                DirectListingCapitalRaise>;
+
+// ============================================================================
+// Registry - Tables Generated from a MessageList
+// ============================================================================
+
+template <typename List> struct Registry;
+
+/**
+ * @brief Size table, validity bitmap and dispatch-table builder.
+ *
+ * @tparam Msgs Message structs, each with a distinct kMsgType.
+ */
+template <typename... Msgs> struct Registry<MessageList<Msgs...>> {
+  /**
+   * @brief Wire size indexed by type byte (0 = not a registered type).
+   */
+  static constexpr std::array<uint8_t, 256> sizes = [] {
+    std::array<uint8_t, 256> table{};
+    ((table[static_cast<uint8_t>(Msgs::kMsgType)] =
+          static_cast<uint8_t>(sizeof(Msgs))),
+     ...);
+    return table;
+  }();
+
+  /**
+   * @brief Type bytes in list order.
+   */
+  static constexpr std::array<char, sizeof...(Msgs)> types = {
+      Msgs::kMsgType...};
+
+  /**
+   * @brief Position in the list + 1, indexed by type byte (0 = unknown).
+   *
+   * Lets a dense per-type array (e.g. label addresses) be indexed by the
+   * raw type byte with one extra load.
+   */
+  static constexpr std::array<uint8_t, 256> positions = [] {
+    std::array<uint8_t, 256> table{};
+    uint8_t next = 1;
+    ((table[static_cast<uint8_t>(Msgs::kMsgType)] = next++), ...);
+    return table;
+  }();
+
+  /**
+   * @brief Largest wire size of any registered message.
+   */
+  static constexpr std::size_t max_size = [] {
+    std::size_t largest = 0;
+    ((largest = sizeof(Msgs) > largest ? sizeof(Msgs) : largest), ...);
+    return largest;
+  }();
+
+  /**
+   * @brief 256-bit set of registered type bytes.
+   */
+  static constexpr std::array<uint64_t, 4> valid = [] {
+    std::array<uint64_t, 4> bits{};
+    ((bits[static_cast<uint8_t>(Msgs::kMsgType) >> 6] |=
+      uint64_t{1} << (static_cast<uint8_t>(Msgs::kMsgType) & 63)),
+     ...);
+    return bits;
+  }();
+
+  /**
+   * @brief 256-bit set of the registered types accepted by a filter.
+   *
+   * @tparam Filter Class with `template <typename Msg> static constexpr bool
+   *                contains`.
+   */
+  template <typename Filter>
+  [[nodiscard]] static constexpr std::array<uint64_t, 4>
+  make_type_set() noexcept {
+    std::array<uint64_t, 4> bits{};
+    ((Filter::template contains<Msgs>
+          ? void(bits[static_cast<uint8_t>(Msgs::kMsgType) >> 6] |=
+                 uint64_t{1} << (static_cast<uint8_t>(Msgs::kMsgType) & 63))
+          : void()),
+     ...);
+    return bits;
+  }
+
+  /**
+   * @brief Build a 256-entry jump table.
+   *
+   * Slot `Msg::kMsgType` holds `&Handler::template handle<Msg>`; every other
+   * slot holds `fallback`.
+   *
+   * @tparam Fn Function pointer type stored in the table.
+   * @tparam Handler Class with a static member template `handle<Msg>`.
+   */
+  template <typename Fn, typename Handler>
+  [[nodiscard]] static constexpr std::array<Fn, 256>
+  make_dispatch_table(Fn fallback) noexcept {
+    std::array<Fn, 256> table{};
+    table.fill(fallback);
+    ((table[static_cast<uint8_t>(Msgs::kMsgType)] =
+          &Handler::template handle<Msgs>),
+     ...);
+    return table;
+  }
+
+private:
+  static constexpr bool types_unique() noexcept {
+    constexpr char types[] = {Msgs::kMsgType...};
+    for (std::size_t i = 0; i < sizeof...(Msgs); ++i) {
+      for (std::size_t j = i + 1; j < sizeof...(Msgs); ++j) {
+        if (types[i] == types[j]) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  static_assert(types_unique(), "Duplicate kMsgType in MessageList");
+  static_assert(((sizeof(Msgs) >= sizeof(MessageHeader)) && ...),
+                "Every message must contain the 11-byte header");
+  static_assert(((sizeof(Msgs) <= 255) && ...),
+                "Message sizes must fit the uint8_t size table");
+};
+
+using MessageRegistry = Registry<Itch50Messages>;
+
+/// Upper bound for buffers that must hold any one message
+inline constexpr std::size_t kMaxMessageSize = MessageRegistry::max_size;
+
+// ============================================================================
+// Lookups
+// ============================================================================
+
+/**
+ * @brief Expected wire size for a type byte, or 0 if unregistered.
+ *
+ * Single table load - no branches.
+ */
+[[nodiscard]] constexpr std::size_t message_size(char msg_type) noexcept {
+  return MessageRegistry::sizes[static_cast<uint8_t>(msg_type)];
+}
+
+/**
+ * @brief Check whether a byte is a registered ITCH 5.0 message type.
+ */
+[[nodiscard]] constexpr bool is_valid_message_type(char msg_type) noexcept {
+  const auto c = static_cast<uint8_t>(msg_type);
+  return (MessageRegistry::valid[c >> 6] >> (c & 63)) & 1u;
+}
+
+// ============================================================================
+// Visitor Hook Binding
+// ============================================================================
+
+/**
+ * @brief Route a decoded message to the visitor's on_xxx hook.
+ *
+ * One overload per registered type; used by the generated dispatch table.
+ */
+template <typename V> void visit(V &v, const SystemEvent &m) {
+  v.on_system_event(m);
+}
+template <typename V> void visit(V &v, const StockDirectory &m) {
+  v.on_stock_directory(m);
+}
+template <typename V> void visit(V &v, const StockTradingAction &m) {
+  v.on_stock_trading_action(m);
+}
+template <typename V> void visit(V &v, const RegSHORestriction &m) {
+  v.on_reg_sho_restriction(m);
+}
+template <typename V> void visit(V &v, const MarketParticipantPosition &m) {
+  v.on_market_participant_position(m);
+}
+template <typename V> void visit(V &v, const MWCBDeclineLevel &m) {
+  v.on_mwcb_decline_level(m);
+}
+template <typename V> void visit(V &v, const MWCBStatus &m) {
+  v.on_mwcb_status(m);
+}
+template <typename V> void visit(V &v, const IPOQuotingPeriod &m) {
+  v.on_ipo_quoting_period(m);
+}
+template <typename V> void visit(V &v, const LULDAuctionCollar &m) {
+  v.on_luld_auction_collar(m);
+}
+template <typename V> void visit(V &v, const OperationalHalt &m) {
+  v.on_operational_halt(m);
+}
+template <typename V> void visit(V &v, const AddOrder &m) {
+  v.on_add_order(m);
+}
+template <typename V> void visit(V &v, const AddOrderMPID &m) {
+  v.on_add_order_mpid(m);
+}
+template <typename V> void visit(V &v, const OrderExecuted &m) {
+  v.on_order_executed(m);
+}
+template <typename V> void visit(V &v, const OrderExecutedWithPrice &m) {
+  v.on_order_executed_with_price(m);
+}
+template <typename V> void visit(V &v, const OrderCancel &m) {
+  v.on_order_cancel(m);
+}
+template <typename V> void visit(V &v, const OrderDelete &m) {
+  v.on_order_delete(m);
+}
+template <typename V> void visit(V &v, const OrderReplace &m) {
+  v.on_order_replace(m);
+}
+template <typename V> void visit(V &v, const Trade &m) { v.on_trade(m); }
+template <typename V> void visit(V &v, const CrossTrade &m) {
+  v.on_cross_trade(m);
+}
+template <typename V> void visit(V &v, const BrokenTrade &m) {
+  v.on_broken_trade(m);
+}
+template <typename V> void visit(V &v, const NOII &m) { v.on_noii(m); }
+template <typename V> void visit(V &v, const RetailPriceImprovement &m) {
+  v.on_retail_price_improvement(m);
+}
+template <typename V> void visit(V &v, const DirectListingCapitalRaise &m) {
+  v.on_direct_listing_capital_raise(m);
+}
+
+// ============================================================================
+// Batch Hook Binding (opt-in)
+// ============================================================================
+
+/**
+ * @brief Run of consecutive same-type messages, as zero-copy pointers.
+ */
+template <typename Msg> using MessageSpan = std::span<const Msg *const>;
+
+/**
+ * @brief Route a run of messages to the visitor's on_xxx_batch hook.
+ *
+ * Each overload only participates when the visitor declares the matching
+ * batch hook, so BatchVisitor<V, Msg> below is true exactly for the types a
+ * visitor has opted into.
+ */
+template <typename V>
+  requires requires(V &v, MessageSpan<SystemEvent> s) {
+    v.on_system_event_batch(s);
+  }
+void visit_batch(V &v, MessageSpan<SystemEvent> s) {
+  v.on_system_event_batch(s);
+}
+template <typename V>
+  requires requires(V &v, MessageSpan<StockDirectory> s) {
+    v.on_stock_directory_batch(s);
+  }
+void visit_batch(V &v, MessageSpan<StockDirectory> s) {
+  v.on_stock_directory_batch(s);
+}
+template <typename V>
+  requires requires(V &v, MessageSpan<StockTradingAction> s) {
+    v.on_stock_trading_action_batch(s);
+  }
+void visit_batch(V &v, MessageSpan<StockTradingAction> s) {
+  v.on_stock_trading_action_batch(s);
+}
+template <typename V>
+  requires requires(V &v, MessageSpan<RegSHORestriction> s) {
+    v.on_reg_sho_restriction_batch(s);
+  }
+void visit_batch(V &v, MessageSpan<RegSHORestriction> s) {
+  v.on_reg_sho_restriction_batch(s);
+}
+template <typename V>
+  requires requires(V &v, MessageSpan<MarketParticipantPosition> s) {
+    v.on_market_participant_position_batch(s);
+  }
+void visit_batch(V &v, MessageSpan<MarketParticipantPosition> s) {
+  v.on_market_participant_position_batch(s);
+}
+template <typename V>
+  requires requires(V &v, MessageSpan<MWCBDeclineLevel> s) {
+    v.on_mwcb_decline_level_batch(s);
+  }
+void visit_batch(V &v, MessageSpan<MWCBDeclineLevel> s) {
+  v.on_mwcb_decline_level_batch(s);
+}
+template <typename V>
+  requires requires(V &v, MessageSpan<MWCBStatus> s) {
+    v.on_mwcb_status_batch(s);
+  }
+void visit_batch(V &v, MessageSpan<MWCBStatus> s) {
+  v.on_mwcb_status_batch(s);
+}
+template <typename V>
+  requires requires(V &v, MessageSpan<IPOQuotingPeriod> s) {
+    v.on_ipo_quoting_period_batch(s);
+  }
+void visit_batch(V &v, MessageSpan<IPOQuotingPeriod> s) {
+  v.on_ipo_quoting_period_batch(s);
+}
+template <typename V>
+  requires requires(V &v, MessageSpan<LULDAuctionCollar> s) {
+    v.on_luld_auction_collar_batch(s);
+  }
+void visit_batch(V &v, MessageSpan<LULDAuctionCollar> s) {
+  v.on_luld_auction_collar_batch(s);
+}
+template <typename V>
+  requires requires(V &v, MessageSpan<OperationalHalt> s) {
+    v.on_operational_halt_batch(s);
+  }
+void visit_batch(V &v, MessageSpan<OperationalHalt> s) {
+  v.on_operational_halt_batch(s);
+}
+template <typename V>
+  requires requires(V &v, MessageSpan<AddOrder> s) { v.on_add_order_batch(s); }
+void visit_batch(V &v, MessageSpan<AddOrder> s) {
+  v.on_add_order_batch(s);
+}
+template <typename V>
+  requires requires(V &v, MessageSpan<AddOrderMPID> s) {
+    v.on_add_order_mpid_batch(s);
+  }
+void visit_batch(V &v, MessageSpan<AddOrderMPID> s) {
+  v.on_add_order_mpid_batch(s);
+}
+template <typename V>
+  requires requires(V &v, MessageSpan<OrderExecuted> s) {
+    v.on_order_executed_batch(s);
+  }
+void visit_batch(V &v, MessageSpan<OrderExecuted> s) {
+  v.on_order_executed_batch(s);
+}
+template <typename V>
+  requires requires(V &v, MessageSpan<OrderExecutedWithPrice> s) {
+    v.on_order_executed_with_price_batch(s);
+  }
+void visit_batch(V &v, MessageSpan<OrderExecutedWithPrice> s) {
+  v.on_order_executed_with_price_batch(s);
+}
+template <typename V>
+  requires requires(V &v, MessageSpan<OrderCancel> s) {
+    v.on_order_cancel_batch(s);
+  }
+void visit_batch(V &v, MessageSpan<OrderCancel> s) {
+  v.on_order_cancel_batch(s);
+}
+template <typename V>
+  requires requires(V &v, MessageSpan<OrderDelete> s) {
+    v.on_order_delete_batch(s);
+  }
+void visit_batch(V &v, MessageSpan<OrderDelete> s) {
+  v.on_order_delete_batch(s);
+}
+template <typename V>
+  requires requires(V &v, MessageSpan<OrderReplace> s) {
+    v.on_order_replace_batch(s);
+  }
+void visit_batch(V &v, MessageSpan<OrderReplace> s) {
+  v.on_order_replace_batch(s);
+}
+template <typename V>
+  requires requires(V &v, MessageSpan<Trade> s) { v.on_trade_batch(s); }
+void visit_batch(V &v, MessageSpan<Trade> s) {
+  v.on_trade_batch(s);
+}
+template <typename V>
+  requires requires(V &v, MessageSpan<CrossTrade> s) {
+    v.on_cross_trade_batch(s);
+  }
+void visit_batch(V &v, MessageSpan<CrossTrade> s) {
+  v.on_cross_trade_batch(s);
+}
+template <typename V>
+  requires requires(V &v, MessageSpan<BrokenTrade> s) {
+    v.on_broken_trade_batch(s);
+  }
+void visit_batch(V &v, MessageSpan<BrokenTrade> s) {
+  v.on_broken_trade_batch(s);
+}
+template <typename V>
+  requires requires(V &v, MessageSpan<NOII> s) { v.on_noii_batch(s); }
+void visit_batch(V &v, MessageSpan<NOII> s) {
+  v.on_noii_batch(s);
+}
+template <typename V>
+  requires requires(V &v, MessageSpan<RetailPriceImprovement> s) {
+    v.on_retail_price_improvement_batch(s);
+  }
+void visit_batch(V &v, MessageSpan<RetailPriceImprovement> s) {
+  v.on_retail_price_improvement_batch(s);
+}
+template <typename V>
+  requires requires(V &v, MessageSpan<DirectListingCapitalRaise> s) {
+    v.on_direct_listing_capital_raise_batch(s);
+  }
+void visit_batch(V &v, MessageSpan<DirectListingCapitalRaise> s) {
+  v.on_direct_listing_capital_raise_batch(s);
+}
+
+/**
+ * @brief Visitor V accepts batches of Msg.
+ */
+template <typename V, typename Msg>
+concept BatchVisitor = requires(V &v, MessageSpan<Msg> s) {
+  visit_batch(v, s);
+};
+
+template <typename V, typename List>
+inline constexpr bool has_batch_hooks_for_v = false;
+
+template <typename V, typename... Msgs>
+inline constexpr bool has_batch_hooks_for_v<V, MessageList<Msgs...>> =
+    (BatchVisitor<V, Msgs> || ...);
+
+/**
+ * @brief Visitor V declares at least one on_xxx_batch hook.
+ */
+template <typename V>
+inline constexpr bool has_batch_hooks_v =
+    has_batch_hooks_for_v<V, Itch50Messages>;
+
+} // namespace itch
@@ -0,0 +1,291 @@
+#pragma once
+
+/**
+ * @file replay_clock.hpp
+ * @brief TSC clock, replay pacer releasing packets on capture schedule,
+ *        and a fixed-rate limiter.
+ *
+ * DESIGN PRINCIPLES:
+ * 1. Time from the TSC, not the kernel: one rdtsc per poll, calibrated once
+ *    against steady_clock.
+ * 2. Busy-wait, never sleep: a sleeping thread wakes tens of microseconds
+ *    late, a spinning one within a few hundred nanoseconds of the target.
+ * 3. Schedule against the first packet, not the previous one: lateness on
+ *    one packet does not shift every later deadline.
+ *
+ * Assumes an invariant TSC (constant rate across P-states, synchronised
+ * across cores), as on every x86-64 server of the last decade. Other
+ * architectures fall back to steady_clock.
+ *
+ * USAGE:
+ *   ReplayPacer pacer(10.0);  // 10x faster than captured
+ *   reader.for_each_packet([&](const char* data, size_t len, uint64_t ts) {
+ *       pacer.wait(ts);
+ *       publish(data, len);
+ *   });
+ */
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace itch {
+
+// ============================================================================
+// TSC Clock
+// ============================================================================
+
+/**
+ * @brief Cycle counter with a measured tick rate.
+ */
+class TscClock {
+public:
+  /// Calibration window: long enough for ~10 ppm rate error
+  static constexpr std::chrono::milliseconds kDefaultCalibration{20};
+
+  /**
+   * @brief Measure the tick rate against steady_clock over `window`.
+   */
+  [[nodiscard]] static TscClock
+  calibrate(std::chrono::nanoseconds window = kDefaultCalibration) noexcept {
+    using Steady = std::chrono::steady_clock;
+    const auto wall_start = Steady::now();
+    const uint64_t tick_start = ticks();
+    auto wall_end = wall_start;
+    while (wall_end - wall_start < window) {
+      wall_end = Steady::now();
+    }
+    const uint64_t tick_end = ticks();
+
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        wall_end - wall_start)
+                        .count();
+    TscClock clock;
+    if (ns > 0 && tick_end > tick_start) {
+      clock.ticks_per_ns_ =
+          static_cast<double>(tick_end - tick_start) / static_cast<double>(ns);
+    }
+    return clock;
+  }
+
+  /**
+   * @brief Current tick count (rdtsc, or steady_clock ns off x86).
+   */
+  [[nodiscard]] static uint64_t ticks() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+#endif
+  }
+
+  /**
+   * @brief Spin-loop hint: frees the pipeline for the sibling hyperthread.
+   */
+  static void relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#endif
+  }
+
+  [[nodiscard]] double ticks_per_ns() const noexcept { return ticks_per_ns_; }
+
+  [[nodiscard]] uint64_t to_ticks(uint64_t ns) const noexcept {
+    return static_cast<uint64_t>(static_cast<double>(ns) * ticks_per_ns_);
+  }
+
+  [[nodiscard]] uint64_t to_nanos(uint64_t ticks) const noexcept {
+    return static_cast<uint64_t>(static_cast<double>(ticks) / ticks_per_ns_);
+  }
+
+private:
+  double ticks_per_ns_ = 1.0;
+};
+
+// ============================================================================
+// Replay Pacer
+// ============================================================================
+
+/**
+ * @brief How closely the pacer kept to schedule.
+ */
+struct PacerStats {
+  uint64_t packets = 0;           ///< wait() calls
+  uint64_t waited = 0;            ///< Packets that arrived early and spun
+  uint64_t total_lateness_ns = 0; ///< Sum of release time - deadline
+  uint64_t max_lateness_ns = 0;   ///< Worst single release
+};
+
+/**
+ * @brief Releases packets at their capture time, scaled by a speed factor.
+ *
+ * The first packet anchors capture time to the TSC; every later packet is
+ * due at anchor + (ts - first_ts) / speed. Timestamps earlier than the
+ * anchor are due immediately.
+ */
+class ReplayPacer {
+public:
+  /// Speed value meaning "no pacing": wait() returns at once
+  static constexpr double kMaxSpeed = 0.0;
+
+  /**
+   * @param speed 1.0 = real time, N = N times faster, kMaxSpeed = flat out.
+   */
+  explicit ReplayPacer(double speed = 1.0,
+                       TscClock clock = TscClock::calibrate()) noexcept
+      : clock_(clock), ticks_per_capture_ns_(0.0) {
+    if (speed > 0.0) {
+      ticks_per_capture_ns_ = clock_.ticks_per_ns() / speed;
+    }
+  }
+
+  /**
+   * @brief Spin until the packet captured at `capture_ns` is due.
+   * @return Nanoseconds the release lagged its deadline.
+   */
+  uint64_t wait(uint64_t capture_ns) noexcept {
+    ++stats_.packets;
+    if (ticks_per_capture_ns_ == 0.0) {
+      return 0;
+    }
+    if (!anchored_) {
+      anchored_ = true;
+      base_capture_ns_ = capture_ns;
+      base_tick_ = TscClock::ticks();
+      return 0;
+    }
+
+    const uint64_t deadline = deadline_of(capture_ns);
+    uint64_t now = TscClock::ticks();
+    if (now < deadline) {
+      ++stats_.waited;
+      do {
+        TscClock::relax();
+        now = TscClock::ticks();
+      } while (now < deadline);
+    }
+
+    const uint64_t late_ns = clock_.to_nanos(now - deadline);
+    stats_.total_lateness_ns += late_ns;
+    if (late_ns > stats_.max_lateness_ns) {
+      stats_.max_lateness_ns = late_ns;
+    }
+    return late_ns;
+  }
+
+  /**
+   * @brief True if wait(capture_ns) would return without spinning.
+   *
+   * Lets a batching sender flush what it holds before it idles.
+   */
+  [[nodiscard]] bool due(uint64_t capture_ns) const noexcept {
+    return ticks_per_capture_ns_ == 0.0 || !anchored_ ||
+           TscClock::ticks() >= deadline_of(capture_ns);
+  }
+
+  /**
+   * @brief Forget the anchor: the next packet restarts the schedule.
+   */
+  void reset() noexcept {
+    anchored_ = false;
+    stats_ = PacerStats{};
+  }
+
+  [[nodiscard]] bool unpaced() const noexcept {
+    return ticks_per_capture_ns_ == 0.0;
+  }
+  [[nodiscard]] const PacerStats &stats() const noexcept { return stats_; }
+  [[nodiscard]] const TscClock &clock() const noexcept { return clock_; }
+
+private:
+  [[nodiscard]] uint64_t deadline_of(uint64_t capture_ns) const noexcept {
+    uint64_t deadline = base_tick_;
+    if (capture_ns > base_capture_ns_) {
+      deadline += static_cast<uint64_t>(
+          static_cast<double>(capture_ns - base_capture_ns_) *
+          ticks_per_capture_ns_);
+    }
+    return deadline;
+  }
+
+  TscClock clock_;
+  double ticks_per_capture_ns_; ///< 0 = unpaced
+  bool anchored_ = false;
+  uint64_t base_capture_ns_ = 0;
+  uint64_t base_tick_ = 0;
+  PacerStats stats_;
+};
+
+// ============================================================================
+// Rate Limiter
+// ============================================================================
+
+/**
+ * @brief Releases at most `per_second` events per second, busy-waiting.
+ *
+ * Event i is due at anchor + i / per_second, so, like the pacer, a stall
+ * is caught up rather than pushing every later event back.
+ */
+class RateLimiter {
+public:
+  /// Rate value meaning "no cap": wait() returns at once
+  static constexpr double kUnlimited = 0.0;
+
+  explicit RateLimiter(double per_second = kUnlimited,
+                       TscClock clock = TscClock::calibrate()) noexcept
+      : ticks_per_event_(0.0) {
+    if (per_second > 0.0) {
+      ticks_per_event_ = clock.ticks_per_ns() * 1e9 / per_second;
+    }
+  }
+
+  /**
+   * @brief True if wait() would return without spinning.
+   */
+  [[nodiscard]] bool due() const noexcept {
+    return ticks_per_event_ == 0.0 || events_ == 0 ||
+           TscClock::ticks() >= deadline();
+  }
+
+  /**
+   * @brief Spin until the next event is due, then count it.
+   */
+  void wait() noexcept {
+    if (ticks_per_event_ == 0.0) {
+      ++events_;
+      return;
+    }
+    if (events_ == 0) {
+      base_tick_ = TscClock::ticks();
+    } else {
+      const uint64_t at = deadline();
+      while (TscClock::ticks() < at) {
+        TscClock::relax();
+      }
+    }
+    ++events_;
+  }
+
+  [[nodiscard]] bool unlimited() const noexcept {
+    return ticks_per_event_ == 0.0;
+  }
+  [[nodiscard]] uint64_t events() const noexcept { return events_; }
+
+private:
+  [[nodiscard]] uint64_t deadline() const noexcept {
+    return base_tick_ + static_cast<uint64_t>(static_cast<double>(events_) *
+                                              ticks_per_event_);
+  }
+
+  double ticks_per_event_; ///< 0 = unlimited
+  uint64_t base_tick_ = 0;
+  uint64_t events_ = 0;
+};
+
+} // namespace itch
@@ -0,0 +1,263 @@
+#pragma once
+
+/**
+ * @file stream_parser.hpp
+ * @brief Resumable parser for ITCH streams delivered in arbitrary chunks.
+ *
+ * DESIGN PRINCIPLES:
+ * 1. Zero-copy whenever possible: complete messages are dispatched straight
+ *    from the caller's buffer via Parser. Batching visitors see carried and
+ *    length-prefixed messages as one-element spans.
+ * 2. Only a message that straddles a chunk boundary is copied - into a
+ *    fixed carry-over buffer sized for the largest ITCH message.
+ * 3. No allocation, no exceptions: a corrupt stream latches failed().
+ *
+ * Framing:
+ *   Raw            - messages back to back, size implied by the type byte
+ *                    (what parse_buffer() consumes)
+ *   LengthPrefixed - 2-byte big-endian length before every message
+ *                    (binary ITCH day files, MoldUDP64 message blocks)
+ *
+ * USAGE:
+ *   StreamParser<> stream;
+ *   while ((n = read(fd, buf, sizeof(buf))) > 0) {
+ *       stream.feed(buf, n, handler);
+ *   }
+ */
+
+#include "binary_reader.hpp"
+#include "parser.hpp"
+#include "registry.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace itch {
+
+/**
+ * @brief How messages are delimited in the byte stream.
+ */
+enum class StreamFraming : uint8_t {
+  Raw,           ///< Concatenated messages, size from the type byte
+  LengthPrefixed ///< 2-byte big-endian length before each message
+};
+
+// ============================================================================
+// Stream Parser Class
+// ============================================================================
+
+/**
+ * @brief Stateful parser that resumes messages split across feed() calls.
+ *
+ * @tparam Framing Stream delimiting (see StreamFraming).
+ *
+ * @example
+ *   StreamParser<StreamFraming::LengthPrefixed> stream;
+ *   reader.for_each_chunk(1 << 20, [&](const char* chunk, size_t len) {
+ *       stream.feed(chunk, len, handler);
+ *   });
+ */
+template <StreamFraming Framing = StreamFraming::Raw> class StreamParser {
+public:
+  static constexpr size_t kPrefixSize =
+      Framing == StreamFraming::LengthPrefixed ? kBinaryItchLengthPrefix : 0;
+
+  /// Enough for one complete record of the largest ITCH message
+  static constexpr size_t kCarryCapacity = kPrefixSize + kMaxMessageSize;
+
+  /**
+   * @brief Parse the next chunk of the stream.
+   *
+   * Completes any message left over from the previous chunk, dispatches
+   * every whole message in place, and keeps the trailing partial message
+   * for the next call.
+   *
+   * @return Bytes of `data` accepted - `length` unless the stream failed
+   *         (unknown type in Raw framing) within this chunk.
+   */
+  template <typename Visitor>
+  size_t feed(const char *data, size_t length, Visitor &visitor) noexcept {
+    if (failed_) {
+      return 0;
+    }
+
+    size_t offset = 0;
+    if (carry_len_ > 0 || skip_ > 0) {
+      offset = complete_carry(data, length, visitor);
+      if (failed_ || carry_len_ > 0 || skip_ > 0) {
+        return offset; // Chunk used up (or stream broken)
+      }
+    }
+
+    const char *body = data + offset;
+    const size_t avail = length - offset;
+    size_t used = 0;
+
+    if constexpr (Framing == StreamFraming::Raw) {
+      used = parser_.parse_buffer(body, avail, visitor);
+      if (used < avail && message_size(body[used]) == 0) {
+        failed_ = true; // on_unknown already called; size unknowable
+        return offset + used;
+      }
+    } else {
+      used = for_each_length_prefixed(body, avail,
+                                      [&](const char *msg, size_t len) {
+                                        dispatch(msg, len, visitor);
+                                      });
+    }
+
+    stash_tail(body + used, avail - used);
+    return length;
+  }
+
+  /**
+   * @brief Bytes of a partial message held for the next feed().
+   */
+  [[nodiscard]] size_t pending() const noexcept { return carry_len_; }
+
+  /**
+   * @brief True once a Raw stream hit an unknown type byte (cannot resync).
+   */
+  [[nodiscard]] bool failed() const noexcept { return failed_; }
+
+  /**
+   * @brief Messages reassembled across a chunk boundary.
+   */
+  [[nodiscard]] uint64_t carried_messages() const noexcept {
+    return carried_;
+  }
+
+  /**
+   * @brief Length-prefixed records too large for any ITCH message that
+   *        straddled a boundary and were skipped.
+   */
+  [[nodiscard]] uint64_t oversized_records() const noexcept {
+    return oversized_;
+  }
+
+  /**
+   * @brief Drop any partial message and clear the failed state.
+   */
+  void reset() noexcept {
+    carry_len_ = 0;
+    skip_ = 0;
+    failed_ = false;
+    carried_ = 0;
+    oversized_ = 0;
+  }
+
+private:
+  /**
+   * @brief Feed the carry-over buffer; dispatch once it holds a message.
+   *
+   * @return Bytes taken from `data`.
+   */
+  template <typename Visitor>
+  size_t complete_carry(const char *data, size_t length,
+                        Visitor &visitor) noexcept {
+    if (skip_ > 0) {
+      return take_skip(length);
+    }
+
+    size_t taken = 0;
+    size_t record = 0;
+
+    if constexpr (Framing == StreamFraming::Raw) {
+      record = message_size(carry_[0]); // Type byte checked when stashed
+    } else {
+      // The length prefix itself may have been split
+      if (carry_len_ < kPrefixSize) {
+        taken = fill(data, length, kPrefixSize);
+        if (carry_len_ < kPrefixSize) {
+          return taken;
+        }
+      }
+      record = kPrefixSize + *reinterpret_cast<const be_u16 *>(carry_);
+      if (record > kCarryCapacity) {
+        skip_ = record - carry_len_;
+        carry_len_ = 0;
+        ++oversized_;
+        return taken + take_skip(length - taken);
+      }
+    }
+
+    taken += fill(data + taken, length - taken, record);
+    if (carry_len_ == record) {
+      dispatch(carry_ + kPrefixSize, record - kPrefixSize, visitor);
+      carry_len_ = 0;
+      ++carried_;
+    }
+    return taken;
+  }
+
+  /**
+   * @brief Deliver one message that is not part of a contiguous run.
+   *
+   * Batching visitors get it through the batch table (a one-element
+   * MessageSpan for batched types), as MoldUdp64Decoder::decode_itch()
+   * does for its blocks; parse() alone would skip their on_xxx_batch hooks.
+   */
+  template <typename Visitor>
+  void dispatch(const char *msg, size_t len, Visitor &visitor) noexcept {
+    if constexpr (has_batch_hooks_v<Visitor>) {
+      if (len == 0) [[unlikely]] {
+        return; // parse() would report BufferTooSmall
+      }
+      // Clamp to the message so trailing record bytes are not parsed
+      const size_t size = message_size(msg[0]);
+      (void)parser_.parse_buffer_batched(
+          msg, size != 0 && size < len ? size : len, visitor);
+    } else {
+      (void)parser_.parse(msg, len, visitor);
+    }
+  }
+
+  /**
+   * @brief Copy up to `target - carry_len_` bytes into the carry buffer.
+   */
+  size_t fill(const char *data, size_t length, size_t target) noexcept {
+    const size_t want = target - carry_len_;
+    const size_t n = want < length ? want : length;
+    std::memcpy(carry_ + carry_len_, data, n);
+    carry_len_ += n;
+    return n;
+  }
+
+  size_t take_skip(size_t length) noexcept {
+    const size_t n = skip_ < length ? skip_ : length;
+    skip_ -= n;
+    return n;
+  }
+
+  /**
+   * @brief Keep the incomplete trailing message (always < one record).
+   */
+  void stash_tail(const char *tail, size_t length) noexcept {
+    if (length == 0) {
+      return;
+    }
+    if constexpr (Framing == StreamFraming::LengthPrefixed) {
+      if (length >= kPrefixSize) {
+        const size_t record =
+            kPrefixSize + *reinterpret_cast<const be_u16 *>(tail);
+        if (record > kCarryCapacity) {
+          skip_ = record - length;
+          ++oversized_;
+          return;
+        }
+      }
+    }
+    std::memcpy(carry_, tail, length);
+    carry_len_ = length;
+  }
+
+  Parser parser_;
+  char carry_[kCarryCapacity];
+  size_t carry_len_ = 0;
+  size_t skip_ = 0; ///< Bytes left of an oversized record being dropped
+  bool failed_ = false;
+  uint64_t carried_ = 0;
+  uint64_t oversized_ = 0;
+};
+
+} // namespace itch
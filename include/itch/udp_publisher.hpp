@@ -0,0 +1,221 @@
+#pragma once
+
+/**
+ * @file udp_publisher.hpp
+ * @brief Batched UDP (unicast or IPv4 multicast) sender for feed replay.
+ *
+ * DESIGN PRINCIPLES:
+ * 1. One syscall per batch: queued datagrams leave in one sendmmsg() call.
+ * 2. Zero-copy: send() queues a pointer, not the bytes, so payloads go to
+ *    the kernel straight from a mapped capture. They must stay valid until
+ *    the batch is flushed.
+ * 3. Connected socket: the destination is fixed at open(), so no per-
+ *    datagram address is passed or looked up.
+ *
+ * USAGE:
+ *   UdpPublisher tx;
+ *   tx.open({.address = "239.1.1.1", .port = 26400});
+ *   reader.for_each_packet([&](const char* data, size_t len) {
+ *       if (net.decode(data, len, udp)) {
+ *           tx.send(udp.payload, udp.length);
+ *       }
+ *   });
+ *   tx.flush();
+ */
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace itch {
+
+// ============================================================================
+// Options and Counters
+// ============================================================================
+
+/**
+ * @brief Destination and batching parameters for UdpPublisher::open().
+ */
+struct PublisherOptions {
+  const char *address = "127.0.0.1"; ///< Unicast or multicast IPv4
+  uint16_t port = 0;
+  const char *interface = nullptr; ///< Multicast egress IPv4; default route
+  int ttl = 1;                     ///< Multicast hops (1: stay on the LAN)
+  bool loopback = true;            ///< Deliver multicast to local listeners
+  size_t batch = 64;               ///< Datagrams per sendmmsg() call
+  int send_buffer = 0;             ///< SO_SNDBUF bytes; 0: default
+};
+
+/**
+ * @brief Send-side counters, cumulative since open().
+ */
+struct PublisherStats {
+  uint64_t packets = 0;  ///< Datagrams the kernel accepted
+  uint64_t bytes = 0;    ///< Payload bytes accepted
+  uint64_t batches = 0;  ///< flush() calls that had datagrams queued
+  uint64_t syscalls = 0; ///< sendmmsg() calls made
+  uint64_t dropped = 0;  ///< Datagrams refused (too large, send errors)
+};
+
+// ============================================================================
+// UDP Publisher Class
+// ============================================================================
+
+/**
+ * @brief sendmmsg() sender over a fixed batch of message headers.
+ *
+ * Not copyable or movable: the message headers point into the object.
+ */
+class UdpPublisher {
+public:
+  /// Largest UDP payload over IPv4
+  static constexpr size_t kMaxDatagram = 65507;
+
+  UdpPublisher() = default;
+  ~UdpPublisher() { close(); }
+
+  UdpPublisher(const UdpPublisher &) = delete;
+  UdpPublisher &operator=(const UdpPublisher &) = delete;
+
+  /**
+   * @brief Create the socket and connect it to the destination.
+   * @return false on a malformed address or a refused socket call.
+   */
+  bool open(const PublisherOptions &options) {
+    close();
+    sockaddr_in to{};
+    to.sin_family = AF_INET;
+    to.sin_port = htons(options.port);
+    in_addr egress{};
+    egress.s_addr = htonl(INADDR_ANY);
+    if (options.batch == 0 || options.address == nullptr ||
+        inet_pton(AF_INET, options.address, &to.sin_addr) != 1 ||
+        (options.interface != nullptr &&
+         inet_pton(AF_INET, options.interface, &egress) != 1)) {
+      return false;
+    }
+
+    fd_ = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd_ < 0) {
+      return false;
+    }
+    bool ok = true;
+    if (IN_MULTICAST(ntohl(to.sin_addr.s_addr))) {
+      const unsigned char ttl = static_cast<unsigned char>(options.ttl);
+      const unsigned char loop = options.loopback ? 1 : 0;
+      ok = setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_TTL, &ttl,
+                      sizeof(ttl)) == 0 &&
+           setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_LOOP, &loop,
+                      sizeof(loop)) == 0;
+      if (ok && options.interface != nullptr) {
+        ok = setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_IF, &egress,
+                        sizeof(egress)) == 0;
+      }
+    }
+    if (ok && options.send_buffer > 0) {
+      ok = setsockopt(fd_, SOL_SOCKET, SO_SNDBUF, &options.send_buffer,
+                      sizeof(options.send_buffer)) == 0;
+    }
+    ok = ok && ::connect(fd_, reinterpret_cast<const sockaddr *>(&to),
+                         sizeof(to)) == 0;
+    if (!ok) {
+      close();
+      return false;
+    }
+
+    batch_ = options.batch;
+    iovecs_.assign(batch_, iovec{});
+    headers_.assign(batch_, mmsghdr{});
+    for (size_t i = 0; i < batch_; ++i) {
+      headers_[i].msg_hdr.msg_iov = &iovecs_[i];
+      headers_[i].msg_hdr.msg_iovlen = 1;
+    }
+    pending_ = 0;
+    stats_ = PublisherStats{};
+    return true;
+  }
+
+  /**
+   * @brief Close the socket; datagrams still queued are discarded.
+   */
+  void close() noexcept {
+    if (fd_ >= 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+    pending_ = 0;
+  }
+
+  [[nodiscard]] bool is_open() const noexcept { return fd_ >= 0; }
+  [[nodiscard]] size_t batch() const noexcept { return batch_; }
+  [[nodiscard]] size_t pending() const noexcept { return pending_; }
+  [[nodiscard]] const PublisherStats &stats() const noexcept {
+    return stats_;
+  }
+
+  /**
+   * @brief Queue one datagram (by reference), flushing if the batch fills.
+   * @return false if it, or the batch it completed, was refused.
+   */
+  bool send(const char *data, size_t len) {
+    if (fd_ < 0 || len > kMaxDatagram) {
+      ++stats_.dropped;
+      return false;
+    }
+    iovecs_[pending_] = {const_cast<char *>(data), len};
+    ++pending_;
+    return pending_ < batch_ || flush();
+  }
+
+  /**
+   * @brief Send every queued datagram; returns when the kernel has them.
+   * @return false if any was refused (counted in stats().dropped).
+   */
+  bool flush() {
+    if (pending_ == 0) {
+      return true;
+    }
+    ++stats_.batches;
+    bool ok = true;
+    size_t done = 0;
+    while (done < pending_) {
+      ++stats_.syscalls;
+      const int sent =
+          sendmmsg(fd_, headers_.data() + done,
+                   static_cast<unsigned>(pending_ - done), 0);
+      if (sent < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        // The first datagram was refused (e.g. ECONNREFUSED after an
+        // ICMP port unreachable): drop it and carry on with the rest
+        ++stats_.dropped;
+        ++done;
+        ok = false;
+        continue;
+      }
+      for (size_t i = done; i < done + static_cast<size_t>(sent); ++i) {
+        stats_.bytes += headers_[i].msg_len;
+      }
+      stats_.packets += static_cast<uint64_t>(sent);
+      done += static_cast<size_t>(sent);
+    }
+    pending_ = 0;
+    return ok;
+  }
+
+private:
+  int fd_ = -1;
+  size_t batch_ = 0;
+  size_t pending_ = 0;
+  std::vector<iovec> iovecs_;
+  std::vector<mmsghdr> headers_;
+  PublisherStats stats_;
+};
+
+} // namespace itch
@@ -0,0 +1,82 @@
+#pragma once
+
+/**
+ * @file cli_args.hpp
+ * @brief Option-value parsers shared by the chronos_* drivers.
+ *
+ * Each parser takes the whole argument and returns false, leaving the
+ * caller to print its usage, if any of it is malformed: trailing input
+ * included.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <itch/replay_clock.hpp>
+
+namespace cli {
+
+/**
+ * @brief Parse a positive decimal count (digits only: no sign, no
+ *        leading space).
+ */
+inline bool parse_count(const char *arg, uint64_t &value) {
+  if (*arg < '0' || *arg > '9') {
+    return false; // strtoull() would take "-1" as a huge count
+  }
+  char *end = nullptr;
+  value = std::strtoull(arg, &end, 10);
+  return *end == '\0' && value > 0;
+}
+
+/**
+ * @brief Parse a --speed value (max, realtime or a positive factor).
+ */
+inline bool parse_speed(const char *arg, double &speed) {
+  if (std::strcmp(arg, "max") == 0) {
+    speed = itch::ReplayPacer::kMaxSpeed;
+    return true;
+  }
+  if (std::strcmp(arg, "realtime") == 0) {
+    speed = 1.0;
+    return true;
+  }
+  char *end = nullptr;
+  speed = std::strtod(arg, &end);
+  return end != arg && *end == '\0' && speed > 0.0;
+}
+
+/**
+ * @brief Parse HH:MM[:SS] into seconds after midnight.
+ */
+inline bool parse_time_of_day(const char *arg, long &seconds) {
+  int h = 0;
+  int m = 0;
+  int s = 0;
+  int used = 0;
+  if (std::sscanf(arg, "%d:%d%n", &h, &m, &used) != 2) {
+    return false;
+  }
+  int more = 0;
+  if (arg[used] == ':' &&
+      std::sscanf(arg + used, ":%d%n", &s, &more) == 1) {
+    used += more;
+  }
+  if (arg[used] != '\0' || h < 0 || h > 23 || m < 0 || m > 59 || s < 0 ||
+      s > 59) {
+    return false;
+  }
+  seconds = h * 3600L + m * 60L + s;
+  return true;
+}
+
+/**
+ * @brief Check a --from/--to pair (-1: not given): --to must not be
+ *        earlier than --from.
+ */
+inline bool valid_time_window(long from_s, long to_s) {
+  return from_s < 0 || to_s < 0 || to_s >= from_s;
+}
+
+} // namespace cli
@@ -2,21 +2,41 @@
  * @file main.cpp
  * @brief PCAP-based ITCH 5.0 feed handler driver.
  *
- * Usage: ./itch_driver <pcap_file>
+ * Usage: ./itch_driver [--map lazy|populate|readahead|hugecopy]
+ *                      [--threads N] <pcap_file | binary_itch_file>
  *
  * This program demonstrates zero-copy ITCH message parsing from a PCAP file:
  * 1. mmap's the PCAP file into memory
  * 2. Iterates over packets, passing pointers directly to parser
  * 3. Collects statistics via visitor pattern
+ *
+ * Raw NASDAQ binary ITCH day files (length-prefixed, no PCAP framing) are
+ * detected automatically and fed to the parser message by message.
+ *
+ * --map selects how the file's pages are faulted in (see mapped_file.hpp);
+ * the faults taken inside the processing loop are reported.
+ *
+ * --threads N splits a PCAP into N byte ranges scanned in parallel (see
+ * parallel_scan.hpp) and sums the per-range statistics. MoldUDP64 gap
+ * tracking restarts in each range, so gaps across a seam go uncounted.
+ * It cannot be combined with --map readahead.
  */
 
 #include <chrono>
 #include <cinttypes>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <itch/binary_reader.hpp>
+#include <itch/mapped_file.hpp>
+#include <itch/moldudp64.hpp>
+#include <itch/net_decoder.hpp>
+#include <itch/parallel_scan.hpp>
 #include <itch/parser.hpp>
 #include <itch/pcap_reader.hpp>
 
+#include "cli_args.hpp"
+
 namespace {
 
 // ============================================================================
@@ -44,7 +64,22 @@ struct StatsVisitor : itch::DefaultVisitor {
     total_executions += static_cast<uint32_t>(msg.executed_shares);
   }
 
-  void on_system_event(const itch::MessageHeader & /*msg*/) {
+  // Batch hooks: parse_buffer hands over whole same-type runs at once
+  void on_add_order_batch(itch::MessageSpan<itch::AddOrder> run) {
+    add_order_count += run.size();
+    for (const itch::AddOrder *msg : run) {
+      total_shares += static_cast<uint32_t>(msg->shares);
+    }
+  }
+
+  void on_order_executed_batch(itch::MessageSpan<itch::OrderExecuted> run) {
+    order_executed_count += run.size();
+    for (const itch::OrderExecuted *msg : run) {
+      total_executions += static_cast<uint32_t>(msg->executed_shares);
+    }
+  }
+
+  void on_system_event(const itch::SystemEvent & /*msg*/) {
     ++system_event_count;
   }
 
@@ -52,6 +87,15 @@ struct StatsVisitor : itch::DefaultVisitor {
     ++unknown_count;
   }
 
+  void merge(const StatsVisitor &other) {
+    add_order_count += other.add_order_count;
+    order_executed_count += other.order_executed_count;
+    system_event_count += other.system_event_count;
+    unknown_count += other.unknown_count;
+    total_shares += other.total_shares;
+    total_executions += other.total_executions;
+  }
+
   [[nodiscard]] uint64_t total_messages() const {
     return add_order_count + order_executed_count + system_event_count +
            unknown_count;
@@ -70,14 +114,188 @@ struct StatsVisitor : itch::DefaultVisitor {
   }
 };
 
+// ============================================================================
+// Packet Scan
+// ============================================================================
+
+/**
+ * @brief Everything the packet loop mutates: one per scanned range.
+ */
+struct PacketScan {
+  explicit PacketScan(itch::LinkType link) : net(link) {}
+
+  void operator()(const char *data, size_t len) {
+    ++packets;
+    if (!net.decode(data, len, udp)) {
+      return; // Not a UDP datagram (ARP, TCP, fragment, ...)
+    }
+
+    // Session layer first: walk length-prefixed blocks, track sequence
+    if (itch::is_moldudp64_packet(udp.payload, udp.length)) {
+      (void)mold.decode_itch(udp.payload, udp.length, stats);
+      return;
+    }
+
+    // Raw ITCH directly in the UDP payload
+    (void)parser.parse_buffer(udp.payload, udp.length, stats);
+  }
+
+  itch::Parser parser;
+  StatsVisitor stats;
+  // Link/IP/UDP headers decoded per the capture's link type
+  itch::UdpDecoder net;
+  itch::UdpDatagram udp;
+  itch::MoldUdp64Decoder<> mold;
+  size_t packets = 0;
+};
+
+/**
+ * @brief Statistics summed over the scanned ranges.
+ */
+struct ScanTotals {
+  StatsVisitor stats;
+  itch::NetDecoderStats net;
+  itch::MoldUdp64Stats mold;
+  size_t packets = 0;
+
+  void merge(const PacketScan &scan) {
+    stats.merge(scan.stats);
+    packets += scan.packets;
+
+    const itch::NetDecoderStats &n = scan.net.stats();
+    net.packets += n.packets;
+    net.datagrams += n.datagrams;
+    net.non_ip += n.non_ip;
+    net.non_udp += n.non_udp;
+    net.fragments += n.fragments;
+    net.truncated += n.truncated;
+    net.filtered += n.filtered;
+
+    const itch::MoldUdp64Stats &m = scan.mold.stats();
+    mold.packets += m.packets;
+    mold.messages += m.messages;
+    mold.heartbeats += m.heartbeats;
+    mold.end_of_session += m.end_of_session;
+    mold.gaps += m.gaps;
+    mold.missed_messages += m.missed_messages;
+    mold.duplicate_packets += m.duplicate_packets;
+    mold.duplicate_messages += m.duplicate_messages;
+    mold.truncated += m.truncated;
+    mold.untracked_packets += m.untracked_packets;
+  }
+};
+
+/**
+ * @brief Print MoldUDP64 session-layer counters.
+ */
+void print_mold_stats(const itch::MoldUdp64Stats &mold) {
+  std::printf("\n=== MoldUDP64 Session Layer ===\n");
+  std::printf("Packets:          %12" PRIu64 "\n", mold.packets);
+  std::printf("Messages:         %12" PRIu64 "\n", mold.messages);
+  std::printf("Heartbeats:       %12" PRIu64 "\n", mold.heartbeats);
+  std::printf("Gaps:             %12" PRIu64 " (%" PRIu64 " messages)\n",
+              mold.gaps, mold.missed_messages);
+  std::printf("Duplicates:       %12" PRIu64 " (%" PRIu64 " messages)\n",
+              mold.duplicate_packets, mold.duplicate_messages);
+  std::printf("Truncated:        %12" PRIu64 "\n", mold.truncated);
+}
+
+/**
+ * @brief Print link/IP/UDP decoder counters.
+ */
+void print_net_stats(const itch::NetDecoderStats &net) {
+  std::printf("\n=== Network Layer ===\n");
+  std::printf("UDP datagrams:    %12" PRIu64 "\n", net.datagrams);
+  std::printf("Non-UDP:          %12" PRIu64 "\n", net.non_ip + net.non_udp);
+  std::printf("Fragments:        %12" PRIu64 "\n", net.fragments);
+  std::printf("Filtered:         %12" PRIu64 "\n", net.filtered);
+  std::printf("Truncated:        %12" PRIu64 "\n", net.truncated);
+}
+
+/**
+ * @brief Print the page faults the processing loop took.
+ */
+void print_faults(const itch::FaultCounts &faults,
+                  const itch::MappedFile &mapping) {
+  std::printf("\n=== Page Faults (%s%s) ===\n",
+              itch::map_strategy_name(mapping.strategy()),
+              mapping.strategy() == itch::MapStrategy::HugeCopy
+                  ? (mapping.huge_pages() ? ", MAP_HUGETLB" : ", THP")
+                  : "");
+  std::printf("Minor:            %12" PRIu64 "\n", faults.minor);
+  std::printf("Major:            %12" PRIu64 "\n", faults.major);
+}
+
+// ============================================================================
+// Binary ITCH Day Files
+// ============================================================================
+
+/**
+ * @brief Parse a length-prefixed binary ITCH file.
+ *
+ * @return Process exit code.
+ */
+int run_binary_itch(const char *path, const itch::MapOptions &map) {
+  itch::BinaryItchReader reader(path, map);
+  if (!reader.is_open()) {
+    std::fprintf(stderr, "Error: Not a PCAP or binary ITCH file: %s\n",
+                 path);
+    return 1;
+  }
+
+  std::printf("Binary ITCH file, size: %.2f MB\n",
+              reader.file_size() / (1024.0 * 1024.0));
+
+  itch::Parser parser;
+  StatsVisitor stats;
+
+  std::printf("Processing messages...\n");
+
+  const itch::FaultCounts faults_before = itch::thread_faults();
+  auto start_time = std::chrono::high_resolution_clock::now();
+
+  size_t message_count =
+      reader.for_each_message([&](const char *msg, size_t len) {
+        (void)parser.parse(msg, len, stats);
+      });
+
+  auto end_time = std::chrono::high_resolution_clock::now();
+  const itch::FaultCounts faults = itch::thread_faults() - faults_before;
+  auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+      end_time - start_time);
+
+  std::printf("\n=== Performance ===\n");
+  std::printf("Messages processed: %zu\n", message_count);
+  std::printf("Time: %.3f ms\n", duration.count() / 1000.0);
+
+  if (duration.count() > 0) {
+    double msgs_per_sec = message_count * 1e6 / duration.count();
+    double mb_per_sec =
+        reader.file_size() / (1024.0 * 1024.0) * 1e6 / duration.count();
+    std::printf("Throughput: %.2f million messages/sec\n",
+                msgs_per_sec / 1e6);
+    std::printf("Bandwidth: %.2f MB/sec\n", mb_per_sec);
+  }
+
+  stats.print_stats();
+  print_faults(faults, reader.mapping());
+  return 0;
+}
+
 // ============================================================================
 // Print Usage
 // ============================================================================
 
 void print_usage(const char *program) {
-  std::fprintf(stderr, "Usage: %s <pcap_file>\n", program);
+  std::fprintf(stderr,
+               "Usage: %s [--map lazy|populate|readahead|hugecopy] "
+               "[--threads N] <pcap_file | binary_itch_file>\n",
+               program);
   std::fprintf(stderr, "\nZero-copy ITCH 5.0 feed handler.\n");
-  std::fprintf(stderr, "Parses NASDAQ ITCH messages from a PCAP file.\n");
+  std::fprintf(stderr, "Parses NASDAQ ITCH messages from a PCAP file or a\n");
+  std::fprintf(stderr, "length-prefixed binary ITCH day file.\n");
+  std::fprintf(stderr, "\n--threads N  scan a PCAP in N parallel byte "
+                       "ranges (default 1; not with --map readahead)\n");
 }
 
 } // anonymous namespace
@@ -88,148 +306,84 @@ void print_usage(const char *program) {
 
 int main(int argc, char *argv[]) {
   // Parse arguments
-  if (argc != 2) {
+  itch::MapOptions map;
+  size_t threads = 1;
+  const char *pcap_file = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--map") == 0 && i + 1 < argc) {
+      if (!itch::parse_map_strategy(argv[++i], map.strategy)) {
+        print_usage(argv[0]);
+        return 1;
+      }
+    } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      uint64_t n = 0;
+      if (!cli::parse_count(argv[++i], n) || n > 1024) {
+        print_usage(argv[0]);
+        return 1;
+      }
+      threads = static_cast<size_t>(n);
+    } else if (pcap_file == nullptr && std::strncmp(argv[i], "--", 2) != 0) {
+      pcap_file = argv[i];
+    } else {
+      print_usage(argv[0]);
+      return 1;
+    }
+  }
+  if (pcap_file == nullptr) {
     print_usage(argv[0]);
     return 1;
   }
-
-  const char *pcap_file = argv[1];
+  // The read-ahead thread paces itself on one consumer (parallel_scan.hpp)
+  if (threads > 1 && map.strategy == itch::MapStrategy::ReadAhead) {
+    std::fprintf(stderr, "Error: --map readahead takes no --threads\n");
+    return 1;
+  }
 
   // Open PCAP file
-  std::printf("Opening PCAP file: %s\n", pcap_file);
-  itch::PcapReader reader(pcap_file);
+  std::printf("Opening file: %s\n", pcap_file);
+  itch::PcapReader reader(pcap_file, map);
 
   if (!reader.is_open()) {
-    std::fprintf(stderr, "Error: Failed to open PCAP file: %s\n", pcap_file);
-    return 1;
+    // Not a PCAP: maybe a raw NASDAQ binary ITCH day file
+    return run_binary_itch(pcap_file, map);
   }
 
   std::printf("File size: %.2f MB\n", reader.file_size() / (1024.0 * 1024.0));
-
-  // Prepare parser and visitor
-  itch::Parser parser;
-  StatsVisitor stats;
+  if (reader.format() == itch::CaptureFormat::PcapNg) {
+    std::printf("Format: pcapng\n");
+  }
 
   // Process packets
   std::printf("Processing packets...\n");
 
+  const itch::FaultCounts faults_before = itch::thread_faults();
   auto start_time = std::chrono::high_resolution_clock::now();
 
-  // ============================================================================
-  // Network Header Offset Heuristics
-  // ============================================================================
-  //
-  // Standard network headers before ITCH payload:
-  //   - Ethernet: 14 bytes
-  //   - IP:       20 bytes
-  //   - UDP:      8 bytes
-  //   - Total:    42 bytes
-  //
-  // Some captures may have VLAN tags (+4 bytes) or other variations.
-  // We use a heuristic: search for valid ITCH message type in first 64 bytes.
-  // ============================================================================
-
-  // Valid ITCH message types
-  auto is_valid_itch_type = [](char c) {
-    // Order messages
-    if (c == 'A' || c == 'F' || c == 'E' || c == 'C' || c == 'X' || c == 'D' ||
-        c == 'U')
-      return true;
-    // Trade messages
-    if (c == 'P' || c == 'Q' || c == 'B')
-      return true;
-    // System/stock messages
-    if (c == 'S' || c == 'R' || c == 'H' || c == 'Y' || c == 'L')
-      return true;
-    // Net order imbalance
-    if (c == 'I' || c == 'N')
-      return true;
-    // MWCB and IPO
-    if (c == 'V' || c == 'W' || c == 'K')
-      return true;
-    return false;
-  };
-
-  // Find ITCH payload offset within a packet
-  auto find_itch_offset = [&is_valid_itch_type](const char *data,
-                                                size_t len) -> size_t {
-    // Common header configurations:
-    // 1. Standard: Ethernet(14) + IP(20) + UDP(8) = 42 bytes
-    // 2. With VLAN: Ethernet(14) + VLAN(4) + IP(20) + UDP(8) = 46 bytes
-    // 3. MoldUDP64: ... + Session(10) + Seq(8) + Count(2) = +20 bytes
-    // 4. Message length prefix: +2 bytes before each ITCH message
-    //
-    // Common offsets to try (in order):
-    constexpr size_t OFFSETS[] = {
-        42, // Standard UDP
-        46, // With VLAN tag
-        62, // Standard + MoldUDP header
-        64, // Standard + MoldUDP + length prefix
-        66, // VLAN + MoldUDP header
-        68, // VLAN + MoldUDP + length prefix
-    };
-
-    // Try each known offset
-    for (size_t offset : OFFSETS) {
-      if (offset < len) {
-        char msg_type = data[offset];
-        if (is_valid_itch_type(msg_type)) {
-          // Additional validation: check stock_locate is reasonable
-          if (len >= offset + 3) {
-            uint16_t stock_locate = static_cast<uint16_t>(
-                (static_cast<uint8_t>(data[offset + 1]) << 8) |
-                static_cast<uint8_t>(data[offset + 2]));
-            if (stock_locate > 0 && stock_locate < 10000) {
-              return offset;
-            }
-          }
-          // Even without stock_locate validation, valid message type is good
-          return offset;
-        }
-      }
-    }
-
-    // Fallback: Search first 100 bytes for valid ITCH message type
-    constexpr size_t SEARCH_LIMIT = 100;
-    size_t search_end = (len < SEARCH_LIMIT) ? len : SEARCH_LIMIT;
-
-    for (size_t offset = 0; offset < search_end; ++offset) {
-      char msg_type = data[offset];
-      if (is_valid_itch_type(msg_type)) {
-        // Validate with stock_locate
-        if (len >= offset + 3) {
-          uint16_t stock_locate = static_cast<uint16_t>(
-              (static_cast<uint8_t>(data[offset + 1]) << 8) |
-              static_cast<uint8_t>(data[offset + 2]));
-          if (stock_locate > 0 && stock_locate < 10000) {
-            return offset;
-          }
-        }
-      }
-    }
-
-    // Last resort: return 42 and let parser handle it
-    return 42;
-  };
-
-  size_t packet_count =
-      reader.for_each_packet([&](const char *data, size_t len) {
-        // Find ITCH payload offset (skip network headers)
-        size_t offset = find_itch_offset(data, len);
-
-        if (offset < len) {
-          const char *itch_data = data + offset;
-          size_t itch_len = len - offset;
-          (void)parser.parse_buffer(itch_data, itch_len, stats);
-        }
-      });
+  ScanTotals totals;
+  if (threads > 1) {
+    totals = itch::parallel_for_each_packet(
+        reader, threads, ScanTotals{},
+        [&](size_t) { return PacketScan(reader.link_type()); },
+        [](ScanTotals &acc, const PacketScan &scan) { acc.merge(scan); });
+  } else {
+    PacketScan scan(reader.link_type());
+    (void)reader.for_each_packet(scan);
+    totals.merge(scan);
+  }
 
   auto end_time = std::chrono::high_resolution_clock::now();
+  // Calling thread only: with --threads the other ranges' faults are
+  // not included
+  const itch::FaultCounts faults = itch::thread_faults() - faults_before;
   auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
       end_time - start_time);
+  const size_t packet_count = totals.packets;
 
   // Print results
   std::printf("\n=== Performance ===\n");
+  if (threads > 1) {
+    std::printf("Threads: %zu\n", threads);
+  }
   std::printf("Packets processed: %zu\n", packet_count);
   std::printf("Time: %.3f ms\n", duration.count() / 1000.0);
 
@@ -242,7 +396,12 @@ int main(int argc, char *argv[]) {
     std::printf("Bandwidth: %.2f MB/sec\n", mb_per_sec);
   }
 
-  stats.print_stats();
+  totals.stats.print_stats();
+  print_net_stats(totals.net);
+  if (totals.mold.packets > 0) {
+    print_mold_stats(totals.mold);
+  }
+  print_faults(faults, reader.mapping());
 
   return 0;
 }
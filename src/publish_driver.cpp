@@ -0,0 +1,291 @@
+/**
+ * @file publish_driver.cpp
+ * @brief Capture-to-UDP publisher for load-testing feed receivers.
+ *
+ * Replays the UDP payloads of a PCAP / pcapng capture (the MoldUDP64
+ * packets) onto a unicast or multicast destination with sendmmsg()
+ * batching, optionally paced on capture timestamps, capped at a packet
+ * rate, and with injected bursts.
+ *
+ * Usage: ./chronos_publish [--to ADDR:PORT] [--interface IFADDR]
+ *                          [--batch N] [--speed max|realtime|N]
+ *                          [--rate PKTS_PER_SEC] [--burst N:EVERY]
+ *                          [--loop N] [pcap_file]
+ *        Default: data/Multiple.Packets.pcap to 127.0.0.1:26400, flat out
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <itch/net_decoder.hpp>
+#include <itch/pcap_reader.hpp>
+#include <itch/replay_clock.hpp>
+#include <itch/udp_publisher.hpp>
+#include <string>
+#include <vector>
+
+#include "cli_args.hpp"
+
+namespace {
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+/// Default PCAP file if none specified
+constexpr const char *DEFAULT_PCAP = "data/Multiple.Packets.pcap";
+
+/// Default destination (the port chronos_replay --listen examples use)
+constexpr const char *DEFAULT_ADDRESS = "127.0.0.1";
+constexpr uint16_t DEFAULT_PORT = 26400;
+
+// ============================================================================
+// Argument Parsing
+// ============================================================================
+
+void print_usage(const char *program) {
+  std::fprintf(stderr,
+               "Usage: %s [--to ADDR:PORT] [--interface IFADDR] [--batch N] "
+               "[--speed max|realtime|N]\n"
+               "       [--rate PKTS_PER_SEC] [--burst N:EVERY] [--loop N] "
+               "[pcap_file]\n",
+               program);
+  std::fprintf(stderr, "\nChronos Capture Publisher\n");
+  std::fprintf(stderr,
+               "Sends each packet's UDP payload to ADDR:PORT "
+               "(default %s:%u).\n",
+               DEFAULT_ADDRESS, static_cast<unsigned>(DEFAULT_PORT));
+  std::fprintf(stderr, "\nDefault PCAP: %s\n", DEFAULT_PCAP);
+  std::fprintf(stderr,
+               "\n--batch  datagrams per sendmmsg (default 64)\n"
+               "--speed  max (default): no pacing; realtime: capture "
+               "spacing;\n         N: N times faster than captured\n"
+               "--rate   at most this many packets per second\n"
+               "--burst  every EVERY packets, send the next N back to back,\n"
+               "         ignoring --speed and --rate\n"
+               "--loop   send the capture N times (default 1)\n");
+}
+
+/**
+ * @brief Parse ADDR:PORT; false if malformed.
+ */
+bool parse_destination(const char *arg, std::string &address,
+                       uint16_t &port) {
+  const char *colon = std::strrchr(arg, ':');
+  uint64_t value = 0;
+  if (colon == nullptr || colon == arg || !cli::parse_count(colon + 1, value) ||
+      value > 65535) {
+    return false;
+  }
+  address.assign(arg, colon);
+  port = static_cast<uint16_t>(value);
+  return true;
+}
+
+/**
+ * @brief Parse N:EVERY (N < EVERY); false if malformed.
+ */
+bool parse_burst(const char *arg, uint64_t &count, uint64_t &every) {
+  const char *colon = std::strchr(arg, ':');
+  if (colon == nullptr) {
+    return false;
+  }
+  const std::string head(arg, colon);
+  return cli::parse_count(head.c_str(), count) &&
+         cli::parse_count(colon + 1, every) && count < every;
+}
+
+// ============================================================================
+// Reporting
+// ============================================================================
+
+/**
+ * @brief Value at quantile `q` of sorted samples.
+ */
+uint64_t percentile(const std::vector<uint64_t> &sorted, double q) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  const auto i = static_cast<size_t>(q * static_cast<double>(sorted.size()));
+  return sorted[std::min(i, sorted.size() - 1)];
+}
+
+void print_latency(std::vector<uint64_t> &batch_ns) {
+  std::sort(batch_ns.begin(), batch_ns.end());
+  std::printf("\n=== sendmmsg Latency (per batch) ===\n");
+  std::printf("p50: %" PRIu64 " ns  p99: %" PRIu64 " ns  p99.9: %" PRIu64
+              " ns  max: %" PRIu64 " ns\n",
+              percentile(batch_ns, 0.50), percentile(batch_ns, 0.99),
+              percentile(batch_ns, 0.999),
+              batch_ns.empty() ? 0 : batch_ns.back());
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Main Driver
+// ============================================================================
+
+int main(int argc, char *argv[]) {
+  const char *pcap_file = DEFAULT_PCAP;
+  bool have_file = false;
+  std::string address = DEFAULT_ADDRESS;
+  itch::PublisherOptions options;
+  options.port = DEFAULT_PORT;
+  double speed = itch::ReplayPacer::kMaxSpeed;
+  uint64_t rate = 0;
+  uint64_t burst_count = 0; // --burst N:EVERY
+  uint64_t burst_every = 0;
+  uint64_t loops = 1;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    bool ok = true;
+    uint64_t value = 0;
+    if (arg == "-h" || arg == "--help") {
+      print_usage(argv[0]);
+      return 0;
+    }
+    if (arg == "--to" && i + 1 < argc) {
+      ok = parse_destination(argv[++i], address, options.port);
+    } else if (arg == "--interface" && i + 1 < argc) {
+      options.interface = argv[++i];
+    } else if (arg == "--batch" && i + 1 < argc) {
+      ok = cli::parse_count(argv[++i], value) && value <= 1024;
+      options.batch = static_cast<size_t>(value);
+    } else if (arg == "--speed" && i + 1 < argc) {
+      ok = cli::parse_speed(argv[++i], speed);
+    } else if (arg == "--rate" && i + 1 < argc) {
+      ok = cli::parse_count(argv[++i], rate);
+    } else if (arg == "--burst" && i + 1 < argc) {
+      ok = parse_burst(argv[++i], burst_count, burst_every);
+    } else if (arg == "--loop" && i + 1 < argc) {
+      ok = cli::parse_count(argv[++i], loops);
+    } else if (!have_file && arg.rfind("--", 0) != 0) {
+      pcap_file = argv[i];
+      have_file = true;
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      print_usage(argv[0]);
+      return 1;
+    }
+  }
+
+  itch::PcapReader reader(pcap_file);
+  if (!reader.is_open()) {
+    std::fprintf(stderr, "Error: Not a PCAP file: %s\n", pcap_file);
+    return 1;
+  }
+  options.address = address.c_str();
+  itch::UdpPublisher publisher;
+  if (!publisher.open(options)) {
+    std::fprintf(stderr, "Error: cannot send to %s:%u\n", address.c_str(),
+                 static_cast<unsigned>(options.port));
+    return 1;
+  }
+
+  std::printf("Publishing %s -> %s:%u\n", pcap_file, address.c_str(),
+              static_cast<unsigned>(options.port));
+  std::printf("  Batch: %zu  Pacing: ", publisher.batch());
+  if (speed > 0.0) {
+    std::printf("%.2fx capture time", speed);
+  } else {
+    std::printf("none");
+  }
+  if (rate > 0) {
+    std::printf("  Rate cap: %" PRIu64 " pkts/s", rate);
+  }
+  if (burst_every > 0) {
+    std::printf("  Bursts: %" PRIu64 " every %" PRIu64, burst_count,
+                burst_every);
+  }
+  std::printf("  Loops: %" PRIu64 "\n", loops);
+
+  // Calibrate the TSC before the clock starts: batches are timed with it
+  const itch::TscClock clock = itch::TscClock::calibrate();
+  itch::ReplayPacer pacer(speed, clock);
+  itch::RateLimiter limiter(static_cast<double>(rate), clock);
+  itch::UdpDecoder net(reader.link_type());
+  itch::UdpDatagram udp;
+
+  std::vector<uint64_t> batch_ns;
+  uint64_t skipped = 0; // Not UDP (ARP, TCP, fragments, ...)
+  uint64_t index = 0;   // UDP packets offered, for burst placement
+
+  auto timed_flush = [&]() {
+    if (publisher.pending() == 0) {
+      return;
+    }
+    const uint64_t t0 = itch::TscClock::ticks();
+    (void)publisher.flush();
+    batch_ns.push_back(clock.to_nanos(itch::TscClock::ticks() - t0));
+  };
+
+  auto on_packet = [&](const char *data, size_t len, uint64_t ts_ns) {
+    if (!net.decode(data, len, udp)) {
+      ++skipped;
+      return;
+    }
+    const bool in_burst =
+        burst_every > 0 && index % burst_every < burst_count;
+    ++index;
+    if (!in_burst) {
+      // Whatever is queued goes now rather than after the wait
+      if (!pacer.due(ts_ns) || !limiter.due()) {
+        timed_flush();
+      }
+      (void)pacer.wait(ts_ns);
+      limiter.wait();
+    }
+    if (publisher.pending() + 1 == publisher.batch()) {
+      // This datagram completes the batch: time the send it triggers
+      const uint64_t t0 = itch::TscClock::ticks();
+      (void)publisher.send(udp.payload, udp.length);
+      batch_ns.push_back(clock.to_nanos(itch::TscClock::ticks() - t0));
+    } else {
+      (void)publisher.send(udp.payload, udp.length);
+    }
+  };
+
+  const auto start = std::chrono::steady_clock::now();
+  for (uint64_t loop = 0; loop < loops; ++loop) {
+    pacer.reset(); // Each pass restarts the capture schedule
+    (void)reader.for_each_packet(on_packet);
+  }
+  timed_flush();
+  const double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+
+  const itch::PublisherStats &ps = publisher.stats();
+  std::printf("\n=== Published ===\n");
+  std::printf("Packets: %" PRIu64 "  Bytes: %" PRIu64 "  Dropped: %" PRIu64
+              "  Not UDP: %" PRIu64 "\n",
+              ps.packets, ps.bytes, ps.dropped, skipped);
+  std::printf("Time: %.3f ms\n", seconds * 1000.0);
+  if (seconds > 0.0) {
+    std::printf("Rate: %.0f pkts/s  %.2f MB/s\n",
+                static_cast<double>(ps.packets) / seconds,
+                static_cast<double>(ps.bytes) / (1024.0 * 1024.0) / seconds);
+  }
+  std::printf("Batches: %" PRIu64 " (%.1f packets each, %" PRIu64
+              " syscalls)\n",
+              ps.batches,
+              ps.batches == 0 ? 0.0
+                              : static_cast<double>(ps.packets) /
+                                    static_cast<double>(ps.batches),
+              ps.syscalls);
+  print_latency(batch_ns);
+
+  if (!pacer.unpaced()) {
+    const itch::PacerStats &pst = pacer.stats();
+    std::printf("\nPacing lateness (last pass): max %" PRIu64 " ns\n",
+                pst.max_lateness_ns);
+  }
+  return ps.dropped == 0 ? 0 : 2;
+}
@@ -8,7 +8,7 @@
  * DESIGN:
  * - PythonAccumulator collects data in C++ vectors (no Python callbacks)
  * - parse_file() returns a dict of NumPy arrays (zero-copy where possible)
- * - Reuses offset detection logic from main.cpp for PCAP header handling
+ * - UdpDecoder locates UDP payloads from the capture's real headers
  */
 
 #include <pybind11/numpy.h>
@@ -20,91 +20,16 @@
 #include <vector>
 
 #include <itch/messages.hpp>
+#include <itch/moldudp64.hpp>
+#include <itch/net_decoder.hpp>
 #include <itch/parser.hpp>
 #include <itch/pcap_reader.hpp>
+#include <itch/soa_decoder.hpp>
 
 namespace py = pybind11;
 
 namespace {
 
-// ============================================================================
-// ITCH Message Type Validation (reused from main.cpp)
-// ============================================================================
-
-inline bool is_valid_itch_type(char c) {
-  // Order messages
-  if (c == 'A' || c == 'F' || c == 'E' || c == 'C' || c == 'X' || c == 'D' ||
-      c == 'U')
-    return true;
-  // Trade messages
-  if (c == 'P' || c == 'Q' || c == 'B')
-    return true;
-  // System/stock messages
-  if (c == 'S' || c == 'R' || c == 'H' || c == 'Y' || c == 'L')
-    return true;
-  // Net order imbalance
-  if (c == 'I' || c == 'N')
-    return true;
-  // MWCB and IPO
-  if (c == 'V' || c == 'W' || c == 'K')
-    return true;
-  return false;
-}
-
-// ============================================================================
-// PCAP Offset Detection (reused from main.cpp)
-// ============================================================================
-
-inline size_t find_itch_offset(const char *data, size_t len) {
-  // Common header configurations
-  constexpr size_t OFFSETS[] = {
-      42, // Standard UDP
-      46, // With VLAN tag
-      62, // Standard + MoldUDP header
-      64, // Standard + MoldUDP + length prefix
-      66, // VLAN + MoldUDP header
-      68, // VLAN + MoldUDP + length prefix
-  };
-
-  // Try each known offset
-  for (size_t offset : OFFSETS) {
-    if (offset < len) {
-      char msg_type = data[offset];
-      if (is_valid_itch_type(msg_type)) {
-        if (len >= offset + 3) {
-          uint16_t stock_locate = static_cast<uint16_t>(
-              (static_cast<uint8_t>(data[offset + 1]) << 8) |
-              static_cast<uint8_t>(data[offset + 2]));
-          if (stock_locate > 0 && stock_locate < 10000) {
-            return offset;
-          }
-        }
-        return offset;
-      }
-    }
-  }
-
-  // Fallback: Search first 100 bytes
-  constexpr size_t SEARCH_LIMIT = 100;
-  size_t search_end = (len < SEARCH_LIMIT) ? len : SEARCH_LIMIT;
-
-  for (size_t offset = 0; offset < search_end; ++offset) {
-    char msg_type = data[offset];
-    if (is_valid_itch_type(msg_type)) {
-      if (len >= offset + 3) {
-        uint16_t stock_locate = static_cast<uint16_t>(
-            (static_cast<uint8_t>(data[offset + 1]) << 8) |
-            static_cast<uint8_t>(data[offset + 2]));
-        if (stock_locate > 0 && stock_locate < 10000) {
-          return offset;
-        }
-      }
-    }
-  }
-
-  return 42; // Last resort
-}
-
 // ============================================================================
 // Python Accumulator - Collects data in C++ vectors
 // ============================================================================
@@ -149,6 +74,50 @@ public:
     exec_match_numbers.push_back(static_cast<uint64_t>(msg.match_number));
   }
 
+  /**
+   * @brief Append a run of AddOrders column by column.
+   *
+   * One resize per column per run instead of six push_backs per message;
+   * the SoA decoder then fills all columns in one SIMD pass.
+   */
+  void on_add_order_batch(itch::MessageSpan<itch::AddOrder> run) {
+    const size_t base = add_order_refs.size();
+    const size_t n = run.size();
+
+    add_order_refs.resize(base + n);
+    add_timestamps.resize(base + n);
+    add_stock_locates.resize(base + n);
+    add_shares.resize(base + n);
+    add_prices.resize(base + n);
+    add_sides.resize(base + n);
+
+    itch::decode_add_orders(
+        run, itch::AddOrderColumns{
+                 add_order_refs.data() + base, add_timestamps.data() + base,
+                 add_stock_locates.data() + base, add_shares.data() + base,
+                 add_prices.data() + base, add_sides.data() + base});
+  }
+
+  /**
+   * @brief Append a run of OrderExecuted messages column by column.
+   */
+  void on_order_executed_batch(itch::MessageSpan<itch::OrderExecuted> run) {
+    const size_t base = exec_order_refs.size();
+    const size_t n = run.size();
+
+    exec_order_refs.resize(base + n);
+    exec_timestamps.resize(base + n);
+    exec_stock_locates.resize(base + n);
+    exec_shares.resize(base + n);
+    exec_match_numbers.resize(base + n);
+
+    itch::decode_order_executed(
+        run, itch::OrderExecutedColumns{
+                 exec_order_refs.data() + base, exec_timestamps.data() + base,
+                 exec_stock_locates.data() + base, exec_shares.data() + base,
+                 exec_match_numbers.data() + base});
+  }
+
   /**
    * @brief Convert accumulated AddOrder data to Python dict of NumPy arrays.
    */
@@ -221,15 +190,23 @@ py::dict parse_file(const std::string &filename) {
   itch::Parser parser;
   PythonAccumulator accumulator;
 
+  itch::UdpDecoder net(reader.link_type());
+  itch::UdpDatagram udp;
+  itch::MoldUdp64Decoder<> mold;
+  size_t skipped_packets = 0;
+
   // Process all packets
   size_t packet_count =
       reader.for_each_packet([&](const char *data, size_t len) {
-        size_t offset = find_itch_offset(data, len);
-        if (offset < len) {
-          const char *itch_data = data + offset;
-          size_t itch_len = len - offset;
-          (void)parser.parse_buffer(itch_data, itch_len, accumulator);
+        if (!net.decode(data, len, udp)) {
+          ++skipped_packets; // Not a UDP datagram
+          return;
+        }
+        if (itch::is_moldudp64_packet(udp.payload, udp.length)) {
+          (void)mold.decode_itch(udp.payload, udp.length, accumulator);
+          return;
         }
+        (void)parser.parse_buffer(udp.payload, udp.length, accumulator);
       });
 
   // Build result dictionary
@@ -238,6 +215,10 @@ py::dict parse_file(const std::string &filename) {
   result["order_executed"] = accumulator.get_order_executed();
   result["packet_count"] = packet_count;
   result["file_size"] = reader.file_size();
+  result["sequence_gaps"] = mold.stats().gaps;
+  result["missed_messages"] = mold.stats().missed_messages;
+  result["duplicate_messages"] = mold.stats().duplicate_messages;
+  result["skipped_packets"] = skipped_packets;
 
   return result;
 }
@@ -283,6 +264,9 @@ PYBIND11_MODULE(itch_handler, m) {
                                         stock_locate, executed_shares, match_number)
                     - 'packet_count': Number of packets processed
                     - 'file_size': Size of PCAP file in bytes
+                    - 'sequence_gaps', 'missed_messages',
+                      'duplicate_messages': MoldUDP64 sequence checks
+                    - 'skipped_packets': Packets that were not UDP datagrams
         )pbdoc");
 
   m.def("version", &version, "Get library version string");
@@ -9,16 +9,38 @@
  * 3. Order book management (matching engine)
  * 4. Performance metrics collection
  *
- * Usage: ./chronos_replay [pcap_file]
- *        Default: data/Multiple.Packets.pcap
+ * Usage: ./chronos_replay [--speed max|realtime|N]
+ *                         [--map lazy|populate|readahead|hugecopy]
+ *                         [--from HH:MM[:SS]] [--to HH:MM[:SS]]
+ *                         [--stream auto|uring|pread]
+ *                         [pcap_file | binary_itch_file]
+ *        ./chronos_replay --line-b line_b.pcap [--map ...] line_a.pcap
+ *        ./chronos_replay --listen [ADDR:]PORT [--interface IFADDR]
+ *        Default: data/Multiple.Packets.pcap, flat out
  */
 
 #include <book/order_book.hpp>
 #include <chrono>
+#include <csignal>
 #include <cinttypes>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <itch/binary_reader.hpp>
+#include <itch/line_arbitrator.hpp>
+#include <itch/mapped_file.hpp>
+#include <itch/moldudp64.hpp>
+#include <itch/net_decoder.hpp>
 #include <itch/parser.hpp>
+#include <itch/pcap_index.hpp>
 #include <itch/pcap_reader.hpp>
+#include <itch/pcap_stream_reader.hpp>
+#include <itch/replay_clock.hpp>
+#include <itch/udp_receiver.hpp>
+#include <string>
+
+#include "cli_args.hpp"
 
 namespace {
 
@@ -172,93 +194,156 @@ private:
 };
 
 // ============================================================================
-// ITCH Payload Detection (reused from main.cpp)
+// Print Usage
 // ============================================================================
 
-/// Valid ITCH message types
-bool is_valid_itch_type(char c) {
-  // Order messages
-  if (c == 'A' || c == 'F' || c == 'E' || c == 'C' || c == 'X' || c == 'D' ||
-      c == 'U')
-    return true;
-  // Trade messages
-  if (c == 'P' || c == 'Q' || c == 'B')
-    return true;
-  // System/stock messages
-  if (c == 'S' || c == 'R' || c == 'H' || c == 'Y' || c == 'L')
-    return true;
-  // Net order imbalance
-  if (c == 'I' || c == 'N')
-    return true;
-  // MWCB and IPO
-  if (c == 'V' || c == 'W' || c == 'K')
-    return true;
-  return false;
+void print_usage(const char *program) {
+  std::fprintf(stderr,
+               "Usage: %s [--speed max|realtime|N] "
+               "[--map lazy|populate|readahead|hugecopy] "
+               "[--from HH:MM[:SS]] [--to HH:MM[:SS]] "
+               "[--stream auto|uring|pread] [pcap_file | binary_itch_file]\n"
+               "       %s --line-b LINE_B_PCAP [--map ...] line_a_pcap\n"
+               "       %s --listen [ADDR:]PORT [--interface IFADDR]\n",
+               program, program, program);
+  std::fprintf(stderr, "\nChronos Market Replay Engine\n");
+  std::fprintf(stderr,
+               "Integrates ITCH parser with OrderBook matching engine.\n");
+  std::fprintf(stderr, "\nDefault PCAP: %s\n", DEFAULT_PCAP);
+  std::fprintf(stderr,
+               "\n--speed  max (default): no pacing; realtime: capture "
+               "spacing;\n         N: N times faster than captured\n");
+  std::fprintf(stderr,
+               "--map    how file pages are faulted in (default lazy)\n");
+  std::fprintf(stderr,
+               "--from/--to  replay [from, to) local time on the capture's "
+               "first day\n             (PCAP only; set TZ for the "
+               "exchange, builds <file>.idx once)\n");
+  std::fprintf(stderr,
+               "--stream read through a fixed buffer ring instead of "
+               "mapping\n         (PCAP only; for captures larger than "
+               "RAM)\n");
+  std::fprintf(stderr,
+               "--listen receive live MoldUDP64 datagrams on ADDR (joined if "
+               "multicast) until\n         Ctrl-C or end of session; "
+               "--interface picks the join's NIC\n");
+  std::fprintf(stderr,
+               "--line-b merge a second capture of the same feed (the B "
+               "line) by MoldUDP64\n         sequence; each message is "
+               "replayed once, from the line that had it first\n");
+}
+
+/**
+ * @brief Epoch ns of `seconds` after local midnight on the day of
+ *        `reference_ns`.
+ */
+uint64_t time_on_day(uint64_t reference_ns, long seconds) {
+  const auto t = static_cast<std::time_t>(reference_ns / 1'000'000'000);
+  std::tm local{};
+  localtime_r(&t, &local);
+  local.tm_hour = 0;
+  local.tm_min = 0;
+  local.tm_sec = static_cast<int>(seconds);
+  local.tm_isdst = -1; // Let mktime decide across DST changes
+  const std::time_t at = std::mktime(&local);
+  return at < 0 ? 0 : static_cast<uint64_t>(at) * 1'000'000'000;
 }
 
-/// Find ITCH payload offset within a packet
-size_t find_itch_offset(const char *data, size_t len) {
-  // Common header configurations
-  constexpr size_t OFFSETS[] = {
-      42, // Standard: Ethernet(14) + IP(20) + UDP(8)
-      46, // With VLAN tag
-      62, // Standard + MoldUDP header
-      64, // Standard + MoldUDP + length prefix
-      66, // VLAN + MoldUDP header
-      68, // VLAN + MoldUDP + length prefix
-  };
-
-  // Try each known offset
-  for (size_t offset : OFFSETS) {
-    if (offset < len) {
-      char msg_type = data[offset];
-      if (is_valid_itch_type(msg_type)) {
-        // Additional validation: check stock_locate is reasonable
-        if (len >= offset + 3) {
-          uint16_t stock_locate = static_cast<uint16_t>(
-              (static_cast<uint8_t>(data[offset + 1]) << 8) |
-              static_cast<uint8_t>(data[offset + 2]));
-          if (stock_locate > 0 && stock_locate < 10000) {
-            return offset;
-          }
-        }
-        return offset;
-      }
+/**
+ * @brief Map (building on first use) the capture's sidecar index and turn
+ *        --from/--to into a packet range; false if it cannot be indexed.
+ */
+bool seek_window(const itch::PcapReader &reader, const char *pcap_file,
+                 long from_s, long to_s, itch::PacketCursor &from,
+                 itch::PacketCursor &to) {
+  const auto start = std::chrono::steady_clock::now();
+  const std::string path = itch::PcapIndex::default_path(pcap_file);
+  itch::PcapIndex index;
+  bool built = false;
+  if (!index.open(path.c_str(), reader)) {
+    if (!itch::PcapIndex::build(reader, path.c_str()) ||
+        !index.open(path.c_str(), reader)) {
+      return false;
     }
+    built = true;
   }
 
-  // Fallback: Search first 100 bytes
-  constexpr size_t SEARCH_LIMIT = 100;
-  size_t search_end = (len < SEARCH_LIMIT) ? len : SEARCH_LIMIT;
-
-  for (size_t offset = 0; offset < search_end; ++offset) {
-    char msg_type = data[offset];
-    if (is_valid_itch_type(msg_type)) {
-      if (len >= offset + 3) {
-        uint16_t stock_locate = static_cast<uint16_t>(
-            (static_cast<uint8_t>(data[offset + 1]) << 8) |
-            static_cast<uint8_t>(data[offset + 2]));
-        if (stock_locate > 0 && stock_locate < 10000) {
-          return offset;
-        }
-      }
+  to = index.end();
+  itch::PacketCursor first = reader.first_packet();
+  itch::PacketRecord record;
+  if (reader.next_packet(first, record)) {
+    if (from_s >= 0) {
+      from = reader.seek_to_time(index, time_on_day(record.ts_ns, from_s));
+    }
+    if (to_s >= 0) {
+      to = reader.seek_to_time(index, time_on_day(record.ts_ns, to_s));
     }
   }
 
-  // Last resort: return 42
-  return 42;
+  const auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+  std::printf("  Index: %s %s (%zu entries, every %u packets)\n",
+              built ? "built" : "loaded", path.c_str(), index.entry_count(),
+              index.stride());
+  std::printf("  Window: packets %" PRIu64 " to %" PRIu64 " of %" PRIu64
+              " (seek %.3f ms)\n",
+              from.packet, to.packet, index.packet_count(),
+              static_cast<double>(us) / 1000.0);
+  return true;
 }
 
-// ============================================================================
-// Print Usage
-// ============================================================================
+/**
+ * @brief Parse a --listen value, [ADDR:]PORT; false if malformed.
+ */
+bool parse_listen(const char *arg, std::string &address, uint16_t &port) {
+  const char *colon = std::strrchr(arg, ':');
+  const char *digits = colon != nullptr ? colon + 1 : arg;
+  char *end = nullptr;
+  const unsigned long value = std::strtoul(digits, &end, 10);
+  if (end == digits || *end != '\0' || value == 0 || value > 65535) {
+    return false;
+  }
+  address = colon != nullptr ? std::string(arg, colon) : std::string();
+  port = static_cast<uint16_t>(value);
+  return true;
+}
 
-void print_usage(const char *program) {
-  std::fprintf(stderr, "Usage: %s [pcap_file]\n", program);
-  std::fprintf(stderr, "\nChronos Market Replay Engine\n");
-  std::fprintf(stderr,
-               "Integrates ITCH parser with OrderBook matching engine.\n");
-  std::fprintf(stderr, "\nDefault PCAP: %s\n", DEFAULT_PCAP);
+volatile std::sig_atomic_t g_stop = 0;
+
+void on_interrupt(int) { g_stop = 1; }
+
+/**
+ * @brief Feed live datagrams through MoldUDP64 into the book until Ctrl-C
+ *        or an end-of-session packet.
+ */
+template <typename Visitor>
+size_t receive_live(itch::UdpReceiver &rx, itch::MoldUdp64Decoder<> &mold,
+                    Visitor &visitor) {
+  std::signal(SIGINT, on_interrupt);
+  size_t packets = 0;
+  // The receive timeout bounds how long a Ctrl-C goes unnoticed
+  while (g_stop == 0 && mold.stats().end_of_session == 0) {
+    packets += rx.receive([&](const char *data, size_t len) {
+      (void)mold.decode_itch(data, len, visitor);
+    });
+  }
+  std::signal(SIGINT, SIG_DFL);
+  return packets;
+}
+
+void print_pacing(const itch::ReplayPacer &pacer, double speed) {
+  const itch::PacerStats &ps = pacer.stats();
+  std::printf("\n=== Pacing (%.2fx, TSC %.3f GHz) ===\n", speed,
+              pacer.clock().ticks_per_ns());
+  std::printf("Released: %" PRIu64 "  Waited: %" PRIu64 "\n", ps.packets,
+              ps.waited);
+  if (ps.packets > 0) {
+    std::printf("Lateness: avg %.1f ns  max %" PRIu64 " ns\n",
+                static_cast<double>(ps.total_lateness_ns) /
+                    static_cast<double>(ps.packets),
+                ps.max_lateness_ns);
+  }
 }
 
 } // anonymous namespace
@@ -269,12 +354,70 @@ void print_usage(const char *program) {
 
 int main(int argc, char *argv[]) {
   // Parse arguments
-  const char *pcap_file = (argc >= 2) ? argv[1] : DEFAULT_PCAP;
-
-  if (argc > 2 || (argc == 2 && (std::string(argv[1]) == "-h" ||
-                                 std::string(argv[1]) == "--help"))) {
+  const char *pcap_file = DEFAULT_PCAP;
+  double speed = itch::ReplayPacer::kMaxSpeed;
+  itch::MapOptions map;
+  bool have_file = false;
+  long from_s = -1; // --from/--to, seconds after midnight
+  long to_s = -1;
+  bool streaming = false; // --stream: bounded-memory reader, no mapping
+  itch::StreamOptions stream;
+  bool listening = false; // --listen: live UDP instead of a file
+  std::string listen_address;
+  itch::ReceiverOptions live;
+  live.timeout_ms = 100;
+  live.receive_buffer = 8 << 20; // Rides out bursts (capped by rmem_max)
+  const char *line_b_file = nullptr; // --line-b: A/B arbitration
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "-h" || arg == "--help") {
+      print_usage(argv[0]);
+      return 0;
+    }
+    if (arg == "--speed" && i + 1 < argc) {
+      if (!cli::parse_speed(argv[++i], speed)) {
+        print_usage(argv[0]);
+        return 1;
+      }
+    } else if (arg == "--map" && i + 1 < argc) {
+      if (!itch::parse_map_strategy(argv[++i], map.strategy)) {
+        print_usage(argv[0]);
+        return 1;
+      }
+    } else if ((arg == "--from" || arg == "--to") && i + 1 < argc) {
+      if (!cli::parse_time_of_day(argv[++i],
+                                  arg == "--from" ? from_s : to_s)) {
+        print_usage(argv[0]);
+        return 1;
+      }
+    } else if (arg == "--stream" && i + 1 < argc) {
+      if (!itch::parse_stream_backend(argv[++i], stream.backend)) {
+        print_usage(argv[0]);
+        return 1;
+      }
+      streaming = true;
+    } else if (arg == "--listen" && i + 1 < argc) {
+      if (!parse_listen(argv[++i], listen_address, live.port)) {
+        print_usage(argv[0]);
+        return 1;
+      }
+      listening = true;
+    } else if (arg == "--interface" && i + 1 < argc) {
+      live.interface = argv[++i];
+    } else if (arg == "--line-b" && i + 1 < argc) {
+      line_b_file = argv[++i];
+    } else if (!have_file && arg.rfind("--", 0) != 0) {
+      pcap_file = argv[i];
+      have_file = true;
+    } else {
+      print_usage(argv[0]);
+      return 1;
+    }
+  }
+  if (!cli::valid_time_window(from_s, to_s)) {
     print_usage(argv[0]);
-    return (argc > 2) ? 1 : 0;
+    return 1;
   }
 
   std::printf(
@@ -299,44 +442,202 @@ int main(int argc, char *argv[]) {
   std::printf("Initializing OrderBook...\n");
   book::OrderBook<POOL_CAPACITY> book(pool);
 
-  std::printf("Opening PCAP file: %s\n", pcap_file);
-  itch::PcapReader reader(pcap_file);
-
-  if (!reader.is_open()) {
-    std::fprintf(stderr, "Error: Failed to open PCAP file: %s\n", pcap_file);
+  itch::PcapReader reader;
+  itch::PcapStreamReader streamer;
+  itch::BinaryItchReader raw_reader;
+  itch::UdpReceiver receiver;
+  itch::PcapReader line_b;
+  const bool windowed = from_s >= 0 || to_s >= 0;
+  const bool arbitrating = line_b_file != nullptr;
+
+  if (arbitrating && (listening || streaming || windowed ||
+                      speed != itch::ReplayPacer::kMaxSpeed)) {
+    std::fprintf(stderr, "Error: --line-b takes no --listen, --stream, "
+                         "--from/--to or --speed\n");
     return 1;
   }
 
-  std::printf("  File size: %.2f MB\n\n",
-              reader.file_size() / (1024.0 * 1024.0));
+  if (listening) {
+    if (have_file || streaming || windowed ||
+        speed != itch::ReplayPacer::kMaxSpeed) {
+      std::fprintf(stderr, "Error: --listen takes no file, --stream, "
+                           "--from/--to or --speed\n");
+      return 1;
+    }
+    // A multicast address is joined; any other is bound
+    in_addr parsed{};
+    if (!listen_address.empty() &&
+        inet_pton(AF_INET, listen_address.c_str(), &parsed) == 1 &&
+        !IN_MULTICAST(ntohl(parsed.s_addr))) {
+      live.bind_address = listen_address.c_str();
+    } else if (!listen_address.empty()) {
+      live.group = listen_address.c_str();
+    }
+    const char *address =
+        listen_address.empty() ? "0.0.0.0" : listen_address.c_str();
+    if (!receiver.open(live)) {
+      std::fprintf(stderr, "Error: cannot listen on %s:%u\n", address,
+                   static_cast<unsigned>(live.port));
+      return 1;
+    }
+    std::printf("Listening: %s:%u (%zu datagrams per recvmmsg)\n", address,
+                static_cast<unsigned>(live.port), receiver.batch());
+    std::printf("  Stops on Ctrl-C or a MoldUDP64 end of session\n");
+  } else {
+    std::printf("Opening file: %s\n", pcap_file);
+    if (streaming) {
+      if (windowed) {
+        std::fprintf(stderr,
+                     "Error: --stream cannot seek; drop --from/--to\n");
+        return 1;
+      }
+      if (!streamer.open(pcap_file, stream)) {
+        std::fprintf(stderr, "Error: Not a PCAP file (or --stream uring "
+                             "refused): %s\n",
+                     pcap_file);
+        return 1;
+      }
+    } else if (!reader.open(pcap_file, map) &&
+               !raw_reader.open(pcap_file, map)) {
+      // Not a PCAP: maybe a raw NASDAQ binary ITCH day file
+      std::fprintf(stderr, "Error: Not a PCAP or binary ITCH file: %s\n",
+                   pcap_file);
+      return 1;
+    }
+    if (arbitrating) {
+      std::printf("Opening line B: %s\n", line_b_file);
+      if (!reader.is_open() || !line_b.open(line_b_file, map)) {
+        std::fprintf(stderr, "Error: --line-b needs two PCAP files\n");
+        return 1;
+      }
+    }
+  }
+
+  const bool binary_itch = raw_reader.is_open();
+  size_t file_size = binary_itch  ? raw_reader.file_size()
+                     : streaming ? streamer.file_size()
+                                 : reader.file_size();
+  if (arbitrating) {
+    file_size += line_b.file_size();
+  }
+
+  if (binary_itch) {
+    std::printf("  Format: binary ITCH (length-prefixed)\n");
+  } else if (streaming) {
+    if (streamer.format() == itch::CaptureFormat::PcapNg) {
+      std::printf("  Format: pcapng\n");
+    }
+  } else if (reader.format() == itch::CaptureFormat::PcapNg) {
+    std::printf("  Format: pcapng (%zu interface%s)\n",
+                reader.interface_count(),
+                reader.interface_count() == 1 ? "" : "s");
+  }
+  if (streaming) {
+    const itch::ChunkedFile &ring = streamer.stream();
+    std::printf("  File size: %.2f MB\n", file_size / (1024.0 * 1024.0));
+    std::printf("  Stream: %s, %zu x %zu KB buffers%s (%.2f MB resident)\n",
+                itch::stream_backend_name(ring.backend()),
+                ring.buffer_count(), ring.buffer_bytes() >> 10,
+                ring.direct() ? ", O_DIRECT" : "",
+                streamer.memory_bytes() / (1024.0 * 1024.0));
+  } else if (!listening) {
+    std::printf("  File size: %.2f MB\n", file_size / (1024.0 * 1024.0));
+    std::printf("  Page strategy: %s\n",
+                itch::map_strategy_name(map.strategy));
+  }
+
+  // Time window: seek through the sidecar index instead of walking
+  itch::PacketCursor window_from = reader.first_packet();
+  itch::PacketCursor window_to = reader.end_of_capture();
+  if (windowed && (binary_itch || !seek_window(reader, pcap_file, from_s,
+                                               to_s, window_from,
+                                               window_to))) {
+    std::fprintf(stderr, "Error: --from/--to need a single-section "
+                         "PCAP or pcapng file\n");
+    return 1;
+  }
+  std::printf("\n");
 
   // ============================================================================
   // Run Replay
   // ============================================================================
 
   std::printf("Starting market replay...\n");
-  std::printf("  Match trigger interval: every %luth order\n\n",
+  std::printf("  Match trigger interval: every %luth order\n",
               static_cast<unsigned long>(MATCH_TRIGGER_INTERVAL));
 
+  // Calibrate the TSC before the clock starts; flat out needs no clock
+  itch::ReplayPacer pacer(speed, speed > 0.0 ? itch::TscClock::calibrate()
+                                             : itch::TscClock{});
+  if (pacer.unpaced()) {
+    std::printf("  Pacing: none (max speed)\n\n");
+  } else {
+    std::printf("  Pacing: %.2fx capture time\n\n", speed);
+  }
+
   ReplayMetrics metrics;
   ReplayVisitor<POOL_CAPACITY> visitor(book, metrics);
   itch::Parser parser;
 
+  const itch::FaultCounts faults_before = itch::thread_faults();
   auto start_time = std::chrono::high_resolution_clock::now();
 
-  size_t packet_count =
-      reader.for_each_packet([&](const char *data, size_t len) {
-        // Find ITCH payload offset (skip network headers)
-        size_t offset = find_itch_offset(data, len);
+  // Link/IP/UDP headers decoded per the capture's link type
+  itch::UdpDecoder net(streaming ? streamer.link_type()
+                                 : reader.link_type());
+  itch::UdpDatagram udp;
+  itch::MoldUdp64Decoder<> mold;
+  itch::LineArbitrator<> arbitrator(reader, line_b);
+
+  size_t packet_count = 0;
+
+  if (arbitrating) {
+    packet_count = arbitrator.run_itch(visitor);
+  } else if (listening) {
+    // Datagrams are MoldUDP64 payloads already: no link headers to strip
+    packet_count = receive_live(receiver, mold, visitor);
+    file_size = receiver.stats().bytes;
+  } else if (binary_itch) {
+    packet_count = raw_reader.for_each_message(
+        [&](const char *msg, size_t len) {
+          // No capture time in a day file: pace on the ITCH timestamp
+          if (!pacer.unpaced() && len >= sizeof(itch::MessageHeader)) {
+            (void)pacer.wait(
+                reinterpret_cast<const itch::MessageHeader *>(msg)
+                    ->timestamp.nanoseconds());
+          }
+          (void)parser.parse(msg, len, visitor);
+        });
+  } else {
+    auto on_packet = [&](const char *data, size_t len, uint64_t ts_ns) {
+      if (!pacer.unpaced()) {
+        (void)pacer.wait(ts_ns);
+      }
+      if (!net.decode(data, len, udp)) {
+        return; // Not a UDP datagram (ARP, TCP, fragment, ...)
+      }
 
-        if (offset < len) {
-          const char *itch_data = data + offset;
-          size_t itch_len = len - offset;
-          (void)parser.parse_buffer(itch_data, itch_len, visitor);
-        }
-      });
+      // Session layer first: walk length-prefixed blocks, track sequence
+      if (itch::is_moldudp64_packet(udp.payload, udp.length)) {
+        (void)mold.decode_itch(udp.payload, udp.length, visitor);
+        return;
+      }
+
+      // Raw ITCH directly in the UDP payload
+      (void)parser.parse_buffer(udp.payload, udp.length, visitor);
+    };
+    if (streaming) {
+      packet_count = streamer.for_each_packet(on_packet);
+    } else if (windowed) {
+      packet_count =
+          reader.for_each_packet_in(window_from, window_to, on_packet);
+    } else {
+      packet_count = reader.for_each_packet(on_packet);
+    }
+  }
 
   auto end_time = std::chrono::high_resolution_clock::now();
+  const itch::FaultCounts faults = itch::thread_faults() - faults_before;
   auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
       end_time - start_time);
 
@@ -345,22 +646,68 @@ int main(int argc, char *argv[]) {
   // ============================================================================
 
   std::printf("\n=== Performance ===\n");
-  std::printf("Packets processed: %zu\n", packet_count);
+  std::printf("%s processed: %zu\n", binary_itch ? "Messages" : "Packets",
+              packet_count);
   std::printf("Total time: %.3f ms\n", duration.count() / 1000.0);
 
   if (duration.count() > 0) {
     double packets_per_sec = packet_count * 1e6 / duration.count();
     double orders_per_sec = metrics.orders_processed * 1e6 / duration.count();
     double mb_per_sec =
-        reader.file_size() / (1024.0 * 1024.0) * 1e6 / duration.count();
+        file_size / (1024.0 * 1024.0) * 1e6 / duration.count();
 
-    std::printf("Throughput: %.2f million packets/sec\n",
-                packets_per_sec / 1e6);
+    std::printf("Throughput: %.2f million %s/sec\n", packets_per_sec / 1e6,
+                binary_itch ? "messages" : "packets");
     std::printf("Order Rate: %.2f million orders/sec\n", orders_per_sec / 1e6);
     std::printf("Bandwidth: %.2f MB/sec\n", mb_per_sec);
   }
 
   metrics.print();
+  if (streaming && (streamer.failed() || streamer.oversize() > 0)) {
+    std::printf("Stream: %s, %" PRIu64 " oversize record%s skipped\n",
+                streamer.failed() ? "stopped early (I/O or framing error)"
+                                  : "complete",
+                streamer.oversize(), streamer.oversize() == 1 ? "" : "s");
+  }
+  std::printf("Page faults in replay loop: %" PRIu64 " minor, %" PRIu64
+              " major\n",
+              faults.minor, faults.major);
+
+  if (listening) {
+    const itch::ReceiverStats &rs = receiver.stats();
+    std::printf("\n=== UDP Receiver ===\n");
+    std::printf("Datagrams: %" PRIu64 "  Syscalls: %" PRIu64
+                " (%.2f datagrams each)\n",
+                rs.packets, rs.syscalls, rs.packets_per_syscall());
+    std::printf("Truncated: %" PRIu64 "  Errors: %" PRIu64 "\n",
+                rs.truncated, rs.errors);
+  }
+
+  if (!pacer.unpaced()) {
+    print_pacing(pacer, speed);
+  }
+
+  if (arbitrating) {
+    std::printf("\n=== A/B Line Arbitration ===\n");
+    for (size_t line = 0; line < itch::LineArbitrator<>::kLines; ++line) {
+      const itch::LineStats ls = arbitrator.line_stats(line);
+      std::printf("Line %c: %" PRIu64 " packets  %" PRIu64
+                  " messages first  %" PRIu64 " gaps (%" PRIu64
+                  " missed)  %" PRIu64 " not MoldUDP64\n",
+                  line == 0 ? 'A' : 'B', ls.packets, ls.wins, ls.gaps,
+                  ls.missed_messages, ls.skipped);
+    }
+  }
+
+  const itch::MoldUdp64Stats &ms =
+      arbitrating ? arbitrator.merged().stats() : mold.stats();
+  if (ms.packets > 0) {
+    std::printf("\n=== MoldUDP64 Session Layer ===\n");
+    std::printf("Messages: %" PRIu64 "  Gaps: %" PRIu64 " (%" PRIu64
+                " missed)  Duplicates: %" PRIu64 "\n",
+                ms.messages, ms.gaps, ms.missed_messages,
+                ms.duplicate_messages);
+  }
 
   // Final book state
   std::printf("\n=== Final Book State ===\n");
@@ -0,0 +1,227 @@
+/**
+ * @file binary_reader_test.cpp
+ * @brief Unit tests for the mmap'd binary ITCH day-file reader.
+ */
+
+#include <gtest/gtest.h>
+#include <itch/binary_reader.hpp>
+#include <itch/parser.hpp>
+
+#include "test_captures.hpp"
+
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace itch::test {
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief Append one length-prefixed OrderDelete with the given order_ref.
+ */
+void append_delete(std::vector<char> &file, uint64_t ref) {
+  file.push_back(0);
+  file.push_back(static_cast<char>(sizeof(OrderDelete)));
+  std::vector<char> msg(sizeof(OrderDelete), 0);
+  msg[0] = 'D';
+  for (int b = 0; b < 8; ++b) {
+    msg[11 + b] = static_cast<char>(ref >> (56 - b * 8));
+  }
+  file.insert(file.end(), msg.begin(), msg.end());
+}
+
+std::vector<char> make_file(uint64_t count) {
+  std::vector<char> file;
+  for (uint64_t ref = 1; ref <= count; ++ref) {
+    append_delete(file, ref);
+  }
+  return file;
+}
+
+struct DeleteCollector : DefaultVisitor {
+  std::vector<uint64_t> refs;
+
+  void on_order_delete(const OrderDelete &msg) {
+    refs.push_back(msg.order_ref);
+  }
+};
+
+constexpr size_t kRecord = kBinaryItchLengthPrefix + sizeof(OrderDelete);
+
+} // namespace
+
+// ============================================================================
+// Open / Validation
+// ============================================================================
+
+TEST(BinaryItchReaderTest, OpensLengthPrefixedFile) {
+  TempFile tmp(make_file(3));
+  BinaryItchReader reader(tmp.path());
+
+  ASSERT_TRUE(reader.is_open());
+  EXPECT_EQ(reader.file_size(), 3 * kRecord);
+  EXPECT_NE(reader.data(), nullptr);
+}
+
+TEST(BinaryItchReaderTest, RejectsMissingEmptyAndForeignFiles) {
+  BinaryItchReader reader;
+  EXPECT_FALSE(reader.open("/nonexistent/file.NASDAQ_ITCH50"));
+
+  TempFile empty(std::vector<char>{});
+  EXPECT_FALSE(reader.open(empty.path()));
+
+  // PCAP magic: no known type byte with a matching length prefix
+  TempFile pcap(std::vector<char>{'\xd4', '\xc3', '\xb2', '\xa1', 2, 0, 4, 0});
+  EXPECT_FALSE(reader.open(pcap.path()));
+  EXPECT_FALSE(reader.is_open());
+}
+
+TEST(BinaryItchReaderTest, MoveTransfersMapping) {
+  TempFile tmp(make_file(2));
+  BinaryItchReader a(tmp.path());
+  ASSERT_TRUE(a.is_open());
+
+  BinaryItchReader b(std::move(a));
+  EXPECT_FALSE(a.is_open());
+  EXPECT_TRUE(b.is_open());
+  EXPECT_EQ(b.for_each_message([](const char *, size_t) {}), 2u);
+}
+
+TEST(BinaryItchReaderTest, RejectsForeignFileUnderEveryStrategy) {
+  TempFile pcap(std::vector<char>{'\xd4', '\xc3', '\xb2', '\xa1', 2, 0, 4, 0});
+  for (MapStrategy strategy : {MapStrategy::Populate, MapStrategy::ReadAhead,
+                               MapStrategy::HugeCopy}) {
+    BinaryItchReader reader;
+    EXPECT_FALSE(reader.open(pcap.path(), {strategy}));
+  }
+}
+
+// ============================================================================
+// Message Iteration
+// ============================================================================
+
+TEST(BinaryItchReaderTest, ForEachMessageFeedsParserZeroCopy) {
+  TempFile tmp(make_file(5));
+  BinaryItchReader reader(tmp.path());
+  ASSERT_TRUE(reader.is_open());
+
+  Parser parser;
+  DeleteCollector collector;
+  const char *first = nullptr;
+
+  size_t count = reader.for_each_message([&](const char *msg, size_t len) {
+    if (first == nullptr) {
+      first = msg;
+    }
+    EXPECT_EQ(len, sizeof(OrderDelete));
+    EXPECT_EQ(parser.parse(msg, len, collector), ParseResult::Ok);
+  });
+
+  EXPECT_EQ(count, 5u);
+  EXPECT_EQ(collector.refs, (std::vector<uint64_t>{1, 2, 3, 4, 5}));
+  // Pointers reference the mapping directly, past the length prefix
+  EXPECT_EQ(first, reader.data() + kBinaryItchLengthPrefix);
+}
+
+TEST(BinaryItchReaderTest, StopsBeforeTruncatedTrailingRecord) {
+  std::vector<char> file = make_file(4);
+  file.resize(file.size() - 5);
+  TempFile tmp(file);
+  BinaryItchReader reader(tmp.path());
+  ASSERT_TRUE(reader.is_open());
+
+  EXPECT_EQ(reader.for_each_message([](const char *, size_t) {}), 3u);
+  EXPECT_EQ(reader.for_each_chunk(1 << 20, [](const char *, size_t len) {
+    EXPECT_EQ(len, 3 * kRecord);
+  }),
+            1u);
+}
+
+TEST(BinaryItchReaderTest, EveryMapStrategyDeliversSameMessages) {
+  TempFile tmp(make_file(50));
+  for (MapStrategy strategy : {MapStrategy::Lazy, MapStrategy::Populate,
+                               MapStrategy::ReadAhead, MapStrategy::HugeCopy}) {
+    BinaryItchReader reader(tmp.path(), {strategy});
+    ASSERT_TRUE(reader.is_open());
+    EXPECT_EQ(reader.mapping().strategy(), strategy);
+
+    Parser parser;
+    DeleteCollector collector;
+    EXPECT_EQ(reader.for_each_message([&](const char *msg, size_t len) {
+      (void)parser.parse(msg, len, collector);
+    }),
+              50u);
+    ASSERT_EQ(collector.refs.size(), 50u);
+    EXPECT_EQ(collector.refs.back(), 50u);
+  }
+}
+
+// ============================================================================
+// Chunked Iteration
+// ============================================================================
+
+TEST(BinaryItchReaderTest, ChunksAreRecordAlignedAndCoverFile) {
+  TempFile tmp(make_file(10));
+  BinaryItchReader reader(tmp.path());
+  ASSERT_TRUE(reader.is_open());
+
+  // Room for 3 records (and a bit) per chunk: 3 + 3 + 3 + 1
+  std::vector<size_t> sizes;
+  DeleteCollector collector;
+  Parser parser;
+  const char *expected = reader.data();
+
+  size_t chunks =
+      reader.for_each_chunk(3 * kRecord + 7, [&](const char *chunk,
+                                                 size_t len) {
+        EXPECT_EQ(chunk, expected);
+        expected = chunk + len;
+        sizes.push_back(len);
+        EXPECT_EQ(for_each_length_prefixed(chunk, len,
+                                           [&](const char *msg, size_t n) {
+                                             (void)parser.parse(msg, n,
+                                                                collector);
+                                           }),
+                  len);
+      });
+
+  EXPECT_EQ(chunks, 4u);
+  EXPECT_EQ(sizes, (std::vector<size_t>{3 * kRecord, 3 * kRecord,
+                                        3 * kRecord, kRecord}));
+  EXPECT_EQ(collector.refs.size(), 10u);
+  EXPECT_EQ(collector.refs.back(), 10u);
+}
+
+TEST(BinaryItchReaderTest, ChunkSmallerThanRecordStillProgresses) {
+  TempFile tmp(make_file(3));
+  BinaryItchReader reader(tmp.path());
+  ASSERT_TRUE(reader.is_open());
+
+  EXPECT_EQ(reader.for_each_chunk(1, [](const char *, size_t len) {
+    EXPECT_EQ(len, kRecord);
+  }),
+            3u);
+}
+
+TEST(BinaryItchReaderTest, ChunkCallbackCanStopEarly) {
+  TempFile tmp(make_file(10));
+  BinaryItchReader reader(tmp.path());
+  ASSERT_TRUE(reader.is_open());
+
+  size_t seen = 0;
+  size_t chunks = reader.for_each_chunk(2 * kRecord, [&](const char *,
+                                                         size_t) {
+    return ++seen < 2;
+  });
+
+  EXPECT_EQ(chunks, 2u);
+  EXPECT_EQ(seen, 2u);
+}
+
+} // namespace itch::test
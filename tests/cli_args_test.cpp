@@ -0,0 +1,89 @@
+/**
+ * @file cli_args_test.cpp
+ * @brief Unit tests for the option-value parsers shared by the drivers.
+ */
+
+#include <gtest/gtest.h>
+
+#include "cli_args.hpp"
+
+// ============================================================================
+// Counts (--threads, --batch, --rate, --loop)
+// ============================================================================
+
+TEST(CliArgsTest, ParsesCounts) {
+  uint64_t value = 0;
+  EXPECT_TRUE(cli::parse_count("4", value));
+  EXPECT_EQ(value, 4u);
+  EXPECT_TRUE(cli::parse_count("1000000", value));
+  EXPECT_EQ(value, 1000000u);
+}
+
+TEST(CliArgsTest, RejectsMalformedCounts) {
+  uint64_t value = 0;
+  EXPECT_FALSE(cli::parse_count("", value));
+  EXPECT_FALSE(cli::parse_count("0", value));
+  EXPECT_FALSE(cli::parse_count("4abc", value));
+  EXPECT_FALSE(cli::parse_count("-1", value));
+  EXPECT_FALSE(cli::parse_count("+4", value));
+  EXPECT_FALSE(cli::parse_count(" 4", value));
+  EXPECT_FALSE(cli::parse_count("many", value));
+}
+
+// ============================================================================
+// --speed
+// ============================================================================
+
+TEST(CliArgsTest, ParsesSpeedKeywordsAndFactors) {
+  double speed = 0.0;
+  EXPECT_TRUE(cli::parse_speed("max", speed));
+  EXPECT_EQ(speed, itch::ReplayPacer::kMaxSpeed);
+  EXPECT_TRUE(cli::parse_speed("realtime", speed));
+  EXPECT_EQ(speed, 1.0);
+  EXPECT_TRUE(cli::parse_speed("2.5", speed));
+  EXPECT_EQ(speed, 2.5);
+}
+
+TEST(CliArgsTest, RejectsMalformedSpeeds) {
+  double speed = 0.0;
+  EXPECT_FALSE(cli::parse_speed("", speed));
+  EXPECT_FALSE(cli::parse_speed("0", speed));
+  EXPECT_FALSE(cli::parse_speed("-1", speed));
+  EXPECT_FALSE(cli::parse_speed("2x", speed));
+  EXPECT_FALSE(cli::parse_speed("fast", speed));
+}
+
+// ============================================================================
+// --from / --to
+// ============================================================================
+
+TEST(CliArgsTest, ParsesTimeOfDay) {
+  long seconds = -1;
+  EXPECT_TRUE(cli::parse_time_of_day("09:30", seconds));
+  EXPECT_EQ(seconds, 9 * 3600 + 30 * 60);
+  EXPECT_TRUE(cli::parse_time_of_day("09:30:15", seconds));
+  EXPECT_EQ(seconds, 9 * 3600 + 30 * 60 + 15);
+  EXPECT_TRUE(cli::parse_time_of_day("23:59:59", seconds));
+  EXPECT_EQ(seconds, 86399);
+}
+
+TEST(CliArgsTest, RejectsTrailingInputAndOutOfRangeFields) {
+  long seconds = -1;
+  EXPECT_FALSE(cli::parse_time_of_day("09:30x", seconds));
+  EXPECT_FALSE(cli::parse_time_of_day("09:30:", seconds));
+  EXPECT_FALSE(cli::parse_time_of_day("09:30:15pm", seconds));
+  EXPECT_FALSE(cli::parse_time_of_day("09:30:15:00", seconds));
+  EXPECT_FALSE(cli::parse_time_of_day("24:00", seconds));
+  EXPECT_FALSE(cli::parse_time_of_day("09:60", seconds));
+  EXPECT_FALSE(cli::parse_time_of_day("0930", seconds));
+  EXPECT_EQ(seconds, -1);
+}
+
+TEST(CliArgsTest, RejectsWindowsEndingBeforeTheyStart) {
+  EXPECT_TRUE(cli::valid_time_window(-1, -1));
+  EXPECT_TRUE(cli::valid_time_window(34200, -1));
+  EXPECT_TRUE(cli::valid_time_window(-1, 34200));
+  EXPECT_TRUE(cli::valid_time_window(34200, 34200));
+  EXPECT_TRUE(cli::valid_time_window(34200, 57600));
+  EXPECT_FALSE(cli::valid_time_window(57600, 34200));
+}
@@ -0,0 +1,239 @@
+/**
+ * @file line_arbitrator_test.cpp
+ * @brief Unit tests for A/B line arbitration over two captures.
+ */
+
+#include <gtest/gtest.h>
+#include <itch/line_arbitrator.hpp>
+#include <itch/pcap_writer.hpp>
+
+#include "test_captures.hpp"
+#include "test_moldudp64.hpp"
+
+#include <string>
+#include <vector>
+
+namespace itch::test {
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace {
+
+constexpr uint64_t kDay = 1'700'000'000ULL * 1'000'000'000;
+
+/**
+ * @brief One packet of a line: first sequence, message count, capture time.
+ */
+struct Pkt {
+  uint64_t sequence;
+  uint16_t count;
+  uint64_t ts_ns;
+  const char *session = kTestSession;
+};
+
+/**
+ * @brief Raw IPv4 + UDP frame around `payload`.
+ */
+std::string ipv4_udp(const std::string &payload) {
+  const size_t udp_len = 8 + payload.size();
+  const size_t ip_len = 20 + udp_len;
+  std::string frame(28, '\0');
+  frame[0] = 0x45;
+  frame[2] = static_cast<char>(ip_len >> 8);
+  frame[3] = static_cast<char>(ip_len);
+  frame[8] = 64;
+  frame[9] = 17; // UDP
+  frame[20] = 0x67; // Source port 26400
+  frame[21] = 0x20;
+  frame[22] = 0x67;
+  frame[23] = 0x20;
+  frame[24] = static_cast<char>(udp_len >> 8);
+  frame[25] = static_cast<char>(udp_len);
+  return frame + payload;
+}
+
+/**
+ * @brief Capture of one line, written with PcapWriter.
+ */
+class LineCapture {
+public:
+  explicit LineCapture(const std::vector<Pkt> &packets,
+                       bool with_noise = false) {
+    for (const Pkt &p : packets) {
+      frames_.push_back(
+          ipv4_udp(delete_packet(p.sequence, p.count, p.session)));
+    }
+    PcapWriter out;
+    (void)out.open(file_.path(), LinkType::Raw);
+    const std::string noise(40, '\x60'); // IPv6 nibble, no UDP header
+    for (size_t i = 0; i < packets.size(); ++i) {
+      if (with_noise) {
+        out.write_packet(packets[i].ts_ns, noise.data(), noise.size());
+      }
+      out.write_packet(packets[i].ts_ns, frames_[i].data(),
+                       frames_[i].size());
+    }
+    (void)out.close();
+    reader_.open(file_.path());
+  }
+
+  LineCapture(const LineCapture &) = delete;
+  LineCapture &operator=(const LineCapture &) = delete;
+
+  [[nodiscard]] const PcapReader &reader() const { return reader_; }
+
+private:
+  TempFile file_;
+  std::vector<std::string> frames_;
+  PcapReader reader_;
+};
+
+std::vector<uint64_t> iota(uint64_t first, uint64_t last) {
+  std::vector<uint64_t> out;
+  for (uint64_t v = first; v <= last; ++v) {
+    out.push_back(v);
+  }
+  return out;
+}
+
+} // namespace
+
+// ============================================================================
+// Merging
+// ============================================================================
+
+TEST(LineArbitratorTest, IdenticalLinesDeliverEachMessageOnce) {
+  const std::vector<Pkt> feed = {{1, 3, kDay + 100}, {4, 3, kDay + 200}};
+  std::vector<Pkt> late = feed;
+  for (Pkt &p : late) {
+    p.ts_ns += 5; // Line B is 5 ns behind
+  }
+  LineCapture a(feed);
+  LineCapture b(late);
+  LineArbitrator<> arb(a.reader(), b.reader());
+  DeleteRefs visitor;
+  EXPECT_EQ(arb.run_itch(visitor), 4u);
+
+  EXPECT_EQ(visitor.refs, iota(1, 6));
+  EXPECT_EQ(arb.line_stats(0).wins, 6u);
+  EXPECT_EQ(arb.line_stats(1).wins, 0u);
+  EXPECT_EQ(arb.merged().stats().duplicate_messages, 6u);
+  EXPECT_EQ(arb.merged().stats().gaps, 0u);
+}
+
+TEST(LineArbitratorTest, FirstCapturedCopyWins) {
+  LineCapture a({{1, 2, kDay + 50}, {3, 2, kDay + 50}});
+  LineCapture b({{1, 2, kDay + 10}, {3, 2, kDay + 90}});
+  LineArbitrator<> arb(a.reader(), b.reader());
+  DeleteRefs visitor;
+  (void)arb.run_itch(visitor);
+  EXPECT_EQ(visitor.refs, iota(1, 4));
+  EXPECT_EQ(arb.line_stats(0).wins, 2u);
+  EXPECT_EQ(arb.line_stats(1).wins, 2u);
+}
+
+TEST(LineArbitratorTest, FillsEachLinesDropsFromTheOther) {
+  // A drops 4-6, B drops 10-12; together they cover 1-15
+  LineCapture a({{1, 3, kDay + 1},
+                 {7, 3, kDay + 3},
+                 {10, 3, kDay + 4},
+                 {13, 3, kDay + 5}});
+  LineCapture b({{1, 3, kDay + 2},
+                 {4, 3, kDay + 2},
+                 {7, 3, kDay + 4},
+                 {13, 3, kDay + 6}});
+  LineArbitrator<> arb(a.reader(), b.reader());
+  DeleteRefs visitor;
+  (void)arb.run_itch(visitor);
+
+  EXPECT_EQ(visitor.refs, iota(1, 15));
+  EXPECT_EQ(arb.merged().stats().gaps, 0u);
+  const LineStats sa = arb.line_stats(0);
+  const LineStats sb = arb.line_stats(1);
+  EXPECT_EQ(sa.gaps, 1u);
+  EXPECT_EQ(sa.missed_messages, 3u);
+  EXPECT_EQ(sb.gaps, 1u);
+  EXPECT_EQ(sb.missed_messages, 3u);
+  EXPECT_EQ(sa.wins + sb.wins, 15u);
+  EXPECT_EQ(sb.wins, 3u); // Only 4-6; ties at 7 go to the earlier A copy
+}
+
+TEST(LineArbitratorTest, SequenceOrderBeatsSkewedClocks) {
+  // B's capture host runs a full second ahead: it must still fill A's gap
+  LineCapture a({{1, 2, kDay + 10}, {5, 2, kDay + 30}});
+  LineCapture b({{1, 2, kDay + 1'000'000'010},
+                 {3, 2, kDay + 1'000'000'020},
+                 {5, 2, kDay + 1'000'000'030}});
+  LineArbitrator<> arb(a.reader(), b.reader());
+  DeleteRefs visitor;
+  (void)arb.run_itch(visitor);
+  EXPECT_EQ(visitor.refs, iota(1, 6));
+  EXPECT_EQ(arb.line_stats(1).wins, 2u);
+}
+
+TEST(LineArbitratorTest, DeliversTheNewTailOfDifferentlyFramedPackets) {
+  LineCapture a({{1, 5, kDay + 10}, {9, 2, kDay + 40}});
+  LineCapture b({{1, 3, kDay + 20}, {4, 5, kDay + 30}});
+  LineArbitrator<> arb(a.reader(), b.reader());
+  DeleteRefs visitor;
+  (void)arb.run_itch(visitor);
+  EXPECT_EQ(visitor.refs, iota(1, 10));
+  EXPECT_EQ(arb.line_stats(0).wins, 7u);
+  EXPECT_EQ(arb.line_stats(1).wins, 3u); // 6-8 from B's second packet
+}
+
+TEST(LineArbitratorTest, ReportsLossesOnBothLinesAsMergedGaps) {
+  LineCapture a({{1, 2, kDay + 1}, {5, 2, kDay + 3}});
+  LineCapture b({{1, 2, kDay + 2}, {5, 2, kDay + 4}});
+  LineArbitrator<> arb(a.reader(), b.reader());
+  DeleteRefs visitor;
+  (void)arb.run_itch(visitor);
+  EXPECT_EQ(visitor.refs, (std::vector<uint64_t>{1, 2, 5, 6}));
+  EXPECT_EQ(arb.merged().stats().gaps, 1u);
+  EXPECT_EQ(arb.merged().stats().missed_messages, 2u);
+}
+
+// ============================================================================
+// Edges
+// ============================================================================
+
+TEST(LineArbitratorTest, OneEmptyLineReplaysTheOther) {
+  LineCapture a({{1, 2, kDay + 1}, {3, 2, kDay + 2}});
+  LineCapture b({});
+  LineArbitrator<> arb(a.reader(), b.reader());
+  DeleteRefs visitor;
+  EXPECT_EQ(arb.run_itch(visitor), 2u);
+  EXPECT_EQ(visitor.refs, iota(1, 4));
+  EXPECT_EQ(arb.line_stats(1).packets, 0u);
+}
+
+TEST(LineArbitratorTest, SkipsPacketsThatAreNotMoldUdp64) {
+  LineCapture a({{1, 2, kDay + 1}, {3, 2, kDay + 3}}, true);
+  LineCapture b({{1, 2, kDay + 2}, {3, 2, kDay + 4}});
+  LineArbitrator<> arb(a.reader(), b.reader());
+  DeleteRefs visitor;
+  (void)arb.run_itch(visitor);
+  EXPECT_EQ(visitor.refs, iota(1, 4));
+  EXPECT_EQ(arb.line_stats(0).skipped, 2u);
+  EXPECT_EQ(arb.line_stats(0).packets, 2u);
+}
+
+TEST(LineArbitratorTest, RawHandlerSeesBlocks) {
+  LineCapture a({{1, 2, kDay + 1}});
+  LineCapture b({{1, 2, kDay + 2}, {3, 1, kDay + 3}});
+  LineArbitrator<> arb(a.reader(), b.reader());
+  struct Blocks {
+    size_t count = 0;
+    void on_message(const char *data, size_t len) {
+      EXPECT_EQ(data[0], 'D');
+      EXPECT_EQ(len, sizeof(OrderDelete));
+      ++count;
+    }
+  } blocks;
+  (void)arb.run(blocks);
+  EXPECT_EQ(blocks.count, 3u);
+}
+
+} // namespace itch::test
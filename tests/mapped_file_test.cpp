@@ -0,0 +1,177 @@
+/**
+ * @file mapped_file_test.cpp
+ * @brief Unit tests for MappedFile page-fault strategies.
+ */
+
+#include <gtest/gtest.h>
+#include <itch/mapped_file.hpp>
+
+#include "test_captures.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace itch::test {
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace {
+
+constexpr size_t kFileSize = size_t{8} << 20; // 2048 pages
+
+/**
+ * @brief kFileSize patterned bytes, the contents of every test file.
+ */
+const std::vector<char> &patterned() {
+  static const std::vector<char> bytes = [] {
+    std::vector<char> out(kFileSize);
+    for (size_t i = 0; i < out.size(); ++i) {
+      out[i] = static_cast<char>(i * 131 + (i >> 12));
+    }
+    return out;
+  }();
+  return bytes;
+}
+
+/**
+ * @brief Read one byte per page; return the faults this thread took.
+ */
+FaultCounts touch_all(const MappedFile &file) {
+  const FaultCounts before = thread_faults();
+  uint8_t sink = 0;
+  for (size_t off = 0; off < file.size(); off += 4096) {
+    sink ^= static_cast<uint8_t>(
+        *static_cast<const volatile char *>(file.data() + off));
+  }
+  (void)sink;
+  return thread_faults() - before;
+}
+
+bool wait_prefetched(const MappedFile &file) {
+  for (int i = 0; i < 2000 && file.prefetched() < file.size(); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return file.prefetched() == file.size();
+}
+
+} // namespace
+
+// ============================================================================
+// Contents
+// ============================================================================
+
+TEST(MappedFileTest, EveryStrategyMapsTheSameBytes) {
+  TempFile tmp(patterned());
+  for (MapStrategy strategy :
+       {MapStrategy::Lazy, MapStrategy::Populate, MapStrategy::ReadAhead,
+        MapStrategy::HugeCopy}) {
+    MappedFile file;
+    ASSERT_TRUE(file.open(tmp.path(), {strategy, size_t{1} << 20}));
+    EXPECT_EQ(file.strategy(), strategy);
+    ASSERT_EQ(file.size(), kFileSize);
+    EXPECT_EQ(std::memcmp(file.data(), patterned().data(), kFileSize), 0)
+        << static_cast<int>(strategy);
+  }
+}
+
+TEST(MappedFileTest, RejectsMissingAndEmptyFiles) {
+  MappedFile file;
+  EXPECT_FALSE(file.open("/nonexistent/capture.pcap"));
+
+  TempFile empty(std::vector<char>{});
+  EXPECT_FALSE(file.open(empty.path(), {MapStrategy::HugeCopy}));
+  EXPECT_FALSE(file.is_open());
+}
+
+TEST(MappedFileTest, ParsesStrategyNames) {
+  MapStrategy strategy = MapStrategy::Lazy;
+  EXPECT_TRUE(parse_map_strategy("readahead", strategy));
+  EXPECT_EQ(strategy, MapStrategy::ReadAhead);
+  EXPECT_TRUE(parse_map_strategy("hugecopy", strategy));
+  EXPECT_EQ(strategy, MapStrategy::HugeCopy);
+  EXPECT_FALSE(parse_map_strategy("eager", strategy));
+}
+
+// ============================================================================
+// Fault Behaviour
+// ============================================================================
+
+TEST(MappedFileTest, LazyMappingFaultsOnFirstTouch) {
+  TempFile tmp(patterned());
+  MappedFile file;
+  ASSERT_TRUE(file.open(tmp.path()));
+
+  // How many depends on fault-around and folio sizes, but never none
+  const FaultCounts faults = touch_all(file);
+  EXPECT_GT(faults.minor + faults.major, 0u);
+}
+
+TEST(MappedFileTest, PopulateAndHugeCopyFaultDuringOpen) {
+  TempFile tmp(patterned());
+  for (MapStrategy strategy : {MapStrategy::Populate, MapStrategy::HugeCopy}) {
+    MappedFile file;
+    ASSERT_TRUE(file.open(tmp.path(), {strategy}));
+    const FaultCounts faults = touch_all(file);
+    EXPECT_LT(faults.minor, 8u) << static_cast<int>(strategy);
+    EXPECT_EQ(faults.major, 0u);
+  }
+}
+
+TEST(MappedFileTest, ReadAheadThreadTakesTheFaults) {
+  TempFile tmp(patterned());
+  MappedFile file;
+  // Window larger than the file: the thread runs to the end on its own
+  ASSERT_TRUE(file.open(tmp.path(), {MapStrategy::ReadAhead, kFileSize}));
+  ASSERT_TRUE(wait_prefetched(file));
+
+  EXPECT_LT(touch_all(file).minor, 8u);
+}
+
+TEST(MappedFileTest, ReadAheadStaysWithinWindowOfConsumer) {
+  TempFile tmp(patterned());
+  MappedFile file;
+  const size_t window = MappedFile::kReadAheadStep;
+  ASSERT_TRUE(file.open(tmp.path(), {MapStrategy::ReadAhead, window}));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(file.prefetched(), window); // Waiting for the consumer
+
+  file.consumed(kFileSize - window);
+  EXPECT_TRUE(wait_prefetched(file));
+}
+
+TEST(MappedFileTest, ReadAheadAdvisesWhenConsumerIsMidPage) {
+  TempFile tmp(patterned());
+  MappedFile file;
+  ASSERT_TRUE(file.open(tmp.path(), {MapStrategy::ReadAhead, 1 << 20}));
+
+  // Readers report message boundaries, never page multiples
+  for (size_t offset = 13; offset < kFileSize; offset += 300'007) {
+    file.consumed(offset);
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+  file.consumed(kFileSize);
+  ASSERT_TRUE(wait_prefetched(file));
+  EXPECT_EQ(file.read_ahead_errors(), 0u);
+}
+
+TEST(MappedFileTest, MoveKeepsReadAheadRunning) {
+  TempFile tmp(patterned());
+  MappedFile a;
+  ASSERT_TRUE(a.open(tmp.path(), {MapStrategy::ReadAhead, 1 << 20}));
+
+  MappedFile b(std::move(a));
+  EXPECT_FALSE(a.is_open());
+  ASSERT_TRUE(b.is_open());
+  b.consumed(kFileSize);
+  EXPECT_TRUE(wait_prefetched(b));
+  EXPECT_EQ(std::memcmp(b.data(), patterned().data(), kFileSize), 0);
+}
+
+} // namespace itch::test
@@ -299,6 +299,149 @@ TEST_F(MatchingTest, VolumeTracking_AfterCancel) {
   EXPECT_EQ(book_.best_bid_volume(), 200);
 }
 
+// ============================================================================
+// Scenario 5: Level Storage and O(1) Cancel
+// ============================================================================
+
+TEST_F(MatchingTest, RestingOrderPointsAtItsLevel) {
+  ASSERT_TRUE(book_.add_order(1, 1000000, 100, Side::Buy));
+  ASSERT_TRUE(book_.add_order(2, 1000000, 50, Side::Buy));
+  ASSERT_EQ(book_.bids().size(), 1u);
+  const PriceLevel *level = book_.bids().front();
+  EXPECT_EQ(level->price, 1000000u);
+  EXPECT_EQ(level->total_volume, 150u);
+  EXPECT_EQ(level->orders.front().level, level);
+  EXPECT_EQ(level->orders.back().level, level);
+}
+
+TEST_F(MatchingTest, CancelDeepLevel_KeepsLevelForReuse) {
+  ASSERT_TRUE(book_.add_order(1, 1000000, 100, Side::Buy));
+  ASSERT_TRUE(book_.add_order(2, 990000, 100, Side::Buy));
+  ASSERT_TRUE(book_.add_order(3, 980000, 100, Side::Buy));
+  const PriceLevel *middle = book_.bids()[1];
+
+  ASSERT_TRUE(book_.cancel_order(2));
+  EXPECT_EQ(book_.bid_level_count(), 2u);
+  EXPECT_EQ(book_.best_bid().value(), 1000000u);
+
+  // The next order at that price lands on the same level
+  ASSERT_TRUE(book_.add_order(4, 990000, 70, Side::Buy));
+  EXPECT_EQ(book_.bid_level_count(), 3u);
+  EXPECT_EQ(book_.bids()[1], middle);
+  EXPECT_EQ(middle->total_volume, 70u);
+}
+
+TEST_F(MatchingTest, CancelBest_SkipsEmptiedLevelsBehindIt) {
+  ASSERT_TRUE(book_.add_order(1, 1010000, 100, Side::Sell));
+  ASSERT_TRUE(book_.add_order(2, 1020000, 100, Side::Sell));
+  ASSERT_TRUE(book_.add_order(3, 1030000, 100, Side::Sell));
+  ASSERT_TRUE(book_.cancel_order(2)); // Empty, left in place
+  ASSERT_TRUE(book_.cancel_order(1)); // Best: releases both
+
+  EXPECT_EQ(book_.asks().size(), 1u);
+  EXPECT_EQ(book_.ask_level_count(), 1u);
+  EXPECT_EQ(book_.best_ask().value(), 1030000u);
+  EXPECT_EQ(book_.best_ask_volume(), 100u);
+}
+
+TEST_F(MatchingTest, SweepReleasesEmptiedLevels) {
+  ASSERT_TRUE(book_.add_order(1, 1010000, 100, Side::Sell));
+  ASSERT_TRUE(book_.add_order(2, 1020000, 100, Side::Sell));
+  ASSERT_TRUE(book_.add_order(3, 1030000, 100, Side::Sell));
+  ASSERT_TRUE(book_.add_order(4, 1040000, 100, Side::Sell));
+  ASSERT_TRUE(book_.cancel_order(3));
+
+  // Sweep through 101-102; the emptied 103 goes with them
+  ASSERT_TRUE(book_.add_order(5, 1035000, 200, Side::Buy));
+  EXPECT_EQ(book_.best_ask().value(), 1040000u);
+  EXPECT_EQ(book_.asks().size(), 1u);
+  EXPECT_TRUE(book_.bids().empty());
+}
+
+TEST_F(MatchingTest, SidesKeepTheBestPriceLast) {
+  // Inserted out of order: new best, deep level, between, at the touch
+  ASSERT_TRUE(book_.add_order(1, 1000000, 10, Side::Buy));
+  ASSERT_TRUE(book_.add_order(2, 1010000, 10, Side::Buy));
+  ASSERT_TRUE(book_.add_order(3, 980000, 10, Side::Buy));
+  ASSERT_TRUE(book_.add_order(4, 990000, 10, Side::Buy));
+  ASSERT_TRUE(book_.add_order(5, 1010000, 5, Side::Buy));
+  ASSERT_TRUE(book_.add_order(6, 1030000, 10, Side::Sell));
+  ASSERT_TRUE(book_.add_order(7, 1020000, 10, Side::Sell));
+  ASSERT_TRUE(book_.add_order(8, 1040000, 10, Side::Sell));
+
+  const std::vector<uint64_t> bids = {980000, 990000, 1000000, 1010000};
+  const std::vector<uint64_t> asks = {1040000, 1030000, 1020000};
+  ASSERT_EQ(book_.bids().size(), bids.size());
+  ASSERT_EQ(book_.asks().size(), asks.size());
+  for (std::size_t i = 0; i < bids.size(); ++i) {
+    EXPECT_EQ(book_.bids()[i]->price, bids[i]);
+  }
+  for (std::size_t i = 0; i < asks.size(); ++i) {
+    EXPECT_EQ(book_.asks()[i]->price, asks[i]);
+  }
+  EXPECT_EQ(book_.bids().back()->total_volume, 15u);
+  EXPECT_EQ(book_.best_bid().value(), 1010000u);
+  EXPECT_EQ(book_.best_ask().value(), 1020000u);
+}
+
+TEST_F(MatchingTest, NewBestOverEmptiedLevels_KeepsThemBelow) {
+  ASSERT_TRUE(book_.add_order(1, 1000000, 10, Side::Buy));
+  ASSERT_TRUE(book_.add_order(2, 990000, 10, Side::Buy));
+  ASSERT_TRUE(book_.cancel_order(2)); // Empty, left in place
+
+  // A sell at the touch consumes it, releasing both levels
+  ASSERT_TRUE(book_.add_order(3, 1000000, 10, Side::Sell));
+  EXPECT_TRUE(book_.bids().empty());
+
+  // Rebuild: the emptied level below a new best is reused in place
+  ASSERT_TRUE(book_.add_order(4, 990000, 10, Side::Buy));
+  ASSERT_TRUE(book_.add_order(5, 1000000, 10, Side::Buy));
+  ASSERT_TRUE(book_.cancel_order(4));
+  ASSERT_TRUE(book_.add_order(6, 1010000, 10, Side::Buy));
+  EXPECT_EQ(book_.bids().size(), 3u);
+  EXPECT_EQ(book_.bid_level_count(), 2u);
+  ASSERT_TRUE(book_.add_order(7, 990000, 20, Side::Buy));
+  EXPECT_EQ(book_.bids().front()->total_volume, 20u);
+  EXPECT_EQ(book_.best_bid_volume(), 10u);
+}
+
+TEST_F(MatchingTest, ManyDeepCancels_CompactTheSide) {
+  // One order per level, 300 levels deep
+  for (uint64_t i = 0; i < 300; ++i) {
+    ASSERT_TRUE(book_.add_order(i + 1, 1000000 - i * 100, 10, Side::Buy));
+  }
+  // Empty every level but the best: the side is compacted along the way
+  for (uint64_t i = 1; i < 300; ++i) {
+    ASSERT_TRUE(book_.cancel_order(i + 1));
+  }
+  EXPECT_EQ(book_.bid_level_count(), 1u);
+  EXPECT_LT(book_.bids().size(), 300u);
+  EXPECT_EQ(book_.best_bid().value(), 1000000u);
+  ASSERT_TRUE(book_.cancel_order(1));
+  EXPECT_TRUE(book_.empty());
+  EXPECT_EQ(pool_.allocated(), 0u);
+}
+
+TEST(LevelPoolTest, ExhaustionRejectsOrderAndRecyclesEmptiedLevels) {
+  MemPool<Order, 16> pool;
+  OrderBook<16, OrderMap<Order, 16>, 3> book(pool);
+  ASSERT_TRUE(book.add_order(1, 1000, 10, Side::Buy));
+  ASSERT_TRUE(book.add_order(2, 990, 10, Side::Buy));
+  ASSERT_TRUE(book.add_order(3, 980, 10, Side::Buy));
+
+  // A fourth price needs a fourth level: refused, nothing leaks
+  EXPECT_FALSE(book.add_order(4, 970, 10, Side::Buy));
+  EXPECT_EQ(book.order_count(), 3u);
+  EXPECT_EQ(pool.allocated(), 3u);
+  EXPECT_TRUE(book.add_order(4, 990, 10, Side::Buy)); // Existing level
+
+  // An emptied deep level is reclaimed when the pool runs out
+  ASSERT_TRUE(book.cancel_order(3));
+  EXPECT_TRUE(book.add_order(5, 1010, 10, Side::Sell));
+  EXPECT_EQ(book.ask_level_count(), 1u);
+  EXPECT_EQ(book.bid_level_count(), 2u);
+}
+
 // ============================================================================
 // Main (if needed for standalone execution)
 // ============================================================================
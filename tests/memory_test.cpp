@@ -284,9 +284,9 @@ TEST_F(MemPoolTest, AllocateDeallocateCycle) {
 TEST(OrderTest, PackedSize) {
   // Verify packed size is as expected
   // IntrusiveNode contributes 16 bytes (2 pointers on 64-bit)
-  // Order fields contribute 21 bytes (8+8+4+1)
-  // Total: 37 bytes when packed
-  EXPECT_EQ(sizeof(Order), 37u);
+  // Order fields contribute 29 bytes (8+8+4+1+8, the last the level)
+  // Total: 45 bytes when packed
+  EXPECT_EQ(sizeof(Order), 45u);
 }
 
 TEST(OrderTest, Construction) {
@@ -356,7 +356,7 @@ TEST_F(PerformanceTest, IntrusiveListPushBackAndIterate) {
   volatile uint64_t sum = 0; // Prevent optimization
   double iterate_time = measure_ms([&]() {
     for (const auto &order : list) {
-      sum += order.qty;
+      sum = sum + order.qty;
     }
   });
 
@@ -386,7 +386,7 @@ TEST_F(PerformanceTest, StdListPushBackAndIterate) {
   volatile uint64_t sum = 0;
   double iterate_time = measure_ms([&]() {
     for (const auto &order : list) {
-      sum += order.qty;
+      sum = sum + order.qty;
     }
   });
 
@@ -456,12 +456,12 @@ TEST_F(PerformanceTest, ComparisonSummary) {
 
   double intrusive_iter = measure_ms([&]() {
     for (const auto &o : intrusive_list)
-      sum1 += o.qty;
+      sum1 = sum1 + o.qty;
   });
 
   double std_iter = measure_ms([&]() {
     for (const auto &o : std_list)
-      sum2 += o.qty;
+      sum2 = sum2 + o.qty;
   });
 
   std::cout << "\n========================================\n";
@@ -225,6 +225,58 @@ TEST(OrderExecutedTest, ParsesRealMessage) {
   EXPECT_EQ(static_cast<uint64_t>(msg->match_number), 1234567890123ull);
 }
 
+// ============================================================================
+// Remaining ITCH 5.0 Messages
+// ============================================================================
+
+TEST(SystemEventTest, SizeIs12Bytes) { EXPECT_EQ(sizeof(SystemEvent), 12); }
+
+TEST(OrderReplaceTest, ParsesRealMessage) {
+  unsigned char buffer[35] = {
+      // Offset 0-10: header
+      'U', 0x00, 0x07, 0x00, 0x00, 0x00, 0x00, 0x3B, 0x9A, 0xCA, 0x00,
+      // Offset 11-18: original_order_ref = 1234567890
+      0x00, 0x00, 0x00, 0x00, 0x49, 0x96, 0x02, 0xD2,
+      // Offset 19-26: new_order_ref = 1234567891
+      0x00, 0x00, 0x00, 0x00, 0x49, 0x96, 0x02, 0xD3,
+      // Offset 27-30: shares = 300
+      0x00, 0x00, 0x01, 0x2C,
+      // Offset 31-34: price = 1000000 = $100.00
+      0x00, 0x0F, 0x42, 0x40};
+
+  const auto *msg = parse<OrderReplace>(reinterpret_cast<const char *>(buffer));
+
+  EXPECT_EQ(static_cast<uint16_t>(msg->stock_locate), 7);
+  EXPECT_EQ(static_cast<uint64_t>(msg->original_order_ref), 1234567890ull);
+  EXPECT_EQ(static_cast<uint64_t>(msg->new_order_ref), 1234567891ull);
+  EXPECT_EQ(static_cast<uint32_t>(msg->shares), 300u);
+  EXPECT_DOUBLE_EQ(msg->price_double(), 100.00);
+}
+
+TEST(TradeTest, MatchNumberAtOffset36) {
+  alignas(8) unsigned char buffer[44] = {};
+  buffer[0] = 'P';
+  buffer[19] = 'S';
+  buffer[43] = 0x2A; // match_number = 42
+
+  const auto *msg = parse<Trade>(reinterpret_cast<const char *>(buffer));
+  EXPECT_EQ(msg->side, 'S');
+  EXPECT_EQ(static_cast<uint64_t>(msg->match_number), 42ull);
+}
+
+TEST(AddOrderMPIDTest, SharesAddOrderPrefix) {
+  alignas(8) unsigned char buffer[40] = {};
+  buffer[0] = 'F';
+  buffer[19] = 'B';
+  buffer[23] = 0x64; // shares = 100
+  std::memcpy(&buffer[36], "GSCO", 4);
+
+  const auto *msg = parse<AddOrderMPID>(reinterpret_cast<const char *>(buffer));
+  EXPECT_TRUE(msg->is_buy());
+  EXPECT_EQ(static_cast<uint32_t>(msg->add_order().shares), 100u);
+  EXPECT_EQ(std::memcmp(msg->attribution, "GSCO", 4), 0);
+}
+
 // ============================================================================
 // Zero-Copy Verification
 // ============================================================================
@@ -0,0 +1,401 @@
+/**
+ * @file moldudp64_test.cpp
+ * @brief Unit tests for the MoldUDP64 session-layer decoder.
+ */
+
+#include <gtest/gtest.h>
+#include <itch/moldudp64.hpp>
+
+#include "test_moldudp64.hpp"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace itch::test {
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief Build a packet with one block per entry of `types`, each a
+ *        zero-filled message of that type whose order_ref (where it has
+ *        one) is its sequence number.
+ *
+ * A block's length is the registered size (or 20 for unknown types) unless
+ * `short_block` names its index, which gets one byte less.
+ */
+std::string make_itch_packet(const char *session, uint64_t sequence,
+                             const std::vector<char> &types,
+                             size_t short_block = SIZE_MAX) {
+  std::vector<std::string> messages;
+  for (size_t i = 0; i < types.size(); ++i) {
+    size_t len = message_size(types[i]) != 0 ? message_size(types[i]) : 20;
+    len -= i == short_block ? 1 : 0;
+    std::string msg(len, '\0');
+    msg[0] = types[i];
+    const uint64_t ref = sequence + i;
+    for (int b = 0; b < 8 && 11u + b < len; ++b) {
+      msg[11 + b] = static_cast<char>(ref >> (56 - b * 8));
+    }
+    messages.push_back(msg);
+  }
+  return mold_packet(messages, sequence, session);
+}
+
+constexpr const char *kSessionA = kTestSession;
+constexpr const char *kSessionB = "SESSIONB  ";
+
+struct RecordingHandler {
+  std::vector<uint64_t> refs;
+  std::vector<std::pair<uint64_t, uint64_t>> gaps;
+  std::vector<std::pair<uint64_t, uint64_t>> duplicates;
+  int ends = 0;
+
+  void on_message(const char *data, size_t len) {
+    ASSERT_EQ(len, sizeof(OrderDelete));
+    refs.push_back(reinterpret_cast<const OrderDelete *>(data)->order_ref);
+  }
+  void on_gap(const MoldSessionId & /*s*/, uint64_t expected,
+              uint64_t received) {
+    gaps.emplace_back(expected, received);
+  }
+  void on_duplicate(const MoldSessionId & /*s*/, uint64_t sequence,
+                    uint64_t count) {
+    duplicates.emplace_back(sequence, count);
+  }
+  void on_end_of_session(const MoldSessionId & /*s*/) { ++ends; }
+};
+
+/// Handler with only the mandatory hook
+struct MessagesOnly {
+  int count = 0;
+  void on_message(const char * /*data*/, size_t /*len*/) { ++count; }
+};
+
+struct DeleteCounter : DefaultVisitor {
+  int deletes = 0;
+  uint64_t gaps = 0;
+  void on_order_delete(const OrderDelete & /*msg*/) { ++deletes; }
+  void on_gap(const MoldSessionId & /*s*/, uint64_t expected,
+              uint64_t received) {
+    gaps += received - expected;
+  }
+};
+
+/// Batches AddOrders, takes OrderDeletes one by one, ignores the rest
+struct AddBatcher : DefaultVisitor {
+  std::vector<std::vector<uint64_t>> batches; ///< Refs, one list per span
+  std::vector<uint64_t> deletes;
+  std::vector<char> unknown;
+
+  void on_add_order_batch(MessageSpan<AddOrder> run) {
+    batches.emplace_back();
+    for (const AddOrder *msg : run) {
+      batches.back().push_back(msg->order_ref);
+    }
+  }
+  void on_order_delete(const OrderDelete &msg) {
+    deletes.push_back(msg.order_ref);
+  }
+  void on_unknown(char msg_type, const char * /*data*/, size_t /*len*/) {
+    unknown.push_back(msg_type);
+  }
+};
+
+/// Handles OrderDeletes only: every other registered type is skipped
+struct DeleteRecorder : DeleteRefs {
+  std::vector<char> unknown;
+
+  void on_unknown(char msg_type, const char * /*data*/, size_t /*len*/) {
+    unknown.push_back(msg_type);
+  }
+};
+
+} // namespace
+
+// ============================================================================
+// Framing
+// ============================================================================
+
+TEST(MoldUdp64Test, WalksBlocksByLengthPrefix) {
+  auto pkt = delete_packet(1, 3, kSessionA);
+  MoldUdp64Decoder<> mold;
+  RecordingHandler handler;
+
+  EXPECT_EQ(mold.decode(pkt.data(), pkt.size(), handler), MoldResult::Ok);
+  EXPECT_EQ(handler.refs, (std::vector<uint64_t>{1, 2, 3}));
+  EXPECT_EQ(mold.stats().messages, 3u);
+  EXPECT_TRUE(is_moldudp64_packet(pkt.data(), pkt.size()));
+}
+
+TEST(MoldUdp64Test, TruncatedBlockStopsDecoding) {
+  auto pkt = delete_packet(1, 2, kSessionA);
+  pkt.resize(pkt.size() - 5);
+  MoldUdp64Decoder<> mold;
+  RecordingHandler handler;
+
+  EXPECT_EQ(mold.decode(pkt.data(), pkt.size(), handler),
+            MoldResult::Truncated);
+  EXPECT_EQ(handler.refs, (std::vector<uint64_t>{1}));
+  EXPECT_EQ(mold.stats().truncated, 1u);
+  EXPECT_FALSE(is_moldudp64_packet(pkt.data(), pkt.size()));
+
+  // The message that was cut off is still expected next
+  auto retry = delete_packet(2, 1, kSessionA);
+  EXPECT_EQ(mold.decode(retry.data(), retry.size(), handler), MoldResult::Ok);
+  EXPECT_EQ(handler.refs, (std::vector<uint64_t>{1, 2}));
+  EXPECT_EQ(mold.stats().gaps, 0u);
+}
+
+TEST(MoldUdp64Test, ShortHeaderIsTruncated) {
+  const char pkt[10] = {};
+  MoldUdp64Decoder<> mold;
+  MessagesOnly handler;
+
+  EXPECT_EQ(mold.decode(pkt, sizeof(pkt), handler), MoldResult::Truncated);
+  EXPECT_EQ(handler.count, 0);
+}
+
+TEST(MoldUdp64Test, RejectsNonMoldPayloads) {
+  std::vector<char> junk(40, 0);
+  EXPECT_FALSE(is_moldudp64_packet(junk.data(), junk.size()));
+
+  auto pkt = delete_packet(1, 1, kSessionA);
+  pkt.push_back(0); // Trailing byte: blocks no longer tile the payload
+  EXPECT_FALSE(is_moldudp64_packet(pkt.data(), pkt.size()));
+}
+
+TEST(MoldUdp64Test, ValidatorAndDecoderAgreeOnZeroLengthBlocks) {
+  const std::string pkt =
+      mold_packet({order_delete(1), "", order_delete(3)}, 1);
+  EXPECT_TRUE(is_moldudp64_packet(pkt.data(), pkt.size()));
+
+  MoldUdp64Decoder<> mold;
+  MessagesOnly handler;
+  EXPECT_EQ(mold.decode(pkt.data(), pkt.size(), handler), MoldResult::Ok);
+  EXPECT_EQ(handler.count, 3);
+
+  // decode_itch() skips the empty block, which still takes sequence 2
+  MoldUdp64Decoder<> itch_mold;
+  DeleteRefs visitor;
+  EXPECT_EQ(itch_mold.decode_itch(pkt.data(), pkt.size(), visitor),
+            MoldResult::Ok);
+  EXPECT_EQ(visitor.refs, (std::vector<uint64_t>{1, 3}));
+  const std::string next = delete_packet(4, 1);
+  EXPECT_EQ(itch_mold.decode_itch(next.data(), next.size(), visitor),
+            MoldResult::Ok);
+  EXPECT_EQ(itch_mold.stats().gaps, 0u);
+}
+
+// ============================================================================
+// Sequence Tracking
+// ============================================================================
+
+TEST(MoldUdp64Test, InOrderPacketsHaveNoGaps) {
+  MoldUdp64Decoder<> mold;
+  RecordingHandler handler;
+  auto p1 = delete_packet(1, 2, kSessionA); // 1, 2
+  auto p2 = delete_packet(3, 3, kSessionA); // 3, 4, 5
+  auto p3 = delete_packet(6, 1, kSessionA); // 6
+  for (const auto *pkt : {&p1, &p2, &p3}) {
+    EXPECT_EQ(mold.decode(pkt->data(), pkt->size(), handler), MoldResult::Ok);
+  }
+
+  EXPECT_EQ(handler.refs, (std::vector<uint64_t>{1, 2, 3, 4, 5, 6}));
+  EXPECT_TRUE(handler.gaps.empty());
+  const auto *state =
+      mold.session(*reinterpret_cast<const MoldSessionId *>(kSessionA));
+  ASSERT_NE(state, nullptr);
+  EXPECT_EQ(state->next_sequence, 7u);
+}
+
+TEST(MoldUdp64Test, GapIsReportedAndMessagesStillDelivered) {
+  MoldUdp64Decoder<> mold;
+  RecordingHandler handler;
+  auto first = delete_packet(1, 2, kSessionA); // 1, 2
+  auto after = delete_packet(6, 2, kSessionA); // 6, 7 (3..5 lost)
+  (void)mold.decode(first.data(), first.size(), handler);
+  EXPECT_EQ(mold.decode(after.data(), after.size(), handler), MoldResult::Ok);
+
+  EXPECT_EQ(handler.refs, (std::vector<uint64_t>{1, 2, 6, 7}));
+  ASSERT_EQ(handler.gaps.size(), 1u);
+  EXPECT_EQ(handler.gaps[0], (std::pair<uint64_t, uint64_t>{3, 6}));
+  EXPECT_EQ(mold.stats().gaps, 1u);
+  EXPECT_EQ(mold.stats().missed_messages, 3u);
+}
+
+TEST(MoldUdp64Test, DuplicatePacketIsDropped) {
+  MoldUdp64Decoder<> mold;
+  RecordingHandler handler;
+  auto pkt = delete_packet(10, 3, kSessionA);
+  (void)mold.decode(pkt.data(), pkt.size(), handler);
+
+  EXPECT_EQ(mold.decode(pkt.data(), pkt.size(), handler),
+            MoldResult::Duplicate);
+  EXPECT_EQ(handler.refs, (std::vector<uint64_t>{10, 11, 12}));
+  ASSERT_EQ(handler.duplicates.size(), 1u);
+  EXPECT_EQ(handler.duplicates[0], (std::pair<uint64_t, uint64_t>{10, 3}));
+  EXPECT_EQ(mold.stats().duplicate_packets, 1u);
+  EXPECT_EQ(mold.stats().duplicate_messages, 3u);
+}
+
+TEST(MoldUdp64Test, OverlappingPacketDeliversOnlyNewMessages) {
+  MoldUdp64Decoder<> mold;
+  RecordingHandler handler;
+  auto first = delete_packet(1, 3, kSessionA);   // 1, 2, 3
+  auto overlap = delete_packet(2, 4, kSessionA); // 2, 3 seen; 4, 5 new
+  (void)mold.decode(first.data(), first.size(), handler);
+  EXPECT_EQ(mold.decode(overlap.data(), overlap.size(), handler),
+            MoldResult::Ok);
+
+  EXPECT_EQ(handler.refs, (std::vector<uint64_t>{1, 2, 3, 4, 5}));
+  EXPECT_EQ(mold.stats().duplicate_messages, 2u);
+  EXPECT_EQ(mold.stats().gaps, 0u);
+}
+
+TEST(MoldUdp64Test, HeartbeatRevealsGapOnce) {
+  MoldUdp64Decoder<> mold;
+  RecordingHandler handler;
+  auto first = delete_packet(1, 1, kSessionA);
+  auto heartbeat = delete_packet(5, kMoldHeartbeat, kSessionA);
+  auto next = delete_packet(5, 1, kSessionA);
+  (void)mold.decode(first.data(), first.size(), handler);
+  EXPECT_EQ(mold.decode(heartbeat.data(), heartbeat.size(), handler),
+            MoldResult::Heartbeat);
+  (void)mold.decode(next.data(), next.size(), handler);
+
+  EXPECT_EQ(mold.stats().heartbeats, 1u);
+  EXPECT_EQ(mold.stats().gaps, 1u);
+  EXPECT_EQ(mold.stats().missed_messages, 3u);
+  EXPECT_EQ(handler.refs, (std::vector<uint64_t>{1, 5}));
+}
+
+TEST(MoldUdp64Test, EndOfSession) {
+  MoldUdp64Decoder<> mold;
+  RecordingHandler handler;
+  auto first = delete_packet(1, 2, kSessionA);
+  auto end = delete_packet(3, kMoldEndOfSession, kSessionA);
+  (void)mold.decode(first.data(), first.size(), handler);
+
+  EXPECT_EQ(mold.decode(end.data(), end.size(), handler),
+            MoldResult::EndOfSession);
+  EXPECT_EQ(handler.ends, 1);
+  EXPECT_TRUE(is_moldudp64_packet(end.data(), end.size()));
+  const auto *state =
+      mold.session(*reinterpret_cast<const MoldSessionId *>(kSessionA));
+  ASSERT_NE(state, nullptr);
+  EXPECT_TRUE(state->ended);
+}
+
+TEST(MoldUdp64Test, SessionsAreTrackedIndependently) {
+  MoldUdp64Decoder<> mold;
+  RecordingHandler handler;
+  auto a1 = delete_packet(1, 1, kSessionA);
+  auto b1 = delete_packet(100, 1, kSessionB);
+  auto a2 = delete_packet(2, 1, kSessionA);
+  auto b2 = delete_packet(101, 1, kSessionB);
+  for (const auto *pkt : {&a1, &b1, &a2, &b2}) {
+    EXPECT_EQ(mold.decode(pkt->data(), pkt->size(), handler), MoldResult::Ok);
+  }
+
+  EXPECT_EQ(mold.session_count(), 2u);
+  EXPECT_EQ(mold.stats().gaps, 0u);
+  EXPECT_EQ(handler.refs, (std::vector<uint64_t>{1, 100, 2, 101}));
+}
+
+TEST(MoldUdp64Test, FullSessionTableStillDelivers) {
+  MoldUdp64Decoder<1> mold;
+  MessagesOnly handler;
+  auto a = delete_packet(1, 1, kSessionA);
+  auto b = delete_packet(1, 2, kSessionB);
+  (void)mold.decode(a.data(), a.size(), handler);
+
+  EXPECT_EQ(mold.decode(b.data(), b.size(), handler),
+            MoldResult::SessionTableFull);
+  EXPECT_EQ(handler.count, 3);
+  EXPECT_EQ(mold.stats().untracked_packets, 1u);
+}
+
+// ============================================================================
+// ITCH Integration
+// ============================================================================
+
+TEST(MoldUdp64Test, DecodeItchDispatchesToVisitor) {
+  MoldUdp64Decoder<> mold;
+  DeleteCounter visitor;
+  auto first = delete_packet(1, 2, kSessionA);
+  auto after = delete_packet(5, 3, kSessionA);
+  (void)mold.decode_itch(first.data(), first.size(), visitor);
+  (void)mold.decode_itch(after.data(), after.size(), visitor);
+
+  EXPECT_EQ(visitor.deletes, 5);
+  EXPECT_EQ(visitor.gaps, 2u);
+}
+
+TEST(MoldUdp64Test, DecodeItchBatchesConsecutiveBlocks) {
+  MoldUdp64Decoder<> mold;
+  AddBatcher visitor;
+  auto pkt = make_itch_packet(kSessionA, 1, {'A', 'A', 'A', 'D', 'A', 'A'});
+  auto next = make_itch_packet(kSessionA, 7, {'A', 'S', 'A'});
+  EXPECT_EQ(mold.decode_itch(pkt.data(), pkt.size(), visitor), MoldResult::Ok);
+  EXPECT_EQ(mold.decode_itch(next.data(), next.size(), visitor),
+            MoldResult::Ok);
+
+  // The SystemEvent is skipped without ending the run; packets end runs
+  const std::vector<std::vector<uint64_t>> expected = {
+      {1, 2, 3}, {5, 6}, {7, 9}};
+  EXPECT_EQ(visitor.batches, expected);
+  EXPECT_EQ(visitor.deletes, std::vector<uint64_t>{4});
+  EXPECT_EQ(mold.stats().messages, 9u);
+}
+
+TEST(MoldUdp64Test, DecodeItchSplitsLongRuns) {
+  MoldUdp64Decoder<> mold;
+  AddBatcher visitor;
+  auto pkt = make_itch_packet(kSessionA, 1, std::vector<char>(70, 'A'));
+  (void)mold.decode_itch(pkt.data(), pkt.size(), visitor);
+
+  ASSERT_EQ(visitor.batches.size(), 2u);
+  EXPECT_EQ(visitor.batches[0].size(), 64u);
+  EXPECT_EQ(visitor.batches[1].size(), 6u);
+  EXPECT_EQ(visitor.batches[1].back(), 70u);
+}
+
+TEST(MoldUdp64Test, DecodeItchDropsShortBatchedBlock) {
+  MoldUdp64Decoder<> mold;
+  AddBatcher visitor;
+  auto pkt = make_itch_packet(kSessionA, 1, {'A', 'A', 'A'}, 1);
+  (void)mold.decode_itch(pkt.data(), pkt.size(), visitor);
+
+  const std::vector<std::vector<uint64_t>> expected = {{1, 3}};
+  EXPECT_EQ(visitor.batches, expected);
+}
+
+TEST(MoldUdp64Test, DecodeItchSkipsUnhandledTypes) {
+  MoldUdp64Decoder<> mold;
+  DeleteRecorder visitor;
+  auto pkt = make_itch_packet(kSessionA, 1, {'A', 'D', 'E', 'Z', 'D'});
+  (void)mold.decode_itch(pkt.data(), pkt.size(), visitor);
+
+  EXPECT_EQ(visitor.refs, (std::vector<uint64_t>{2, 5}));
+  // Unregistered types still reach on_unknown
+  EXPECT_EQ(visitor.unknown, std::vector<char>{'Z'});
+}
+
+TEST(MoldUdp64Test, DecodeItchBatchingVisitorSeesUnknownInOrder) {
+  MoldUdp64Decoder<> mold;
+  AddBatcher visitor;
+  auto pkt = make_itch_packet(kSessionA, 1, {'A', 'Z', 'A'});
+  (void)mold.decode_itch(pkt.data(), pkt.size(), visitor);
+
+  const std::vector<std::vector<uint64_t>> expected = {{1}, {3}};
+  EXPECT_EQ(visitor.batches, expected);
+  EXPECT_EQ(visitor.unknown, std::vector<char>{'Z'});
+}
+
+} // namespace itch::test
@@ -0,0 +1,415 @@
+/**
+ * @file net_decoder_test.cpp
+ * @brief Unit tests for the link/IP/UDP decoder.
+ */
+
+#include <gtest/gtest.h>
+#include <itch/net_decoder.hpp>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace itch::test {
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace {
+
+void put16(std::vector<char> &v, uint16_t x) {
+  v.push_back(static_cast<char>(x >> 8));
+  v.push_back(static_cast<char>(x));
+}
+
+/// MoldUDP64-header-sized payload: long enough for flow caching
+constexpr const char *kPayload = "0000010059B ITCH 5.0";
+
+struct FrameSpec {
+  std::vector<uint16_t> vlan_tpids; ///< Outer to inner tag protocol IDs
+  int ip_version = 4;
+  size_t ipv4_options = 0; ///< Bytes, multiple of 4
+  uint8_t protocol = 17;
+  uint16_t frag = 0; ///< IPv4 flags/fragment offset field
+  uint8_t src_last = 1;
+  uint16_t src_port = 1234;
+  uint16_t dst_port = 26477;
+  std::string payload = kPayload;
+  size_t padding = 0; ///< Trailing bytes after the datagram
+};
+
+/**
+ * @brief Network + transport headers and payload (no link layer).
+ */
+std::vector<char> make_ip(const FrameSpec &spec) {
+  std::vector<char> ip;
+  const uint16_t udp_len = static_cast<uint16_t>(8 + spec.payload.size());
+
+  if (spec.ip_version == 4) {
+    const size_t ihl = 20 + spec.ipv4_options;
+    ip.push_back(static_cast<char>(0x40 | (ihl / 4)));
+    ip.push_back(0);
+    put16(ip, static_cast<uint16_t>(ihl + udp_len));
+    put16(ip, 0x1234);
+    put16(ip, spec.frag);
+    ip.push_back(64);
+    ip.push_back(static_cast<char>(spec.protocol));
+    put16(ip, 0);
+    const char src[] = {10, 0, 0, static_cast<char>(spec.src_last)};
+    const char dst[] = {static_cast<char>(233), 54, 12, 111};
+    ip.insert(ip.end(), src, src + 4);
+    ip.insert(ip.end(), dst, dst + 4);
+    ip.insert(ip.end(), spec.ipv4_options, 1); // NOP options
+  } else {
+    ip.push_back(0x60);
+    ip.push_back(0);
+    put16(ip, 0);
+    put16(ip, udp_len);
+    ip.push_back(static_cast<char>(spec.protocol));
+    ip.push_back(64);
+    for (int i = 0; i < 16; ++i) {
+      ip.push_back(static_cast<char>(i == 15 ? spec.src_last : 0x20));
+    }
+    for (int i = 0; i < 16; ++i) {
+      ip.push_back(static_cast<char>(0xff));
+    }
+  }
+
+  put16(ip, spec.src_port);
+  put16(ip, spec.dst_port);
+  put16(ip, udp_len);
+  put16(ip, 0);
+  ip.insert(ip.end(), spec.payload.begin(), spec.payload.end());
+  ip.insert(ip.end(), spec.padding, 0);
+  return ip;
+}
+
+std::vector<char> make_ethernet(const FrameSpec &spec) {
+  std::vector<char> frame(12, 0x11); // dst + src MAC
+  for (uint16_t tpid : spec.vlan_tpids) {
+    put16(frame, tpid);
+    put16(frame, 100); // TCI
+  }
+  put16(frame, spec.ip_version == 4 ? 0x0800 : 0x86DD);
+  std::vector<char> ip = make_ip(spec);
+  frame.insert(frame.end(), ip.begin(), ip.end());
+  return frame;
+}
+
+std::string payload_of(const UdpDatagram &udp) {
+  return std::string(udp.payload, udp.length);
+}
+
+} // namespace
+
+// ============================================================================
+// Ethernet
+// ============================================================================
+
+TEST(UdpDecoderTest, PlainEthernetIPv4) {
+  std::vector<char> frame = make_ethernet(FrameSpec{});
+  UdpDecoder net;
+  UdpDatagram udp;
+
+  ASSERT_TRUE(net.decode(frame.data(), frame.size(), udp));
+  EXPECT_EQ(udp.payload, frame.data() + 42);
+  EXPECT_EQ(payload_of(udp), kPayload);
+  EXPECT_EQ(udp.src_port, 1234);
+  EXPECT_EQ(udp.dst_port, 26477);
+  EXPECT_EQ(udp.ip_version, 4);
+}
+
+TEST(UdpDecoderTest, VlanAndQinQTags) {
+  FrameSpec single;
+  single.vlan_tpids = {0x8100};
+  FrameSpec qinq;
+  qinq.vlan_tpids = {0x88A8, 0x8100};
+  FrameSpec legacy;
+  legacy.vlan_tpids = {0x9100, 0x8100};
+
+  UdpDecoder net;
+  UdpDatagram udp;
+
+  std::vector<char> f1 = make_ethernet(single);
+  ASSERT_TRUE(net.decode(f1.data(), f1.size(), udp));
+  EXPECT_EQ(udp.payload, f1.data() + 46);
+
+  std::vector<char> f2 = make_ethernet(qinq);
+  ASSERT_TRUE(net.decode(f2.data(), f2.size(), udp));
+  EXPECT_EQ(udp.payload, f2.data() + 50);
+
+  std::vector<char> f3 = make_ethernet(legacy);
+  ASSERT_TRUE(net.decode(f3.data(), f3.size(), udp));
+  EXPECT_EQ(udp.payload, f3.data() + 50);
+}
+
+TEST(UdpDecoderTest, IPv4OptionsShiftPayload) {
+  FrameSpec spec;
+  spec.ipv4_options = 12;
+  std::vector<char> frame = make_ethernet(spec);
+  UdpDecoder net;
+  UdpDatagram udp;
+
+  ASSERT_TRUE(net.decode(frame.data(), frame.size(), udp));
+  EXPECT_EQ(udp.payload, frame.data() + 54);
+  EXPECT_EQ(payload_of(udp), kPayload);
+}
+
+TEST(UdpDecoderTest, EthernetPaddingIsTrimmed) {
+  FrameSpec spec;
+  spec.padding = 6; // Short frames are padded to 60 bytes on the wire
+  std::vector<char> frame = make_ethernet(spec);
+  UdpDecoder net;
+  UdpDatagram udp;
+
+  ASSERT_TRUE(net.decode(frame.data(), frame.size(), udp));
+  EXPECT_EQ(payload_of(udp), kPayload);
+}
+
+TEST(UdpDecoderTest, IPv6) {
+  FrameSpec spec;
+  spec.ip_version = 6;
+  std::vector<char> frame = make_ethernet(spec);
+  UdpDecoder net;
+  UdpDatagram udp;
+
+  ASSERT_TRUE(net.decode(frame.data(), frame.size(), udp));
+  EXPECT_EQ(udp.payload, frame.data() + 14 + 40 + 8);
+  EXPECT_EQ(udp.ip_version, 6);
+  EXPECT_EQ(payload_of(udp), kPayload);
+}
+
+TEST(UdpDecoderTest, IPv6ExtensionHeaderIsWalked) {
+  FrameSpec spec;
+  spec.ip_version = 6;
+  std::vector<char> frame = make_ethernet(spec);
+  // Insert an 8-byte destination-options header before UDP
+  const size_t ext_at = 14 + 40;
+  const char ext[8] = {17, 0, 1, 4, 0, 0, 0, 0};
+  frame.insert(frame.begin() + ext_at, ext, ext + 8);
+  frame[14 + 6] = 60;
+
+  UdpDecoder net;
+  UdpDatagram udp;
+  ASSERT_TRUE(net.decode(frame.data(), frame.size(), udp));
+  EXPECT_EQ(udp.payload, frame.data() + ext_at + 8 + 8);
+  EXPECT_EQ(payload_of(udp), kPayload);
+}
+
+// ============================================================================
+// Rejection
+// ============================================================================
+
+TEST(UdpDecoderTest, RejectsNonUdpNonIpAndFragments) {
+  UdpDecoder net;
+  UdpDatagram udp;
+
+  FrameSpec tcp;
+  tcp.protocol = 6;
+  std::vector<char> f1 = make_ethernet(tcp);
+  EXPECT_FALSE(net.decode(f1.data(), f1.size(), udp));
+  EXPECT_EQ(net.stats().non_udp, 1u);
+
+  std::vector<char> arp = make_ethernet(FrameSpec{});
+  arp[12] = 0x08;
+  arp[13] = 0x06;
+  EXPECT_FALSE(net.decode(arp.data(), arp.size(), udp));
+  EXPECT_EQ(net.stats().non_ip, 1u);
+
+  FrameSpec more_fragments;
+  more_fragments.frag = 0x2000;
+  std::vector<char> f2 = make_ethernet(more_fragments);
+  EXPECT_FALSE(net.decode(f2.data(), f2.size(), udp));
+  EXPECT_EQ(net.stats().fragments, 1u);
+
+  std::vector<char> f3 = make_ethernet(FrameSpec{});
+  EXPECT_FALSE(net.decode(f3.data(), 40, udp));
+  EXPECT_EQ(net.stats().truncated, 1u);
+}
+
+TEST(UdpDecoderTest, FragmentOfAKnownFlowIsRejected) {
+  UdpDecoder net;
+  UdpDatagram udp;
+
+  std::vector<char> whole = make_ethernet(FrameSpec{});
+  ASSERT_TRUE(net.decode(whole.data(), whole.size(), udp));
+
+  FrameSpec fragment;
+  fragment.frag = 0x0010; // Non-zero offset: no UDP header here
+  std::vector<char> frame = make_ethernet(fragment);
+  EXPECT_FALSE(net.decode(frame.data(), frame.size(), udp));
+  EXPECT_EQ(net.stats().fragments, 1u);
+}
+
+TEST(UdpDecoderTest, PortFilter) {
+  UdpDecoder net;
+  net.set_port_filter(26400, 26499);
+  UdpDatagram udp;
+
+  std::vector<char> in_range = make_ethernet(FrameSpec{});
+  EXPECT_TRUE(net.decode(in_range.data(), in_range.size(), udp));
+
+  FrameSpec other;
+  other.dst_port = 53;
+  std::vector<char> out_of_range = make_ethernet(other);
+  EXPECT_FALSE(net.decode(out_of_range.data(), out_of_range.size(), udp));
+  EXPECT_EQ(net.stats().filtered, 1u);
+}
+
+// ============================================================================
+// Other Link Types
+// ============================================================================
+
+TEST(UdpDecoderTest, RawIpLinkTypes) {
+  std::vector<char> v4 = make_ip(FrameSpec{});
+  FrameSpec spec6;
+  spec6.ip_version = 6;
+  std::vector<char> v6 = make_ip(spec6);
+  UdpDatagram udp;
+
+  UdpDecoder raw(LinkType::Raw);
+  ASSERT_TRUE(raw.decode(v4.data(), v4.size(), udp));
+  EXPECT_EQ(payload_of(udp), kPayload);
+  ASSERT_TRUE(raw.decode(v6.data(), v6.size(), udp));
+  EXPECT_EQ(udp.ip_version, 6);
+
+  UdpDecoder ipv4(LinkType::IPv4);
+  ASSERT_TRUE(ipv4.decode(v4.data(), v4.size(), udp));
+  EXPECT_EQ(udp.payload, v4.data() + 28);
+}
+
+TEST(UdpDecoderTest, LinuxCookedAndLoopback) {
+  std::vector<char> ip = make_ip(FrameSpec{});
+  UdpDatagram udp;
+
+  std::vector<char> sll(14, 0);
+  put16(sll, 0x0800);
+  sll.insert(sll.end(), ip.begin(), ip.end());
+  UdpDecoder cooked(LinkType::LinuxSll);
+  ASSERT_TRUE(cooked.decode(sll.data(), sll.size(), udp));
+  EXPECT_EQ(udp.payload, sll.data() + 16 + 28);
+
+  std::vector<char> sll2;
+  put16(sll2, 0x0800);
+  sll2.insert(sll2.end(), 18, 0);
+  sll2.insert(sll2.end(), ip.begin(), ip.end());
+  UdpDecoder cooked2(LinkType::LinuxSll2);
+  ASSERT_TRUE(cooked2.decode(sll2.data(), sll2.size(), udp));
+  EXPECT_EQ(udp.payload, sll2.data() + 20 + 28);
+
+  // AF_INET = 2 in little-endian host order
+  std::vector<char> null = {2, 0, 0, 0};
+  null.insert(null.end(), ip.begin(), ip.end());
+  UdpDecoder loopback(LinkType::Null);
+  ASSERT_TRUE(loopback.decode(null.data(), null.size(), udp));
+  EXPECT_EQ(payload_of(udp), kPayload);
+}
+
+TEST(UdpDecoderTest, UnknownLinkTypeIsRejected) {
+  std::vector<char> frame = make_ethernet(FrameSpec{});
+  UdpDecoder net(static_cast<LinkType>(105)); // 802.11
+  UdpDatagram udp;
+  EXPECT_FALSE(net.decode(frame.data(), frame.size(), udp));
+  EXPECT_EQ(net.stats().non_ip, 1u);
+}
+
+// ============================================================================
+// Packet Sequences
+// ============================================================================
+
+TEST(UdpDecoderTest, EveryPacketOfAFlowIsDecoded) {
+  FrameSpec spec;
+  spec.vlan_tpids = {0x8100};
+  UdpDecoder net;
+  UdpDatagram udp;
+
+  for (int i = 0; i < 10; ++i) {
+    spec.payload = kPayload + std::to_string(i);
+    std::vector<char> frame = make_ethernet(spec);
+    ASSERT_TRUE(net.decode(frame.data(), frame.size(), udp));
+    EXPECT_EQ(payload_of(udp), spec.payload);
+  }
+
+  EXPECT_EQ(net.stats().packets, 10u);
+  EXPECT_EQ(net.stats().datagrams, 10u);
+}
+
+TEST(UdpDecoderTest, InterleavedLayouts) {
+  FrameSpec a;
+  FrameSpec b;
+  b.vlan_tpids = {0x8100};
+  b.src_last = 2;
+  FrameSpec c;
+  c.ipv4_options = 4;
+  c.src_last = 3;
+
+  std::vector<char> fa = make_ethernet(a);
+  std::vector<char> fb = make_ethernet(b);
+  std::vector<char> fc = make_ethernet(c);
+  UdpDecoder net;
+  UdpDatagram udp;
+
+  for (int round = 0; round < 3; ++round) {
+    ASSERT_TRUE(net.decode(fa.data(), fa.size(), udp));
+    EXPECT_EQ(udp.payload, fa.data() + 42);
+    ASSERT_TRUE(net.decode(fb.data(), fb.size(), udp));
+    EXPECT_EQ(udp.payload, fb.data() + 46);
+    ASSERT_TRUE(net.decode(fc.data(), fc.size(), udp));
+    EXPECT_EQ(udp.payload, fc.data() + 46);
+  }
+
+  EXPECT_EQ(net.stats().datagrams, 9u);
+}
+
+TEST(UdpDecoderTest, ShortFramesAreDecoded) {
+  FrameSpec spec;
+  spec.payload = "tiny";
+  std::vector<char> frame = make_ethernet(spec);
+  UdpDecoder net;
+  UdpDatagram udp;
+
+  ASSERT_TRUE(net.decode(frame.data(), frame.size(), udp));
+  EXPECT_EQ(payload_of(udp), "tiny");
+}
+
+TEST(UdpDecoderTest, TruncatedFrameOfAKnownFlowStaysInBounds) {
+  FrameSpec spec;
+  spec.ip_version = 6;
+  std::vector<char> frame = make_ethernet(spec);
+  UdpDecoder net;
+  UdpDatagram udp;
+  ASSERT_TRUE(net.decode(frame.data(), frame.size(), udp));
+
+  // Same flow, claiming a 64 KiB datagram
+  frame[14 + 40 + 4] = static_cast<char>(0xFF);
+  frame[14 + 40 + 5] = static_cast<char>(0xFF);
+
+  // Cut inside the UDP header (IPv6 puts it at 54..61)
+  for (size_t len : {size_t{60}, size_t{61}}) {
+    std::vector<char> cut(frame.begin(), frame.begin() + len);
+    EXPECT_FALSE(net.decode(cut.data(), cut.size(), udp));
+  }
+  EXPECT_EQ(net.stats().truncated, 2u);
+
+  // Cut inside the payload: trimmed to what was captured
+  std::vector<char> cut(frame.begin(), frame.begin() + 66);
+  ASSERT_TRUE(net.decode(cut.data(), cut.size(), udp));
+  EXPECT_EQ(udp.payload, cut.data() + 62);
+  EXPECT_EQ(udp.length, 4u);
+}
+
+TEST(UdpDecoderTest, ResetZeroesCounters) {
+  std::vector<char> frame = make_ethernet(FrameSpec{});
+  UdpDecoder net;
+  UdpDatagram udp;
+  ASSERT_TRUE(net.decode(frame.data(), frame.size(), udp));
+  EXPECT_FALSE(net.decode(frame.data(), 20, udp));
+
+  net.reset();
+  EXPECT_EQ(net.stats().packets, 0u);
+  EXPECT_EQ(net.stats().datagrams, 0u);
+  EXPECT_EQ(net.stats().truncated, 0u);
+}
+
+} // namespace itch::test
@@ -0,0 +1,204 @@
+/**
+ * @file order_map_test.cpp
+ * @brief Unit tests for the open-addressing order index and its use in
+ *        OrderBook.
+ */
+
+#include <gtest/gtest.h>
+
+#include <book/order_book.hpp>
+#include <book/order_map.hpp>
+
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace book;
+
+// ============================================================================
+// Fixture
+// ============================================================================
+
+class OrderMapTest : public ::testing::Test {
+protected:
+  static constexpr std::size_t CAPACITY = 1000;
+
+  std::vector<Order> orders_ = std::vector<Order>(4 * CAPACITY);
+  OrderMap<Order, CAPACITY> map_;
+
+  Order *order(std::size_t i) { return &orders_[i]; }
+
+  /// j-th smallest key whose home slot is `slot`
+  static uint64_t key_with_home(std::size_t slot, uint64_t j) {
+    for (uint64_t key = 0;; ++key) {
+      if (decltype(map_)::home(key) == slot && j-- == 0) {
+        return key;
+      }
+    }
+  }
+};
+
+// ============================================================================
+// Basic Operations
+// ============================================================================
+
+TEST_F(OrderMapTest, SizedFromCapacity) {
+  // Power of two, load factor at most 2/3 when full
+  EXPECT_EQ(decltype(map_)::kSlots, 2048u);
+  EXPECT_GE(decltype(map_)::kSlots * 2, CAPACITY * 3);
+  EXPECT_TRUE(map_.empty());
+}
+
+TEST_F(OrderMapTest, InsertFindErase) {
+  EXPECT_TRUE(map_.insert(42, order(0)));
+  EXPECT_TRUE(map_.insert(0, order(1))); // Key 0 is an ordinary key
+  EXPECT_EQ(map_.size(), 2u);
+  EXPECT_EQ(map_.find(42), order(0));
+  EXPECT_EQ(map_.find(0), order(1));
+  EXPECT_EQ(map_.find(7), nullptr);
+
+  EXPECT_EQ(map_.erase(42), order(0));
+  EXPECT_EQ(map_.find(42), nullptr);
+  EXPECT_EQ(map_.erase(42), nullptr);
+  EXPECT_EQ(map_.size(), 1u);
+}
+
+TEST_F(OrderMapTest, RejectsDuplicateKeys) {
+  ASSERT_TRUE(map_.insert(5, order(0)));
+  EXPECT_FALSE(map_.insert(5, order(1)));
+  EXPECT_EQ(map_.find(5), order(0));
+  EXPECT_EQ(map_.size(), 1u);
+}
+
+TEST_F(OrderMapTest, RefusesInsertBeyondCapacity) {
+  for (std::size_t i = 0; i < CAPACITY; ++i) {
+    ASSERT_TRUE(map_.insert(i, order(i)));
+  }
+  EXPECT_FALSE(map_.insert(CAPACITY, order(CAPACITY)));
+  EXPECT_EQ(map_.size(), CAPACITY);
+  ASSERT_NE(map_.erase(3), nullptr);
+  EXPECT_TRUE(map_.insert(CAPACITY, order(CAPACITY)));
+}
+
+// ============================================================================
+// Hashing
+// ============================================================================
+
+TEST_F(OrderMapTest, ConsecutiveRefsShareACacheLine) {
+  using Map = decltype(map_);
+  constexpr uint64_t kRun = uint64_t{1} << Map::kRunBits;
+  for (uint64_t key = 4000; key < 4000 + 16 * kRun; key += kRun) {
+    EXPECT_EQ(Map::home(key) % kRun, 0u);
+    for (uint64_t j = 1; j < kRun; ++j) {
+      EXPECT_EQ(Map::home(key + j), Map::home(key) + j);
+    }
+  }
+}
+
+TEST(OrderMapSmallTest, TinyTablesStillSpanTwoLines) {
+  std::vector<Order> orders(2);
+  OrderMap<Order, 1> map;
+  EXPECT_EQ(decltype(map)::kSlots, 8u);
+  EXPECT_TRUE(map.insert(UINT64_MAX, &orders[0]));
+  EXPECT_FALSE(map.insert(7, &orders[1])); // Full
+  EXPECT_EQ(map.find(UINT64_MAX), &orders[0]);
+  EXPECT_EQ(map.erase(UINT64_MAX), &orders[0]);
+  EXPECT_TRUE(map.empty());
+}
+
+// ============================================================================
+// Collisions and Backward-Shift Deletion
+// ============================================================================
+
+TEST_F(OrderMapTest, EraseKeepsCollidingRunsReachable) {
+  std::vector<uint64_t> keys;
+  for (uint64_t j = 0; j < 6; ++j) {
+    keys.push_back(key_with_home(0, j));
+  }
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    ASSERT_TRUE(map_.insert(keys[i], order(i)));
+  }
+  // Remove from the middle of the run: later entries shift back
+  EXPECT_EQ(map_.erase(keys[2]), order(2));
+  EXPECT_EQ(map_.erase(keys[0]), order(0));
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_EQ(map_.find(keys[i]), (i == 0 || i == 2) ? nullptr : order(i));
+  }
+}
+
+TEST_F(OrderMapTest, WrapsAroundTheEndOfTheTable) {
+  constexpr uint64_t kLast = decltype(map_)::kSlots - 1;
+  // Run of four homed on the last slot spills into slots 0-2; a fifth key
+  // homed on slot 1 lands behind them
+  for (uint64_t j = 0; j < 4; ++j) {
+    ASSERT_TRUE(map_.insert(key_with_home(kLast, j), order(j)));
+  }
+  ASSERT_TRUE(map_.insert(key_with_home(1, 0), order(10)));
+
+  EXPECT_EQ(map_.erase(key_with_home(kLast, 0)), order(0));
+  EXPECT_EQ(map_.erase(key_with_home(kLast, 2)), order(2));
+  EXPECT_EQ(map_.find(key_with_home(kLast, 1)), order(1));
+  EXPECT_EQ(map_.find(key_with_home(kLast, 3)), order(3));
+  EXPECT_EQ(map_.find(key_with_home(1, 0)), order(10));
+  EXPECT_EQ(map_.size(), 3u);
+}
+
+TEST_F(OrderMapTest, MatchesUnorderedMapUnderRandomChurn) {
+  std::mt19937_64 rng(20240611);
+  std::unordered_map<uint64_t, Order *> model;
+  std::vector<uint64_t> live;
+  uint64_t next_ref = 1'000'000;
+
+  for (int step = 0; step < 200'000; ++step) {
+    const bool add = live.empty() ||
+                     (live.size() < CAPACITY && rng() % 100 < 52);
+    if (add) {
+      // Mostly sequential refs, with occasional far outliers
+      const uint64_t key = rng() % 50 == 0 ? rng() : next_ref++;
+      Order *value = order(key % orders_.size());
+      const bool fresh = model.emplace(key, value).second;
+      EXPECT_EQ(map_.insert(key, value), fresh);
+      if (fresh) {
+        live.push_back(key);
+      }
+    } else {
+      const std::size_t pick = rng() % live.size();
+      const uint64_t key = live[pick];
+      live[pick] = live.back();
+      live.pop_back();
+      ASSERT_EQ(map_.erase(key), model[key]);
+      model.erase(key);
+    }
+    ASSERT_EQ(map_.size(), model.size());
+  }
+  for (const auto &[key, value] : model) {
+    EXPECT_EQ(map_.find(key), value);
+  }
+}
+
+// ============================================================================
+// OrderBook Integration
+// ============================================================================
+
+TEST(OrderBookIndexTest, DuplicateIdRejectedWithoutLeakingPoolSlots) {
+  MemPool<Order, 4> pool;
+  OrderBook<4> book(pool);
+  ASSERT_TRUE(book.add_order(1, 1000, 10, Side::Buy));
+  EXPECT_FALSE(book.add_order(1, 900, 10, Side::Buy));  // Resting dup
+  EXPECT_FALSE(book.add_order(1, 1000, 5, Side::Sell)); // Crossing dup
+  EXPECT_EQ(pool.allocated(), 1u);
+  EXPECT_EQ(book.order_count(), 1u);
+  EXPECT_EQ(book.best_bid_volume(), 10u);
+}
+
+TEST(OrderBookIndexTest, FilledMakersLeaveTheIndex) {
+  MemPool<Order, 8> pool;
+  OrderBook<8> book(pool);
+  ASSERT_TRUE(book.add_order(1, 1000, 10, Side::Sell));
+  ASSERT_TRUE(book.add_order(2, 1000, 10, Side::Sell));
+  ASSERT_TRUE(book.add_order(3, 1000, 15, Side::Buy)); // Fills 1, half of 2
+  EXPECT_EQ(book.order_count(), 1u);
+  EXPECT_FALSE(book.cancel_order(1));
+  EXPECT_TRUE(book.cancel_order(2));
+  EXPECT_TRUE(book.add_order(1, 1000, 10, Side::Sell)); // ID free again
+}
@@ -0,0 +1,217 @@
+/**
+ * @file order_table_test.cpp
+ * @brief Unit tests for the direct-mapped sliding-window order index.
+ */
+
+#include <gtest/gtest.h>
+
+#include <book/order_book.hpp>
+#include <book/order_table.hpp>
+
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace book;
+
+// ============================================================================
+// Fixture
+// ============================================================================
+
+class OrderTableTest : public ::testing::Test {
+protected:
+  static constexpr std::size_t CAPACITY = 1000;
+
+  // 64-ref pages: a window of 32 pages (2048 refs), overflow of 314
+  using Table = OrderTable<Order, CAPACITY, 6>;
+
+  std::vector<Order> orders_ = std::vector<Order>(4 * CAPACITY);
+  Table table_;
+
+  Order *order(uint64_t i) { return &orders_[i % orders_.size()]; }
+};
+
+// ============================================================================
+// Basic Operations
+// ============================================================================
+
+TEST_F(OrderTableTest, SizedFromCapacity) {
+  EXPECT_EQ(Table::kPageRefs, 64u);
+  EXPECT_EQ(Table::kWindowPages, 32u);
+  EXPECT_EQ(Table::kWindowRefs, 2048u);
+  EXPECT_TRUE(table_.empty());
+}
+
+TEST_F(OrderTableTest, InsertFindErase) {
+  EXPECT_TRUE(table_.insert(42, order(0)));
+  EXPECT_TRUE(table_.insert(0, order(1)));
+  EXPECT_EQ(table_.size(), 2u);
+  EXPECT_EQ(table_.find(42), order(0));
+  EXPECT_EQ(table_.find(0), order(1));
+  EXPECT_EQ(table_.find(7), nullptr);
+
+  EXPECT_EQ(table_.erase(42), order(0));
+  EXPECT_EQ(table_.find(42), nullptr);
+  EXPECT_EQ(table_.erase(42), nullptr);
+  EXPECT_EQ(table_.size(), 1u);
+  EXPECT_EQ(table_.overflow_size(), 0u);
+}
+
+TEST_F(OrderTableTest, RejectsDuplicateKeys) {
+  ASSERT_TRUE(table_.insert(5, order(0)));
+  EXPECT_FALSE(table_.insert(5, order(1)));
+  EXPECT_EQ(table_.find(5), order(0));
+  EXPECT_EQ(table_.size(), 1u);
+}
+
+TEST_F(OrderTableTest, AnchorsAnEmptyWindowAtTheFirstRef) {
+  const uint64_t first = 5'000'000'123;
+  ASSERT_TRUE(table_.insert(first, order(0)));
+  EXPECT_EQ(table_.window_base(), first & ~uint64_t{63});
+  EXPECT_EQ(table_.overflow_size(), 0u);
+  EXPECT_EQ(table_.find(first), order(0));
+}
+
+// ============================================================================
+// Sliding and Recycling
+// ============================================================================
+
+TEST_F(OrderTableTest, SlidesAndRecyclesDeadPages) {
+  // A day of short-lived orders: never more than 10 resting
+  for (uint64_t ref = 1; ref <= 20000; ++ref) {
+    ASSERT_TRUE(table_.insert(ref, order(ref)));
+    if (ref > 10) {
+      ASSERT_EQ(table_.erase(ref - 10), order(ref - 10));
+    }
+  }
+  EXPECT_EQ(table_.size(), 10u);
+  EXPECT_EQ(table_.overflow_size(), 0u);
+  EXPECT_GT(table_.window_base(), 20000u - Table::kWindowRefs);
+  EXPECT_GT(table_.pages_recycled(), 0u);
+}
+
+TEST_F(OrderTableTest, SurvivorsOfRecycledPagesMoveToOverflow) {
+  ASSERT_TRUE(table_.insert(1, order(1)));   // Rests all day
+  ASSERT_TRUE(table_.insert(100, order(2))); // Also rests
+  for (uint64_t ref = 200; ref < 10000; ++ref) {
+    ASSERT_TRUE(table_.insert(ref, order(ref)));
+    ASSERT_NE(table_.erase(ref), nullptr);
+  }
+  EXPECT_GT(table_.window_base(), 100u);
+  EXPECT_EQ(table_.overflow_size(), 2u);
+  EXPECT_EQ(table_.find(1), order(1));
+  EXPECT_FALSE(table_.insert(100, order(3)));
+  EXPECT_EQ(table_.erase(100), order(2));
+  EXPECT_EQ(table_.size(), 1u);
+}
+
+TEST_F(OrderTableTest, OutliersGoToOverflowWithoutMovingTheWindow) {
+  ASSERT_TRUE(table_.insert(10'000, order(0)));
+  const uint64_t base = table_.window_base();
+  ASSERT_TRUE(table_.insert(UINT64_MAX - 1, order(1))); // Far ahead
+  ASSERT_TRUE(table_.insert(3, order(2)));              // Below the window
+  EXPECT_EQ(table_.window_base(), base);
+  EXPECT_EQ(table_.overflow_size(), 2u);
+  EXPECT_EQ(table_.find(UINT64_MAX - 1), order(1));
+  EXPECT_EQ(table_.find(3), order(2));
+  EXPECT_EQ(table_.erase(3), order(2));
+  EXPECT_EQ(table_.size(), 2u);
+}
+
+TEST_F(OrderTableTest, WindowCatchingUpWithAnOutlierStillFindsIt) {
+  ASSERT_TRUE(table_.insert(0, order(0)));
+  const uint64_t outlier = 2 * Table::kWindowRefs + 5;
+  ASSERT_TRUE(table_.insert(outlier, order(1)));
+  ASSERT_EQ(table_.overflow_size(), 1u);
+  // Sequential refs slide the window over the outlier's ref
+  for (uint64_t ref = 1; ref < outlier; ++ref) {
+    ASSERT_TRUE(table_.insert(ref, order(ref)));
+    ASSERT_NE(table_.erase(ref), nullptr);
+  }
+  EXPECT_FALSE(table_.insert(outlier, order(2)));
+  EXPECT_EQ(table_.find(outlier), order(1));
+  EXPECT_EQ(table_.erase(outlier), order(1));
+  EXPECT_EQ(table_.find(outlier), nullptr);
+}
+
+TEST_F(OrderTableTest, RefusesWhenOverflowCannotTakeSurvivors) {
+  // Fill the window's first pages with long-lived orders
+  for (uint64_t ref = 0; ref < 800; ++ref) {
+    ASSERT_TRUE(table_.insert(ref, order(ref)));
+  }
+  // Sliding past them needs 800 overflow slots; only 314 exist, so the
+  // window stops after four pages and the new ref itself overflows
+  const uint64_t ahead = Table::kWindowRefs + 900;
+  EXPECT_TRUE(table_.insert(ahead, order(0)));
+  EXPECT_EQ(table_.window_base(), 4 * Table::kPageRefs);
+  EXPECT_EQ(table_.overflow_size(), 4 * Table::kPageRefs + 1);
+  EXPECT_EQ(table_.find(ahead), order(0));
+  for (uint64_t ref = 0; ref < 800; ++ref) {
+    ASSERT_EQ(table_.find(ref), order(ref));
+  }
+}
+
+TEST_F(OrderTableTest, RefusesInsertBeyondCapacity) {
+  for (uint64_t ref = 0; ref < CAPACITY; ++ref) {
+    ASSERT_TRUE(table_.insert(ref, order(ref)));
+  }
+  EXPECT_FALSE(table_.insert(CAPACITY, order(0)));
+  ASSERT_NE(table_.erase(3), nullptr);
+  EXPECT_TRUE(table_.insert(CAPACITY, order(0)));
+}
+
+TEST_F(OrderTableTest, MatchesUnorderedMapOverADayOfRefs) {
+  std::mt19937_64 rng(20240612);
+  std::unordered_map<uint64_t, Order *> model;
+  std::vector<uint64_t> live;
+  uint64_t next_ref = 700'000'000;
+
+  for (int step = 0; step < 200'000; ++step) {
+    // Fewer resting than the overflow holds: no insert is ever refused
+    const bool add = live.empty() ||
+                     (live.size() < 300 && rng() % 100 < 52);
+    if (add) {
+      // Mostly sequential refs, with occasional far outliers
+      const uint64_t key = rng() % 500 == 0 ? rng() : next_ref++;
+      Order *value = order(key);
+      const bool fresh = model.emplace(key, value).second;
+      ASSERT_EQ(table_.insert(key, value), fresh);
+      if (fresh) {
+        live.push_back(key);
+      }
+    } else {
+      // Cancel recent orders far more often than old ones
+      const std::size_t back = std::min<std::size_t>(
+          live.size() - 1, rng() % 4 == 0 ? rng() % live.size() : rng() % 8);
+      const std::size_t pick = live.size() - 1 - back;
+      const uint64_t key = live[pick];
+      live.erase(live.begin() + static_cast<std::ptrdiff_t>(pick));
+      ASSERT_EQ(table_.erase(key), model[key]);
+      model.erase(key);
+    }
+    ASSERT_EQ(table_.size(), model.size());
+  }
+  for (const auto &[key, value] : model) {
+    EXPECT_EQ(table_.find(key), value);
+  }
+  EXPECT_GT(table_.pages_recycled(), 0u);
+}
+
+// ============================================================================
+// OrderBook Integration
+// ============================================================================
+
+TEST(OrderBookTableTest, MatchesAndCancelsThroughTheTable) {
+  using Book = OrderBook<64, OrderTable<Order, 64>>;
+  Book::PoolType pool;
+  Book book(pool);
+  ASSERT_TRUE(book.add_order(1'000'001, 1000, 10, Side::Sell));
+  ASSERT_TRUE(book.add_order(1'000'002, 1001, 10, Side::Sell));
+  EXPECT_FALSE(book.add_order(1'000'002, 999, 10, Side::Buy));
+  ASSERT_TRUE(book.add_order(1'000'003, 1000, 15, Side::Buy)); // Fills 1
+  EXPECT_EQ(book.order_count(), 2u);
+  EXPECT_FALSE(book.cancel_order(1'000'001));
+  EXPECT_TRUE(book.cancel_order(1'000'002));
+  EXPECT_EQ(book.best_bid_volume(), 5u);
+  EXPECT_EQ(pool.allocated(), 1u);
+}
@@ -0,0 +1,235 @@
+/**
+ * @file parallel_scan_test.cpp
+ * @brief Unit tests for packet-boundary resync and the parallel scan.
+ */
+
+#include <gtest/gtest.h>
+#include <itch/parallel_scan.hpp>
+
+#include "test_captures.hpp"
+
+#include <string>
+#include <vector>
+
+namespace itch::test {
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace {
+
+constexpr uint32_t kFirstSec = 1'700'000'000;
+
+constexpr uint64_t kFirstNs = uint64_t{kFirstSec} * 1'000'000'000;
+constexpr uint64_t kTenthSec = 100'000'000;
+constexpr uint64_t kOneSec = 1'000'000'000;
+
+size_t varied_size(size_t i) { return 16 + (i * 37) % 90; }
+
+/**
+ * @brief Plant a well-formed fake record header in every seventh payload,
+ *        to lure resync().
+ */
+std::vector<CapturedPacket> with_lures(std::vector<CapturedPacket> packets) {
+  std::vector<char> fake;
+  put32(fake, kFirstSec);
+  put32(fake, 0);
+  put32(fake, 4);
+  put32(fake, 4);
+  for (size_t i = 3; i < packets.size(); i += 7) {
+    std::string &data = packets[i].data;
+    data.insert(data.find(':') + 1, fake.data(), fake.size());
+  }
+  return packets;
+}
+
+/**
+ * @brief Offsets of every packet record, from a sequential walk.
+ */
+std::vector<size_t> record_offsets(const PcapReader &reader) {
+  std::vector<size_t> offsets;
+  PacketCursor cursor = reader.first_packet();
+  PacketRecord record;
+  while (reader.next_packet(cursor, record)) {
+    offsets.push_back(record.offset);
+  }
+  return offsets;
+}
+
+std::vector<std::string> sequential(const PcapReader &reader) {
+  std::vector<std::string> out;
+  reader.for_each_packet(
+      [&](const char *data, size_t len) { out.emplace_back(data, len); });
+  return out;
+}
+
+/**
+ * @brief Per-range visitor collecting payloads in order.
+ */
+struct Collector {
+  std::vector<std::string> packets;
+
+  void operator()(const char *data, size_t len) {
+    packets.emplace_back(data, len);
+  }
+};
+
+std::vector<std::string> parallel(const PcapReader &reader, size_t threads) {
+  return parallel_for_each_packet(
+      reader, threads, std::vector<std::string>{},
+      [](size_t) { return Collector{}; },
+      [](std::vector<std::string> &all, Collector &range) {
+        all.insert(all.end(), range.packets.begin(), range.packets.end());
+      });
+}
+
+/**
+ * @brief resync() from every offset must land on the next real record.
+ */
+void expect_resync_exact(const PcapReader &reader) {
+  const std::vector<size_t> offsets = record_offsets(reader);
+  ASSERT_FALSE(offsets.empty());
+  size_t next = 0;
+  for (size_t o = offsets.front(); o <= reader.file_size(); ++o) {
+    while (next < offsets.size() && offsets[next] < o) {
+      ++next;
+    }
+    const size_t expected =
+        next < offsets.size() ? offsets[next] : reader.file_size();
+    ASSERT_EQ(reader.resync(o), expected) << "from offset " << o;
+  }
+}
+
+} // namespace
+
+// ============================================================================
+// Resync
+// ============================================================================
+
+TEST(PcapResyncTest, ClassicLandsOnNextRecordFromAnyOffset) {
+  TempFile tmp(classic_capture(with_lures(
+      numbered_packets(60, kFirstNs, kTenthSec, varied_size))));
+  PcapReader reader(tmp.path());
+  ASSERT_TRUE(reader.is_open());
+  expect_resync_exact(reader);
+  EXPECT_EQ(reader.resync(0), sizeof(PcapGlobalHeader));
+}
+
+TEST(PcapResyncTest, PcapNgLandsOnNextPacketBlockFromAnyOffset) {
+  TempFile tmp(pcapng_capture(
+      with_lures(numbered_packets(60, kFirstNs, kOneSec, varied_size)),
+      TsUnit::Micro));
+  PcapReader reader(tmp.path());
+  ASSERT_EQ(reader.format(), CaptureFormat::PcapNg);
+  expect_resync_exact(reader);
+}
+
+TEST(PcapResyncTest, RejectsTimestampsFarFromFirstPacket) {
+  std::vector<char> bytes = classic_capture(with_lures(
+      numbered_packets(20, kFirstNs, kTenthSec, varied_size)));
+  size_t at = 0;
+  {
+    TempFile original(bytes);
+    at = record_offsets(PcapReader(original.path()))[10];
+  }
+  // Packet 10's ts_sec jumps a year: no chain may start before it
+  const uint32_t year_later = kFirstSec + 365 * 86400;
+  for (int i = 0; i < 4; ++i) {
+    bytes[at + i] = static_cast<char>(year_later >> (i * 8));
+  }
+  TempFile tmp(bytes);
+  PcapReader reader(tmp.path());
+  EXPECT_GT(reader.resync(at - 1), at);
+}
+
+// ============================================================================
+// Range Splitting
+// ============================================================================
+
+TEST(SplitRangesTest, RangesPartitionEveryPacket) {
+  TempFile tmp(classic_capture(with_lures(
+      numbered_packets(500, kFirstNs, kTenthSec, varied_size))));
+  PcapReader reader(tmp.path());
+  const std::vector<std::string> all = sequential(reader);
+
+  for (size_t n = 1; n <= 9; ++n) {
+    const std::vector<ScanRange> ranges = split_ranges(reader, n);
+    ASSERT_EQ(ranges.size(), n);
+    EXPECT_EQ(ranges.front().begin, reader.first_packet().offset);
+    EXPECT_EQ(ranges.back().end, reader.file_size());
+
+    std::vector<std::string> joined;
+    for (size_t i = 0; i < ranges.size(); ++i) {
+      if (i > 0) {
+        EXPECT_EQ(ranges[i].begin, ranges[i - 1].end);
+      }
+      reader.for_each_packet_in({ranges[i].begin, 0}, {ranges[i].end, 0},
+                                [&](const char *data, size_t len) {
+                                  joined.emplace_back(data, len);
+                                });
+    }
+    EXPECT_EQ(joined, all) << n << " ranges";
+  }
+}
+
+TEST(SplitRangesTest, MultiSectionPcapNgStaysWhole) {
+  const std::vector<CapturedPacket> packets =
+      with_lures(numbered_packets(50, kFirstNs, kOneSec, varied_size));
+  std::vector<char> bytes;
+  pcapng_section(bytes, packets, TsUnit::Micro);
+  pcapng_section(bytes, packets, TsUnit::Micro);
+  TempFile tmp(bytes);
+  PcapReader reader(tmp.path());
+
+  const std::vector<ScanRange> ranges = split_ranges(reader, 4);
+  ASSERT_EQ(ranges.size(), 1u);
+  EXPECT_EQ(ranges[0].end, reader.file_size());
+}
+
+// ============================================================================
+// Parallel Scan
+// ============================================================================
+
+TEST(ParallelScanTest, ReductionMatchesSequentialScan) {
+  const std::vector<CapturedPacket> packets =
+      with_lures(numbered_packets(2000, kFirstNs, kTenthSec, varied_size));
+  for (const std::vector<char> &bytes :
+       {classic_capture(packets), pcapng_capture(packets, TsUnit::Micro)}) {
+    TempFile tmp(bytes);
+    PcapReader reader(tmp.path());
+    const std::vector<std::string> all = sequential(reader);
+    ASSERT_EQ(all.size(), 2000u);
+    EXPECT_EQ(parallel(reader, 4), all);
+    EXPECT_EQ(parallel(reader, 1), all);
+  }
+}
+
+TEST(ParallelScanTest, MoreThreadsThanPackets) {
+  TempFile tmp(classic_capture(with_lures(
+      numbered_packets(3, kFirstNs, kTenthSec, varied_size))));
+  PcapReader reader(tmp.path());
+  EXPECT_EQ(parallel(reader, 16), sequential(reader));
+}
+
+TEST(ParallelScanTest, VisitorsMayTakeTimestamps) {
+  TempFile tmp(classic_capture(with_lures(
+      numbered_packets(1000, kFirstNs, kTenthSec, varied_size))));
+  PcapReader reader(tmp.path());
+
+  struct Latest {
+    uint64_t ts_ns = 0;
+    void operator()(const char *, size_t, uint64_t ts) {
+      ts_ns = ts > ts_ns ? ts : ts_ns;
+    }
+  };
+  const uint64_t latest = parallel_for_each_packet(
+      reader, 3, uint64_t{0}, [](size_t) { return Latest{}; },
+      [](uint64_t &acc, const Latest &range) {
+        acc = range.ts_ns > acc ? range.ts_ns : acc;
+      });
+  EXPECT_EQ(latest, (uint64_t{kFirstSec} + 99) * 1'000'000'000 +
+                        900'000'000);
+}
+
+} // namespace itch::test
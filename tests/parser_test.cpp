@@ -24,7 +24,7 @@ struct CountingVisitor : DefaultVisitor {
   void on_order_executed(const OrderExecuted & /*msg*/) {
     ++order_executed_count;
   }
-  void on_system_event(const MessageHeader & /*msg*/) { ++system_event_count; }
+  void on_system_event(const SystemEvent & /*msg*/) { ++system_event_count; }
   void on_unknown(char msg_type, const char * /*data*/, size_t /*len*/) {
     ++unknown_count;
     last_unknown_type = msg_type;
@@ -212,6 +212,168 @@ TEST(ParserTest, ParseBuffer_IncompleteMessage_StopsEarly) {
   EXPECT_EQ(visitor.add_order_count, 1);
 }
 
+TEST(ParserTest, ParseBuffer_DrainsNonOrderMessages) {
+  // SystemEvent, OrderDelete, OrderCancel, AddOrder: previously the parser
+  // stopped at the first 'D' and lost everything after it.
+  std::vector<unsigned char> buffer;
+
+  unsigned char system_event[12] = {'S',  0x00, 0x00, 0x00, 0x01, 0x00,
+                                    0x00, 0x00, 0x00, 0x00, 0x01, 'O'};
+  unsigned char order_delete[19] = {'D',  0x00, 0x01, 0x00, 0x02, 0x00, 0x00,
+                                    0x3B, 0x9A, 0xCA, 0x00, 0x00, 0x00, 0x00,
+                                    0x00, 0x49, 0x96, 0x02, 0xD2};
+  unsigned char order_cancel[23] = {
+      'X',  0x00, 0x01, 0x00, 0x02, 0x00, 0x00, 0x3B, 0x9A, 0xCA, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x49, 0x96, 0x02, 0xD2, 0x00, 0x00, 0x00, 0x64};
+  unsigned char add_order[36] = {
+      'A',  0x00, 0x01, 0x00, 0x02, 0x00, 0x00, 0x3B, 0x9A, 0xCA, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x49, 0x96, 0x02, 0xD2, 'B',  0x00, 0x00, 0x01, 0xF4,
+      'A',  'A',  'P',  'L',  ' ',  ' ',  ' ',  ' ',  0x00, 0x0F, 0x42, 0x40};
+
+  buffer.insert(buffer.end(), system_event, system_event + 12);
+  buffer.insert(buffer.end(), order_delete, order_delete + 19);
+  buffer.insert(buffer.end(), order_cancel, order_cancel + 23);
+  buffer.insert(buffer.end(), add_order, add_order + 36);
+
+  struct FullVisitor : CountingVisitor {
+    int delete_count = 0;
+    int cancel_count = 0;
+    uint32_t cancelled_shares = 0;
+    char event_code = 0;
+
+    void on_system_event(const SystemEvent &msg) {
+      CountingVisitor::on_system_event(msg);
+      event_code = msg.event_code;
+    }
+    void on_order_delete(const OrderDelete &msg) {
+      ++delete_count;
+      EXPECT_EQ(static_cast<uint64_t>(msg.order_ref), 1234567890ull);
+    }
+    void on_order_cancel(const OrderCancel &msg) {
+      ++cancel_count;
+      cancelled_shares = msg.cancelled_shares;
+    }
+  };
+
+  FullVisitor visitor;
+  Parser parser;
+  size_t consumed = parser.parse_buffer(
+      reinterpret_cast<const char *>(buffer.data()), buffer.size(), visitor);
+
+  EXPECT_EQ(consumed, buffer.size());
+  EXPECT_EQ(visitor.system_event_count, 1);
+  EXPECT_EQ(visitor.event_code, 'O');
+  EXPECT_EQ(visitor.delete_count, 1);
+  EXPECT_EQ(visitor.cancel_count, 1);
+  EXPECT_EQ(visitor.cancelled_shares, 100u);
+  EXPECT_EQ(visitor.add_order_count, 1);
+  EXPECT_EQ(visitor.unknown_count, 0);
+}
+
+// ============================================================================
+// Batched Visitor Tests
+// ============================================================================
+
+struct BatchingVisitor : DefaultVisitor {
+  std::vector<size_t> add_batches;
+  std::vector<uint64_t> order_refs;
+  int single_add_count = 0;
+  int executed_count = 0;
+
+  void on_add_order_batch(MessageSpan<AddOrder> run) {
+    add_batches.push_back(run.size());
+    for (const AddOrder *msg : run) {
+      order_refs.push_back(static_cast<uint64_t>(msg->order_ref));
+    }
+  }
+  void on_add_order(const AddOrder & /*msg*/) { ++single_add_count; }
+  void on_order_executed(const OrderExecuted & /*msg*/) { ++executed_count; }
+};
+
+static_assert(has_batch_hooks_v<BatchingVisitor>);
+static_assert(BatchVisitor<BatchingVisitor, AddOrder>);
+static_assert(!BatchVisitor<BatchingVisitor, OrderExecuted>);
+static_assert(!has_batch_hooks_v<CountingVisitor>);
+
+std::vector<unsigned char> make_add_order(uint64_t order_ref) {
+  std::vector<unsigned char> msg(36, 0);
+  msg[0] = 'A';
+  for (int i = 0; i < 8; ++i) {
+    msg[11 + i] = static_cast<unsigned char>(order_ref >> (56 - i * 8));
+  }
+  msg[19] = 'B';
+  return msg;
+}
+
+TEST(ParserBatchTest, GroupsConsecutiveSameTypeRuns) {
+  std::vector<unsigned char> buffer;
+  std::vector<unsigned char> exec(31, 0);
+  exec[0] = 'E';
+
+  // A A A E A A
+  for (uint64_t ref : {1, 2, 3}) {
+    auto msg = make_add_order(ref);
+    buffer.insert(buffer.end(), msg.begin(), msg.end());
+  }
+  buffer.insert(buffer.end(), exec.begin(), exec.end());
+  for (uint64_t ref : {4, 5}) {
+    auto msg = make_add_order(ref);
+    buffer.insert(buffer.end(), msg.begin(), msg.end());
+  }
+
+  BatchingVisitor visitor;
+  Parser parser;
+  size_t consumed = parser.parse_buffer(
+      reinterpret_cast<const char *>(buffer.data()), buffer.size(), visitor);
+
+  EXPECT_EQ(consumed, buffer.size());
+  ASSERT_EQ(visitor.add_batches.size(), 2u);
+  EXPECT_EQ(visitor.add_batches[0], 3u);
+  EXPECT_EQ(visitor.add_batches[1], 2u);
+  EXPECT_EQ(visitor.order_refs, (std::vector<uint64_t>{1, 2, 3, 4, 5}));
+  EXPECT_EQ(visitor.single_add_count, 0);
+  EXPECT_EQ(visitor.executed_count, 1);
+}
+
+TEST(ParserBatchTest, SplitsLongRunsAtMaxBatch) {
+  constexpr size_t kMax = BatchDispatchTable<BatchingVisitor>::kMaxBatch;
+  std::vector<unsigned char> buffer;
+  for (uint64_t ref = 0; ref < kMax + 5; ++ref) {
+    auto msg = make_add_order(ref);
+    buffer.insert(buffer.end(), msg.begin(), msg.end());
+  }
+
+  BatchingVisitor visitor;
+  Parser parser;
+  size_t consumed = parser.parse_buffer(
+      reinterpret_cast<const char *>(buffer.data()), buffer.size(), visitor);
+
+  EXPECT_EQ(consumed, buffer.size());
+  ASSERT_EQ(visitor.add_batches.size(), 2u);
+  EXPECT_EQ(visitor.add_batches[0], kMax);
+  EXPECT_EQ(visitor.add_batches[1], 5u);
+  EXPECT_EQ(visitor.order_refs.back(), kMax + 4);
+}
+
+TEST(ParserBatchTest, StopsBeforeIncompleteTrailingMessage) {
+  std::vector<unsigned char> buffer;
+  for (uint64_t ref : {7, 8}) {
+    auto msg = make_add_order(ref);
+    buffer.insert(buffer.end(), msg.begin(), msg.end());
+  }
+  buffer.push_back('A'); // Start of a third, truncated AddOrder
+  buffer.push_back(0x00);
+
+  BatchingVisitor visitor;
+  Parser parser;
+  size_t consumed = parser.parse_buffer(
+      reinterpret_cast<const char *>(buffer.data()), buffer.size(), visitor);
+
+  EXPECT_EQ(consumed, 72u);
+  ASSERT_EQ(visitor.add_batches.size(), 1u);
+  EXPECT_EQ(visitor.add_batches[0], 2u);
+}
+
 // ============================================================================
 // get_message_size Tests
 // ============================================================================
@@ -219,7 +381,34 @@ TEST(ParserTest, ParseBuffer_IncompleteMessage_StopsEarly) {
 TEST(MessageSizeTest, KnownTypes) {
   EXPECT_EQ(get_message_size(msg_type::AddOrder), 36u);
   EXPECT_EQ(get_message_size(msg_type::OrderExecuted), 31u);
-  EXPECT_EQ(get_message_size(msg_type::SystemEvent), sizeof(MessageHeader));
+  EXPECT_EQ(get_message_size(msg_type::SystemEvent), 12u);
+}
+
+TEST(MessageSizeTest, AllItch50Types) {
+  // Sizes from the NASDAQ TotalView-ITCH 5.0 specification
+  EXPECT_EQ(get_message_size('S'), 12u);
+  EXPECT_EQ(get_message_size('R'), 39u);
+  EXPECT_EQ(get_message_size('H'), 25u);
+  EXPECT_EQ(get_message_size('Y'), 20u);
+  EXPECT_EQ(get_message_size('L'), 26u);
+  EXPECT_EQ(get_message_size('V'), 35u);
+  EXPECT_EQ(get_message_size('W'), 12u);
+  EXPECT_EQ(get_message_size('K'), 28u);
+  EXPECT_EQ(get_message_size('J'), 35u);
+  EXPECT_EQ(get_message_size('h'), 21u);
+  EXPECT_EQ(get_message_size('A'), 36u);
+  EXPECT_EQ(get_message_size('F'), 40u);
+  EXPECT_EQ(get_message_size('E'), 31u);
+  EXPECT_EQ(get_message_size('C'), 36u);
+  EXPECT_EQ(get_message_size('X'), 23u);
+  EXPECT_EQ(get_message_size('D'), 19u);
+  EXPECT_EQ(get_message_size('U'), 35u);
+  EXPECT_EQ(get_message_size('P'), 44u);
+  EXPECT_EQ(get_message_size('Q'), 40u);
+  EXPECT_EQ(get_message_size('B'), 19u);
+  EXPECT_EQ(get_message_size('I'), 50u);
+  EXPECT_EQ(get_message_size('N'), 20u);
+  EXPECT_EQ(get_message_size('O'), 48u);
 }
 
 TEST(MessageSizeTest, UnknownType_ReturnsZero) {
@@ -227,6 +416,233 @@ TEST(MessageSizeTest, UnknownType_ReturnsZero) {
   EXPECT_EQ(get_message_size('\0'), 0u);
 }
 
+// ============================================================================
+// Handled-Type Detection
+// ============================================================================
+
+struct OverloadedDeleteVisitor : DefaultVisitor {
+  int deletes = 0;
+  void on_order_delete(const OrderDelete & /*msg*/) { ++deletes; }
+  void on_order_delete(const OrderCancel & /*msg*/) { ++deletes; }
+};
+
+struct FullVisitor {
+  std::vector<char> types; ///< Type byte of every message, in order
+
+  template <typename Msg> void handle(const Msg & /*msg*/) {
+    types.push_back(Msg::kMsgType);
+  }
+  void on_system_event(const SystemEvent &m) { handle(m); }
+  void on_stock_directory(const StockDirectory &m) { handle(m); }
+  void on_stock_trading_action(const StockTradingAction &m) { handle(m); }
+  void on_reg_sho_restriction(const RegSHORestriction &m) { handle(m); }
+  void on_market_participant_position(const MarketParticipantPosition &m) {
+    handle(m);
+  }
+  void on_mwcb_decline_level(const MWCBDeclineLevel &m) { handle(m); }
+  void on_mwcb_status(const MWCBStatus &m) { handle(m); }
+  void on_ipo_quoting_period(const IPOQuotingPeriod &m) { handle(m); }
+  void on_luld_auction_collar(const LULDAuctionCollar &m) { handle(m); }
+  void on_operational_halt(const OperationalHalt &m) { handle(m); }
+  void on_add_order(const AddOrder &m) { handle(m); }
+  void on_add_order_mpid(const AddOrderMPID &m) { handle(m); }
+  void on_order_executed(const OrderExecuted &m) { handle(m); }
+  void on_order_executed_with_price(const OrderExecutedWithPrice &m) {
+    handle(m);
+  }
+  void on_order_cancel(const OrderCancel &m) { handle(m); }
+  void on_order_delete(const OrderDelete &m) { handle(m); }
+  void on_order_replace(const OrderReplace &m) { handle(m); }
+  void on_trade(const Trade &m) { handle(m); }
+  void on_cross_trade(const CrossTrade &m) { handle(m); }
+  void on_broken_trade(const BrokenTrade &m) { handle(m); }
+  void on_noii(const NOII &m) { handle(m); }
+  void on_retail_price_improvement(const RetailPriceImprovement &m) {
+    handle(m);
+  }
+  void on_direct_listing_capital_raise(const DirectListingCapitalRaise &m) {
+    handle(m);
+  }
+  void on_unknown(char /*type*/, const char * /*data*/, size_t /*len*/) {}
+};
+
+static_assert(HandlesMessage<CountingVisitor, AddOrder>);
+static_assert(HandlesMessage<CountingVisitor, SystemEvent>);
+static_assert(!HandlesMessage<CountingVisitor, OrderDelete>);
+static_assert(HandlesMessage<OverloadedDeleteVisitor, OrderDelete>);
+static_assert(HandledTypes<DefaultVisitor>::bits ==
+              std::array<uint64_t, 4>{});
+static_assert(HandledTypes<FullVisitor>::all);
+static_assert(!HandledTypes<CountingVisitor>::all);
+static_assert(HandledTypes<CountingVisitor>::test('A'));
+static_assert(!HandledTypes<CountingVisitor>::test('D'));
+
+TEST(ParserTest, ParseBuffer_StepsOverUnhandledTypes) {
+  // D A D D E D followed by an unknown byte
+  std::vector<char> buffer;
+  auto append = [&buffer](char type, size_t size) {
+    std::vector<char> msg(size, 0);
+    msg[0] = type;
+    buffer.insert(buffer.end(), msg.begin(), msg.end());
+  };
+  append('D', sizeof(OrderDelete));
+  append('A', sizeof(AddOrder));
+  append('D', sizeof(OrderDelete));
+  append('D', sizeof(OrderDelete));
+  append('E', sizeof(OrderExecuted));
+  append('D', sizeof(OrderDelete));
+  const size_t known_bytes = buffer.size();
+  buffer.push_back('Z');
+
+  CountingVisitor visitor;
+  Parser parser;
+  size_t consumed = parser.parse_buffer(buffer.data(), buffer.size(), visitor);
+
+  EXPECT_EQ(consumed, known_bytes);
+  EXPECT_EQ(visitor.add_order_count, 1);
+  EXPECT_EQ(visitor.order_executed_count, 1);
+  EXPECT_EQ(visitor.unknown_count, 1);
+  EXPECT_EQ(visitor.last_unknown_type, 'Z');
+}
+
+TEST(ParserTest, ParseBuffer_SkipRunStopsAtZeroByte) {
+  std::vector<char> buffer(sizeof(OrderDelete) * 2 + 4, 0);
+  buffer[0] = 'D';
+  buffer[sizeof(OrderDelete)] = 'D';
+
+  CountingVisitor visitor;
+  Parser parser;
+  size_t consumed = parser.parse_buffer(buffer.data(), buffer.size(), visitor);
+
+  EXPECT_EQ(consumed, sizeof(OrderDelete) * 2);
+  EXPECT_EQ(visitor.unknown_count, 1);
+  EXPECT_EQ(visitor.last_unknown_type, '\0');
+}
+
+TEST(ParserTest, ParseBuffer_OverloadedHookIsStillCalled) {
+  std::vector<char> buffer(sizeof(OrderDelete) * 3, 0);
+  for (size_t i = 0; i < 3; ++i) {
+    buffer[i * sizeof(OrderDelete)] = 'D';
+  }
+
+  OverloadedDeleteVisitor visitor;
+  Parser parser;
+  size_t consumed = parser.parse_buffer(buffer.data(), buffer.size(), visitor);
+
+  EXPECT_EQ(consumed, buffer.size());
+  EXPECT_EQ(visitor.deletes, 3);
+}
+
+// ============================================================================
+// Threaded Parse Loop
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief Every registered type, several times, in a scrambled order.
+ */
+std::vector<char> make_every_type_buffer() {
+  std::vector<char> buffer;
+  const auto &types = MessageRegistry::types;
+  for (size_t i = 0; i < types.size() * 5; ++i) {
+    const char type = types[(i * 7) % types.size()];
+    std::vector<char> msg(message_size(type), 0);
+    msg[0] = type;
+    buffer.insert(buffer.end(), msg.begin(), msg.end());
+  }
+  return buffer;
+}
+
+} // namespace
+
+TEST(ParserThreadedTest, MatchesTableLoopOnEveryType) {
+  const std::vector<char> buffer = make_every_type_buffer();
+  Parser parser;
+
+  FullVisitor table;
+  FullVisitor threaded;
+  EXPECT_EQ(parser.parse_buffer(buffer.data(), buffer.size(), table),
+            buffer.size());
+  EXPECT_EQ(parser.parse_buffer<ParseLoop::Threaded>(
+                buffer.data(), buffer.size(), threaded),
+            buffer.size());
+
+  EXPECT_EQ(threaded.types, table.types);
+  EXPECT_EQ(threaded.types.size(), MessageRegistry::types.size() * 5);
+}
+
+TEST(ParserThreadedTest, PartialVisitorSeesSameMessages) {
+  const std::vector<char> buffer = make_every_type_buffer();
+  Parser parser;
+
+  CountingVisitor table;
+  CountingVisitor threaded;
+  (void)parser.parse_buffer(buffer.data(), buffer.size(), table);
+  (void)parser.parse_buffer<ParseLoop::Threaded>(buffer.data(), buffer.size(),
+                                                 threaded);
+
+  EXPECT_EQ(threaded.add_order_count, 5);
+  EXPECT_EQ(threaded.add_order_count, table.add_order_count);
+  EXPECT_EQ(threaded.order_executed_count, table.order_executed_count);
+  EXPECT_EQ(threaded.system_event_count, table.system_event_count);
+}
+
+TEST(ParserThreadedTest, StopsAtIncompleteAndUnknownMessages) {
+  std::vector<char> buffer(sizeof(OrderDelete) + sizeof(AddOrder) - 1, 0);
+  buffer[0] = 'D';
+  buffer[sizeof(OrderDelete)] = 'A';
+
+  Parser parser;
+  CountingVisitor visitor;
+  EXPECT_EQ(parser.parse_buffer<ParseLoop::Threaded>(buffer.data(),
+                                                     buffer.size(), visitor),
+            sizeof(OrderDelete));
+  EXPECT_EQ(visitor.add_order_count, 0);
+  EXPECT_EQ(visitor.unknown_count, 0);
+
+  buffer[sizeof(OrderDelete)] = 'Z';
+  EXPECT_EQ(parser.parse_buffer<ParseLoop::Threaded>(buffer.data(),
+                                                     buffer.size(), visitor),
+            sizeof(OrderDelete));
+  EXPECT_EQ(visitor.unknown_count, 1);
+  EXPECT_EQ(visitor.last_unknown_type, 'Z');
+
+  EXPECT_EQ(parser.parse_buffer<ParseLoop::Threaded>(buffer.data(), 0,
+                                                     visitor),
+            0u);
+}
+
+TEST(ParserThreadedTest, SkipsUnhandledRunsLikeTableLoop) {
+  // D D A D [X cut short]: D and X are left to DefaultVisitor
+  std::vector<char> buffer;
+  for (char type : {'D', 'D', 'A', 'D', 'X'}) {
+    std::vector<char> msg(message_size(type), 0);
+    msg[0] = type;
+    buffer.insert(buffer.end(), msg.begin(), msg.end());
+  }
+  const size_t length = buffer.size() - 1;
+  const size_t complete = length - (sizeof(OrderCancel) - 1);
+
+  Parser parser;
+  CountingVisitor table;
+  CountingVisitor threaded;
+  EXPECT_EQ(parser.parse_buffer(buffer.data(), length, table), complete);
+  EXPECT_EQ(parser.parse_buffer<ParseLoop::Threaded>(buffer.data(), length,
+                                                     threaded),
+            complete);
+  EXPECT_EQ(threaded.add_order_count, 1);
+  EXPECT_EQ(threaded.unknown_count, 0);
+
+  // An unknown type after a skipped run still reaches on_unknown
+  buffer[complete] = 'Z';
+  EXPECT_EQ(parser.parse_buffer<ParseLoop::Threaded>(buffer.data(), length,
+                                                     threaded),
+            complete);
+  EXPECT_EQ(threaded.unknown_count, 1);
+  EXPECT_EQ(threaded.last_unknown_type, 'Z');
+}
+
 // ============================================================================
 // Convenience Function Test
 // ============================================================================
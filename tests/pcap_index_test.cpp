@@ -0,0 +1,283 @@
+/**
+ * @file pcap_index_test.cpp
+ * @brief Unit tests for the sidecar packet index and cursor seeking.
+ */
+
+#include <gtest/gtest.h>
+#include <itch/pcap_index.hpp>
+
+#include "test_captures.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace itch::test {
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace {
+
+constexpr uint64_t kBaseNs = 1'700'000'000'000'000'000ull;
+constexpr uint64_t kSpacingNs = 1'000; // Between consecutive packets
+
+/**
+ * @brief TempFile whose sidecar index is removed along with it.
+ */
+class IndexedFile : public TempFile {
+public:
+  explicit IndexedFile(const std::vector<char> &contents)
+      : TempFile(contents, "index"),
+        index_path_(PcapIndex::default_path(path())) {}
+
+  ~IndexedFile() { std::remove(index_path_.c_str()); }
+
+  [[nodiscard]] const char *index_path() const { return index_path_.c_str(); }
+
+private:
+  std::string index_path_;
+};
+
+uint64_t ts_of(size_t i) { return kBaseNs + i * kSpacingNs; }
+
+/// pcapng after-packet hook: a non-packet block after every fifth packet
+void filler_block(std::vector<char> &out, size_t i) {
+  if (i % 5 == 4) {
+    pcapng_block(out, 0x00000BAD, std::vector<char>(8, 'x'));
+  }
+}
+
+/**
+ * @brief Payloads in [from, to), via the range iterator.
+ */
+std::vector<std::string> collect(const PcapReader &reader, PacketCursor from,
+                                 PacketCursor to) {
+  std::vector<std::string> out;
+  reader.for_each_packet_in(from, to, [&](const char *data, size_t len) {
+    out.emplace_back(data, len);
+  });
+  return out;
+}
+
+std::string packet_at(const PcapReader &reader, PacketCursor cursor) {
+  PacketRecord record;
+  if (!reader.next_packet(cursor, record)) {
+    return "<end>";
+  }
+  return std::string(record.data, record.length);
+}
+
+} // namespace
+
+// ============================================================================
+// Cursor API
+// ============================================================================
+
+TEST(PcapCursorTest, NextPacketWalksWholeCapture) {
+  IndexedFile tmp(classic_capture(
+      numbered_packets(10, kBaseNs, kSpacingNs), TsUnit::Nano));
+  PcapReader reader(tmp.path());
+  ASSERT_TRUE(reader.is_open());
+
+  PacketCursor cursor = reader.first_packet();
+  PacketRecord record;
+  size_t n = 0;
+  while (reader.next_packet(cursor, record)) {
+    EXPECT_EQ(std::string(record.data, record.length), numbered_payload(n));
+    EXPECT_EQ(record.ts_ns, ts_of(n));
+    ++n;
+    EXPECT_EQ(cursor.packet, n);
+  }
+  EXPECT_EQ(n, 10u);
+  EXPECT_EQ(cursor.offset, reader.file_size());
+}
+
+TEST(PcapCursorTest, RangeToEndMatchesForEachPacket) {
+  IndexedFile tmp(pcapng_capture(
+      numbered_packets(12, kBaseNs, kSpacingNs), TsUnit::Nano, filler_block));
+  PcapReader reader(tmp.path());
+  ASSERT_TRUE(reader.is_open());
+
+  std::vector<std::string> all;
+  reader.for_each_packet(
+      [&](const char *data, size_t len) { all.emplace_back(data, len); });
+  EXPECT_EQ(collect(reader, reader.first_packet(), reader.end_of_capture()),
+            all);
+  EXPECT_EQ(all.size(), 12u);
+}
+
+// ============================================================================
+// Index Build and Validation
+// ============================================================================
+
+TEST(PcapIndexTest, BuildsOneEntryPerStride) {
+  IndexedFile tmp(classic_capture(
+      numbered_packets(1000, kBaseNs, kSpacingNs), TsUnit::Nano));
+  PcapReader reader(tmp.path());
+  ASSERT_TRUE(PcapIndex::build(reader, tmp.index_path(), 64));
+
+  PcapIndex index;
+  ASSERT_TRUE(index.open(tmp.index_path(), reader));
+  EXPECT_EQ(index.stride(), 64u);
+  EXPECT_EQ(index.packet_count(), 1000u);
+  ASSERT_EQ(index.entry_count(), 16u); // ceil(1000 / 64)
+  EXPECT_EQ(index.entry(0).offset, sizeof(PcapGlobalHeader));
+  EXPECT_EQ(index.entry(3).ts_ns, ts_of(3 * 64));
+  EXPECT_EQ(index.end().packet, 1000u);
+
+  FILE *f = std::fopen(tmp.index_path(), "rb");
+  ASSERT_NE(f, nullptr);
+  std::fseek(f, 0, SEEK_END);
+  EXPECT_EQ(std::ftell(f), 48 + 16 * 16);
+  std::fclose(f);
+}
+
+TEST(PcapIndexTest, RefusesIndexOfAnotherCapture) {
+  IndexedFile a(classic_capture(
+      numbered_packets(100, kBaseNs, kSpacingNs), TsUnit::Nano));
+  std::vector<char> other = classic_capture(
+      numbered_packets(100, kBaseNs, kSpacingNs), TsUnit::Nano);
+  other[sizeof(PcapGlobalHeader) + 16] = 'X'; // Same size, other bytes
+  IndexedFile b(other);
+
+  PcapReader reader_a(a.path());
+  PcapReader reader_b(b.path());
+  ASSERT_TRUE(PcapIndex::build(reader_a, a.index_path(), 8));
+
+  PcapIndex index;
+  EXPECT_FALSE(index.open(a.index_path(), reader_b));
+  EXPECT_FALSE(index.is_open());
+  EXPECT_TRUE(index.open(a.index_path(), reader_a));
+}
+
+TEST(PcapIndexTest, RefusesMissingOrMalformedIndex) {
+  IndexedFile tmp(classic_capture(
+      numbered_packets(10, kBaseNs, kSpacingNs), TsUnit::Nano));
+  PcapReader reader(tmp.path());
+  PcapIndex index;
+  EXPECT_FALSE(index.open(tmp.index_path(), reader)); // Not built yet
+
+  IndexedFile junk(std::vector<char>(64, 'j'));
+  EXPECT_FALSE(index.open(junk.path(), reader));
+  EXPECT_FALSE(PcapIndex::build(reader, tmp.index_path(), 0));
+}
+
+// ============================================================================
+// Seeking
+// ============================================================================
+
+TEST(PcapIndexTest, SeekToPacketLandsOnThatPacket) {
+  IndexedFile tmp(classic_capture(
+      numbered_packets(1000, kBaseNs, kSpacingNs), TsUnit::Nano));
+  PcapReader reader(tmp.path());
+  ASSERT_TRUE(PcapIndex::build(reader, tmp.index_path(), 64));
+  PcapIndex index;
+  ASSERT_TRUE(index.open(tmp.index_path(), reader));
+
+  for (uint64_t n : {0u, 1u, 63u, 64u, 65u, 500u, 999u}) {
+    const PacketCursor cursor = reader.seek_to_packet(index, n);
+    EXPECT_EQ(cursor.packet, n);
+    EXPECT_EQ(packet_at(reader, cursor), numbered_payload(n));
+  }
+  EXPECT_EQ(reader.seek_to_packet(index, 1000).offset, reader.file_size());
+}
+
+TEST(PcapIndexTest, SeekToTimeFindsFirstPacketAtOrAfter) {
+  IndexedFile tmp(classic_capture(
+      numbered_packets(1000, kBaseNs, kSpacingNs), TsUnit::Nano));
+  PcapReader reader(tmp.path());
+  ASSERT_TRUE(PcapIndex::build(reader, tmp.index_path(), 64));
+  PcapIndex index;
+  ASSERT_TRUE(index.open(tmp.index_path(), reader));
+
+  EXPECT_EQ(reader.seek_to_time(index, ts_of(300)).packet, 300u);
+  EXPECT_EQ(reader.seek_to_time(index, ts_of(300) + 1).packet, 301u);
+  EXPECT_EQ(reader.seek_to_time(index, ts_of(128)).packet, 128u);
+  EXPECT_EQ(reader.seek_to_time(index, 0).packet, 0u);
+  EXPECT_EQ(packet_at(reader, reader.seek_to_time(index, ts_of(777))),
+            numbered_payload(777));
+  EXPECT_EQ(reader.seek_to_time(index, ts_of(999) + 1).offset,
+            reader.file_size());
+}
+
+TEST(PcapIndexTest, SeekToTimeLandsOnFirstOfRepeatedTimestamps) {
+  // Seconds {1,2,2,2,2,2,2,3}: index entries 1..3 all stamped 2s
+  constexpr uint64_t kSecondsOf[] = {1, 2, 2, 2, 2, 2, 2, 3};
+  std::vector<CapturedPacket> packets = numbered_packets(8, 0, 0);
+  for (size_t i = 0; i < packets.size(); ++i) {
+    packets[i].ts_ns = kSecondsOf[i] * 1'000'000'000ull;
+  }
+  IndexedFile tmp(classic_capture(packets, TsUnit::Nano));
+  PcapReader reader(tmp.path());
+  ASSERT_TRUE(PcapIndex::build(reader, tmp.index_path(), 2));
+  PcapIndex index;
+  ASSERT_TRUE(index.open(tmp.index_path(), reader));
+
+  EXPECT_EQ(reader.seek_to_time(index, 2'000'000'000ull).packet, 1u);
+  EXPECT_EQ(reader.seek_to_time(index, 3'000'000'000ull).packet, 7u);
+  EXPECT_EQ(reader.seek_to_time(index, 1'000'000'000ull).packet, 0u);
+}
+
+TEST(PcapIndexTest, TimeSliceIteratesHalfOpenRange) {
+  IndexedFile tmp(classic_capture(
+      numbered_packets(1000, kBaseNs, kSpacingNs), TsUnit::Nano));
+  PcapReader reader(tmp.path());
+  ASSERT_TRUE(PcapIndex::build(reader, tmp.index_path(), 32));
+  PcapIndex index;
+  ASSERT_TRUE(index.open(tmp.index_path(), reader));
+
+  const PacketCursor from = reader.seek_to_time(index, ts_of(250));
+  const PacketCursor to = reader.seek_to_time(index, ts_of(260));
+  std::vector<uint64_t> stamps;
+  const size_t n = reader.for_each_packet_in(
+      from, to,
+      [&](const char *, size_t, uint64_t ts_ns) { stamps.push_back(ts_ns); });
+
+  ASSERT_EQ(n, 10u);
+  EXPECT_EQ(stamps.front(), ts_of(250));
+  EXPECT_EQ(stamps.back(), ts_of(259));
+  EXPECT_EQ(collect(reader, reader.seek_to_packet(index, 990), index.end())
+                .size(),
+            10u);
+}
+
+TEST(PcapIndexTest, PcapNgSeekSkipsNonPacketBlocks) {
+  IndexedFile tmp(pcapng_capture(
+      numbered_packets(200, kBaseNs, kSpacingNs), TsUnit::Nano, filler_block));
+  PcapReader reader(tmp.path());
+  ASSERT_EQ(reader.format(), CaptureFormat::PcapNg);
+  ASSERT_TRUE(PcapIndex::build(reader, tmp.index_path(), 16));
+  PcapIndex index;
+  ASSERT_TRUE(index.open(tmp.index_path(), reader));
+  EXPECT_EQ(index.packet_count(), 200u);
+
+  for (uint64_t n : {0u, 4u, 5u, 16u, 79u, 80u, 199u}) {
+    EXPECT_EQ(packet_at(reader, reader.seek_to_packet(index, n)),
+              numbered_payload(n));
+  }
+
+  // Packet 20 follows a non-packet block that must stay out of the range
+  const std::vector<std::string> slice =
+      collect(reader, reader.seek_to_time(index, ts_of(15)),
+              reader.seek_to_packet(index, 20));
+  ASSERT_EQ(slice.size(), 5u);
+  EXPECT_EQ(slice.back(), numbered_payload(19));
+}
+
+TEST(PcapIndexTest, RefusesMultiSectionPcapNg) {
+  std::vector<char> bytes = pcapng_capture(
+      numbered_packets(10, kBaseNs, kSpacingNs), TsUnit::Nano, filler_block);
+  const std::vector<char> second = pcapng_capture(
+      numbered_packets(10, kBaseNs, kSpacingNs), TsUnit::Nano, filler_block);
+  bytes.insert(bytes.end(), second.begin(), second.end());
+  IndexedFile tmp(bytes);
+
+  PcapReader reader(tmp.path());
+  ASSERT_TRUE(reader.is_open());
+  EXPECT_FALSE(PcapIndex::build(reader, tmp.index_path()));
+}
+
+} // namespace itch::test
@@ -0,0 +1,319 @@
+/**
+ * @file pcap_reader_test.cpp
+ * @brief Unit tests for the mmap'd PCAP / pcapng reader.
+ */
+
+#include <gtest/gtest.h>
+#include <itch/pcap_reader.hpp>
+
+#include "test_captures.hpp"
+
+#include <string>
+#include <vector>
+
+namespace itch::test {
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace {
+
+constexpr ByteOrder kBig = ByteOrder::Big;
+
+/**
+ * @brief Interface that also carries an if_name option, so every test
+ *        exercises skipping of unrelated options.
+ */
+PcapNgInterfaceSpec named(LinkType link, uint32_t snaplen = 0,
+                          int tsresol = -1) {
+  return {link, snaplen, tsresol, "em1"};
+}
+
+std::vector<uint64_t> timestamps(const PcapReader &reader) {
+  std::vector<uint64_t> out;
+  reader.for_each_packet(
+      [&](const char *, size_t, uint64_t ts_ns) { out.push_back(ts_ns); });
+  return out;
+}
+
+std::vector<std::string> collect(const PcapReader &reader) {
+  std::vector<std::string> packets;
+  reader.for_each_packet([&](const char *data, size_t len) {
+    packets.emplace_back(data, len);
+  });
+  return packets;
+}
+
+} // namespace
+
+// ============================================================================
+// Classic PCAP
+// ============================================================================
+
+TEST(PcapReaderTest, ClassicPcapSingleInterface) {
+  TempFile tmp(classic_capture({{1'000'000'002, "first"},
+                                 {1'000'000'002, "second!"}},
+                                TsUnit::Nano, 65535, LinkType::LinuxSll));
+
+  PcapReader reader(tmp.path());
+  ASSERT_TRUE(reader.is_open());
+  EXPECT_EQ(reader.format(), CaptureFormat::Pcap);
+  EXPECT_EQ(reader.link_type(), LinkType::LinuxSll);
+  ASSERT_EQ(reader.interface_count(), 1u);
+  EXPECT_EQ(reader.interface(0).snaplen, 65535u);
+  EXPECT_EQ(reader.interface(0).tsresol, 9);
+  EXPECT_EQ(collect(reader), (std::vector<std::string>{"first", "second!"}));
+}
+
+TEST(PcapReaderTest, EveryMapStrategyIteratesSamePackets) {
+  std::vector<char> out;
+  pcapng_section_header(out);
+  pcapng_interface(out, named(LinkType::Ethernet));
+  pcapng_enhanced_packet(out, 0, 0, "one");
+  pcapng_enhanced_packet(out, 0, 0, "two");
+  TempFile tmp(out);
+
+  for (MapStrategy strategy : {MapStrategy::Populate, MapStrategy::ReadAhead,
+                               MapStrategy::HugeCopy}) {
+    PcapReader reader(tmp.path(), {strategy});
+    ASSERT_TRUE(reader.is_open());
+    EXPECT_EQ(reader.mapping().strategy(), strategy);
+    EXPECT_EQ(reader.format(), CaptureFormat::PcapNg);
+    EXPECT_EQ(collect(reader), (std::vector<std::string>{"one", "two"}));
+  }
+}
+
+// ============================================================================
+// pcapng
+// ============================================================================
+
+TEST(PcapReaderTest, PcapNgInterfacesAndPackets) {
+  std::vector<char> out;
+  pcapng_section_header(out);
+  pcapng_interface(out, named(LinkType::Ethernet));
+  pcapng_interface(out, named(LinkType::Ethernet, 9000, 9));
+  pcapng_enhanced_packet(out, 0, 1, "abc"); // Padded to 4
+  pcapng_block(out, 4, std::vector<char>(8, 'x')); // Name Resolution: skipped
+  pcapng_enhanced_packet(out, 1, 2, "ITCH-payload");
+  TempFile tmp(out);
+
+  PcapReader reader(tmp.path());
+  ASSERT_TRUE(reader.is_open());
+  EXPECT_EQ(reader.format(), CaptureFormat::PcapNg);
+  EXPECT_EQ(reader.link_type(), LinkType::Ethernet);
+  ASSERT_EQ(reader.interface_count(), 2u);
+  EXPECT_EQ(reader.interface(0).tsresol, 6); // Default: microseconds
+  EXPECT_EQ(reader.interface(1).link_type, LinkType::Ethernet);
+  EXPECT_EQ(reader.interface(1).snaplen, 9000u);
+  EXPECT_EQ(reader.interface(1).tsresol, 9);
+
+  EXPECT_EQ(collect(reader),
+            (std::vector<std::string>{"abc", "ITCH-payload"}));
+}
+
+TEST(PcapReaderTest, PcapNgRejectsMixedLinkTypes) {
+  std::vector<char> out;
+  pcapng_section_header(out);
+  pcapng_interface(out, named(LinkType::Ethernet));
+  pcapng_interface(out, named(LinkType::LinuxSll));
+  pcapng_enhanced_packet(out, 1, 1, "cooked");
+  TempFile tmp(out);
+
+  PcapReader reader;
+  EXPECT_FALSE(reader.open(tmp.path()));
+  EXPECT_FALSE(reader.is_open());
+}
+
+TEST(PcapReaderTest, PcapNgStopsAtLaterInterfaceOfAnotherLinkType) {
+  std::vector<char> out;
+  pcapng_section_header(out);
+  pcapng_interface(out, named(LinkType::Ethernet));
+  pcapng_enhanced_packet(out, 0, 1, "first");
+  pcapng_interface(out, named(LinkType::Ethernet));
+  pcapng_enhanced_packet(out, 1, 2, "second");
+  pcapng_interface(out, named(LinkType::LinuxSll));
+  pcapng_enhanced_packet(out, 2, 3, "cooked");
+  TempFile tmp(out);
+
+  PcapReader reader(tmp.path());
+  ASSERT_TRUE(reader.is_open());
+  EXPECT_EQ(collect(reader), (std::vector<std::string>{"first", "second"}));
+  EXPECT_FALSE(reader.single_section());
+
+  PacketCursor cursor = reader.first_packet();
+  PacketRecord record;
+  EXPECT_TRUE(reader.next_packet(cursor, record));
+  EXPECT_TRUE(reader.next_packet(cursor, record));
+  EXPECT_EQ(std::string(record.data, record.length), "second");
+  EXPECT_FALSE(reader.next_packet(cursor, record));
+}
+
+TEST(PcapReaderTest, PcapNgPayloadIsZeroCopy) {
+  std::vector<char> out;
+  pcapng_section_header(out);
+  pcapng_interface(out, named(LinkType::Ethernet));
+  const size_t epb_at = out.size();
+  pcapng_enhanced_packet(out, 0, 0, "zero-copy");
+  TempFile tmp(out);
+
+  PcapReader reader(tmp.path());
+  ASSERT_TRUE(reader.is_open());
+  const char *seen = nullptr;
+  EXPECT_EQ(reader.for_each_packet(
+                [&](const char *data, size_t) { seen = data; }),
+            1u);
+  // Past the block header and the fixed EPB fields, straight into the map
+  EXPECT_EQ(seen, reader.data() + epb_at + sizeof(PcapNgBlockHeader) +
+                      sizeof(PcapNgEnhancedPacketHeader));
+}
+
+TEST(PcapReaderTest, PcapNgBigEndianSection) {
+  std::vector<char> out;
+  pcapng_section_header(out, kBig);
+  pcapng_interface(out, named(LinkType::LinuxSll2, 1500, 0x80 | 20), kBig);
+  pcapng_enhanced_packet(out, 0, 7, "big-endian", kBig);
+  TempFile tmp(out);
+
+  PcapReader reader(tmp.path());
+  ASSERT_TRUE(reader.is_open());
+  EXPECT_EQ(reader.link_type(), LinkType::LinuxSll2);
+  EXPECT_EQ(reader.interface(0).tsresol, 0x80 | 20);
+  EXPECT_EQ(collect(reader), std::vector<std::string>{"big-endian"});
+}
+
+TEST(PcapReaderTest, PcapNgSimplePacketTruncatedToSnaplen) {
+  std::vector<char> out;
+  pcapng_section_header(out);
+  pcapng_interface(out, named(LinkType::Ethernet, 4));
+  pcapng_simple_packet(out, 8, "abcd"); // 8-byte frame, 4 captured
+  TempFile tmp(out);
+
+  PcapReader reader(tmp.path());
+  ASSERT_TRUE(reader.is_open());
+  EXPECT_EQ(collect(reader), std::vector<std::string>{"abcd"});
+}
+
+TEST(PcapReaderTest, PcapNgSimplePacketExcludesPadding) {
+  std::vector<char> out;
+  pcapng_section_header(out);
+  pcapng_interface(out, named(LinkType::Ethernet));
+  pcapng_simple_packet(out, 3, "abc"); // Padded to 4 in the block
+  TempFile tmp(out);
+
+  PcapReader reader(tmp.path());
+  ASSERT_TRUE(reader.is_open());
+  EXPECT_EQ(collect(reader), std::vector<std::string>{"abc"});
+}
+
+TEST(PcapReaderTest, PcapNgNewSectionSwitchesByteOrder) {
+  std::vector<char> out;
+  pcapng_section_header(out);
+  pcapng_interface(out, named(LinkType::Ethernet));
+  pcapng_enhanced_packet(out, 0, 0, "little");
+  pcapng_section_header(out, kBig);
+  pcapng_interface(out, named(LinkType::Ethernet), kBig);
+  pcapng_enhanced_packet(out, 0, 0, "big", kBig);
+  TempFile tmp(out);
+
+  PcapReader reader(tmp.path());
+  ASSERT_TRUE(reader.is_open());
+  EXPECT_EQ(collect(reader), (std::vector<std::string>{"little", "big"}));
+}
+
+TEST(PcapReaderTest, PcapNgStopsAtTruncatedBlock) {
+  std::vector<char> out;
+  pcapng_section_header(out);
+  pcapng_interface(out, named(LinkType::Ethernet));
+  pcapng_enhanced_packet(out, 0, 0, "kept");
+  pcapng_enhanced_packet(out, 0, 0, "cut off");
+  out.resize(out.size() - 6);
+  TempFile tmp(out);
+
+  PcapReader reader(tmp.path());
+  ASSERT_TRUE(reader.is_open());
+  EXPECT_EQ(collect(reader), std::vector<std::string>{"kept"});
+}
+
+TEST(PcapReaderTest, RejectsBadByteOrderMagic) {
+  std::vector<char> out;
+  pcapng_section_header(out);
+  out[8] = 0x11;
+  TempFile tmp(out);
+
+  PcapReader reader;
+  EXPECT_FALSE(reader.open(tmp.path()));
+  EXPECT_FALSE(reader.is_open());
+}
+
+// ============================================================================
+// Packet Timestamps
+// ============================================================================
+
+TEST(PcapReaderTest, ClassicMicrosecondTimestamps) {
+  TempFile tmp(classic_capture({{1'700'000'000'123'456'000ull, "a"},
+                                 {1'700'000'001'000'000'000ull, "b"}}));
+
+  PcapReader reader(tmp.path());
+  ASSERT_TRUE(reader.is_open());
+  EXPECT_EQ(timestamps(reader),
+            (std::vector<uint64_t>{1'700'000'000'123'456'000ull,
+                                   1'700'000'001'000'000'000ull}));
+}
+
+TEST(PcapReaderTest, ClassicNanosecondTimestamps) {
+  std::vector<char> out; // Swapped-order file
+  classic_header(out, TsUnit::Nano, LinkType::Ethernet, 65535, kBig);
+  classic_record(out, 1'700'000'000, 123'456'789, "a", kBig);
+  TempFile tmp(out);
+
+  PcapReader reader(tmp.path());
+  ASSERT_TRUE(reader.is_open());
+  EXPECT_EQ(timestamps(reader),
+            std::vector<uint64_t>{1'700'000'000'123'456'789ull});
+}
+
+TEST(PcapReaderTest, PcapNgTimestampsUsePerInterfaceResolution) {
+  std::vector<char> out;
+  pcapng_section_header(out);
+  pcapng_interface(out, named(LinkType::Ethernet));              // us
+  pcapng_interface(out, named(LinkType::Ethernet, 0, 9));        // ns
+  pcapng_interface(out, named(LinkType::Ethernet, 0, 0x80 | 1)); // 1/2 s
+  pcapng_enhanced_packet(out, 0, 1'700'000'000'000'001ull, "us");
+  pcapng_enhanced_packet(out, 1, 1'700'000'000'000'000'002ull, "ns");
+  pcapng_enhanced_packet(out, 2, 3, "2^-1");
+  pcapng_simple_packet(out, 3, "spb"); // No timestamp: repeats the last one
+  TempFile tmp(out);
+
+  PcapReader reader(tmp.path());
+  ASSERT_TRUE(reader.is_open());
+  EXPECT_EQ(timestamps(reader),
+            (std::vector<uint64_t>{1'700'000'000'000'001'000ull,
+                                   1'700'000'000'000'000'002ull,
+                                   1'500'000'000ull, 1'500'000'000ull}));
+}
+
+// ============================================================================
+// Timestamp Resolution
+// ============================================================================
+
+TEST(PcapReaderTest, InterfaceTimestampToNanos) {
+  PcapInterface iface;
+  EXPECT_EQ(iface.to_nanos(1'500'000), 1'500'000'000u); // Default: µs
+
+  iface.tsresol = 9;
+  EXPECT_EQ(iface.to_nanos(42), 42u);
+
+  iface.tsresol = 12; // Picoseconds
+  EXPECT_EQ(iface.to_nanos(5'000), 5u);
+
+  iface.tsresol = 0x80 | 10; // 1/1024 s
+  EXPECT_EQ(iface.to_nanos(1024), 1'000'000'000u);
+  EXPECT_EQ(iface.to_nanos(512), 500'000'000u);
+
+  // 2^-32 s ticks over a whole day must not overflow
+  iface.tsresol = 0x80 | 32;
+  EXPECT_EQ(iface.to_nanos(86'400ull << 32), 86'400'000'000'000u);
+}
+
+} // namespace itch::test
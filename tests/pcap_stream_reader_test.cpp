@@ -0,0 +1,283 @@
+/**
+ * @file pcap_stream_reader_test.cpp
+ * @brief Unit tests for ChunkedFile and the streaming PCAP reader.
+ */
+
+#include <gtest/gtest.h>
+#include <itch/pcap_stream_reader.hpp>
+
+#include "test_captures.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace itch::test {
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace {
+
+constexpr uint64_t kFirstNs = 1'700'000'000ull * 1'000'000'000;
+constexpr uint64_t kTenthSec = 100'000'000;
+
+/// Classic snaplen large enough for the oversize records
+constexpr uint32_t kBigSnaplen = 0x00FFFFFF;
+
+/// Smallest ring buffer: records straddle buffers all the time
+constexpr size_t kTinyBuffer = ChunkedFile::kAlignment;
+
+size_t varied_size(size_t i) { return 10 + (i * 37) % 300; }
+
+/// pcapng after-packet hook: a Simple Packet Block after every fifth EPB
+void simple_packet_filler(std::vector<char> &out, size_t i) {
+  if (i % 5 == 4) {
+    pcapng_simple_packet(out, 6, "simple");
+  }
+}
+
+using Packet = std::pair<std::string, uint64_t>;
+
+std::vector<Packet> mapped_packets(const char *path) {
+  std::vector<Packet> out;
+  PcapReader reader(path);
+  reader.for_each_packet([&](const char *data, size_t len, uint64_t ts) {
+    out.emplace_back(std::string(data, len), ts);
+  });
+  return out;
+}
+
+std::vector<Packet> streamed_packets(PcapStreamReader &reader) {
+  std::vector<Packet> out;
+  const size_t count =
+      reader.for_each_packet([&](const char *data, size_t len, uint64_t ts) {
+        out.emplace_back(std::string(data, len), ts);
+      });
+  EXPECT_EQ(count, out.size());
+  return out;
+}
+
+StreamOptions tiny(StreamBackend backend) {
+  StreamOptions options;
+  options.backend = backend;
+  options.buffer_bytes = kTinyBuffer;
+  options.buffer_count = 3;
+  return options;
+}
+
+} // namespace
+
+// ============================================================================
+// ChunkedFile
+// ============================================================================
+
+class ChunkedFileTest : public ::testing::TestWithParam<StreamBackend> {};
+
+TEST_P(ChunkedFileTest, StreamsFileBytesInOrder) {
+  std::vector<char> bytes(kTinyBuffer * 7 + 123);
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    bytes[i] = static_cast<char>(i * 31 + i / 4096);
+  }
+  TempFile tmp(bytes);
+
+  ChunkedFile file;
+  ASSERT_TRUE(file.open(tmp.path(), tiny(GetParam())));
+  EXPECT_EQ(file.size(), bytes.size());
+  EXPECT_EQ(file.memory_bytes(), 3 * kTinyBuffer);
+
+  // Twice: start() rewinds
+  for (int pass = 0; pass < 2; ++pass) {
+    ASSERT_TRUE(file.start());
+    std::vector<char> streamed;
+    const char *chunk = nullptr;
+    size_t length = 0;
+    while (file.next(chunk, length)) {
+      streamed.insert(streamed.end(), chunk, chunk + length);
+    }
+    EXPECT_FALSE(file.failed());
+    EXPECT_EQ(streamed, bytes);
+  }
+}
+
+TEST_P(ChunkedFileTest, StopsEarlyWithoutLeakingReads) {
+  TempFile tmp(std::vector<char>(kTinyBuffer * 20, 'x'));
+  ChunkedFile file;
+  ASSERT_TRUE(file.open(tmp.path(), tiny(GetParam())));
+  ASSERT_TRUE(file.start());
+  const char *chunk = nullptr;
+  size_t length = 0;
+  ASSERT_TRUE(file.next(chunk, length));
+  file.close(); // Reads still in flight are drained
+  EXPECT_FALSE(file.is_open());
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, ChunkedFileTest,
+                         ::testing::Values(StreamBackend::Auto,
+                                           StreamBackend::Pread));
+
+TEST(ChunkedFileTest, RejectsMissingAndEmptyFiles) {
+  ChunkedFile file;
+  EXPECT_FALSE(file.open("/nonexistent/capture.pcap"));
+  TempFile empty(std::vector<char>{});
+  EXPECT_FALSE(file.open(empty.path()));
+}
+
+TEST(StreamBackendTest, NamesRoundTrip) {
+  for (StreamBackend backend : {StreamBackend::Auto, StreamBackend::IoUring,
+                                StreamBackend::Pread}) {
+    StreamBackend parsed = StreamBackend::Auto;
+    ASSERT_TRUE(parse_stream_backend(stream_backend_name(backend), parsed));
+    EXPECT_EQ(parsed, backend);
+  }
+  StreamBackend parsed = StreamBackend::Pread;
+  EXPECT_FALSE(parse_stream_backend("aio", parsed));
+}
+
+// ============================================================================
+// PcapStreamReader
+// ============================================================================
+
+class PcapStreamReaderTest : public ::testing::TestWithParam<StreamBackend> {
+};
+
+TEST_P(PcapStreamReaderTest, ClassicMatchesMappedReader) {
+  TempFile tmp(classic_capture(
+      numbered_packets(3000, kFirstNs, kTenthSec, varied_size), TsUnit::Micro,
+      kBigSnaplen));
+  PcapStreamReader reader(tmp.path(), tiny(GetParam()));
+  ASSERT_TRUE(reader.is_open());
+  EXPECT_EQ(reader.format(), CaptureFormat::Pcap);
+  EXPECT_EQ(reader.link_type(), LinkType::Ethernet);
+
+  const std::vector<Packet> expected = mapped_packets(tmp.path());
+  ASSERT_EQ(expected.size(), 3000u);
+  EXPECT_EQ(streamed_packets(reader), expected);
+  EXPECT_FALSE(reader.failed());
+
+  // A second pass streams the file again
+  EXPECT_EQ(streamed_packets(reader), expected);
+}
+
+TEST_P(PcapStreamReaderTest, PcapNgMatchesMappedReader) {
+  // Nanosecond interfaces; packets a second (and a nanosecond) apart
+  const auto size = [](size_t i) { return 10 + (i * 53) % 400; };
+  std::vector<char> bytes;
+  pcapng_section(bytes,
+                 numbered_packets(400, kFirstNs, 1'000'000'001, size),
+                 TsUnit::Nano, simple_packet_filler);
+  // Interfaces restart with the section
+  pcapng_section(bytes,
+                 numbered_packets(300, kFirstNs, 1'000'000'001, size),
+                 TsUnit::Nano, simple_packet_filler);
+  TempFile tmp(bytes);
+
+  PcapStreamReader reader(tmp.path(), tiny(GetParam()));
+  ASSERT_TRUE(reader.is_open());
+  EXPECT_EQ(reader.format(), CaptureFormat::PcapNg);
+
+  const std::vector<Packet> expected = mapped_packets(tmp.path());
+  ASSERT_EQ(expected.size(), 700u + 140u);
+  EXPECT_EQ(streamed_packets(reader), expected);
+  EXPECT_FALSE(reader.failed());
+}
+
+TEST_P(PcapStreamReaderTest, ReassemblesRecordsLargerThanABuffer) {
+  const std::vector<size_t> sizes = {100, 3 * kTinyBuffer, 50, 9000, 7};
+  TempFile tmp(classic_capture(
+      numbered_packets(sizes.size(), kFirstNs, kTenthSec,
+                       [&](size_t i) { return sizes[i]; }),
+      TsUnit::Micro, kBigSnaplen));
+  PcapStreamReader reader(tmp.path(), tiny(GetParam()));
+  EXPECT_EQ(streamed_packets(reader), mapped_packets(tmp.path()));
+  EXPECT_EQ(reader.oversize(), 0u);
+}
+
+TEST_P(PcapStreamReaderTest, SkipsRecordsBeyondCarryCapacity) {
+  const size_t huge = PcapStreamReader::kCarryCapacity + 1000;
+  const std::vector<size_t> sizes = {100, huge, 50, 60};
+  TempFile tmp(classic_capture(
+      numbered_packets(sizes.size(), kFirstNs, kTenthSec,
+                       [&](size_t i) { return sizes[i]; }),
+      TsUnit::Micro, kBigSnaplen));
+  PcapStreamReader reader(tmp.path(), tiny(GetParam()));
+
+  std::vector<size_t> lengths;
+  reader.for_each_packet(
+      [&](const char *, size_t len) { lengths.push_back(len); });
+  EXPECT_EQ(lengths, (std::vector<size_t>{100, 50, 60}));
+  EXPECT_EQ(reader.oversize(), 1u);
+  EXPECT_FALSE(reader.failed());
+}
+
+TEST_P(PcapStreamReaderTest, IgnoresTruncatedTail) {
+  std::vector<char> bytes = classic_capture(
+      numbered_packets(200, kFirstNs, kTenthSec, varied_size), TsUnit::Micro,
+      kBigSnaplen);
+  bytes.resize(bytes.size() - 5);
+  TempFile tmp(bytes);
+  PcapStreamReader reader(tmp.path(), tiny(GetParam()));
+  EXPECT_EQ(reader.for_each_packet([](const char *, size_t) {}), 199u);
+  EXPECT_FALSE(reader.failed());
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, PcapStreamReaderTest,
+                         ::testing::Values(StreamBackend::Auto,
+                                           StreamBackend::Pread));
+
+TEST(PcapStreamReaderTest, MemoryIsBoundedByTheRing) {
+  TempFile tmp(classic_capture(
+      numbered_packets(20000, kFirstNs, kTenthSec, varied_size), TsUnit::Micro,
+      kBigSnaplen));
+  StreamOptions options = tiny(StreamBackend::Pread);
+  options.buffer_count = 4;
+  PcapStreamReader reader(tmp.path(), options);
+  ASSERT_TRUE(reader.is_open());
+  EXPECT_EQ(reader.stream().memory_bytes(), 4 * kTinyBuffer);
+  EXPECT_EQ(reader.memory_bytes(),
+            4 * kTinyBuffer + PcapStreamReader::kCarryCapacity);
+  EXPECT_LT(reader.memory_bytes(), reader.file_size());
+}
+
+TEST(PcapStreamReaderTest, PcapNgLinkTypeComesFromTheInterface) {
+  std::vector<char> bytes;
+  pcapng_section_header(bytes);
+  pcapng_interface(bytes, {LinkType::LinuxSll2});
+  pcapng_enhanced_packet(bytes, 0, 0, "cooked");
+  TempFile tmp(bytes);
+
+  PcapStreamReader reader(tmp.path(), tiny(StreamBackend::Pread));
+  ASSERT_TRUE(reader.is_open());
+  EXPECT_EQ(reader.link_type(), LinkType::LinuxSll2);
+  EXPECT_EQ(reader.link_type(), PcapReader(tmp.path()).link_type());
+}
+
+TEST(PcapStreamReaderTest, PcapNgLinkTypeMustNotChange) {
+  std::vector<char> mixed;
+  pcapng_section_header(mixed);
+  pcapng_interface(mixed, {LinkType::Ethernet});
+  pcapng_interface(mixed, {LinkType::LinuxSll});
+  TempFile rejected(mixed);
+  PcapStreamReader reader;
+  EXPECT_FALSE(reader.open(rejected.path(), tiny(StreamBackend::Pread)));
+
+  // A later interface of another link type ends the pass
+  std::vector<char> bytes = pcapng_capture(numbered_packets(3, kFirstNs, 1));
+  pcapng_interface(bytes, {LinkType::LinuxSll});
+  pcapng_enhanced_packet(bytes, 1, 0, "cooked");
+  TempFile later(bytes);
+  ASSERT_TRUE(reader.open(later.path(), tiny(StreamBackend::Pread)));
+  EXPECT_EQ(reader.for_each_packet([](const char *, size_t) {}), 3u);
+  EXPECT_TRUE(reader.failed());
+}
+
+TEST(PcapStreamReaderTest, RejectsNonCaptures) {
+  TempFile tmp(std::vector<char>(100, 'z'));
+  PcapStreamReader reader;
+  EXPECT_FALSE(reader.open(tmp.path()));
+  EXPECT_FALSE(reader.open("/nonexistent/capture.pcap"));
+  EXPECT_EQ(reader.for_each_packet([](const char *, size_t) {}), 0u);
+}
+
+} // namespace itch::test
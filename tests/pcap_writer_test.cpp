@@ -0,0 +1,249 @@
+/**
+ * @file pcap_writer_test.cpp
+ * @brief Unit tests for the writev writer, PcapWriter and MessageFilter.
+ */
+
+#include <gtest/gtest.h>
+#include <itch/message_filter.hpp>
+#include <itch/moldudp64.hpp>
+#include <itch/pcap_reader.hpp>
+#include <itch/pcap_writer.hpp>
+
+#include "test_captures.hpp"
+#include "test_moldudp64.hpp"
+
+#include <string>
+#include <vector>
+
+namespace itch::test {
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief Common ITCH header: type, locate and timestamp (ns since midnight).
+ */
+std::string itch_message(char type, uint16_t locate, uint64_t ts_ns,
+                         size_t size = 36) {
+  std::string msg(size, '\0');
+  msg[0] = type;
+  msg[1] = static_cast<char>(locate >> 8);
+  msg[2] = static_cast<char>(locate);
+  for (int i = 0; i < 6; ++i) {
+    msg[5 + i] = static_cast<char>(ts_ns >> (40 - i * 8));
+  }
+  return msg;
+}
+
+} // namespace
+
+// ============================================================================
+// GatherWriter
+// ============================================================================
+
+TEST(GatherWriterTest, WritesRangesInOrder) {
+  TempFile tmp;
+  GatherWriter out;
+  ASSERT_TRUE(out.open(tmp.path()));
+  const std::string a = "alpha,";
+  const std::string b = "beta,";
+  out.append(a.data(), a.size());
+  out.append_copy("copied,", 7);
+  out.append(b.data(), b.size());
+  EXPECT_EQ(out.pending(), 3u);
+  ASSERT_TRUE(out.close());
+  EXPECT_EQ(tmp.contents(), "alpha,copied,beta,");
+  EXPECT_EQ(out.bytes_written(), 18u);
+  EXPECT_EQ(out.writev_calls(), 1u);
+}
+
+TEST(GatherWriterTest, MergesTouchingRanges) {
+  TempFile tmp;
+  GatherWriter out;
+  ASSERT_TRUE(out.open(tmp.path()));
+  const std::string buffer = "0123456789";
+  out.append(buffer.data(), 3);
+  out.append(buffer.data() + 3, 4);
+  out.append(buffer.data() + 7, 3);
+  // Consecutive copies land next to each other in the arena too
+  out.append_copy("ab", 2);
+  out.append_copy("cd", 2);
+  EXPECT_EQ(out.pending(), 2u);
+  ASSERT_TRUE(out.close());
+  EXPECT_EQ(tmp.contents(), "0123456789abcd");
+}
+
+TEST(GatherWriterTest, FlushesWhenTheIovecTableFills) {
+  TempFile tmp;
+  GatherWriter out;
+  ASSERT_TRUE(out.open(tmp.path()));
+  // Every other byte: no two ranges touch
+  const std::string source(2 * (GatherWriter::kMaxIovecs + 10), 'x');
+  std::string expected;
+  for (size_t i = 0; i < GatherWriter::kMaxIovecs + 10; ++i) {
+    out.append(source.data() + 2 * i, 1);
+    expected.push_back('x');
+  }
+  EXPECT_EQ(out.writev_calls(), 1u);
+  EXPECT_EQ(out.pending(), 10u);
+  ASSERT_TRUE(out.close());
+  EXPECT_EQ(out.writev_calls(), 2u);
+  EXPECT_EQ(tmp.contents(), expected);
+}
+
+TEST(GatherWriterTest, RecyclesTheArenaOnlyAfterAFlush) {
+  TempFile tmp;
+  GatherWriter out;
+  ASSERT_TRUE(out.open(tmp.path()));
+  std::string expected;
+  const std::string gap = "|";
+  for (int i = 0; i < 5000; ++i) {
+    const std::string record = std::to_string(i) + std::string(30, 'r');
+    out.append_copy(record.data(), record.size());
+    out.append(gap.data(), gap.size()); // Breaks merging
+    expected += record + gap;
+  }
+  const std::string big(GatherWriter::kArenaBytes + 1, 'B');
+  out.append_copy(big.data(), big.size()); // Too big to stage
+  expected += big;
+  ASSERT_TRUE(out.close());
+  EXPECT_EQ(tmp.contents(), expected);
+}
+
+TEST(GatherWriterTest, ReportsOpenFailure) {
+  GatherWriter out;
+  EXPECT_FALSE(out.open("/nonexistent-dir/out.bin"));
+  EXPECT_TRUE(out.failed());
+  out.append("x", 1);
+  EXPECT_FALSE(out.flush());
+}
+
+// ============================================================================
+// PcapWriter
+// ============================================================================
+
+TEST(PcapWriterTest, RoundTripsThroughPcapReader) {
+  TempFile tmp;
+  const std::vector<std::string> payloads = {"first", std::string(1500, 'm'),
+                                             "last"};
+  const std::vector<uint64_t> stamps = {1'700'000'000'123'456'789ULL,
+                                        1'700'000'000'999'999'999ULL,
+                                        1'700'000'001'000'000'001ULL};
+  PcapWriter out;
+  ASSERT_TRUE(out.open(tmp.path(), LinkType::Raw));
+  for (size_t i = 0; i < payloads.size(); ++i) {
+    out.write_packet(stamps[i], payloads[i].data(), payloads[i].size());
+  }
+  EXPECT_EQ(out.packets(), 3u);
+  ASSERT_TRUE(out.close());
+
+  PcapReader reader(tmp.path());
+  ASSERT_TRUE(reader.is_open());
+  EXPECT_EQ(reader.link_type(), LinkType::Raw);
+  std::vector<std::string> got;
+  std::vector<uint64_t> got_ts;
+  (void)reader.for_each_packet(
+      [&](const char *data, size_t len, uint64_t ts_ns) {
+        got.emplace_back(data, len);
+        got_ts.push_back(ts_ns);
+      });
+  EXPECT_EQ(got, payloads);
+  EXPECT_EQ(got_ts, stamps); // Nanoseconds survive
+  EXPECT_EQ(out.writer().bytes_written(),
+            sizeof(PcapGlobalHeader) + 3 * sizeof(PcapPacketHeader) + 1509);
+}
+
+TEST(PcapWriterTest, EmptyCaptureIsJustTheHeader) {
+  TempFile tmp;
+  PcapWriter out;
+  ASSERT_TRUE(out.open(tmp.path(), LinkType::Ethernet));
+  ASSERT_TRUE(out.close());
+  PcapReader reader(tmp.path());
+  ASSERT_TRUE(reader.is_open());
+  EXPECT_EQ(reader.for_each_packet([](const char *, size_t) {}), 0u);
+}
+
+// ============================================================================
+// MessageFilter
+// ============================================================================
+
+TEST(MessageFilterTest, EmptyFilterAcceptsEveryMessage) {
+  MessageFilter filter;
+  EXPECT_TRUE(filter.accepts_all());
+  const std::string msg = itch_message('A', 7, 100);
+  EXPECT_TRUE(filter.matches(msg.data(), msg.size()));
+  EXPECT_FALSE(filter.matches(msg.data(), sizeof(MessageHeader) - 1));
+}
+
+TEST(MessageFilterTest, CriteriaCombineWithAnd) {
+  MessageFilter filter;
+  filter.add_locate(7);
+  filter.add_locate(9);
+  filter.add_type('A');
+  filter.add_type('D');
+  filter.set_window(1000, 2000);
+  EXPECT_FALSE(filter.accepts_all());
+
+  auto matches = [&](char type, uint16_t locate, uint64_t ts) {
+    const std::string msg = itch_message(type, locate, ts);
+    return filter.matches(msg.data(), msg.size());
+  };
+  EXPECT_TRUE(matches('A', 7, 1000));
+  EXPECT_TRUE(matches('D', 9, 1999));
+  EXPECT_FALSE(matches('E', 7, 1500)); // Type
+  EXPECT_FALSE(matches('A', 8, 1500)); // Locate
+  EXPECT_FALSE(matches('A', 7, 999));  // Before the window
+  EXPECT_FALSE(matches('A', 7, 2000)); // Window end is exclusive
+}
+
+TEST(MessageFilterTest, LocatesSpanTheFullRange) {
+  MessageFilter filter;
+  filter.add_locate(65535);
+  const std::string last = itch_message('A', 65535, 0);
+  const std::string first = itch_message('A', 0, 0);
+  EXPECT_TRUE(filter.matches(last.data(), last.size()));
+  EXPECT_FALSE(filter.matches(first.data(), first.size()));
+}
+
+// ============================================================================
+// MoldUDP64 Block Walking
+// ============================================================================
+
+TEST(MoldBlockWalkTest, VisitsEveryBlockWithItsPrefix) {
+  const std::vector<std::string> messages = {itch_message('A', 1, 5),
+                                             itch_message('D', 2, 6, 19)};
+  const std::string pkt = mold_packet(messages);
+  std::vector<std::string> got;
+  EXPECT_TRUE(for_each_mold_message(
+      pkt.data(), pkt.size(), [&](const char *msg, size_t len) {
+        EXPECT_EQ(static_cast<uint8_t>(msg[-1]), len);
+        got.emplace_back(msg, len);
+      }));
+  EXPECT_EQ(got, messages);
+}
+
+TEST(MoldBlockWalkTest, StopsAtATruncatedBlock) {
+  std::string pkt = mold_packet({itch_message('A', 1, 5), "xyz"});
+  pkt.resize(pkt.size() - 1);
+  size_t visited = 0;
+  EXPECT_FALSE(for_each_mold_message(pkt.data(), pkt.size(),
+                                     [&](const char *, size_t) {
+                                       ++visited;
+                                     }));
+  EXPECT_EQ(visited, 1u);
+
+  std::string end_of_session = mold_packet({});
+  end_of_session[18] = '\xFF';
+  end_of_session[19] = '\xFF';
+  EXPECT_TRUE(for_each_mold_message(end_of_session.data(),
+                                    end_of_session.size(),
+                                    [&](const char *, size_t) {
+                                      ++visited;
+                                    }));
+  EXPECT_EQ(visited, 1u);
+}
+
+} // namespace itch::test
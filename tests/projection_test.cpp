@@ -0,0 +1,148 @@
+/**
+ * @file projection_test.cpp
+ * @brief Unit tests for compile-time field projection.
+ */
+
+#include <gtest/gtest.h>
+#include <itch/parser.hpp>
+#include <itch/projection.hpp>
+
+#include <type_traits>
+#include <vector>
+
+namespace itch::test {
+
+// ============================================================================
+// Compile-time Checks
+// ============================================================================
+
+static_assert((detail::available_fields_v<AddOrder> & field::Side) != 0);
+static_assert((detail::available_fields_v<OrderDelete> & field::Side) == 0);
+static_assert((detail::available_fields_v<OrderCancel> & field::Shares) != 0);
+static_assert((detail::available_fields_v<OrderReplace> &
+               field::NewOrderRef) != 0);
+static_assert((detail::available_fields_v<CrossTrade> & field::Price) != 0);
+static_assert((detail::available_fields_v<NOII> & field::Price) == 0);
+
+// Unrequested fields take no space
+static_assert(sizeof(Projection<field::OrderRef>) == sizeof(uint64_t));
+static_assert(std::is_empty_v<Projection<0>>);
+
+// A message that lacks a requested field cannot be projected
+static_assert(std::is_convertible_v<const AddOrder &, Projection<field::Side>>);
+static_assert(
+    !std::is_convertible_v<const OrderDelete &, Projection<field::Side>>);
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace {
+
+void write_be(std::vector<char> &buf, size_t offset, uint64_t value,
+              size_t bytes) {
+  for (size_t i = 0; i < bytes; ++i) {
+    buf[offset + bytes - 1 - i] = static_cast<char>(value >> (8 * i));
+  }
+}
+
+/// Header with locate, tracking and a 48-bit timestamp filled in.
+std::vector<char> make_message(char type, size_t size, uint16_t locate,
+                               uint64_t timestamp) {
+  std::vector<char> buf(size, 0);
+  buf[0] = type;
+  write_be(buf, 1, locate, 2);
+  write_be(buf, 3, 7, 2);
+  write_be(buf, 5, timestamp, 6);
+  return buf;
+}
+
+struct VolumeVisitor : DefaultVisitor {
+  static constexpr FieldMask kFields = field::StockLocate | field::Shares;
+  using Fields = Projection<kFields>;
+
+  uint64_t volume[4] = {};
+  int deletes = 0;
+
+  void on_add_order(const Fields &f) { volume[f.stock_locate] += f.shares; }
+  void on_order_executed(const Fields &f) {
+    volume[f.stock_locate] += f.shares;
+  }
+  void on_order_cancel(const Fields &f) { volume[f.stock_locate] += f.shares; }
+
+  // Wire-struct hooks still work alongside projected ones
+  void on_order_delete(const OrderDelete & /*msg*/) { ++deletes; }
+};
+
+} // namespace
+
+// ============================================================================
+// Projection
+// ============================================================================
+
+TEST(ProjectionTest, DecodesOnlyRequestedFieldsInHostOrder) {
+  auto buf = make_message('A', sizeof(AddOrder), 3, 0x123456789ABCULL);
+  write_be(buf, 11, 0xDEADBEEFCAFEULL, 8);
+  buf[19] = 'S';
+  write_be(buf, 20, 500, 4);
+  write_be(buf, 32, 1500000, 4);
+  const auto &msg = *reinterpret_cast<const AddOrder *>(buf.data());
+
+  const auto p = project<field::Timestamp | field::OrderRef | field::Side |
+                         field::Price>(msg);
+  EXPECT_EQ(p.timestamp, 0x123456789ABCULL);
+  EXPECT_EQ(p.order_ref, 0xDEADBEEFCAFEULL);
+  EXPECT_EQ(p.side, 'S');
+  EXPECT_EQ(p.price, 1500000u);
+}
+
+TEST(ProjectionTest, SharedNamesMapToPerMessageFields) {
+  auto exec = make_message('E', sizeof(OrderExecuted), 1, 0);
+  write_be(exec, 19, 40, 4);
+  write_be(exec, 23, 99, 8);
+  const auto e = project<field::Shares | field::MatchNumber>(
+      *reinterpret_cast<const OrderExecuted *>(exec.data()));
+  EXPECT_EQ(e.shares, 40u);
+  EXPECT_EQ(e.match_number, 99u);
+
+  auto replace = make_message('U', sizeof(OrderReplace), 1, 0);
+  write_be(replace, 11, 10, 8);
+  write_be(replace, 19, 11, 8);
+  const auto r = project<field::OrderRef | field::NewOrderRef>(
+      *reinterpret_cast<const OrderReplace *>(replace.data()));
+  EXPECT_EQ(r.order_ref, 10u);
+  EXPECT_EQ(r.new_order_ref, 11u);
+}
+
+TEST(ProjectionTest, ParserDeliversProjectedHooks) {
+  std::vector<char> stream;
+  auto append = [&stream](const std::vector<char> &msg) {
+    stream.insert(stream.end(), msg.begin(), msg.end());
+  };
+
+  auto add = make_message('A', sizeof(AddOrder), 2, 0);
+  write_be(add, 20, 100, 4);
+  append(add);
+
+  auto exec = make_message('E', sizeof(OrderExecuted), 2, 0);
+  write_be(exec, 19, 30, 4);
+  append(exec);
+
+  auto cancel = make_message('X', sizeof(OrderCancel), 1, 0);
+  write_be(cancel, 19, 5, 4);
+  append(cancel);
+
+  append(make_message('D', sizeof(OrderDelete), 1, 0));
+
+  VolumeVisitor visitor;
+  Parser parser;
+  const size_t consumed =
+      parser.parse_buffer(stream.data(), stream.size(), visitor);
+
+  EXPECT_EQ(consumed, stream.size());
+  EXPECT_EQ(visitor.volume[2], 130u);
+  EXPECT_EQ(visitor.volume[1], 5u);
+  EXPECT_EQ(visitor.deletes, 1);
+}
+
+} // namespace itch::test
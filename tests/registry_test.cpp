@@ -0,0 +1,106 @@
+/**
+ * @file registry_test.cpp
+ * @brief Unit tests for the compile-time ITCH message registry.
+ */
+
+#include <gtest/gtest.h>
+#include <itch/parser.hpp>
+#include <itch/registry.hpp>
+
+#include <algorithm>
+
+namespace itch::test {
+
+// ============================================================================
+// Compile-time Checks
+// ============================================================================
+
+static_assert(Itch50Messages::size == 23);
+static_assert(message_size('A') == sizeof(AddOrder));
+static_assert(message_size('Z') == 0);
+static_assert(is_valid_message_type('h'));
+static_assert(!is_valid_message_type('G'));
+
+// ============================================================================
+// Size Table
+// ============================================================================
+
+TEST(RegistryTest, SizeTableMatchesStructs) {
+  EXPECT_EQ(message_size(AddOrder::kMsgType), sizeof(AddOrder));
+  EXPECT_EQ(message_size(OrderReplace::kMsgType), sizeof(OrderReplace));
+  EXPECT_EQ(message_size(NOII::kMsgType), sizeof(NOII));
+  EXPECT_EQ(message_size(SystemEvent::kMsgType), sizeof(SystemEvent));
+}
+
+TEST(RegistryTest, MaxMessageSizeBoundsEveryType) {
+  size_t largest = 0;
+  for (int c = 0; c < 256; ++c) {
+    largest = std::max(largest, message_size(static_cast<char>(c)));
+  }
+  EXPECT_EQ(kMaxMessageSize, largest);
+  EXPECT_EQ(kMaxMessageSize, sizeof(NOII));
+}
+
+TEST(RegistryTest, SizeAndValidityAgree) {
+  // The two tables are generated from the same list and must never diverge.
+  for (int c = 0; c < 256; ++c) {
+    const char type = static_cast<char>(c);
+    EXPECT_EQ(is_valid_message_type(type), message_size(type) != 0)
+        << "type byte " << c;
+  }
+}
+
+TEST(RegistryTest, ValidTypeCount) {
+  int valid = 0;
+  for (int c = 0; c < 256; ++c) {
+    valid += is_valid_message_type(static_cast<char>(c)) ? 1 : 0;
+  }
+  EXPECT_EQ(valid, static_cast<int>(Itch50Messages::size));
+}
+
+// ============================================================================
+// Dispatch Table
+// ============================================================================
+
+struct TypeRecorder : DefaultVisitor {
+  char last = 0;
+  int unknown = 0;
+
+  void on_order_delete(const OrderDelete &msg) { last = msg.msg_type; }
+  void on_broken_trade(const BrokenTrade &msg) { last = msg.msg_type; }
+  void on_unknown(char /*msg_type*/, const char * /*data*/, size_t /*len*/) {
+    ++unknown;
+  }
+};
+
+TEST(RegistryTest, DispatchRoutesByTypeByte) {
+  // 'D' and 'B' share a 19-byte layout; the table must still tell them apart.
+  unsigned char buffer[19] = {'D'};
+  TypeRecorder visitor;
+  Parser parser;
+
+  EXPECT_EQ(parser.parse(reinterpret_cast<const char *>(buffer),
+                         sizeof(buffer), visitor),
+            ParseResult::Ok);
+  EXPECT_EQ(visitor.last, 'D');
+
+  buffer[0] = 'B';
+  EXPECT_EQ(parser.parse(reinterpret_cast<const char *>(buffer),
+                         sizeof(buffer), visitor),
+            ParseResult::Ok);
+  EXPECT_EQ(visitor.last, 'B');
+  EXPECT_EQ(visitor.unknown, 0);
+}
+
+TEST(RegistryTest, DispatchChecksPerTypeLength) {
+  // 19 bytes is a complete OrderDelete but a truncated OrderCancel.
+  unsigned char buffer[19] = {'X'};
+  TypeRecorder visitor;
+  Parser parser;
+
+  EXPECT_EQ(parser.parse(reinterpret_cast<const char *>(buffer),
+                         sizeof(buffer), visitor),
+            ParseResult::BufferTooSmall);
+}
+
+} // namespace itch::test
@@ -0,0 +1,170 @@
+/**
+ * @file replay_clock_test.cpp
+ * @brief Unit tests for the TSC clock, the replay pacer and the rate
+ *        limiter.
+ */
+
+#include <gtest/gtest.h>
+#include <itch/replay_clock.hpp>
+
+#include <chrono>
+
+namespace itch::test {
+
+namespace {
+
+using Steady = std::chrono::steady_clock;
+
+double elapsed_ms(Steady::time_point start) {
+  return std::chrono::duration<double, std::milli>(Steady::now() - start)
+      .count();
+}
+
+} // namespace
+
+// ============================================================================
+// TSC Clock
+// ============================================================================
+
+TEST(TscClockTest, CalibratedRateTracksSteadyClock) {
+  const TscClock clock = TscClock::calibrate();
+  ASSERT_GT(clock.ticks_per_ns(), 0.0);
+
+  const auto start = Steady::now();
+  const uint64_t t0 = TscClock::ticks();
+  while (elapsed_ms(start) < 5.0) {
+  }
+  const double tsc_ms = clock.to_nanos(TscClock::ticks() - t0) / 1e6;
+
+  EXPECT_NEAR(tsc_ms, elapsed_ms(start), 0.5);
+}
+
+TEST(TscClockTest, ConversionsRoundTrip) {
+  const TscClock clock = TscClock::calibrate();
+  const uint64_t ns = 1'000'000;
+  EXPECT_NEAR(static_cast<double>(clock.to_nanos(clock.to_ticks(ns))),
+              static_cast<double>(ns), 2.0);
+}
+
+// ============================================================================
+// Replay Pacer
+// ============================================================================
+
+TEST(ReplayPacerTest, RealTimeHonoursCaptureSpacing) {
+  ReplayPacer pacer(1.0);
+  const uint64_t base = 1'700'000'000'000'000'000ull; // Epoch ns
+  const auto start = Steady::now();
+
+  for (uint64_t i = 0; i < 5; ++i) {
+    (void)pacer.wait(base + i * 1'000'000); // 1 ms apart
+  }
+
+  const double ms = elapsed_ms(start);
+  EXPECT_GE(ms, 3.9);
+  EXPECT_LT(ms, 40.0);
+  EXPECT_EQ(pacer.stats().packets, 5u);
+  EXPECT_GE(pacer.stats().waited, 1u);
+}
+
+TEST(ReplayPacerTest, SpeedFactorCompressesSchedule) {
+  ReplayPacer pacer(10.0);
+  const auto start = Steady::now();
+
+  (void)pacer.wait(0);
+  (void)pacer.wait(50'000'000); // 50 ms captured -> 5 ms replayed
+
+  const double ms = elapsed_ms(start);
+  EXPECT_GE(ms, 4.9);
+  EXPECT_LT(ms, 40.0);
+}
+
+TEST(ReplayPacerTest, MaxSpeedNeverWaits) {
+  ReplayPacer pacer(ReplayPacer::kMaxSpeed);
+  EXPECT_TRUE(pacer.unpaced());
+  const auto start = Steady::now();
+
+  for (uint64_t i = 0; i < 100; ++i) {
+    EXPECT_EQ(pacer.wait(i * 1'000'000'000ull), 0u); // 1 s apart
+  }
+
+  EXPECT_LT(elapsed_ms(start), 50.0);
+  EXPECT_EQ(pacer.stats().packets, 100u);
+  EXPECT_EQ(pacer.stats().waited, 0u);
+}
+
+TEST(ReplayPacerTest, BackwardsTimestampIsDueImmediately) {
+  ReplayPacer pacer(1.0);
+  const auto start = Steady::now();
+
+  (void)pacer.wait(10'000'000'000);
+  (void)pacer.wait(5'000'000'000); // Before the anchor
+
+  EXPECT_LT(elapsed_ms(start), 50.0);
+  EXPECT_EQ(pacer.stats().waited, 0u);
+}
+
+TEST(ReplayPacerTest, ResetReanchorsSchedule) {
+  ReplayPacer pacer(1.0);
+  (void)pacer.wait(0);
+  pacer.reset();
+  const auto start = Steady::now();
+
+  // Against the old anchor this would spin for 10 s
+  (void)pacer.wait(10'000'000'000);
+  (void)pacer.wait(10'001'000'000);
+
+  const double ms = elapsed_ms(start);
+  EXPECT_GE(ms, 0.9);
+  EXPECT_LT(ms, 40.0);
+  EXPECT_EQ(pacer.stats().packets, 2u);
+}
+
+TEST(ReplayPacerTest, DueReportsWhetherWaitWouldSpin) {
+  ReplayPacer pacer(1.0);
+  EXPECT_TRUE(pacer.due(0)); // Not anchored yet
+  (void)pacer.wait(0);
+  EXPECT_TRUE(pacer.due(0));
+  EXPECT_FALSE(pacer.due(10'000'000'000)); // 10 s out
+
+  ReplayPacer flat_out(ReplayPacer::kMaxSpeed);
+  (void)flat_out.wait(0);
+  EXPECT_TRUE(flat_out.due(10'000'000'000));
+}
+
+// ============================================================================
+// Rate Limiter
+// ============================================================================
+
+TEST(RateLimiterTest, CapsEventRate) {
+  RateLimiter limiter(10'000.0); // 0.1 ms apart
+  const auto start = Steady::now();
+
+  for (int i = 0; i < 51; ++i) {
+    limiter.wait();
+  }
+
+  const double ms = elapsed_ms(start);
+  EXPECT_GE(ms, 4.9);
+  EXPECT_LT(ms, 40.0);
+  EXPECT_EQ(limiter.events(), 51u);
+}
+
+TEST(RateLimiterTest, DueTracksTheSchedule) {
+  RateLimiter limiter(1.0); // One per second
+  EXPECT_TRUE(limiter.due());
+  limiter.wait();
+  EXPECT_FALSE(limiter.due());
+}
+
+TEST(RateLimiterTest, UnlimitedNeverWaits) {
+  RateLimiter limiter;
+  EXPECT_TRUE(limiter.unlimited());
+  const auto start = Steady::now();
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(limiter.due());
+    limiter.wait();
+  }
+  EXPECT_LT(elapsed_ms(start), 50.0);
+}
+
+} // namespace itch::test
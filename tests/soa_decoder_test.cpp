@@ -0,0 +1,212 @@
+/**
+ * @file soa_decoder_test.cpp
+ * @brief Unit tests for the bulk SoA decoder (SIMD vs scalar vs accessors).
+ */
+
+#include <gtest/gtest.h>
+#include <itch/soa_decoder.hpp>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace itch::test {
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace {
+
+/// Write `bytes` big-endian bytes of `value` at `dst`.
+void put_be(char *dst, uint64_t value, size_t bytes) {
+  for (size_t i = 0; i < bytes; ++i) {
+    dst[bytes - 1 - i] = static_cast<char>(value >> (8 * i));
+  }
+}
+
+/// Fill `n` AddOrder records with random field values.
+std::vector<AddOrder> random_add_orders(size_t n, uint32_t seed) {
+  std::mt19937_64 rng(seed);
+  std::vector<AddOrder> out(n);
+  for (auto &msg : out) {
+    char *raw = reinterpret_cast<char *>(&msg);
+    std::memset(raw, 0, sizeof(AddOrder));
+    raw[0] = 'A';
+    put_be(raw + 1, rng(), 2);
+    put_be(raw + 3, rng(), 2);
+    put_be(raw + 5, rng(), 6);
+    put_be(raw + 11, rng(), 8);
+    raw[19] = (rng() & 1) ? 'B' : 'S';
+    put_be(raw + 20, rng(), 4);
+    std::memcpy(raw + 24, "AAPL    ", 8);
+    put_be(raw + 32, rng(), 4);
+  }
+  return out;
+}
+
+/// Fill `n` OrderExecuted records with random field values.
+std::vector<OrderExecuted> random_executions(size_t n, uint32_t seed) {
+  std::mt19937_64 rng(seed);
+  std::vector<OrderExecuted> out(n);
+  for (auto &msg : out) {
+    char *raw = reinterpret_cast<char *>(&msg);
+    raw[0] = 'E';
+    put_be(raw + 1, rng(), 2);
+    put_be(raw + 3, rng(), 2);
+    put_be(raw + 5, rng(), 6);
+    put_be(raw + 11, rng(), 8);
+    put_be(raw + 19, rng(), 4);
+    put_be(raw + 23, rng(), 8);
+  }
+  return out;
+}
+
+struct AddOrderStore {
+  explicit AddOrderStore(size_t n)
+      : refs(n), ts(n), locates(n), shares(n), prices(n), sides(n) {}
+
+  AddOrderColumns columns() {
+    return {refs.data(),   ts.data(),     locates.data(),
+            shares.data(), prices.data(), sides.data()};
+  }
+
+  std::vector<uint64_t> refs, ts;
+  std::vector<uint16_t> locates;
+  std::vector<uint32_t> shares, prices;
+  std::vector<char> sides;
+};
+
+struct ExecutedStore {
+  explicit ExecutedStore(size_t n)
+      : refs(n), ts(n), locates(n), shares(n), matches(n) {}
+
+  OrderExecutedColumns columns() {
+    return {refs.data(), ts.data(), locates.data(), shares.data(),
+            matches.data()};
+  }
+
+  std::vector<uint64_t> refs, ts;
+  std::vector<uint16_t> locates;
+  std::vector<uint32_t> shares;
+  std::vector<uint64_t> matches;
+};
+
+void expect_matches_accessors(const std::vector<AddOrder> &msgs,
+                              const AddOrderStore &s) {
+  for (size_t i = 0; i < msgs.size(); ++i) {
+    EXPECT_EQ(s.refs[i], static_cast<uint64_t>(msgs[i].order_ref)) << i;
+    EXPECT_EQ(s.ts[i], msgs[i].timestamp.nanoseconds()) << i;
+    EXPECT_EQ(s.locates[i], static_cast<uint16_t>(msgs[i].stock_locate)) << i;
+    EXPECT_EQ(s.shares[i], static_cast<uint32_t>(msgs[i].shares)) << i;
+    EXPECT_EQ(s.prices[i], static_cast<uint32_t>(msgs[i].price)) << i;
+    EXPECT_EQ(s.sides[i], msgs[i].side) << i;
+  }
+}
+
+} // namespace
+
+// ============================================================================
+// AddOrder
+// ============================================================================
+
+TEST(SoaDecoderTest, AddOrderKnownValues) {
+  auto msgs = random_add_orders(1, 1);
+  char *raw = reinterpret_cast<char *>(msgs.data());
+  put_be(raw + 5, 0x0000123456789ABCULL, 6);
+  put_be(raw + 11, 0x0102030405060708ULL, 8);
+  put_be(raw + 32, 1500000, 4);
+
+  AddOrderStore store(1);
+  decode_add_orders(msgs, store.columns());
+
+  EXPECT_EQ(store.ts[0], 0x123456789ABCULL);
+  EXPECT_EQ(store.refs[0], 0x0102030405060708ULL);
+  EXPECT_EQ(store.prices[0], 1500000u);
+}
+
+TEST(SoaDecoderTest, AddOrderMatchesScalarForAllTailLengths) {
+  // 0..13 covers empty input, pure tail, and several SIMD blocks + tail.
+  for (size_t n = 0; n <= 13; ++n) {
+    const auto msgs = random_add_orders(n, static_cast<uint32_t>(n) + 7);
+
+    AddOrderStore simd(n);
+    AddOrderStore scalar(n);
+    decode_add_orders(msgs, simd.columns());
+    decode_add_orders_scalar(msgs, scalar.columns());
+
+    EXPECT_EQ(simd.refs, scalar.refs) << "n=" << n;
+    EXPECT_EQ(simd.ts, scalar.ts) << "n=" << n;
+    EXPECT_EQ(simd.locates, scalar.locates) << "n=" << n;
+    EXPECT_EQ(simd.shares, scalar.shares) << "n=" << n;
+    EXPECT_EQ(simd.prices, scalar.prices) << "n=" << n;
+    EXPECT_EQ(simd.sides, scalar.sides) << "n=" << n;
+    expect_matches_accessors(msgs, simd);
+  }
+}
+
+TEST(SoaDecoderTest, AddOrderPointerSpanFollowsPointerOrder) {
+  const auto msgs = random_add_orders(9, 42);
+
+  // Reverse order, as a batch hook could hand over non-contiguous records.
+  std::vector<const AddOrder *> ptrs;
+  for (size_t i = msgs.size(); i-- > 0;) {
+    ptrs.push_back(&msgs[i]);
+  }
+
+  AddOrderStore store(ptrs.size());
+  decode_add_orders(MessageSpan<AddOrder>(ptrs), store.columns());
+
+  for (size_t i = 0; i < ptrs.size(); ++i) {
+    EXPECT_EQ(store.refs[i], static_cast<uint64_t>(ptrs[i]->order_ref));
+    EXPECT_EQ(store.ts[i], ptrs[i]->timestamp.nanoseconds());
+    EXPECT_EQ(store.prices[i], static_cast<uint32_t>(ptrs[i]->price));
+    EXPECT_EQ(store.sides[i], ptrs[i]->side);
+  }
+}
+
+// ============================================================================
+// OrderExecuted
+// ============================================================================
+
+TEST(SoaDecoderTest, OrderExecutedMatchesScalarForAllTailLengths) {
+  for (size_t n = 0; n <= 13; ++n) {
+    const auto msgs = random_executions(n, static_cast<uint32_t>(n) + 100);
+
+    ExecutedStore simd(n);
+    ExecutedStore scalar(n);
+    decode_order_executed(msgs, simd.columns());
+    decode_order_executed_scalar(msgs, scalar.columns());
+
+    EXPECT_EQ(simd.refs, scalar.refs) << "n=" << n;
+    EXPECT_EQ(simd.ts, scalar.ts) << "n=" << n;
+    EXPECT_EQ(simd.locates, scalar.locates) << "n=" << n;
+    EXPECT_EQ(simd.shares, scalar.shares) << "n=" << n;
+    EXPECT_EQ(simd.matches, scalar.matches) << "n=" << n;
+
+    for (size_t i = 0; i < n; ++i) {
+      EXPECT_EQ(simd.shares[i], static_cast<uint32_t>(msgs[i].executed_shares));
+      EXPECT_EQ(simd.matches[i], static_cast<uint64_t>(msgs[i].match_number));
+    }
+  }
+}
+
+TEST(SoaDecoderTest, OrderExecutedPointerSpan) {
+  const auto msgs = random_executions(6, 5);
+  std::vector<const OrderExecuted *> ptrs;
+  for (const auto &msg : msgs) {
+    ptrs.push_back(&msg);
+  }
+
+  ExecutedStore from_ptrs(ptrs.size());
+  ExecutedStore from_array(msgs.size());
+  decode_order_executed(MessageSpan<OrderExecuted>(ptrs), from_ptrs.columns());
+  decode_order_executed(msgs, from_array.columns());
+
+  EXPECT_EQ(from_ptrs.refs, from_array.refs);
+  EXPECT_EQ(from_ptrs.ts, from_array.ts);
+  EXPECT_EQ(from_ptrs.shares, from_array.shares);
+  EXPECT_EQ(from_ptrs.matches, from_array.matches);
+}
+
+} // namespace itch::test
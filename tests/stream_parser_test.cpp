@@ -0,0 +1,245 @@
+/**
+ * @file stream_parser_test.cpp
+ * @brief Unit tests for StreamParser carry-over across chunk boundaries.
+ */
+
+#include <gtest/gtest.h>
+#include <itch/stream_parser.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace itch::test {
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief Append one message; order_ref (offset 11) is `ref` when present.
+ */
+void append_msg(std::vector<char> &out, char type, uint64_t ref,
+                bool prefixed) {
+  const size_t size = message_size(type);
+  if (prefixed) {
+    out.push_back(static_cast<char>(size >> 8));
+    out.push_back(static_cast<char>(size));
+  }
+  std::vector<char> msg(size, 0);
+  msg[0] = type;
+  if (type != SystemEvent::kMsgType) {
+    for (int b = 0; b < 8; ++b) {
+      msg[11 + b] = static_cast<char>(ref >> (56 - b * 8));
+    }
+  }
+  out.insert(out.end(), msg.begin(), msg.end());
+}
+
+/**
+ * @brief 40 mixed messages: sizes 12, 19, 31, 36 interleaved.
+ */
+std::vector<char> make_stream(bool prefixed) {
+  constexpr char kTypes[] = {'A', 'D', 'E', 'S'};
+  std::vector<char> out;
+  for (uint64_t i = 0; i < 40; ++i) {
+    append_msg(out, kTypes[i % 4], 100 + i, prefixed);
+  }
+  return out;
+}
+
+/**
+ * @brief Records every dispatched message as "<type><ref>" plus its address.
+ */
+struct SequenceVisitor : DefaultVisitor {
+  std::vector<std::string> seen;
+  std::vector<const void *> addresses;
+  std::vector<char> unknown;
+
+  void on_add_order(const AddOrder &msg) { record('A', msg.order_ref, &msg); }
+  void on_order_delete(const OrderDelete &msg) {
+    record('D', msg.order_ref, &msg);
+  }
+  void on_order_executed(const OrderExecuted &msg) {
+    record('E', msg.order_ref, &msg);
+  }
+  void on_system_event(const SystemEvent &msg) { record('S', 0, &msg); }
+  void on_unknown(char type, const char * /*data*/, size_t /*len*/) {
+    unknown.push_back(type);
+  }
+
+private:
+  void record(char type, uint64_t ref, const void *at) {
+    seen.push_back(type + std::to_string(ref));
+    addresses.push_back(at);
+  }
+};
+
+/**
+ * @brief Implements only the AddOrder batch hook (no per-message hooks).
+ */
+struct AddOrderBatchVisitor : DefaultVisitor {
+  std::vector<uint64_t> refs;
+
+  void on_add_order_batch(MessageSpan<AddOrder> run) {
+    for (const AddOrder *msg : run) {
+      refs.push_back(msg->order_ref);
+    }
+  }
+};
+
+/**
+ * @brief 10 AddOrders split mid-message into two chunks; refs seen.
+ */
+template <StreamFraming Framing>
+std::vector<uint64_t> feed_batch_only_split() {
+  constexpr bool kPrefixed = Framing == StreamFraming::LengthPrefixed;
+  std::vector<char> stream;
+  for (uint64_t i = 0; i < 10; ++i) {
+    append_msg(stream, 'A', i, kPrefixed);
+  }
+  const size_t split = stream.size() / 2 + 3; // Inside the sixth message
+
+  StreamParser<Framing> parser;
+  AddOrderBatchVisitor visitor;
+  EXPECT_EQ(parser.feed(stream.data(), split, visitor), split);
+  EXPECT_EQ(parser.feed(stream.data() + split, stream.size() - split,
+                        visitor),
+            stream.size() - split);
+  EXPECT_EQ(parser.carried_messages(), 1u);
+  EXPECT_EQ(parser.pending(), 0u);
+  return visitor.refs;
+}
+
+std::vector<std::string> parse_whole(const std::vector<char> &stream) {
+  SequenceVisitor visitor;
+  Parser parser;
+  EXPECT_EQ(parser.parse_buffer(stream.data(), stream.size(), visitor),
+            stream.size());
+  return visitor.seen;
+}
+
+template <StreamFraming Framing>
+SequenceVisitor feed_in_chunks(const std::vector<char> &stream, size_t chunk,
+                               StreamParser<Framing> &parser) {
+  SequenceVisitor visitor;
+  for (size_t off = 0; off < stream.size(); off += chunk) {
+    const size_t n = std::min(chunk, stream.size() - off);
+    EXPECT_EQ(parser.feed(stream.data() + off, n, visitor), n);
+  }
+  return visitor;
+}
+
+} // namespace
+
+// ============================================================================
+// Raw Framing
+// ============================================================================
+
+TEST(StreamParserTest, EveryChunkSizeMatchesWholeBufferParse) {
+  const std::vector<char> stream = make_stream(false);
+  const std::vector<std::string> expected = parse_whole(stream);
+  ASSERT_EQ(expected.size(), 40u);
+
+  for (size_t chunk = 1; chunk <= stream.size(); ++chunk) {
+    StreamParser<> parser;
+    SequenceVisitor visitor = feed_in_chunks(stream, chunk, parser);
+    EXPECT_EQ(visitor.seen, expected) << "chunk=" << chunk;
+    EXPECT_EQ(parser.pending(), 0u);
+    EXPECT_FALSE(parser.failed());
+  }
+}
+
+TEST(StreamParserTest, OnlyBoundaryMessagesAreCopied) {
+  const std::vector<char> stream = make_stream(false);
+  StreamParser<> parser;
+  SequenceVisitor visitor;
+
+  // Split in the middle of the first message
+  const size_t split = 5;
+  EXPECT_EQ(parser.feed(stream.data(), split, visitor), split);
+  EXPECT_EQ(parser.pending(), split);
+  EXPECT_TRUE(visitor.seen.empty());
+
+  EXPECT_EQ(parser.feed(stream.data() + split, stream.size() - split,
+                        visitor),
+            stream.size() - split);
+  ASSERT_EQ(visitor.seen.size(), 40u);
+  EXPECT_EQ(parser.carried_messages(), 1u);
+
+  // First message came from the carry buffer, the rest from the input
+  const char *begin = stream.data();
+  const char *end = begin + stream.size();
+  const auto *first = static_cast<const char *>(visitor.addresses[0]);
+  EXPECT_TRUE(first < begin || first >= end);
+  for (size_t i = 1; i < visitor.addresses.size(); ++i) {
+    const auto *at = static_cast<const char *>(visitor.addresses[i]);
+    EXPECT_TRUE(at >= begin && at < end) << i;
+  }
+}
+
+TEST(StreamParserTest, UnknownTypeLatchesFailure) {
+  std::vector<char> stream = make_stream(false);
+  const size_t bad_at = message_size('A') + message_size('D');
+  stream[bad_at] = '?';
+
+  StreamParser<> parser;
+  SequenceVisitor visitor;
+  EXPECT_EQ(parser.feed(stream.data(), stream.size(), visitor), bad_at);
+  EXPECT_TRUE(parser.failed());
+  EXPECT_EQ(visitor.seen.size(), 2u);
+  EXPECT_EQ(visitor.unknown, std::vector<char>{'?'});
+
+  EXPECT_EQ(parser.feed(stream.data(), stream.size(), visitor), 0u);
+
+  parser.reset();
+  EXPECT_FALSE(parser.failed());
+  EXPECT_EQ(parser.feed(stream.data(), bad_at, visitor), bad_at);
+}
+
+TEST(StreamParserTest, BatchOnlyVisitorSeesCarriedMessage) {
+  const std::vector<uint64_t> expected = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  EXPECT_EQ(feed_batch_only_split<StreamFraming::Raw>(), expected);
+}
+
+// ============================================================================
+// Length-Prefixed Framing
+// ============================================================================
+
+TEST(StreamParserTest, LengthPrefixedEveryChunkSize) {
+  const std::vector<std::string> expected = parse_whole(make_stream(false));
+  const std::vector<char> stream = make_stream(true);
+
+  for (size_t chunk = 1; chunk <= stream.size(); ++chunk) {
+    StreamParser<StreamFraming::LengthPrefixed> parser;
+    SequenceVisitor visitor = feed_in_chunks(stream, chunk, parser);
+    EXPECT_EQ(visitor.seen, expected) << "chunk=" << chunk;
+    EXPECT_EQ(parser.pending(), 0u);
+  }
+}
+
+TEST(StreamParserTest, LengthPrefixedSkipsOversizedRecordAcrossBoundary) {
+  std::vector<char> stream;
+  append_msg(stream, 'D', 1, true);
+  stream.push_back(0x01); // 300-byte record: no ITCH message is that large
+  stream.push_back(0x2C);
+  stream.insert(stream.end(), 300, 'Z');
+  append_msg(stream, 'D', 2, true);
+
+  for (size_t chunk : {size_t{7}, size_t{64}, size_t{100}}) {
+    StreamParser<StreamFraming::LengthPrefixed> parser;
+    SequenceVisitor visitor = feed_in_chunks(stream, chunk, parser);
+    EXPECT_EQ(visitor.seen, (std::vector<std::string>{"D1", "D2"}))
+        << "chunk=" << chunk;
+    EXPECT_EQ(parser.oversized_records(), 1u);
+  }
+}
+
+TEST(StreamParserTest, LengthPrefixedBatchOnlyVisitorSeesEveryMessage) {
+  const std::vector<uint64_t> expected = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  EXPECT_EQ(feed_batch_only_split<StreamFraming::LengthPrefixed>(), expected);
+}
+
+} // namespace itch::test
@@ -0,0 +1,338 @@
+#pragma once
+
+/**
+ * @file test_captures.hpp
+ * @brief Shared test helpers: temporary files and PCAP/pcapng builders.
+ *
+ * Captures are built in memory. The whole-capture builders write one
+ * little-endian Ethernet interface; tests that need other link types,
+ * several interfaces or a big-endian section compose the block writers
+ * directly. Each test decides payloads and timestamps; the builders only
+ * frame them.
+ *
+ * USAGE:
+ *   std::vector<CapturedPacket> packets = {{ts_ns, "payload"}, ...};
+ *   TempFile tmp(classic_capture(packets), "reader");
+ *   PcapReader reader(tmp.path());
+ */
+
+#include <itch/pcap_reader.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace itch::test {
+
+// ============================================================================
+// Temporary Files
+// ============================================================================
+
+/**
+ * @brief File under /tmp holding `contents` (empty by default, for tests
+ *        that write it themselves), removed on destruction.
+ */
+class TempFile {
+public:
+  /// Created as /tmp/chronos_<tag>_XXXXXX
+  explicit TempFile(const std::vector<char> &contents = {},
+                    const std::string &tag = "test") {
+    std::string tmpl = "/tmp/chronos_" + tag + "_XXXXXX";
+    const int fd = mkstemp(tmpl.data());
+    path_ = tmpl;
+    if (fd >= 0) {
+      FILE *f = fdopen(fd, "wb");
+      std::fwrite(contents.data(), 1, contents.size(), f);
+      std::fclose(f);
+    }
+  }
+
+  ~TempFile() { std::remove(path_.c_str()); }
+
+  TempFile(const TempFile &) = delete;
+  TempFile &operator=(const TempFile &) = delete;
+
+  [[nodiscard]] const char *path() const { return path_.c_str(); }
+
+  /**
+   * @brief What the file holds now.
+   */
+  [[nodiscard]] std::string contents() const {
+    std::ifstream in(path_, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in),
+            std::istreambuf_iterator<char>()};
+  }
+
+private:
+  std::string path_;
+};
+
+// ============================================================================
+// Byte Writers
+// ============================================================================
+
+/// Byte order a capture (or one pcapng section) is written in
+enum class ByteOrder : uint8_t { Little, Big };
+
+inline void put16(std::vector<char> &out, uint16_t v,
+                  ByteOrder order = ByteOrder::Little) {
+  const char bytes[2] = {static_cast<char>(v), static_cast<char>(v >> 8)};
+  if (order == ByteOrder::Big) {
+    out.insert(out.end(), std::rbegin(bytes), std::rend(bytes));
+  } else {
+    out.insert(out.end(), std::begin(bytes), std::end(bytes));
+  }
+}
+
+inline void put32(std::vector<char> &out, uint32_t v,
+                  ByteOrder order = ByteOrder::Little) {
+  put16(out, static_cast<uint16_t>(order == ByteOrder::Big ? v >> 16 : v),
+        order);
+  put16(out, static_cast<uint16_t>(order == ByteOrder::Big ? v : v >> 16),
+        order);
+}
+
+/// Append `data`, then zero bytes up to a multiple of four
+inline void put_padded(std::vector<char> &out, const std::string &data) {
+  out.insert(out.end(), data.begin(), data.end());
+  out.resize((out.size() + 3) & ~size_t{3}, '\0');
+}
+
+// ============================================================================
+// Classic PCAP
+// ============================================================================
+
+/// Timestamp unit written to the capture
+enum class TsUnit : uint8_t { Micro, Nano };
+
+/**
+ * @brief Classic global header; Nano selects the nanosecond magic
+ *        (0xa1b23c4d).
+ */
+inline void classic_header(std::vector<char> &out, TsUnit unit,
+                           LinkType link = LinkType::Ethernet,
+                           uint32_t snaplen = 65535,
+                           ByteOrder order = ByteOrder::Little) {
+  put32(out, unit == TsUnit::Nano ? 0xa1b23c4d : 0xa1b2c3d4, order);
+  put16(out, 2, order);
+  put16(out, 4, order);
+  put32(out, 0, order);
+  put32(out, 0, order);
+  put32(out, snaplen, order);
+  put32(out, static_cast<uint32_t>(link), order);
+}
+
+/**
+ * @brief One classic record; `frac` is in the header's unit.
+ */
+inline void classic_record(std::vector<char> &out, uint32_t sec,
+                           uint32_t frac, const std::string &data,
+                           ByteOrder order = ByteOrder::Little) {
+  put32(out, sec, order);
+  put32(out, frac, order);
+  put32(out, static_cast<uint32_t>(data.size()), order);
+  put32(out, static_cast<uint32_t>(data.size()), order);
+  out.insert(out.end(), data.begin(), data.end());
+}
+
+// ============================================================================
+// pcapng
+// ============================================================================
+
+/**
+ * @brief Frame `body` as a pcapng block (total length before and after).
+ */
+inline void pcapng_block(std::vector<char> &out, uint32_t type,
+                         const std::vector<char> &body,
+                         ByteOrder order = ByteOrder::Little) {
+  const auto total = static_cast<uint32_t>(12 + body.size());
+  put32(out, type, order);
+  put32(out, total, order);
+  out.insert(out.end(), body.begin(), body.end());
+  put32(out, total, order);
+}
+
+/**
+ * @brief Section Header Block (version 1.0, section length unknown).
+ */
+inline void pcapng_section_header(std::vector<char> &out,
+                                  ByteOrder order = ByteOrder::Little) {
+  std::vector<char> body;
+  put32(body, kPcapNgByteOrderMagic, order);
+  put16(body, 1, order);
+  put16(body, 0, order);
+  put32(body, 0xFFFFFFFF, order); // Section length: unknown
+  put32(body, 0xFFFFFFFF, order);
+  pcapng_block(out, kPcapNgSectionHeader, body, order);
+}
+
+/**
+ * @brief Fields and options of one Interface Description Block.
+ */
+struct PcapNgInterfaceSpec {
+  LinkType link = LinkType::Ethernet;
+  uint32_t snaplen = 0;
+  int tsresol = -1;           ///< if_tsresol value; -1: none (microseconds)
+  const char *name = nullptr; ///< if_name value, if any
+};
+
+/**
+ * @brief Interface Description Block; options (and opt_endofopt) only
+ *        when the spec asks for one.
+ */
+inline void pcapng_interface(std::vector<char> &out,
+                             const PcapNgInterfaceSpec &spec = {},
+                             ByteOrder order = ByteOrder::Little) {
+  std::vector<char> body;
+  put16(body, static_cast<uint16_t>(spec.link), order);
+  put16(body, 0, order);
+  put32(body, spec.snaplen, order);
+  if (spec.name != nullptr) {
+    const std::string name = spec.name;
+    put16(body, 2, order); // if_name
+    put16(body, static_cast<uint16_t>(name.size()), order);
+    put_padded(body, name);
+  }
+  if (spec.tsresol >= 0) {
+    put16(body, kPcapNgOptionTsResol, order);
+    put16(body, 1, order);
+    put_padded(body, std::string(1, static_cast<char>(spec.tsresol)));
+  }
+  if (spec.name != nullptr || spec.tsresol >= 0) {
+    put32(body, 0, order); // opt_endofopt
+  }
+  pcapng_block(out, kPcapNgInterfaceDescription, body, order);
+}
+
+/**
+ * @brief Enhanced Packet Block; `ticks` is in the interface's resolution.
+ */
+inline void pcapng_enhanced_packet(std::vector<char> &out, uint32_t iface,
+                                   uint64_t ticks, const std::string &data,
+                                   ByteOrder order = ByteOrder::Little) {
+  std::vector<char> body;
+  put32(body, iface, order);
+  put32(body, static_cast<uint32_t>(ticks >> 32), order);
+  put32(body, static_cast<uint32_t>(ticks), order);
+  put32(body, static_cast<uint32_t>(data.size()), order);
+  put32(body, static_cast<uint32_t>(data.size()), order);
+  put_padded(body, data);
+  pcapng_block(out, kPcapNgEnhancedPacket, body, order);
+}
+
+/**
+ * @brief Simple Packet Block of a frame `orig_len` bytes long.
+ */
+inline void pcapng_simple_packet(std::vector<char> &out, uint32_t orig_len,
+                                 const std::string &data,
+                                 ByteOrder order = ByteOrder::Little) {
+  std::vector<char> body;
+  put32(body, orig_len, order);
+  put_padded(body, data);
+  pcapng_block(out, kPcapNgSimplePacket, body, order);
+}
+
+// ============================================================================
+// Whole Captures
+// ============================================================================
+
+/**
+ * @brief One packet to frame: capture timestamp and bytes.
+ */
+struct CapturedPacket {
+  uint64_t ts_ns = 0;
+  std::string data;
+};
+
+/// Payload length of packet `i` (see numbered_packets())
+using PayloadSizeFn = std::function<size_t(size_t)>;
+
+/**
+ * @brief Payload of packet `i`: "pkt<i>:", filled up to `size` bytes with
+ *        one letter per packet.
+ */
+inline std::string numbered_payload(size_t i, size_t size = 0) {
+  std::string data = "pkt" + std::to_string(i) + ":";
+  data.resize(size > data.size() ? size : data.size(),
+              static_cast<char>('a' + i % 26));
+  return data;
+}
+
+/**
+ * @brief `count` packets of numbered_payload(i, size_fn(i)), the first at
+ *        `first_ns` and then every `spacing_ns`. Without `size_fn` each
+ *        payload is just its number.
+ */
+inline std::vector<CapturedPacket>
+numbered_packets(size_t count, uint64_t first_ns, uint64_t spacing_ns,
+                 const PayloadSizeFn &size_fn = {}) {
+  std::vector<CapturedPacket> out;
+  out.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    out.push_back({first_ns + i * spacing_ns,
+                   numbered_payload(i, size_fn ? size_fn(i) : 0)});
+  }
+  return out;
+}
+
+/**
+ * @brief Classic PCAP: global header, then one record per packet.
+ */
+inline std::vector<char>
+classic_capture(const std::vector<CapturedPacket> &packets,
+                TsUnit unit = TsUnit::Micro, uint32_t snaplen = 65535,
+                LinkType link = LinkType::Ethernet) {
+  std::vector<char> out;
+  classic_header(out, unit, link, snaplen);
+  for (const CapturedPacket &p : packets) {
+    const uint64_t frac = p.ts_ns % 1'000'000'000;
+    classic_record(out, static_cast<uint32_t>(p.ts_ns / 1'000'000'000),
+                   static_cast<uint32_t>(unit == TsUnit::Nano ? frac
+                                                              : frac / 1000),
+                   p.data);
+  }
+  return out;
+}
+
+/// Called after each packet's block (e.g. to interleave other blocks)
+using PcapNgAfterPacket = std::function<void(std::vector<char> &, size_t)>;
+
+/**
+ * @brief Append one pcapng section: header, one Ethernet interface, and
+ *        an EPB per packet. Nano adds if_tsresol=9; Micro leaves the
+ *        default.
+ */
+inline void pcapng_section(std::vector<char> &out,
+                           const std::vector<CapturedPacket> &packets,
+                           TsUnit unit = TsUnit::Nano,
+                           const PcapNgAfterPacket &after = {}) {
+  const bool nano = unit == TsUnit::Nano;
+  pcapng_section_header(out);
+  pcapng_interface(out, {LinkType::Ethernet, 0, nano ? 9 : -1});
+  for (size_t i = 0; i < packets.size(); ++i) {
+    const CapturedPacket &p = packets[i];
+    pcapng_enhanced_packet(out, 0, nano ? p.ts_ns : p.ts_ns / 1000, p.data);
+    if (after) {
+      after(out, i);
+    }
+  }
+}
+
+/**
+ * @brief One-section pcapng capture (see pcapng_section()).
+ */
+inline std::vector<char>
+pcapng_capture(const std::vector<CapturedPacket> &packets,
+               TsUnit unit = TsUnit::Nano,
+               const PcapNgAfterPacket &after = {}) {
+  std::vector<char> out;
+  pcapng_section(out, packets, unit, after);
+  return out;
+}
+
+} // namespace itch::test
@@ -0,0 +1,103 @@
+#pragma once
+
+/**
+ * @file test_moldudp64.hpp
+ * @brief Shared test helpers: MoldUDP64 packet builders and a visitor that
+ *        records OrderDelete refs.
+ *
+ * USAGE:
+ *   std::string pkt = delete_packet(5, 3);   // Refs 5, 6, 7
+ *   DeleteRefs visitor;
+ *   (void)mold.decode_itch(pkt.data(), pkt.size(), visitor);
+ */
+
+#include <itch/moldudp64.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace itch::test {
+
+/// Session of every packet unless a test needs a second one
+inline constexpr const char *kTestSession = "SESSIONA  ";
+
+// ============================================================================
+// Packet Builders
+// ============================================================================
+
+/**
+ * @brief Downstream header alone: `session` (10 bytes), sequence, count.
+ */
+inline std::string mold_header(uint64_t sequence, uint16_t count,
+                               const char *session = kTestSession) {
+  std::string pkt(session, 10);
+  for (int i = 0; i < 8; ++i) {
+    pkt.push_back(static_cast<char>(sequence >> (56 - i * 8)));
+  }
+  pkt.push_back(static_cast<char>(count >> 8));
+  pkt.push_back(static_cast<char>(count));
+  return pkt;
+}
+
+/**
+ * @brief Downstream packet with one length-prefixed block per message.
+ */
+inline std::string mold_packet(const std::vector<std::string> &messages,
+                               uint64_t sequence = 0,
+                               const char *session = kTestSession) {
+  std::string pkt =
+      mold_header(sequence, static_cast<uint16_t>(messages.size()), session);
+  for (const std::string &msg : messages) {
+    pkt.push_back(static_cast<char>(msg.size() >> 8));
+    pkt.push_back(static_cast<char>(msg.size()));
+    pkt += msg;
+  }
+  return pkt;
+}
+
+/**
+ * @brief Zero-filled OrderDelete for `ref`.
+ */
+inline std::string order_delete(uint64_t ref) {
+  std::string msg(sizeof(OrderDelete), '\0');
+  msg[0] = 'D';
+  for (int b = 0; b < 8; ++b) {
+    msg[11 + b] = static_cast<char>(ref >> (56 - b * 8));
+  }
+  return msg;
+}
+
+/**
+ * @brief Packet of `count` OrderDeletes whose refs are their sequence
+ *        numbers, so tests can see exactly which messages were delivered.
+ *
+ * The heartbeat and end-of-session counts give a header-only packet.
+ */
+inline std::string delete_packet(uint64_t sequence, uint16_t count,
+                                 const char *session = kTestSession) {
+  if (count == kMoldHeartbeat || count == kMoldEndOfSession) {
+    return mold_header(sequence, count, session);
+  }
+  std::vector<std::string> messages;
+  for (uint16_t i = 0; i < count; ++i) {
+    messages.push_back(order_delete(sequence + i));
+  }
+  return mold_packet(messages, sequence, session);
+}
+
+// ============================================================================
+// Visitors
+// ============================================================================
+
+/**
+ * @brief Records the order_ref of every OrderDelete, in delivery order.
+ */
+struct DeleteRefs : DefaultVisitor {
+  std::vector<uint64_t> refs;
+  void on_order_delete(const OrderDelete &msg) {
+    refs.push_back(msg.order_ref);
+  }
+};
+
+} // namespace itch::test
@@ -0,0 +1,183 @@
+/**
+ * @file udp_publisher_test.cpp
+ * @brief Unit tests for the sendmmsg UDP publisher, over loopback.
+ */
+
+#include <gtest/gtest.h>
+#include <itch/udp_publisher.hpp>
+#include <itch/udp_receiver.hpp>
+
+#include <string>
+#include <vector>
+
+namespace itch::test {
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief Loopback receiver on a kernel-chosen port.
+ */
+struct Sink {
+  UdpReceiver rx;
+
+  Sink() {
+    ReceiverOptions options;
+    options.bind_address = "127.0.0.1";
+    options.timeout_ms = 500;
+    (void)rx.open(options);
+  }
+
+  std::vector<std::string> drain(size_t count) {
+    std::vector<std::string> out;
+    while (out.size() < count) {
+      if (rx.receive([&](const char *data, size_t len) {
+            out.emplace_back(data, len);
+          }) == 0) {
+        break;
+      }
+    }
+    return out;
+  }
+};
+
+PublisherOptions to_port(uint16_t port, size_t batch) {
+  PublisherOptions options;
+  options.port = port;
+  options.batch = batch;
+  return options;
+}
+
+} // namespace
+
+// ============================================================================
+// Batching
+// ============================================================================
+
+TEST(UdpPublisherTest, SendsFullBatchesAndFlushesTheRest) {
+  Sink sink;
+  ASSERT_TRUE(sink.rx.is_open());
+  UdpPublisher tx;
+  ASSERT_TRUE(tx.open(to_port(sink.rx.port(), 4)));
+
+  std::vector<std::string> sent;
+  for (int i = 0; i < 10; ++i) {
+    sent.push_back("payload-" + std::to_string(i));
+  }
+  for (const std::string &s : sent) {
+    ASSERT_TRUE(tx.send(s.data(), s.size()));
+  }
+  // Two full batches went out on their own; two datagrams wait
+  EXPECT_EQ(tx.stats().batches, 2u);
+  EXPECT_EQ(tx.pending(), 2u);
+  ASSERT_TRUE(tx.flush());
+  EXPECT_EQ(tx.pending(), 0u);
+
+  EXPECT_EQ(sink.drain(sent.size()), sent);
+  EXPECT_EQ(tx.stats().packets, 10u);
+  EXPECT_EQ(tx.stats().batches, 3u);
+  EXPECT_EQ(tx.stats().syscalls, 3u);
+  EXPECT_EQ(tx.stats().dropped, 0u);
+}
+
+TEST(UdpPublisherTest, CountsBytes) {
+  Sink sink;
+  UdpPublisher tx;
+  ASSERT_TRUE(tx.open(to_port(sink.rx.port(), 8)));
+  const std::string a(100, 'a');
+  const std::string b(300, 'b');
+  (void)tx.send(a.data(), a.size());
+  (void)tx.send(b.data(), b.size());
+  ASSERT_TRUE(tx.flush());
+  EXPECT_EQ(tx.stats().bytes, 400u);
+  EXPECT_EQ(sink.drain(2), (std::vector<std::string>{a, b}));
+}
+
+TEST(UdpPublisherTest, EmptyFlushIsNotABatch) {
+  UdpPublisher tx;
+  ASSERT_TRUE(tx.open(to_port(9, 4)));
+  EXPECT_TRUE(tx.flush());
+  EXPECT_EQ(tx.stats().batches, 0u);
+  EXPECT_EQ(tx.stats().syscalls, 0u);
+}
+
+// ============================================================================
+// Refusals
+// ============================================================================
+
+TEST(UdpPublisherTest, DropsOversizeDatagrams) {
+  UdpPublisher tx;
+  ASSERT_TRUE(tx.open(to_port(9, 4)));
+  const std::vector<char> huge(UdpPublisher::kMaxDatagram + 1, 'x');
+  EXPECT_FALSE(tx.send(huge.data(), huge.size()));
+  EXPECT_EQ(tx.stats().dropped, 1u);
+  EXPECT_EQ(tx.pending(), 0u);
+}
+
+TEST(UdpPublisherTest, KeepsGoingWhenTheKernelRefuses) {
+  // Nobody listens: loopback answers with port unreachable, and the
+  // connected socket reports it on a later send
+  uint16_t closed = 0;
+  {
+    Sink gone;
+    closed = gone.rx.port();
+  }
+  UdpPublisher tx;
+  ASSERT_TRUE(tx.open(to_port(closed, 4)));
+  const std::string data = "into the void";
+  for (int i = 0; i < 40; ++i) {
+    (void)tx.send(data.data(), data.size());
+  }
+  (void)tx.flush();
+  EXPECT_EQ(tx.stats().packets + tx.stats().dropped, 40u);
+  EXPECT_EQ(tx.pending(), 0u);
+}
+
+TEST(UdpPublisherTest, RejectsBadOptions) {
+  UdpPublisher tx;
+  PublisherOptions options;
+  options.address = "localhost"; // Numeric IPv4 only
+  EXPECT_FALSE(tx.open(options));
+  options = PublisherOptions{};
+  options.batch = 0;
+  EXPECT_FALSE(tx.open(options));
+  const std::string data = "closed";
+  EXPECT_FALSE(tx.send(data.data(), data.size()));
+}
+
+// ============================================================================
+// Multicast
+// ============================================================================
+
+TEST(UdpPublisherTest, PublishesToMulticastGroup) {
+  ReceiverOptions ropts;
+  ropts.group = "239.255.77.78";
+  ropts.interface = "127.0.0.1";
+  ropts.timeout_ms = 200;
+  UdpReceiver rx;
+  if (!rx.open(ropts)) {
+    GTEST_SKIP() << "multicast join refused on loopback";
+  }
+
+  PublisherOptions options;
+  options.address = "239.255.77.78";
+  options.interface = "127.0.0.1";
+  options.port = rx.port();
+  UdpPublisher tx;
+  ASSERT_TRUE(tx.open(options));
+  const std::string data = "to the group";
+  (void)tx.send(data.data(), data.size());
+  if (!tx.flush()) {
+    GTEST_SKIP() << "no multicast route via loopback";
+  }
+
+  std::vector<std::string> got;
+  (void)rx.receive(
+      [&](const char *p, size_t len) { got.emplace_back(p, len); });
+  EXPECT_EQ(got, (std::vector<std::string>{data}));
+}
+
+} // namespace itch::test
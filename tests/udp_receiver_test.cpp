@@ -0,0 +1,247 @@
+/**
+ * @file udp_receiver_test.cpp
+ * @brief Unit tests for the recvmmsg UDP receiver, over loopback.
+ */
+
+#include <gtest/gtest.h>
+#include <itch/moldudp64.hpp>
+#include <itch/udp_receiver.hpp>
+
+#include "test_moldudp64.hpp"
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace itch::test {
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief Plain UDP socket sending to a loopback port.
+ */
+class Sender {
+public:
+  explicit Sender(uint16_t port, const char *to = "127.0.0.1") {
+    fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    to_.sin_family = AF_INET;
+    to_.sin_port = htons(port);
+    inet_pton(AF_INET, to, &to_.sin_addr);
+  }
+
+  ~Sender() { ::close(fd_); }
+
+  Sender(const Sender &) = delete;
+  Sender &operator=(const Sender &) = delete;
+
+  /**
+   * @brief Send multicast out of the loopback interface, and back to us.
+   */
+  bool multicast_via_loopback() {
+    in_addr lo{};
+    inet_pton(AF_INET, "127.0.0.1", &lo);
+    const unsigned char loop = 1;
+    return setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_IF, &lo, sizeof(lo)) ==
+               0 &&
+           setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_LOOP, &loop,
+                      sizeof(loop)) == 0;
+  }
+
+  bool send(const std::string &data) {
+    return ::sendto(fd_, data.data(), data.size(), 0,
+                    reinterpret_cast<const sockaddr *>(&to_),
+                    sizeof(to_)) == static_cast<ssize_t>(data.size());
+  }
+
+private:
+  int fd_ = -1;
+  sockaddr_in to_{};
+};
+
+ReceiverOptions loopback(size_t batch) {
+  ReceiverOptions options;
+  options.bind_address = "127.0.0.1";
+  options.batch = batch;
+  options.timeout_ms = 1000;
+  return options;
+}
+
+uint64_t realtime_ns() {
+  timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000 +
+         static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/**
+ * @brief Receive until `count` datagrams arrived (or a call times out).
+ */
+std::vector<std::string> receive_all(UdpReceiver &rx, size_t count) {
+  std::vector<std::string> out;
+  while (out.size() < count) {
+    const size_t got = rx.receive(
+        [&](const char *data, size_t len) { out.emplace_back(data, len); });
+    if (got == 0) {
+      break;
+    }
+  }
+  return out;
+}
+
+} // namespace
+
+// ============================================================================
+// Receiving
+// ============================================================================
+
+TEST(UdpReceiverTest, ReceivesQueuedDatagramsInBatches) {
+  UdpReceiver rx;
+  ASSERT_TRUE(rx.open(loopback(8)));
+  ASSERT_NE(rx.port(), 0);
+  Sender tx(rx.port());
+
+  std::vector<std::string> sent;
+  for (int i = 0; i < 20; ++i) {
+    sent.push_back("datagram " + std::to_string(i) +
+                   std::string(static_cast<size_t>(i), '.'));
+    ASSERT_TRUE(tx.send(sent.back()));
+  }
+
+  EXPECT_EQ(receive_all(rx, sent.size()), sent);
+  EXPECT_EQ(rx.stats().packets, 20u);
+  // Loopback queues synchronously: 8 + 8 + 4
+  EXPECT_EQ(rx.stats().syscalls, 3u);
+  EXPECT_GT(rx.stats().packets_per_syscall(), 6.0);
+}
+
+TEST(UdpReceiverTest, StampsKernelReceiveTime) {
+  UdpReceiver rx;
+  ASSERT_TRUE(rx.open(loopback(4)));
+  Sender tx(rx.port());
+
+  const uint64_t before = realtime_ns();
+  ASSERT_TRUE(tx.send("stamped"));
+  uint64_t stamp = 0;
+  ASSERT_EQ(rx.receive([&](const char *, size_t, uint64_t ts_ns) {
+    stamp = ts_ns;
+  }),
+            1u);
+  EXPECT_GE(stamp, before);
+  EXPECT_LE(stamp, realtime_ns());
+}
+
+TEST(UdpReceiverTest, TimestampsCanBeDisabled) {
+  ReceiverOptions options = loopback(4);
+  options.timestamps = false;
+  UdpReceiver rx;
+  ASSERT_TRUE(rx.open(options));
+  Sender tx(rx.port());
+  ASSERT_TRUE(tx.send("plain"));
+
+  uint64_t stamp = 1;
+  ASSERT_EQ(rx.receive([&](const char *, size_t, uint64_t ts_ns) {
+    stamp = ts_ns;
+  }),
+            1u);
+  EXPECT_EQ(stamp, 0u);
+}
+
+TEST(UdpReceiverTest, DropsDatagramsLongerThanASlot) {
+  ReceiverOptions options = loopback(4);
+  options.max_datagram = 64;
+  UdpReceiver rx;
+  ASSERT_TRUE(rx.open(options));
+  Sender tx(rx.port());
+  ASSERT_TRUE(tx.send(std::string(100, 'x')));
+  ASSERT_TRUE(tx.send("fits"));
+
+  EXPECT_EQ(receive_all(rx, 1), (std::vector<std::string>{"fits"}));
+  EXPECT_EQ(rx.stats().truncated, 1u);
+}
+
+TEST(UdpReceiverTest, PollModeReturnsAtOnce) {
+  ReceiverOptions options = loopback(4);
+  options.timeout_ms = 0;
+  UdpReceiver rx;
+  ASSERT_TRUE(rx.open(options));
+
+  EXPECT_EQ(rx.receive([](const char *, size_t) {}), 0u);
+  EXPECT_EQ(rx.stats().empty, 1u);
+  EXPECT_EQ(rx.stats().errors, 0u);
+}
+
+TEST(UdpReceiverTest, TimeoutBoundsTheWait) {
+  ReceiverOptions options = loopback(4);
+  options.timeout_ms = 20;
+  UdpReceiver rx;
+  ASSERT_TRUE(rx.open(options));
+
+  const uint64_t start = realtime_ns();
+  EXPECT_EQ(rx.receive([](const char *, size_t) {}), 0u);
+  EXPECT_GE(realtime_ns() - start, 15'000'000u);
+  EXPECT_EQ(rx.stats().empty, 1u);
+}
+
+TEST(UdpReceiverTest, RejectsBadOptions) {
+  UdpReceiver rx;
+  ReceiverOptions options;
+  options.bind_address = "not an address";
+  EXPECT_FALSE(rx.open(options));
+
+  options = ReceiverOptions{};
+  options.batch = 0;
+  EXPECT_FALSE(rx.open(options));
+  EXPECT_EQ(rx.receive([](const char *, size_t) {}), 0u);
+}
+
+// ============================================================================
+// Feed Path
+// ============================================================================
+
+TEST(UdpReceiverTest, FeedsMoldUdp64Decoder) {
+  UdpReceiver rx;
+  ASSERT_TRUE(rx.open(loopback(16)));
+  Sender tx(rx.port());
+  for (uint64_t seq = 1; seq <= 30; seq += 3) {
+    ASSERT_TRUE(tx.send(delete_packet(seq, 3)));
+  }
+
+  MoldUdp64Decoder<> mold;
+  DeleteRefs visitor;
+  size_t packets = 0;
+  while (packets < 10) {
+    const size_t got = rx.receive([&](const char *data, size_t len) {
+      (void)mold.decode_itch(data, len, visitor);
+    });
+    ASSERT_GT(got, 0u);
+    packets += got;
+  }
+
+  ASSERT_EQ(visitor.refs.size(), 30u);
+  for (uint64_t i = 0; i < 30; ++i) {
+    EXPECT_EQ(visitor.refs[i], i + 1);
+  }
+  EXPECT_EQ(mold.stats().gaps, 0u);
+}
+
+TEST(UdpReceiverTest, JoinsMulticastGroup) {
+  ReceiverOptions options;
+  options.group = "239.255.77.77";
+  options.interface = "127.0.0.1";
+  options.timeout_ms = 200;
+  UdpReceiver rx;
+  if (!rx.open(options)) {
+    GTEST_SKIP() << "multicast join refused on loopback";
+  }
+  Sender tx(rx.port(), "239.255.77.77");
+  if (!tx.multicast_via_loopback() || !tx.send("to the group")) {
+    GTEST_SKIP() << "no multicast route via loopback";
+  }
+  EXPECT_EQ(receive_all(rx, 1), (std::vector<std::string>{"to the group"}));
+}
+
+} // namespace itch::test